@@ -0,0 +1,181 @@
+#include "support/common.h"
+#include "support/ocl.h"
+#include "support/timer.h"
+#include "support/verify.h"
+
+#include <unistd.h>
+#include <thread>
+#include <assert.h>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+// Params ---------------------------------------------------------------------
+struct Params {
+
+    int   platform;
+    int   device;
+    int   n_work_items;
+    int   n_work_groups;
+    int   n_warmup;
+    int   n_reps;
+    int   chunk_size;
+    int   n_bins;
+    int   n_windows;
+    int   windows[4];
+
+    Params(int argc, char **argv) {
+        platform      = 0;
+        device        = 0;
+        n_work_items  = 256;
+        n_work_groups = 16;
+        n_warmup      = 5;
+        n_reps        = 50;
+        chunk_size    = 256 * 1024;   // samples per tick
+        n_bins        = 256;
+        n_windows     = 4;            // window sizes, in chunks
+        windows[0]    = 4;
+        windows[1]    = 16;
+        windows[2]    = 64;
+        windows[3]    = 256;
+    }
+};
+
+
+void read_chunk(unsigned int *input, const Params &p) {
+
+	for(int i = 0; i < p.chunk_size; i++){
+		input[i] = rand() % 4096;
+	}
+}
+
+
+// Main ------------------------------------------------------------------------------------------
+int main(int argc, char **argv) {
+
+    const Params p(argc, argv);
+    OpenCLSetup  ocl(p.platform, p.device);
+    cl_int       clStatus;
+    Timer        timer;
+
+    // Allocate buffers
+    timer.start("Allocation");
+
+	int n_tasks  = p.chunk_size / p.n_work_items;
+	int max_wnd  = *std::max_element(p.windows, p.windows + p.n_windows);
+
+    // Host keeps the samples of the current window only to verify the result
+    unsigned int *h_window      = (unsigned int *)malloc((size_t)max_wnd * p.chunk_size * sizeof(unsigned int));
+    unsigned int *h_ring        = (unsigned int *)malloc((size_t)max_wnd * p.n_bins * sizeof(unsigned int));
+    unsigned int *h_histo       = (unsigned int *)malloc(p.n_bins * sizeof(unsigned int));
+    cl_mem        d_chunk       = clCreateBuffer(
+        ocl.clContext, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, p.chunk_size * sizeof(unsigned int), NULL, &clStatus);
+    CL_ERR();
+    cl_mem d_histo = clCreateBuffer(
+        ocl.clContext, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, p.n_bins * sizeof(unsigned int), NULL, &clStatus);
+    CL_ERR();
+    cl_mem d_ring  = clCreateBuffer(
+        ocl.clContext, CL_MEM_READ_WRITE, (size_t)max_wnd * p.n_bins * sizeof(unsigned int), NULL, &clStatus);
+    CL_ERR();
+    ALLOC_ERR(h_window, h_ring, h_histo);
+    clFinish(ocl.clCommandQueue);
+
+    timer.stop("Allocation");
+    timer.print("Allocation", 1);
+
+    srand(time(NULL));
+    memset(h_ring, 0, (size_t)max_wnd * p.n_bins * sizeof(unsigned int));
+
+    size_t ls[1] = {(size_t)p.n_work_items};
+    size_t gs[1] = {(size_t)p.n_work_groups * p.n_work_items};
+    size_t ls_evict[1] = {(size_t)p.n_work_items};
+    size_t gs_evict[1] = {(size_t)divceil(p.n_bins, p.n_work_items) * p.n_work_items};
+
+    printf("\n\nChunk size: %d samples, %d bins\n", p.chunk_size, p.n_bins);
+    printf("%10s %16s %16s %16s\n", "Window", "Samples", "Tick avg (ms)", "Tick max (ms)");
+
+    for(int w = 0; w < p.n_windows; w++) {
+
+        const int n_slots = p.windows[w];
+
+        // Reset the window: all slots empty
+        memset(h_histo, 0, p.n_bins * sizeof(unsigned int));
+        clStatus = clEnqueueWriteBuffer(
+            ocl.clCommandQueue, d_ring, CL_TRUE, 0, (size_t)n_slots * p.n_bins * sizeof(unsigned int), h_ring, 0, NULL, NULL);
+        CL_ERR();
+        clStatus = clEnqueueWriteBuffer(
+            ocl.clCommandQueue, d_histo, CL_TRUE, 0, p.n_bins * sizeof(unsigned int), h_histo, 0, NULL, NULL);
+        CL_ERR();
+        clFinish(ocl.clCommandQueue);
+
+        // The first n_slots ticks fill the window, only later ticks evict real chunks
+        std::vector<double> latency;
+        for(int tick = 0; tick < n_slots + p.n_warmup + p.n_reps; tick++) {
+
+            const int slot = tick % n_slots;
+            unsigned int *h_chunk = h_window + (size_t)slot * p.chunk_size;
+            read_chunk(h_chunk, p);
+
+            const double start = getCurrentTimestamp();
+
+            clStatus = clEnqueueWriteBuffer(
+                ocl.clCommandQueue, d_chunk, CL_FALSE, 0, p.chunk_size * sizeof(unsigned int), h_chunk, 0, NULL, NULL);
+            CL_ERR();
+
+            // Subtract the oldest chunk and empty its slot
+            clSetKernelArg(ocl.clKernelEvict, 0, sizeof(int), &p.n_bins);
+            clSetKernelArg(ocl.clKernelEvict, 1, sizeof(int), &slot);
+            clSetKernelArg(ocl.clKernelEvict, 2, sizeof(cl_mem), &d_histo);
+            clSetKernelArg(ocl.clKernelEvict, 3, sizeof(cl_mem), &d_ring);
+            clStatus = clEnqueueNDRangeKernel(ocl.clCommandQueue, ocl.clKernelEvict, 1, NULL, gs_evict, ls_evict, 0, NULL, NULL);
+            CL_ERR();
+
+            // Add the newest chunk to the same slot and to the window histogram
+            clSetKernelArg(ocl.clKernel, 0, sizeof(int), &n_tasks);
+            clSetKernelArg(ocl.clKernel, 1, sizeof(int), &p.n_bins);
+            clSetKernelArg(ocl.clKernel, 2, sizeof(int), &slot);
+            clSetKernelArg(ocl.clKernel, 3, sizeof(cl_mem), &d_chunk);
+            clSetKernelArg(ocl.clKernel, 4, sizeof(cl_mem), &d_histo);
+            clSetKernelArg(ocl.clKernel, 5, sizeof(cl_mem), &d_ring);
+            clSetKernelArg(ocl.clKernel, 6, p.n_bins * sizeof(unsigned int), NULL);
+            clStatus = clEnqueueNDRangeKernel(ocl.clCommandQueue, ocl.clKernel, 1, NULL, gs, ls, 0, NULL, NULL);
+            CL_ERR();
+
+            clStatus = clEnqueueReadBuffer(
+                ocl.clCommandQueue, d_histo, CL_TRUE, 0, p.n_bins * sizeof(unsigned int), h_histo, 0, NULL, NULL);
+            CL_ERR();
+            clFinish(ocl.clCommandQueue);
+
+            const double stop = getCurrentTimestamp();
+            if(tick >= n_slots + p.n_warmup)
+                latency.push_back((stop - start) * 1e3);
+        }
+
+        double sum = 0.0, max = 0.0;
+        for(unsigned int i = 0; i < latency.size(); i++) {
+            sum += latency[i];
+            max = std::max(max, latency[i]);
+        }
+        printf("%10d %16ld %16.3f %16.3f\n", n_slots, (long)n_slots * p.chunk_size, sum / latency.size(), max);
+
+        // Verify answer against the samples currently in the window
+        verify(h_histo, h_window, n_slots * p.chunk_size, p.n_bins);
+    }
+
+
+    // Free memory
+    timer.start("Deallocation");
+    free(h_window);
+    free(h_ring);
+    free(h_histo);
+    clStatus = clReleaseMemObject(d_chunk);
+    clStatus = clReleaseMemObject(d_histo);
+    clStatus = clReleaseMemObject(d_ring);
+    CL_ERR();
+    ocl.release();
+    timer.stop("Deallocation");
+    timer.print("Deallocation", 1);
+
+    printf("\nTest Passed\n");
+    return 0;
+}
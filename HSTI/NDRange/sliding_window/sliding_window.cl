@@ -0,0 +1,66 @@
+#define _OPENCL_COMPILER_
+
+#pragma OPENCL EXTENSION cl_khr_global_int32_base_atomics : enable
+#pragma OPENCL EXTENSION cl_khr_global_int32_extended_atomics : enable
+
+#include "support/common.h"
+
+// The window histogram (histo) is kept as the sum of the per-chunk histograms
+// stored in a ring of n_slots * bins counters (ring). Each tick evicts the
+// oldest slot and refills it with the histogram of the newest chunk, so the
+// work per tick depends on the chunk size only, not on the window size.
+
+// OpenCL kernel ------------------------------------------------------------------------------------------
+__kernel
+void Window_evict_kernel(int bins, int slot, __global unsigned int *histo, __global unsigned int *ring) {
+
+    __global unsigned int *evicted = ring + slot * bins;
+
+    // Subtract the evicted chunk and clear its slot for the incoming chunk
+    for(int pos = get_global_id(0); pos < bins; pos += get_global_size(0)) {
+        histo[pos] -= evicted[pos];
+        evicted[pos] = 0;
+    }
+}
+
+__kernel
+void Histogram_kernel(int n_tasks, int bins, int slot, __global unsigned int *data,
+    __global unsigned int *histo, __global unsigned int *ring, __local unsigned int *l_histo ) {
+
+    // Block and thread index
+    const int bx = get_group_id(0);
+    const int tx = get_local_id(0);
+    const int bD = get_local_size(0);
+    const int gD = get_num_groups(0);
+
+    __global unsigned int *added = ring + slot * bins;
+
+    // Sub-histograms initialization
+    for(int pos = tx; pos < bins; pos += bD) {
+        l_histo[pos] = 0;
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE); // Intra-block synchronization
+
+    // Main loop over the newest chunk only
+    for(int i = bx; i < n_tasks; i += gD) {
+
+        // Global memory read
+        unsigned int d = data[i * bD + tx];
+
+// Atomic vote in shared memory
+        atomic_add(&l_histo[((d * bins) >> 12)], 1);
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE); // Intra-block synchronization
+
+    // Merge per-block histograms into the ring slot and the window histogram
+    for(int pos = tx; pos < bins; pos += bD) {
+        unsigned int v = l_histo[pos];
+        if(v != 0) {
+// Atomic addition in global memory
+            atomic_add(added + pos, v);
+            atomic_add(histo + pos, v);
+        }
+    }
+}
@@ -4,55 +4,75 @@
 #include <limits.h>
 #include <math.h>
 #include <float.h>
-#include <omp.h>
 #include "kmeans.h"
+#include "AOCLUtils/aocl_utils.h"
 
 #define AOCL_ALIGNMENT 64
-#include <malloc.h>
+#define ARENA_ROUND(bytes) (((bytes) + AOCL_ALIGNMENT - 1) / AOCL_ALIGNMENT * AOCL_ALIGNMENT)
 
 float	min_rmse_ref = FLT_MAX;		
-extern double wtime(void);
 	/* reference min_rmse value */
 
+/*---< arena_init() >--------------------------------------------------------*/
+/* Carves every host buffer out of one allocation; each region starts on an
+   AOCL_ALIGNMENT boundary so that it can be transferred by DMA. */
+void arena_init(km_arena *arena, int npoints, int nfeatures, int nclusters)
+{
+	size_t sizes[6] = {
+		ARENA_ROUND((size_t) npoints * nfeatures * sizeof(float)),	/* feature */
+		ARENA_ROUND((size_t) npoints * sizeof(int)),				/* membership */
+		ARENA_ROUND((size_t) npoints * sizeof(int)),				/* membership_OCL */
+		ARENA_ROUND((size_t) nclusters * nfeatures * sizeof(float)),	/* clusters */
+		ARENA_ROUND((size_t) nclusters * nfeatures * sizeof(float)),	/* new_centers */
+		ARENA_ROUND((size_t) nclusters * sizeof(int))				/* new_centers_len */
+	};
+	size_t total = 0;
+	for (int i = 0; i < 6; i++)
+		total += sizes[i];
+
+	char *p = (char*) aocl_utils::alignedMalloc(total);
+	if (p == NULL) {
+		fprintf(stderr, "Allocation error at %s, %d\n", __FILE__, __LINE__);
+		exit(-1);
+	}
+
+	arena->base            = p;
+	arena->feature         = (float*) p;	p += sizes[0];
+	arena->membership      = (int*)   p;	p += sizes[1];
+	arena->membership_OCL  = (int*)   p;	p += sizes[2];
+	arena->clusters        = (float*) p;	p += sizes[3];
+	arena->new_centers     = (float*) p;	p += sizes[4];
+	arena->new_centers_len = (int*)   p;
+}
+
+void arena_free(km_arena *arena)
+{
+	aocl_utils::alignedFree(arena->base);
+	arena->base = NULL;
+}
+
 /*---< cluster() >-----------------------------------------------------------*/
 void cluster(int      npoints,				/* number of data points */
             int      nfeatures,				/* number of attributes for each point */
-            float  **features,				/* array: [npoints][nfeatures] */                  
+            km_arena *arena,				/* in: features, out: centres and membership */
             int      nclusters,				/* range of min to max number of clusters */
             float    threshold,				/* loop terminating factor */
-            float ***cluster_centres,		/* out: [best_nclusters][nfeatures] */
 			int		 nloops					/* number of iteration for each number of clusters */
 			)
 {    
-	int		index =0;						/* number of iteration to reach the best RMSE */
-	int		rmse;							/* RMSE for each clustering */
-    int    *membership;						/* which cluster a data point belongs to */
-    float **tmp_cluster_centres;			/* hold coordinates of cluster centers */
 	int		i;
+	double	start_time;
 	
-	/* allocate memory for membership */
-	membership = (int*) _aligned_malloc(npoints * sizeof(int), AOCL_ALIGNMENT);
-
-	/* allocate device memory, invert data array */
-	allocate(npoints, nfeatures, nclusters, features);
-
-	/* iterate nloops times for each number of clusters */
+	/* iterate nloops times for each number of clusters; every loop reuses
+	   the arena and the device buffers */
 	for(i = 0; i < nloops; i++)
 	{
-		/* initialize initial cluster centers, CUDA calls (@ kmeans_cuda.cu) */
-		tmp_cluster_centres = kmeans_clustering(features,
-												nfeatures,
-												npoints,
-												nclusters,
-												threshold,
-												membership);
-		if (*cluster_centres) {
-			free((*cluster_centres)[0]);
-			free(*cluster_centres);
-		}
-		*cluster_centres = tmp_cluster_centres;	        					
+		start_time = aocl_utils::getCurrentTimestamp();
+		kmeans_clustering(arena,
+						  nfeatures,
+						  npoints,
+						  nclusters,
+						  threshold);
+		printf("loop %d: time to convergence (ms): %0.3f\n", i, (aocl_utils::getCurrentTimestamp() - start_time) * 1e3);
 	}		
-	deallocateMemory();						/* free device memory (@ kmeans_cuda.cu) */
-	
-    _aligned_free(membership);
-}
\ No newline at end of file
+}
@@ -7,11 +7,6 @@
 #include "kmeans.h"
 #include "timer.h"
 
-#include <windows.h>
-
-#define AOCL_ALIGNMENT 64
-#include <malloc.h>
-
 #ifndef FLT_MAX
 #define FLT_MAX 3.40282347e+38
 #endif
@@ -77,6 +72,8 @@ Timer timer;
 static int shutdown()
 {
 	// release resources
+	if( clKernel ) clReleaseKernel( clKernel );
+	if( clProgram ) clReleaseProgram( clProgram );
 	if( clCommandQueue ) clReleaseCommandQueue( clCommandQueue );
 	if( clContext ) clReleaseContext( clContext );
 	// reset all variables
@@ -90,25 +87,49 @@ cl_mem d_feature;
 cl_mem d_cluster;
 cl_mem d_membership;
 
-float *feature_swap;
-int   *membership_OCL;
-int   *membership_d;
-float *feature_d;
-float *clusters_d;
-float *center_d;
+
+/* Reads a kernel source file, NULL if it does not exist */
+static char *loadSource(const char *file_name, size_t *size)
+{
+	FILE *fp = fopen(file_name, "rb");
+	if (fp == NULL)
+		return NULL;
+	fseek(fp, 0, SEEK_END);
+	*size = ftell(fp);
+	rewind(fp);
+	char *source = new char[*size + 1];
+	if (fread(source, 1, *size, fp) != *size) {
+		delete [] source;
+		fclose(fp);
+		return NULL;
+	}
+	source[*size] = '\0';
+	fclose(fp);
+	return source;
+}
 
 
-int allocate(int n_points, int n_features, int n_clusters, float **feature)
+/* Sets up the device and uploads the features, already in the SoA layout
+   the kernel reads. platform is a substring of the OpenCL platform name;
+   on anything but the Intel FPGA platform (e.g. a CPU runtime for testing
+   on Linux) the kernel is built from baseline.cl instead of the AOCX. */
+int allocate(int n_points, int n_features, int n_clusters, float *feature, const char *platform)
 {
 	cl_int  clStatus;
 
 
 	// Get the OpenCL platform.
 	cl_platform_id clPlatform = NULL;
-	clPlatform = findPlatform("Intel(R) FPGA");
+	clPlatform = findPlatform(platform);
 	if(clPlatform == NULL) {
-		printf("ERROR: Unable to find Intel(R) FPGA OpenCL platform.\n");
+		printf("ERROR: Unable to find %s OpenCL platform, using the first one.\n", platform);
+		clPlatform = findPlatform("");
 	}
+	if(clPlatform == NULL) {
+		printf("ERROR: No OpenCL platform found.\n");
+		exit(-1);
+	}
+	bool is_fpga = getPlatformName(clPlatform).find("FPGA") != std::string::npos;
 
 
 	// Query the available OpenCL device.
@@ -141,15 +162,29 @@ int allocate(int n_points, int n_features, int n_clusters, float **feature)
 
 
 	// Create the program.
-	std::string binary_file = getBoardBinaryFile("baseline", clDeviceID);
-	printf("\nUsing AOCX:%s\n",binary_file.c_str());
-	clProgram = createProgramFromBinary(clContext, binary_file.c_str(), &clDeviceID, 1);	
+	if (is_fpga) {
+		std::string binary_file = getBoardBinaryFile("baseline", clDeviceID);
+		printf("\nUsing AOCX:%s\n",binary_file.c_str());
+		clProgram = createProgramFromBinary(clContext, binary_file.c_str(), &clDeviceID, 1);	
+	} else {
+		const char *source_files[] = { "baseline.cl", "device/baseline.cl" };
+		char       *source = NULL;
+		size_t      source_size = 0;
+		for (int i = 0; i < 2 && source == NULL; i++) {
+			source = loadSource(source_files[i], &source_size);
+			if (source)
+				printf("\nUsing source:%s\n", source_files[i]);
+		}
+		if (source == NULL) {
+			printf("ERROR: Unable to find baseline.cl\n");
+			exit(-1);
+		}
+		clProgram = clCreateProgramWithSource(clContext, 1, (const char **) &source, &source_size, &clStatus);
+		delete [] source;
+	}
 	CL_ERR();
 
 
-    char clOptions[50];
-    sprintf(clOptions, "-I.");
-
 	// Build the program that was just created.
     clStatus = clBuildProgram(clProgram, 0, NULL, "", NULL, NULL);  
     if(clStatus == CL_BUILD_PROGRAM_FAILURE) {
@@ -162,6 +197,7 @@ int allocate(int n_points, int n_features, int n_clusters, float **feature)
         clGetProgramBuildInfo(clProgram, clDevices[0], CL_PROGRAM_BUILD_LOG, log_size, log, NULL);
         // Print the log
         fprintf(stderr, "%s\t", log);
+        free(log);
     }
     CL_ERR();
 
@@ -171,26 +207,20 @@ int allocate(int n_points, int n_features, int n_clusters, float **feature)
     CL_ERR();
 
 
-	d_feature = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_points * n_features * sizeof(float), NULL, 0 );
-	d_cluster = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_clusters * n_features  * sizeof(float), NULL, 0 );
-	d_membership = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_points * sizeof(int), NULL, 0 );
-	
-	
-	feature_swap = (float*) _aligned_malloc (n_points * n_features * sizeof(float), AOCL_ALIGNMENT);
-	for(int j = 0; j < n_points; j ++){
-		for(int i = 0; i < n_features; i ++){
-			feature_swap[i * n_points + j] = feature[j][i];
-		}
-	}
-	
+	d_feature = clCreateBuffer(clContext, CL_MEM_READ_ONLY, n_points * n_features * sizeof(float), NULL, &clStatus );
+	CL_ERR();
+	d_cluster = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_clusters * n_features  * sizeof(float), NULL, &clStatus );
+	CL_ERR();
+	d_membership = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_points * sizeof(int), NULL, &clStatus );
+	CL_ERR();
 
 
 	//write buffers
-	//clStatus = clEnqueueWriteBuffer(clCommandQueue, d_feature, 1, 0, n_points * n_features * sizeof(float), feature_swap, 0, 0, 0);
-	clStatus = clEnqueueWriteBuffer(clCommandQueue, d_feature, 1, 0, n_points * n_features * sizeof(float), feature[0], 0, 0, 0);
+	clStatus = clEnqueueWriteBuffer(clCommandQueue, d_feature, 1, 0, n_points * n_features * sizeof(float), feature, 0, 0, 0);
 	CL_ERR();
 
-	membership_OCL = (int*) _aligned_malloc(n_points * sizeof(int), AOCL_ALIGNMENT);
+	delete [] clDevices;
+	return 0;
 }
 
 
@@ -199,8 +229,6 @@ void deallocateMemory()
 	clReleaseMemObject(d_feature);
 	clReleaseMemObject(d_cluster);
 	clReleaseMemObject(d_membership);
-	_aligned_free(feature_swap);
-	_aligned_free(membership_OCL);
 }
 
 
@@ -211,21 +239,22 @@ int main( int argc, char** argv)
 }
 
 
-int	kmeansOCL(float **feature,    /* in: [npoints][nfeatures] */
+int	kmeansOCL(float *feature,    /* in: [nfeatures][npoints] */
            int     n_features,
            int     n_points,
            int     n_clusters,
            int    *membership,
-		   float **clusters,
-		   int     *new_centers_len,
-           float  **new_centers,
-		   float   *time)	
+           int    *membership_OCL,
+		   float  *clusters,
+		   int    *new_centers_len,
+           float  *new_centers,
+		   float  *time)	
 { 
 	int delta = 0;
 	int i, j;
 	cl_int  clStatus;
 
-	clStatus = clEnqueueWriteBuffer(clCommandQueue, d_cluster, 1, 0, n_clusters * n_features * sizeof(float), clusters[0], 0, 0, 0);
+	clStatus = clEnqueueWriteBuffer(clCommandQueue, d_cluster, 1, 0, n_clusters * n_features * sizeof(float), clusters, 0, 0, 0);
 	clFinish(clCommandQueue);
 	CL_ERR();
 	
@@ -271,7 +300,7 @@ int	kmeansOCL(float **feature,    /* in: [npoints][nfeatures] */
 		}
 		for (j = 0; j < n_features; j++)
 		{
-			new_centers[cluster_id][j] += feature[i][j];
+			new_centers[cluster_id*n_features+j] += feature[j*n_points+i];
 		}
 	}
 
@@ -279,6 +308,8 @@ int	kmeansOCL(float **feature,    /* in: [npoints][nfeatures] */
 	if(delta == 0){
 		int temp;
 		FILE *fp = fopen("output/output.txt", "r");
+		if(fp == NULL)
+			return delta;
 		for(int i = 0; i < n_points; i++){
 			fscanf(fp, "%d", &temp);
 			if(membership_OCL[i] != temp){
@@ -286,9 +317,9 @@ int	kmeansOCL(float **feature,    /* in: [npoints][nfeatures] */
 				break;
 			}
 		}
+		fclose(fp);
 		printf("pass!!\n");
 	}
 
 	return delta;
 }
-
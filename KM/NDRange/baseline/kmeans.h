@@ -5,16 +5,30 @@
 #define FLT_MAX 3.40282347e+38
 #endif
 
+/* All host data of a run lives in one aligned arena, allocated once and
+   reused by every loop. Features are kept in the structure-of-arrays layout
+   the kernel reads, feature[l * npoints + i], from input to upload. */
+typedef struct {
+	void   *base;
+	float  *feature;			/* [nfeatures][npoints] */
+	int    *membership;			/* [npoints] */
+	int    *membership_OCL;		/* [npoints], read back from the device */
+	float  *clusters;			/* [nclusters][nfeatures] */
+	float  *new_centers;		/* [nclusters][nfeatures] */
+	int    *new_centers_len;	/* [nclusters] */
+} km_arena;
+
 /* rmse.c */
 float   euclid_dist_2        (float*, float*, int);
 int     find_nearest_point   (float* , int, float**, int);
 float	rms_err(float**, int, int, float**, int);
-void    cluster(int, int, float**, int, float, float***, int);
+void    arena_init(km_arena *arena, int npoints, int nfeatures, int nclusters);
+void    arena_free(km_arena *arena);
+void    cluster(int, int, km_arena*, int, float, int);
 int setup(int argc, char** argv);
-int allocate(int npoints, int nfeatures, int nclusters, float **feature);
+int allocate(int npoints, int nfeatures, int nclusters, float *feature, const char *platform);
 void deallocateMemory();
-int	kmeansOCL(float **feature, int nfeatures, int npoints, int nclusters, int *membership, float **clusters, int *new_centers_len, float  **new_centers, float* time);
-float** kmeans_clustering(float **feature, int nfeatures, int npoints, int nclusters, float threshold, int *membership); 
+int	kmeansOCL(float *feature, int nfeatures, int npoints, int nclusters, int *membership, int *membership_OCL, float *clusters, int *new_centers_len, float *new_centers, float* time);
+int     kmeans_clustering(km_arena *arena, int nfeatures, int npoints, int nclusters, float threshold);
 
 #endif
-
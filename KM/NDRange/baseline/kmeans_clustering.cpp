@@ -1,82 +1,48 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <float.h>
 #include <math.h>
-#include <omp.h>
 #include "kmeans.h"
-#define RANDOM_MAX 2147483647
 
-#define AOCL_ALIGNMENT 64
-#include <malloc.h>
-
-extern double wtime(void);
 /*----< kmeans_clustering() >---------------------------------------------*/
-float** kmeans_clustering(float **feature,    /* in: [npoints][nfeatures] */
-                          int     nfeatures,
-                          int     npoints,
-                          int     nclusters,
-                          float   threshold,
-                          int    *membership) /* out: [npoints] */
+/* Runs to convergence in the buffers of the arena; the centres are left in
+   arena->clusters and the membership in arena->membership. Returns the
+   number of iterations. */
+int kmeans_clustering(km_arena *arena,
+                      int       nfeatures,
+                      int       npoints,
+                      int       nclusters,
+                      float     threshold)
 {    
-    int      i, j, n = 0;				/* counters */
-	int		 loop=0, temp;
-    int     *new_centers_len;	/* [nclusters]: no. of points in each cluster */
-    float    delta;				/* if the point moved */
-    float  **clusters;			/* out: [nclusters][nfeatures] */
-    float  **new_centers;		/* [nclusters][nfeatures] */
-	int     *initial;			/* used to hold the index of points not yet selected
-								   prevents the "birthday problem" of dual selection (?)
-								   considered holding initial cluster indices, but changed due to
-								   possible, though unlikely, infinite loops */
-	int      initial_points;
+    int      i, j;					/* counters */
+	int		 loop=0;
+    float    delta;					/* if the point moved */
+    float   *feature         = arena->feature;			/* in: [nfeatures][npoints] */
+    float   *clusters        = arena->clusters;			/* out: [nclusters][nfeatures] */
+    float   *new_centers     = arena->new_centers;		/* [nclusters][nfeatures] */
+    int     *new_centers_len = arena->new_centers_len;	/* [nclusters]: no. of points in each cluster */
 	int		 c = 0;
-	float	 *time;
+	float	 time[1];
 	float	 total_time;
 
 	/* nclusters should never be > npoints
 	   that would guarantee a cluster without points */
 	if (nclusters > npoints)
 		nclusters = npoints;
-    /* allocate space for and initialize returning variable clusters[] */
-	clusters    = (float**) _aligned_malloc(nclusters *             sizeof(float*), AOCL_ALIGNMENT);
-	clusters[0] = (float*)  _aligned_malloc(nclusters * nfeatures * sizeof(float), AOCL_ALIGNMENT);
-    for (i=1; i<nclusters; i++)
-        clusters[i] = clusters[i-1] + nfeatures;
-	/* initialize the random clusters */
-	initial = (int *) _aligned_malloc (npoints * sizeof(int), AOCL_ALIGNMENT);
-	for (i = 0; i < npoints; i++)
-	{
-		initial[i] = i;
-	}
-	initial_points = npoints;
-    /* randomly pick cluster centers */
-    for (i=0; i<nclusters && initial_points >= 0; i++) {
-		//n = (int)rand() % initial_points;		
-		
-        for (j=0; j<nfeatures; j++)
-            clusters[i][j] = feature[initial[n]][j];	// remapped
 
-		/* swap the selected index to the end (not really necessary,
-		   could just move the end up) */
-		temp = initial[n];
-		initial[n] = initial[initial_points-1];
-		initial[initial_points-1] = temp;
-		initial_points--;
-		n++;
-    }
+	/* the first nclusters points are the initial centers
+	   (the random pick of the original code was disabled) */
+    for (i=0; i<nclusters; i++)
+        for (j=0; j<nfeatures; j++)
+            clusters[i*nfeatures+j] = feature[j*npoints+i];
 
 	/* initialize the membership to -1 for all */
     for (i=0; i < npoints; i++)
-	  membership[i] = -1;
-
-    /* allocate space for and initialize new_centers_len and new_centers */
-    new_centers_len = (int*) calloc(nclusters, sizeof(int));
-	time			= (float*) malloc (sizeof(float));
+	  arena->membership[i] = -1;
 
-	new_centers    = (float**) _aligned_malloc(nclusters *            sizeof(float*), AOCL_ALIGNMENT);
-    new_centers[0] = (float*)  calloc(nclusters * nfeatures, sizeof(float));
-    for (i=1; i<nclusters; i++)
-        new_centers[i] = new_centers[i-1] + nfeatures;
+	memset(new_centers, 0, nclusters * nfeatures * sizeof(float));
+	memset(new_centers_len, 0, nclusters * sizeof(int));
 
 	total_time = 0.0;
 
@@ -84,11 +50,12 @@ float** kmeans_clustering(float **feature,    /* in: [npoints][nfeatures] */
 	do {
         delta	   = 0.0;
 		// CUDA
-		delta = (float) kmeansOCL(feature,			/* in: [npoints][nfeatures] */
+		delta = (float) kmeansOCL(feature,			/* in: [nfeatures][npoints] */
 								   nfeatures,		/* number of attributes for each point */
 								   npoints,			/* number of data points */
 								   nclusters,		/* number of clusters */
-								   membership,		/* which cluster the point belongs to */
+								   arena->membership,		/* which cluster the point belongs to */
+								   arena->membership_OCL,	/* staging of the device membership */
 								   clusters,		/* out: [nclusters][nfeatures] */
 								   new_centers_len,	/* out: number of points in each cluster */
 								   new_centers,		/* sum of points in each cluster */
@@ -99,8 +66,8 @@ float** kmeans_clustering(float **feature,    /* in: [npoints][nfeatures] */
 		for (i=0; i<nclusters; i++) {
 			for (j=0; j<nfeatures; j++) {
 				if (new_centers_len[i] > 0)
-					clusters[i][j] = new_centers[i][j] / new_centers_len[i];	/* take average i.e. sum/n */
-				new_centers[i][j] = 0.0;	/* set back to 0 */
+					clusters[i*nfeatures+j] = new_centers[i*nfeatures+j] / new_centers_len[i];	/* take average i.e. sum/n */
+				new_centers[i*nfeatures+j] = 0.0;	/* set back to 0 */
 			}
 			new_centers_len[i] = 0;			/* set back to 0 */
 		}	 
@@ -110,10 +77,7 @@ float** kmeans_clustering(float **feature,    /* in: [npoints][nfeatures] */
 	
 	printf("iterated %d times\n", c);
 	printf("Kernel Time (ms): %0.3f\n", total_time / c);
-    free(new_centers[0]);
-    _aligned_free(new_centers);
-    free(new_centers_len);
-    return clusters;
+    return c;
 }
 
 
@@ -5,55 +5,55 @@
 #include <string.h>
 #include <limits.h>
 #include <math.h>
-#include <fcntl.h>
-#include <omp.h>
-#include "kmeans.h"
-#include <unistd.h>
 #include <time.h>
-
-#define AOCL_ALIGNMENT 64
-#include <malloc.h>
-
-extern double wtime(void);
+#include "kmeans.h"
 
 
 /*---< main() >-------------------------------------------------------------*/
+/* host [-loops <n>] [-platform <name>]
+   -platform picks the OpenCL platform by name, e.g. "portable" for PoCL;
+   the Intel FPGA platform is the default. */
 int setup(int argc, char **argv) {
 
-		char   *filename = "input/input.txt";	
-		float  *buf;
-		char	line[1024];
-		float	threshold = 0.001;		
+		char   *filename = "input/input.txt";
+		const char *platform = "Intel(R) FPGA";
+		float	threshold = 0.001;
 		int		nclusters=128;					// 128 clusters
 		int		nfeatures = 8;					// 8 features
 		int		npoints = 25600;				// 25600 points
-		float	len;		         
-		float **features;
-		float **cluster_centres=NULL;
-		int		nloops = 1;					
+		km_arena arena;
+		int		nloops = 1;
 		int		isOutput = 0;
 
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-loops") && i + 1 < argc)
+			nloops = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-platform") && i + 1 < argc)
+			platform = argv[++i];
+	}
 
 
-    /* allocate space for features[] and read attributes of all objects */
-	buf         = (float*) _aligned_malloc(npoints*nfeatures*sizeof(float), AOCL_ALIGNMENT);
-	features    = (float**)_aligned_malloc(npoints*          sizeof(float*), AOCL_ALIGNMENT);
-	features[0] = (float*) _aligned_malloc(npoints*nfeatures*sizeof(float), AOCL_ALIGNMENT);
-    for (int i=1; i<npoints; i++)
-        features[i] = features[i-1] + nfeatures;
-    
-
+    /* allocate the arena and read attributes of all objects straight into
+       the [nfeatures][npoints] layout */
+	arena_init(&arena, npoints, nfeatures, nclusters);
 
 	float temp;
 	FILE *fp = fopen(filename, "r");
-	for(int i = 0; i < npoints * nfeatures; i++){
-		fscanf(fp, "%f", &temp);
-		buf[i] = temp;
+	if (fp == NULL) {
+		printf("Error: cannot open %s\n", filename);
+		exit(0);
 	}
+	for(int i = 0; i < npoints; i++){
+		for(int j = 0; j < nfeatures; j++){
+			fscanf(fp, "%f", &temp);
+			arena.feature[j * npoints + i] = temp;
+		}
+	}
+	fclose(fp);
 
 	printf("\nI/O completed\n");
 	printf("\nNumber of objects: %d\n", npoints);
-	printf("Number of features: %d\n", nfeatures);	
+	printf("Number of features: %d\n", nfeatures);
 
 	/* ============== I/O end ==============*/
 	// error check for clusters
@@ -63,20 +63,20 @@ int setup(int argc, char **argv) {
 		exit(0);
 	}
 
-	memcpy(features[0], buf, npoints*nfeatures*sizeof(float)); /* now features holds 2-dimensional array of features */
-	_aligned_free(buf);
-
 
 	/* ======================= core of the clustering ===================*/
 
-	cluster_centres = NULL;
+	/* allocate device memory, upload the features once */
+	allocate(npoints, nfeatures, nclusters, arena.feature, platform);
+
     cluster(npoints,				/* number of data points */
 			nfeatures,				/* number of features for each point */
-			features,				/* array: [npoints][nfeatures] */
+			&arena,					/* in: [nfeatures][npoints], out: centres */
 			nclusters,				/* range of min to max number of clusters */
 			threshold,				/* loop termination factor */
-			&cluster_centres,		/* return: [best_nclusters][nfeatures] */  
-			nloops);				/* number of iteration for each number of clusters */		   
+			nloops);				/* number of iteration for each number of clusters */
+
+	deallocateMemory();				/* free device memory */
 
 
 	/* =============== Command Line Output =============== */
@@ -87,16 +87,15 @@ int setup(int argc, char **argv) {
 		for(int i = 0; i < nclusters; i++){
 			printf("%d:", i);
 			for(int j = 0; j < nfeatures; j++){
-				printf(" %.2f", cluster_centres[i][j]);
+				printf(" %.2f", arena.clusters[i * nfeatures + j]);
 			}
 			printf("\n\n");
 		}
-	}	
+	}
+
 
-	
 
 	/* free up memory */
-	_aligned_free(features[0]);
-	_aligned_free(features);    
+	arena_free(&arena);
     return(0);
 }
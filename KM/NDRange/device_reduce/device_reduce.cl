@@ -0,0 +1,172 @@
+#ifndef FLT_MAX
+#define FLT_MAX 3.40282347e+38
+#endif
+#define NUM_CLUSTERS 128
+#define NUM_FEATURE  8
+#define WG_SIZE      128
+
+// Assignment kernel. Besides the membership, every work-group emits the
+// partial sums and counts of its own points per cluster, plus the number of
+// points that changed cluster. Requires nclusters <= NUM_CLUSTERS <= WG_SIZE.
+__kernel
+__attribute((reqd_work_group_size(WG_SIZE,1,1)))
+void kmeans_kernel_c(__global float  *restrict feature,
+			  __global float  *restrict clusters,
+			  __global int    *restrict membership,
+			  __global float  *restrict partial_centers,	/* [ngroups][NUM_CLUSTERS][NUM_FEATURE] */
+			  __global int    *restrict partial_len,		/* [ngroups][NUM_CLUSTERS] */
+			  __global int    *restrict partial_delta,		/* [ngroups] */
+			    int     npoints,
+				int     nclusters,
+				int     nfeatures ) {
+
+	unsigned int point_id = get_global_id(0);
+	unsigned int local_id = get_local_id(0);
+	unsigned int group_id = get_group_id(0);
+    int index = 0;
+
+	__local float l_clusters[NUM_CLUSTERS*NUM_FEATURE];
+	__local float l_points[WG_SIZE*NUM_FEATURE];
+	__local int   l_index[WG_SIZE];
+	__local int   l_changed[WG_SIZE];
+
+	if (local_id < nclusters){
+
+		l_clusters[local_id*NUM_FEATURE+0] = clusters[local_id*NUM_FEATURE+0];
+		l_clusters[local_id*NUM_FEATURE+1] = clusters[local_id*NUM_FEATURE+1];
+		l_clusters[local_id*NUM_FEATURE+2] = clusters[local_id*NUM_FEATURE+2];
+		l_clusters[local_id*NUM_FEATURE+3] = clusters[local_id*NUM_FEATURE+3];
+		l_clusters[local_id*NUM_FEATURE+4] = clusters[local_id*NUM_FEATURE+4];
+		l_clusters[local_id*NUM_FEATURE+5] = clusters[local_id*NUM_FEATURE+5];
+		l_clusters[local_id*NUM_FEATURE+6] = clusters[local_id*NUM_FEATURE+6];
+		l_clusters[local_id*NUM_FEATURE+7] = clusters[local_id*NUM_FEATURE+7];
+	}
+
+	// The last work-group may be partial: padded work-items carry no point
+	bool valid = point_id < npoints;
+
+	float p_feature[NUM_FEATURE];
+	#pragma unroll
+	for (int l = 0; l < NUM_FEATURE; l++){
+		p_feature[l] = valid ? feature[point_id * NUM_FEATURE + l] : 0.0f;
+	}
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+	float min_dist = FLT_MAX;
+
+	#pragma unroll 8
+	for (int i=0; i < nclusters; i++) {
+
+		float dist = 0;
+		float ans  = 0;
+
+		#pragma unroll
+		for (int l = 0; l < NUM_FEATURE; l++){
+			float cluster_tmp = l_clusters[i*NUM_FEATURE+l];
+			float feature_tmp = p_feature[l];
+			float sub_tmp = feature_tmp - cluster_tmp;
+			ans += sub_tmp * sub_tmp;
+		}
+		dist = ans;
+
+		if (dist < min_dist) {
+			min_dist = dist;
+			index    = i;
+		}
+	}
+
+	int changed = 0;
+	if (valid) {
+		changed = (membership[point_id] != index);
+		membership[point_id] = index;
+	} else {
+		index = -1;
+	}
+
+	// Stage the assignment of this work-group in local memory
+	l_index[local_id]   = index;
+	l_changed[local_id] = changed;
+	#pragma unroll
+	for (int l = 0; l < NUM_FEATURE; l++){
+		l_points[local_id*NUM_FEATURE+l] = p_feature[l];
+	}
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+	// Work-item c accumulates cluster c over the points of this work-group
+	if (local_id < nclusters){
+
+		float sum[NUM_FEATURE];
+		int   len = 0;
+		#pragma unroll
+		for (int l = 0; l < NUM_FEATURE; l++)
+			sum[l] = 0.0f;
+
+		for (int j = 0; j < WG_SIZE; j++){
+			if (l_index[j] == local_id){
+				len++;
+				#pragma unroll
+				for (int l = 0; l < NUM_FEATURE; l++)
+					sum[l] += l_points[j*NUM_FEATURE+l];
+			}
+		}
+
+		#pragma unroll
+		for (int l = 0; l < NUM_FEATURE; l++)
+			partial_centers[(group_id*NUM_CLUSTERS + local_id)*NUM_FEATURE + l] = sum[l];
+		partial_len[group_id*NUM_CLUSTERS + local_id] = len;
+	}
+
+	if (local_id == 0){
+		int delta = 0;
+		for (int j = 0; j < WG_SIZE; j++)
+			delta += l_changed[j];
+		partial_delta[group_id] = delta;
+	}
+}
+
+
+// Reduction kernel. One work-item per cluster folds the per-group partial
+// sums and writes the new centre in place; clusters without points keep
+// their previous centre. Work-item 0 also folds the changed-point count.
+__kernel
+void kmeans_reduce(__global float  *restrict partial_centers,
+			  __global int    *restrict partial_len,
+			  __global int    *restrict partial_delta,
+			  __global float  *restrict clusters,
+			  __global int    *restrict delta,
+			    int     ngroups,
+				int     nclusters ) {
+
+	unsigned int cluster_id = get_global_id(0);
+
+	if (cluster_id < nclusters){
+
+		float sum[NUM_FEATURE];
+		int   len = 0;
+		#pragma unroll
+		for (int l = 0; l < NUM_FEATURE; l++)
+			sum[l] = 0.0f;
+
+		for (int g = 0; g < ngroups; g++){
+			len += partial_len[g*NUM_CLUSTERS + cluster_id];
+			#pragma unroll
+			for (int l = 0; l < NUM_FEATURE; l++)
+				sum[l] += partial_centers[(g*NUM_CLUSTERS + cluster_id)*NUM_FEATURE + l];
+		}
+
+		if (len > 0){
+			#pragma unroll
+			for (int l = 0; l < NUM_FEATURE; l++)
+				clusters[cluster_id*NUM_FEATURE + l] = sum[l] / len;
+		}
+	}
+
+	if (cluster_id == 0){
+		int d = 0;
+		for (int g = 0; g < ngroups; g++)
+			d += partial_delta[g];
+		delta[0] = d;
+	}
+}
@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <float.h>
+#include <math.h>
+#include <omp.h>
+#include "kmeans.h"
+#define RANDOM_MAX 2147483647
+
+#define AOCL_ALIGNMENT 64
+#include <malloc.h>
+
+extern double wtime(void);
+/*----< kmeans_clustering() >---------------------------------------------*/
+float** kmeans_clustering(float **feature,    /* in: [npoints][nfeatures] */
+                          int     nfeatures,
+                          int     npoints,
+                          int     nclusters,
+                          float   threshold,
+                          int    *membership, /* out: [npoints] */
+                          int     compare)    /* also time the host reduction */
+{    
+    int      i, j, n = 0;				/* counters */
+	int		 loop=0, temp;
+    float    delta;				/* if the point moved */
+    float  **clusters;			/* out: [nclusters][nfeatures] */
+	int     *initial;			/* used to hold the index of points not yet selected
+								   prevents the "birthday problem" of dual selection (?)
+								   considered holding initial cluster indices, but changed due to
+								   possible, though unlikely, infinite loops */
+	int      initial_points;
+	int		 c = 0;
+	float	 *time;
+	float	 total_time, total_reduce_time, total_host_reduce_time;
+
+	/* nclusters should never be > npoints
+	   that would guarantee a cluster without points */
+	if (nclusters > npoints)
+		nclusters = npoints;
+    /* allocate space for and initialize returning variable clusters[] */
+	clusters    = (float**) _aligned_malloc(nclusters *             sizeof(float*), AOCL_ALIGNMENT);
+	clusters[0] = (float*)  _aligned_malloc(nclusters * nfeatures * sizeof(float), AOCL_ALIGNMENT);
+    for (i=1; i<nclusters; i++)
+        clusters[i] = clusters[i-1] + nfeatures;
+	/* initialize the random clusters */
+	initial = (int *) _aligned_malloc (npoints * sizeof(int), AOCL_ALIGNMENT);
+	for (i = 0; i < npoints; i++)
+	{
+		initial[i] = i;
+	}
+	initial_points = npoints;
+    /* randomly pick cluster centers */
+    for (i=0; i<nclusters && initial_points >= 0; i++) {
+		//n = (int)rand() % initial_points;		
+		
+        for (j=0; j<nfeatures; j++)
+            clusters[i][j] = feature[initial[n]][j];	// remapped
+
+		/* swap the selected index to the end (not really necessary,
+		   could just move the end up) */
+		temp = initial[n];
+		initial[n] = initial[initial_points-1];
+		initial[initial_points-1] = temp;
+		initial_points--;
+		n++;
+    }
+
+	/* initialize the membership to -1 for all */
+    for (i=0; i < npoints; i++)
+	  membership[i] = -1;
+
+	/* new centres are reduced on the device, no host accumulators needed */
+	time			= (float*) calloc (3, sizeof(float));
+
+	total_time = 0.0;
+	total_reduce_time = 0.0;
+	total_host_reduce_time = 0.0;
+
+	/* iterate until convergence */
+	do {
+        delta	   = 0.0;
+		// CUDA
+		delta = (float) kmeansOCL(feature,			/* in: [npoints][nfeatures] */
+								   nfeatures,		/* number of attributes for each point */
+								   npoints,			/* number of data points */
+								   nclusters,		/* number of clusters */
+								   membership,		/* which cluster the point belongs to */
+								   clusters,		/* in/out: [nclusters][nfeatures] */
+								   c,				/* iteration number */
+								   time);
+
+		total_time += time[0];
+		total_reduce_time += time[1];
+		total_host_reduce_time += time[2];
+		c++;
+    } while ((delta > threshold) && (loop++ < 500));	/* makes sure loop terminates */
+	
+	printf("iterated %d times\n", c);
+	printf("Kernel Time (ms): %0.3f\n", total_time / c);
+	printf("Device Reduction Time (ms): %0.3f\n", total_reduce_time / c);
+	if (compare)
+		printf("Host Reduction Time (ms): %0.3f\n", total_host_reduce_time / c);
+	printf("Iteration Time, device reduction (ms): %0.3f\n", (total_time + total_reduce_time) / c);
+	if (compare)
+		printf("Iteration Time, host reduction (ms): %0.3f\n", (total_time + total_host_reduce_time) / c);
+    free(time);
+    return clusters;
+}
+
+
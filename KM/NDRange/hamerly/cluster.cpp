@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <float.h>
+#include <omp.h>
+#include "kmeans.h"
+
+#define AOCL_ALIGNMENT 64
+#include <malloc.h>
+
+float	min_rmse_ref = FLT_MAX;		
+extern double wtime(void);
+	/* reference min_rmse value */
+
+/*---< cluster() >-----------------------------------------------------------*/
+void cluster(int      npoints,				/* number of data points */
+            int      nfeatures,				/* number of attributes for each point */
+            float  **features,				/* array: [npoints][nfeatures] */                  
+            int      nclusters,				/* range of min to max number of clusters */
+            float    threshold,				/* loop terminating factor */
+            float ***cluster_centres,		/* out: [best_nclusters][nfeatures] */
+			int		 nloops					/* number of iteration for each number of clusters */
+			)
+{    
+	int		index =0;						/* number of iteration to reach the best RMSE */
+	int		rmse;							/* RMSE for each clustering */
+    int    *membership;						/* which cluster a data point belongs to */
+    float **tmp_cluster_centres;			/* hold coordinates of cluster centers */
+	int		i, j, prune, agree;
+	int    *membership_ref;					/* membership of the unpruned run */
+	float **cpu_centres;					/* centres of the CPU reference */
+	
+	/* allocate memory for membership */
+	membership     = (int*) _aligned_malloc(npoints * sizeof(int), AOCL_ALIGNMENT);
+	membership_ref = (int*) _aligned_malloc(npoints * sizeof(int), AOCL_ALIGNMENT);
+	cpu_centres    = (float**) _aligned_malloc(nclusters * sizeof(float*), AOCL_ALIGNMENT);
+	cpu_centres[0] = (float*)  _aligned_malloc(nclusters * nfeatures * sizeof(float), AOCL_ALIGNMENT);
+	for (i=1; i<nclusters; i++)
+		cpu_centres[i] = cpu_centres[i-1] + nfeatures;
+
+	/* allocate device memory, invert data array */
+	allocate(npoints, nfeatures, nclusters, features);
+
+	/* iterate nloops times for each number of clusters */
+	for(i = 0; i < nloops; i++)
+	{
+		/* full scan first, then with Hamerly pruning from the same seeds */
+		for(prune = 0; prune <= 1; prune++)
+		{
+			printf("\n================= device, %s =================\n", prune ? "hamerly" : "lloyd");
+			tmp_cluster_centres = kmeans_clustering(features,
+													nfeatures,
+													npoints,
+													nclusters,
+													threshold,
+													membership,
+													prune);
+			if (*cluster_centres) {
+				_aligned_free((*cluster_centres)[0]);
+				_aligned_free(*cluster_centres);
+			}
+			*cluster_centres = tmp_cluster_centres;
+			if (!prune)
+				memcpy(membership_ref, membership, npoints * sizeof(int));
+		}
+	}		
+	deallocateMemory();						/* free device memory (@ kmeans_cuda.cu) */
+
+	/* pruning must not change the result */
+	for (j = 0, agree = 0; j < npoints; j++)
+		agree += (membership[j] == membership_ref[j]);
+	printf("device membership agreement, hamerly vs lloyd: %d of %d\n", agree, npoints);
+
+	/* CPU reference of both modes */
+	for(prune = 0; prune <= 1; prune++)
+	{
+		printf("\n================= cpu, %s =================\n", prune ? "hamerly" : "lloyd");
+		kmeans_hamerly_cpu(features, nfeatures, npoints, nclusters, threshold, membership_ref, cpu_centres, prune);
+	}
+	for (j = 0, agree = 0; j < npoints; j++)
+		agree += (membership[j] == membership_ref[j]);
+	printf("membership agreement, device vs cpu hamerly: %d of %d\n", agree, npoints);
+
+	_aligned_free(cpu_centres[0]);
+	_aligned_free(cpu_centres);
+    _aligned_free(membership_ref);
+    _aligned_free(membership);
+}
\ No newline at end of file
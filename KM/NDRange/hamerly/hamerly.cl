@@ -0,0 +1,292 @@
+#ifndef FLT_MAX
+#define FLT_MAX 3.40282347e+38
+#endif
+#define NUM_CLUSTERS 128
+#define NUM_FEATURE  8
+#define WG_SIZE      128
+
+// Hamerly-pruned assignment kernel. Every point keeps an upper bound on the
+// distance to its centre and a lower bound on the distance to any other
+// centre. Bounds are first loosened by the centre drift of the last update;
+// when the upper bound is below both the lower bound and half the distance
+// from its centre to the nearest other centre, the assignment cannot change
+// and the distance scan is skipped. With prune == 0 every point is scanned.
+//
+// As in device_reduce, every work-group also emits partial centroid sums,
+// counts, changed points and skipped distance computations.
+// Requires nclusters <= NUM_CLUSTERS <= WG_SIZE.
+__kernel
+__attribute((reqd_work_group_size(WG_SIZE,1,1)))
+void kmeans_kernel_c(__global float  *restrict feature,
+			  __global float  *restrict clusters,
+			  __global int    *restrict membership,
+			  __global float  *restrict upper,				/* [npoints] */
+			  __global float  *restrict lower,				/* [npoints] */
+			  __global float  *restrict separation,			/* [nclusters]: half distance to the nearest other centre */
+			  __global float  *restrict drift,				/* [nclusters]: distance moved in the last update */
+			  __global float  *restrict max_drift,			/* [1] */
+			  __global float  *restrict partial_centers,	/* [ngroups][NUM_CLUSTERS][NUM_FEATURE] */
+			  __global int    *restrict partial_len,		/* [ngroups][NUM_CLUSTERS] */
+			  __global int    *restrict partial_delta,		/* [ngroups] */
+			  __global int    *restrict partial_skipped,	/* [ngroups] */
+			    int     npoints,
+				int     nclusters,
+				int     nfeatures,
+				int     prune ) {
+
+	unsigned int point_id = get_global_id(0);
+	unsigned int local_id = get_local_id(0);
+	unsigned int group_id = get_group_id(0);
+
+	__local float l_clusters[NUM_CLUSTERS*NUM_FEATURE];
+	__local float l_separation[NUM_CLUSTERS];
+	__local float l_drift[NUM_CLUSTERS];
+	__local float l_points[WG_SIZE*NUM_FEATURE];
+	__local int   l_index[WG_SIZE];
+	__local int   l_changed[WG_SIZE];
+	__local int   l_skipped[WG_SIZE];
+
+	if (local_id < nclusters){
+
+		l_clusters[local_id*NUM_FEATURE+0] = clusters[local_id*NUM_FEATURE+0];
+		l_clusters[local_id*NUM_FEATURE+1] = clusters[local_id*NUM_FEATURE+1];
+		l_clusters[local_id*NUM_FEATURE+2] = clusters[local_id*NUM_FEATURE+2];
+		l_clusters[local_id*NUM_FEATURE+3] = clusters[local_id*NUM_FEATURE+3];
+		l_clusters[local_id*NUM_FEATURE+4] = clusters[local_id*NUM_FEATURE+4];
+		l_clusters[local_id*NUM_FEATURE+5] = clusters[local_id*NUM_FEATURE+5];
+		l_clusters[local_id*NUM_FEATURE+6] = clusters[local_id*NUM_FEATURE+6];
+		l_clusters[local_id*NUM_FEATURE+7] = clusters[local_id*NUM_FEATURE+7];
+		l_separation[local_id] = separation[local_id];
+		l_drift[local_id]      = drift[local_id];
+	}
+
+	// The last work-group may be partial: padded work-items carry no point
+	bool valid = point_id < npoints;
+
+	float p_feature[NUM_FEATURE];
+	#pragma unroll
+	for (int l = 0; l < NUM_FEATURE; l++){
+		p_feature[l] = valid ? feature[point_id * NUM_FEATURE + l] : 0.0f;
+	}
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+	int   index   = valid ? membership[point_id] : -1;
+	float u       = valid ? upper[point_id] : 0.0f;
+	float lo      = valid ? lower[point_id] : 0.0f;
+	int   skipped = 0;
+	bool  scan    = valid;
+
+	if (valid && prune && index >= 0){
+
+		u  += l_drift[index];
+		lo -= max_drift[0];
+		float m = fmax(l_separation[index], lo);
+
+		if (u <= m){
+			scan    = false;
+			skipped = nclusters;
+		} else {
+			// Tighten the upper bound with the exact distance to the current centre
+			float ans = 0;
+			#pragma unroll
+			for (int l = 0; l < NUM_FEATURE; l++){
+				float sub_tmp = p_feature[l] - l_clusters[index*NUM_FEATURE+l];
+				ans += sub_tmp * sub_tmp;
+			}
+			u = sqrt(ans);
+			if (u <= m){
+				scan    = false;
+				skipped = nclusters - 1;
+			}
+		}
+	}
+
+	int old_index = index;
+
+	if (scan){
+
+		float min_dist    = FLT_MAX;
+		float second_dist = FLT_MAX;
+		index = 0;
+
+		#pragma unroll 8
+		for (int i=0; i < nclusters; i++) {
+
+			float dist = 0;
+			float ans  = 0;
+
+			#pragma unroll
+			for (int l = 0; l < NUM_FEATURE; l++){
+				float cluster_tmp = l_clusters[i*NUM_FEATURE+l];
+				float feature_tmp = p_feature[l];
+				float sub_tmp = feature_tmp - cluster_tmp;
+				ans += sub_tmp * sub_tmp;
+			}
+			dist = ans;
+
+			if (dist < min_dist) {
+				second_dist = min_dist;
+				min_dist    = dist;
+				index       = i;
+			} else if (dist < second_dist) {
+				second_dist = dist;
+			}
+		}
+		u  = sqrt(min_dist);
+		lo = sqrt(second_dist);
+	}
+
+	int changed = 0;
+	if (valid) {
+		changed = (old_index != index);
+		membership[point_id] = index;
+		upper[point_id]      = u;
+		lower[point_id]      = lo;
+	}
+
+	// Stage the assignment of this work-group in local memory
+	l_index[local_id]   = index;
+	l_changed[local_id] = changed;
+	l_skipped[local_id] = skipped;
+	#pragma unroll
+	for (int l = 0; l < NUM_FEATURE; l++){
+		l_points[local_id*NUM_FEATURE+l] = p_feature[l];
+	}
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+	// Work-item c accumulates cluster c over the points of this work-group
+	if (local_id < nclusters){
+
+		float sum[NUM_FEATURE];
+		int   len = 0;
+		#pragma unroll
+		for (int l = 0; l < NUM_FEATURE; l++)
+			sum[l] = 0.0f;
+
+		for (int j = 0; j < WG_SIZE; j++){
+			if (l_index[j] == local_id){
+				len++;
+				#pragma unroll
+				for (int l = 0; l < NUM_FEATURE; l++)
+					sum[l] += l_points[j*NUM_FEATURE+l];
+			}
+		}
+
+		#pragma unroll
+		for (int l = 0; l < NUM_FEATURE; l++)
+			partial_centers[(group_id*NUM_CLUSTERS + local_id)*NUM_FEATURE + l] = sum[l];
+		partial_len[group_id*NUM_CLUSTERS + local_id] = len;
+	}
+
+	if (local_id == 0){
+		int delta = 0;
+		int skip  = 0;
+		for (int j = 0; j < WG_SIZE; j++){
+			delta += l_changed[j];
+			skip  += l_skipped[j];
+		}
+		partial_delta[group_id]   = delta;
+		partial_skipped[group_id] = skip;
+	}
+}
+
+
+// Reduction kernel. One work-item per cluster folds the per-group partial
+// sums, writes the new centre in place and records how far it moved;
+// clusters without points keep their previous centre. Work-item 0 also folds
+// the changed-point and skipped-distance counts into stats[0] and stats[1].
+__kernel
+void kmeans_reduce(__global float  *restrict partial_centers,
+			  __global int    *restrict partial_len,
+			  __global int    *restrict partial_delta,
+			  __global int    *restrict partial_skipped,
+			  __global float  *restrict clusters,
+			  __global float  *restrict drift,
+			  __global int    *restrict stats,
+			    int     ngroups,
+				int     nclusters ) {
+
+	unsigned int cluster_id = get_global_id(0);
+
+	if (cluster_id < nclusters){
+
+		float sum[NUM_FEATURE];
+		int   len = 0;
+		#pragma unroll
+		for (int l = 0; l < NUM_FEATURE; l++)
+			sum[l] = 0.0f;
+
+		for (int g = 0; g < ngroups; g++){
+			len += partial_len[g*NUM_CLUSTERS + cluster_id];
+			#pragma unroll
+			for (int l = 0; l < NUM_FEATURE; l++)
+				sum[l] += partial_centers[(g*NUM_CLUSTERS + cluster_id)*NUM_FEATURE + l];
+		}
+
+		float moved = 0;
+		if (len > 0){
+			#pragma unroll
+			for (int l = 0; l < NUM_FEATURE; l++){
+				float center  = sum[l] / len;
+				float sub_tmp = center - clusters[cluster_id*NUM_FEATURE + l];
+				moved += sub_tmp * sub_tmp;
+				clusters[cluster_id*NUM_FEATURE + l] = center;
+			}
+		}
+		drift[cluster_id] = sqrt(moved);
+	}
+
+	if (cluster_id == 0){
+		int d = 0;
+		int s = 0;
+		for (int g = 0; g < ngroups; g++){
+			d += partial_delta[g];
+			s += partial_skipped[g];
+		}
+		stats[0] = d;
+		stats[1] = s;
+	}
+}
+
+
+// Separation kernel. One work-item per cluster computes half the distance to
+// the nearest other centre; work-item 0 also finds the largest drift.
+__kernel
+void kmeans_separation(__global float  *restrict clusters,
+			  __global float  *restrict drift,
+			  __global float  *restrict separation,
+			  __global float  *restrict max_drift,
+				int     nclusters ) {
+
+	unsigned int cluster_id = get_global_id(0);
+
+	if (cluster_id < nclusters){
+
+		float center[NUM_FEATURE];
+		#pragma unroll
+		for (int l = 0; l < NUM_FEATURE; l++)
+			center[l] = clusters[cluster_id*NUM_FEATURE + l];
+
+		float min_dist = FLT_MAX;
+		for (int i = 0; i < nclusters; i++){
+			float ans = 0;
+			#pragma unroll
+			for (int l = 0; l < NUM_FEATURE; l++){
+				float sub_tmp = center[l] - clusters[i*NUM_FEATURE + l];
+				ans += sub_tmp * sub_tmp;
+			}
+			if (i != cluster_id && ans < min_dist)
+				min_dist = ans;
+		}
+		separation[cluster_id] = 0.5f * sqrt(min_dist);
+	}
+
+	if (cluster_id == 0){
+		float m = 0;
+		for (int i = 0; i < nclusters; i++)
+			m = fmax(m, drift[i]);
+		max_drift[0] = m;
+	}
+}
@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+#include "kmeans.h"
+#include "AOCLUtils/aocl_utils.h"
+
+#define AOCL_ALIGNMENT 64
+#include <malloc.h>
+
+static float dist_2(float *a, float *b, int nfeatures)
+{
+	float ans = 0;
+	for (int l = 0; l < nfeatures; l++) {
+		float sub_tmp = a[l] - b[l];
+		ans += sub_tmp * sub_tmp;
+	}
+	return ans;
+}
+
+/*----< kmeans_hamerly_cpu() >---------------------------------------------*/
+/* Sequential reference of the device algorithm: same seeding (the first
+   nclusters points), same bounds test and same stopping rule. With
+   prune == 0 it is plain Lloyd k-means. Returns the number of iterations. */
+int kmeans_hamerly_cpu(float **feature,    /* in: [npoints][nfeatures] */
+                       int     nfeatures,
+                       int     npoints,
+                       int     nclusters,
+                       float   threshold,
+                       int    *membership, /* out: [npoints] */
+                       float **clusters,   /* out: [nclusters][nfeatures] */
+                       int     prune)
+{
+	int      i, j, c = 0;
+	int      delta;
+	long     skipped, total_skipped = 0;
+	float   *upper      = (float*) _aligned_malloc(npoints * sizeof(float), AOCL_ALIGNMENT);
+	float   *lower      = (float*) _aligned_malloc(npoints * sizeof(float), AOCL_ALIGNMENT);
+	float   *separation = (float*) _aligned_malloc(nclusters * sizeof(float), AOCL_ALIGNMENT);
+	float   *drift      = (float*) calloc(nclusters, sizeof(float));
+	float   *sums       = (float*) _aligned_malloc(nclusters * nfeatures * sizeof(float), AOCL_ALIGNMENT);
+	int     *len        = (int*)   _aligned_malloc(nclusters * sizeof(int), AOCL_ALIGNMENT);
+	float    max_drift  = 0.0f;
+
+	for (i = 0; i < nclusters; i++)
+		memcpy(clusters[i], feature[i], nfeatures * sizeof(float));
+	for (i = 0; i < npoints; i++)
+		membership[i] = -1;
+
+	const double start_time = aocl_utils::getCurrentTimestamp();
+
+	do {
+		/* half distance from every centre to the nearest other one */
+		for (i = 0; i < nclusters; i++) {
+			float min_dist = FLT_MAX;
+			for (j = 0; j < nclusters; j++) {
+				float d = dist_2(clusters[i], clusters[j], nfeatures);
+				if (j != i && d < min_dist)
+					min_dist = d;
+			}
+			separation[i] = 0.5f * sqrtf(min_dist);
+		}
+
+		memset(sums, 0, nclusters * nfeatures * sizeof(float));
+		memset(len, 0, nclusters * sizeof(int));
+		delta   = 0;
+		skipped = 0;
+
+		for (i = 0; i < npoints; i++) {
+			int   index = membership[i];
+			int   scan  = 1;
+			float u     = upper[i];
+			float lo    = lower[i];
+
+			if (prune && index >= 0) {
+				u  += drift[index];
+				lo -= max_drift;
+				float m = fmaxf(separation[index], lo);
+				if (u <= m) {
+					scan = 0;
+					skipped += nclusters;
+				} else {
+					u = sqrtf(dist_2(feature[i], clusters[index], nfeatures));
+					if (u <= m) {
+						scan = 0;
+						skipped += nclusters - 1;
+					}
+				}
+			}
+
+			if (scan) {
+				float min_dist = FLT_MAX, second_dist = FLT_MAX;
+				int   old_index = index;
+				for (j = 0; j < nclusters; j++) {
+					float d = dist_2(feature[i], clusters[j], nfeatures);
+					if (d < min_dist) {
+						second_dist = min_dist;
+						min_dist    = d;
+						index       = j;
+					} else if (d < second_dist) {
+						second_dist = d;
+					}
+				}
+				u  = sqrtf(min_dist);
+				lo = sqrtf(second_dist);
+				if (index != old_index)
+					delta++;
+			}
+
+			membership[i] = index;
+			upper[i]      = u;
+			lower[i]      = lo;
+			len[index]++;
+			for (j = 0; j < nfeatures; j++)
+				sums[index * nfeatures + j] += feature[i][j];
+		}
+
+		/* new centres and how far each one moved */
+		max_drift = 0.0f;
+		for (i = 0; i < nclusters; i++) {
+			float moved = 0.0f;
+			if (len[i] > 0) {
+				for (j = 0; j < nfeatures; j++) {
+					float center  = sums[i * nfeatures + j] / len[i];
+					float sub_tmp = center - clusters[i][j];
+					moved += sub_tmp * sub_tmp;
+					clusters[i][j] = center;
+				}
+			}
+			drift[i]  = sqrtf(moved);
+			max_drift = fmaxf(max_drift, drift[i]);
+		}
+
+		printf("cpu iteration %3d: %6d points moved, %10ld of %ld distances skipped (%5.1f%%)\n",
+			c, delta, skipped, (long) npoints * nclusters, 100.0 * skipped / ((double) npoints * nclusters));
+		total_skipped += skipped;
+		c++;
+	} while ((delta > threshold) && (c <= 500));	/* makes sure loop terminates */
+
+	printf("cpu %s: iterated %d times, %ld distances skipped\n", prune ? "hamerly" : "lloyd", c, total_skipped);
+	printf("cpu Time to convergence (ms): %0.3f\n", (aocl_utils::getCurrentTimestamp() - start_time) * 1e3);
+
+	_aligned_free(upper);
+	_aligned_free(lower);
+	_aligned_free(separation);
+	free(drift);
+	_aligned_free(sums);
+	_aligned_free(len);
+	return c;
+}
@@ -0,0 +1,395 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <iostream>
+#include <string>
+#include "kmeans.h"
+#include "timer.h"
+
+#include <windows.h>
+
+#define AOCL_ALIGNMENT 64
+#include <malloc.h>
+
+#ifndef FLT_MAX
+#define FLT_MAX 3.40282347e+38
+#endif
+#ifdef RD_WG_SIZE_0_0
+        #define BLOCK_SIZE RD_WG_SIZE_0_0
+#elif defined(RD_WG_SIZE_0)
+        #define BLOCK_SIZE RD_WG_SIZE_0
+#elif defined(RD_WG_SIZE)
+        #define BLOCK_SIZE RD_WG_SIZE
+#else
+        #define BLOCK_SIZE 256
+#endif
+#ifdef RD_WG_SIZE_1_0
+     #define BLOCK_SIZE2 RD_WG_SIZE_1_0
+#elif defined(RD_WG_SIZE_1)
+     #define BLOCK_SIZE2 RD_WG_SIZE_1
+#elif defined(RD_WG_SIZE)
+     #define BLOCK_SIZE2 RD_WG_SIZE
+#else
+     #define BLOCK_SIZE2 256
+#endif
+
+#include <CL/cl.h>
+#include <fstream>
+#include <iostream>
+
+#include "CL/opencl.h"
+#include "AOCLUtils/aocl_utils.h"
+
+using namespace aocl_utils;
+
+// Allocation error checking
+#define ERR_1(v1)                                                                                                      \
+    if(v1 == NULL) {                                                                                                   \
+        fprintf(stderr, "Allocation error at %s, %d\n", __FILE__, __LINE__);                                           \
+        exit(-1);                                                                                                      \
+    }
+#define ERR_2(v1,v2) ERR_1(v1) ERR_1(v2)
+#define ERR_3(v1,v2,v3) ERR_2(v1,v2) ERR_1(v3)
+#define ERR_4(v1,v2,v3,v4) ERR_3(v1,v2,v3) ERR_1(v4)
+#define ERR_5(v1,v2,v3,v4,v5) ERR_4(v1,v2,v3,v4) ERR_1(v5)
+#define ERR_6(v1,v2,v3,v4,v5,v6) ERR_5(v1,v2,v3,v4,v5) ERR_1(v6)
+#define GET_ERR_MACRO(_1,_2,_3,_4,_5,_6,NAME,...) NAME
+#define ALLOC_ERR(...) GET_ERR_MACRO(__VA_ARGS__,ERR_6,ERR_5,ERR_4,ERR_3,ERR_2,ERR_1)(__VA_ARGS__)
+
+#define CL_ERR()                                                                                                       \
+    if(clStatus != CL_SUCCESS) {                                                                                       \
+        fprintf(stderr, "OpenCL error: %d\n at %s, %d\n", clStatus, __FILE__, __LINE__);                               \
+        exit(-1);                                                                                                      \
+    }
+
+
+
+// local variables
+static cl_context	    clContext;
+static cl_command_queue clCommandQueue;
+static cl_program       clProgram;
+static cl_kernel        clKernel;
+static cl_kernel        clKernelReduce;
+static cl_kernel        clKernelSeparation;
+static cl_device_id		clDeviceID;
+
+Timer timer;
+
+static int shutdown()
+{
+	// release resources
+	if( clKernel ) clReleaseKernel( clKernel );
+	if( clKernelReduce ) clReleaseKernel( clKernelReduce );
+	if( clKernelSeparation ) clReleaseKernel( clKernelSeparation );
+	if( clProgram ) clReleaseProgram( clProgram );
+	if( clCommandQueue ) clReleaseCommandQueue( clCommandQueue );
+	if( clContext ) clReleaseContext( clContext );
+	// reset all variables
+	clCommandQueue = 0;
+	clContext = 0;
+	return 0;
+}
+
+
+cl_mem d_feature;
+cl_mem d_cluster;
+cl_mem d_membership;
+cl_mem d_partial_centers;
+cl_mem d_partial_len;
+cl_mem d_partial_delta;
+cl_mem d_partial_skipped;
+cl_mem d_stats;
+cl_mem d_upper;
+cl_mem d_lower;
+cl_mem d_separation;
+cl_mem d_drift;
+cl_mem d_max_drift;
+
+// Work-group size of kmeans_kernel_c, must match WG_SIZE in hamerly.cl
+#define WG_SIZE 128
+static int n_groups;
+
+extern int check_output;
+
+float *feature_swap;
+int   *membership_OCL;
+int   *membership_d;
+float *feature_d;
+float *clusters_d;
+float *center_d;
+
+
+int allocate(int n_points, int n_features, int n_clusters, float **feature)
+{
+	cl_int  clStatus;
+
+
+	// Get the OpenCL platform.
+	cl_platform_id clPlatform = NULL;
+	clPlatform = findPlatform("Intel(R) FPGA");
+	if(clPlatform == NULL) {
+		printf("ERROR: Unable to find Intel(R) FPGA OpenCL platform.\n");
+	}
+
+
+	// Query the available OpenCL device.
+    cl_uint clNumDevices;
+    clStatus = clGetDeviceIDs(clPlatform, CL_DEVICE_TYPE_ALL, 0, NULL, &clNumDevices);
+    CL_ERR();
+    cl_device_id *clDevices = new cl_device_id[clNumDevices];
+    clStatus                = clGetDeviceIDs(clPlatform, CL_DEVICE_TYPE_ALL, clNumDevices, clDevices, NULL);
+    CL_ERR();
+
+	printf("Platform: %s\n",getPlatformName(clPlatform).c_str());
+	printf("Using %d device(s)\n",clNumDevices);
+	for(unsigned i = 0; i < clNumDevices; ++i) {
+		printf("  %s\n", getDeviceName(clDevices[i]).c_str());
+	}
+
+
+	// Create the context.
+	clContext = clCreateContext(NULL, clNumDevices, clDevices, &oclContextCallback, NULL, &clStatus);
+    CL_ERR();
+    char device_name_[100];
+    clGetDeviceInfo(clDevices[0], CL_DEVICE_NAME, 100, &device_name_, NULL);
+    clDeviceID = clDevices[0];
+    fprintf(stderr, "%s\t", device_name_);
+	
+	
+	// create command queue for the first device
+	clCommandQueue = clCreateCommandQueue( clContext, clDevices[0], 0, &clStatus );
+	CL_ERR();
+
+
+	// Create the program.
+	std::string binary_file = getBoardBinaryFile("hamerly", clDeviceID);
+	printf("\nUsing AOCX:%s\n",binary_file.c_str());
+	clProgram = createProgramFromBinary(clContext, binary_file.c_str(), &clDeviceID, 1);	
+	CL_ERR();
+
+
+    char clOptions[50];
+    sprintf(clOptions, "-I.");
+
+	// Build the program that was just created.
+    clStatus = clBuildProgram(clProgram, 0, NULL, "", NULL, NULL);  
+    if(clStatus == CL_BUILD_PROGRAM_FAILURE) {
+        // Determine the size of the log
+        size_t log_size;
+        clGetProgramBuildInfo(clProgram, clDevices[0], CL_PROGRAM_BUILD_LOG, 0, NULL, &log_size);
+        // Allocate memory for the log
+        char *log = (char *)malloc(log_size);
+        // Get the log
+        clGetProgramBuildInfo(clProgram, clDevices[0], CL_PROGRAM_BUILD_LOG, log_size, log, NULL);
+        // Print the log
+        fprintf(stderr, "%s\t", log);
+    }
+    CL_ERR();
+
+
+	// Kernel.
+    clKernel  = clCreateKernel(clProgram, "kmeans_kernel_c", &clStatus);
+    CL_ERR();
+    clKernelReduce = clCreateKernel(clProgram, "kmeans_reduce", &clStatus);
+    CL_ERR();
+    clKernelSeparation = clCreateKernel(clProgram, "kmeans_separation", &clStatus);
+    CL_ERR();
+
+	if(n_clusters > WG_SIZE) {
+		printf("Error: nclusters(%d) > work-group size(%d) -- cannot proceed\n", n_clusters, WG_SIZE);
+		exit(0);
+	}
+	n_groups = (n_points + WG_SIZE - 1) / WG_SIZE;
+
+
+	d_feature = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_points * n_features * sizeof(float), NULL, 0 );
+	d_cluster = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_clusters * n_features  * sizeof(float), NULL, 0 );
+	d_membership = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_points * sizeof(int), NULL, 0 );
+
+	// Per-group partial results are laid out with the compile-time stride NUM_CLUSTERS of the kernel
+	d_partial_centers = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_groups * WG_SIZE * n_features * sizeof(float), NULL, 0 );
+	d_partial_len     = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_groups * WG_SIZE * sizeof(int), NULL, 0 );
+	d_partial_delta   = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_groups * sizeof(int), NULL, 0 );
+	d_partial_skipped = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_groups * sizeof(int), NULL, 0 );
+	d_stats           = clCreateBuffer(clContext, CL_MEM_READ_WRITE, 2 * sizeof(int), NULL, 0 );
+
+	// Hamerly bounds: per point, and per centre
+	d_upper      = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_points * sizeof(float), NULL, 0 );
+	d_lower      = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_points * sizeof(float), NULL, 0 );
+	d_separation = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_clusters * sizeof(float), NULL, 0 );
+	d_drift      = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_clusters * sizeof(float), NULL, 0 );
+	d_max_drift  = clCreateBuffer(clContext, CL_MEM_READ_WRITE, sizeof(float), NULL, 0 );
+	
+	
+	feature_swap = (float*) _aligned_malloc (n_points * n_features * sizeof(float), AOCL_ALIGNMENT);
+	for(int j = 0; j < n_points; j ++){
+		for(int i = 0; i < n_features; i ++){
+			feature_swap[i * n_points + j] = feature[j][i];
+		}
+	}
+	
+
+
+	//write buffers
+	//clStatus = clEnqueueWriteBuffer(clCommandQueue, d_feature, 1, 0, n_points * n_features * sizeof(float), feature_swap, 0, 0, 0);
+	clStatus = clEnqueueWriteBuffer(clCommandQueue, d_feature, 1, 0, n_points * n_features * sizeof(float), feature[0], 0, 0, 0);
+	CL_ERR();
+
+	membership_OCL = (int*) _aligned_malloc(n_points * sizeof(int), AOCL_ALIGNMENT);
+}
+
+
+void deallocateMemory()
+{
+	clReleaseMemObject(d_feature);
+	clReleaseMemObject(d_cluster);
+	clReleaseMemObject(d_membership);
+	clReleaseMemObject(d_partial_centers);
+	clReleaseMemObject(d_partial_len);
+	clReleaseMemObject(d_partial_delta);
+	clReleaseMemObject(d_partial_skipped);
+	clReleaseMemObject(d_stats);
+	clReleaseMemObject(d_upper);
+	clReleaseMemObject(d_lower);
+	clReleaseMemObject(d_separation);
+	clReleaseMemObject(d_drift);
+	clReleaseMemObject(d_max_drift);
+	_aligned_free(feature_swap);
+	_aligned_free(membership_OCL);
+}
+
+
+int main( int argc, char** argv) 
+{
+	setup(argc, argv);
+	shutdown();
+}
+
+
+/* Separation of the current centres and largest drift, needed by the
+   bounds test of the next assignment. */
+static void kmeansSeparation(int n_clusters)
+{
+	cl_int  clStatus;
+
+	clSetKernelArg(clKernelSeparation, 0, sizeof(void *), (void*) &d_cluster);
+	clSetKernelArg(clKernelSeparation, 1, sizeof(void *), (void*) &d_drift);
+	clSetKernelArg(clKernelSeparation, 2, sizeof(void *), (void*) &d_separation);
+	clSetKernelArg(clKernelSeparation, 3, sizeof(void *), (void*) &d_max_drift);
+	clSetKernelArg(clKernelSeparation, 4, sizeof(cl_int), (void*) &n_clusters);
+
+	size_t gs[1] = {(size_t)WG_SIZE};
+	size_t ls[1] = {(size_t)WG_SIZE};
+
+	clStatus = clEnqueueNDRangeKernel(clCommandQueue, clKernelSeparation, 1, NULL, gs, ls, 0, 0, 0);
+	CL_ERR();
+}
+
+
+int	kmeansOCL(int     n_features,
+           int     n_points,
+           int     n_clusters,
+           int    *membership,
+		   float **clusters,		/* in/out: [nclusters][nfeatures] */
+		   int     iteration,
+		   int     prune,			/* skip distance scans proven unnecessary by the bounds */
+		   int    *skipped,			/* out: distance computations skipped in this iteration */
+		   float   *time)			/* out: kernel time in ms */
+{ 
+	int stats[2];
+	cl_int  clStatus;
+
+	/* centres, bounds and membership stay resident on the device between iterations */
+	if (iteration == 0) {
+		clStatus = clEnqueueWriteBuffer(clCommandQueue, d_cluster, 1, 0, n_clusters * n_features * sizeof(float), clusters[0], 0, 0, 0);
+		CL_ERR();
+		clStatus = clEnqueueWriteBuffer(clCommandQueue, d_membership, 1, 0, n_points * sizeof(int), membership, 0, 0, 0);
+		CL_ERR();
+
+		/* no drift yet; the first assignment scans every point since membership is -1 */
+		float *zero = (float*) calloc(n_clusters, sizeof(float));
+		clStatus = clEnqueueWriteBuffer(clCommandQueue, d_drift, 1, 0, n_clusters * sizeof(float), zero, 0, 0, 0);
+		CL_ERR();
+		kmeansSeparation(n_clusters);
+		clFinish(clCommandQueue);
+		free(zero);
+	}
+	
+	
+	timer.start("Kernel");
+					
+	clSetKernelArg(clKernel, 0, sizeof(void *), (void*) &d_feature);
+	clSetKernelArg(clKernel, 1, sizeof(void *), (void*) &d_cluster);
+	clSetKernelArg(clKernel, 2, sizeof(void *), (void*) &d_membership);
+	clSetKernelArg(clKernel, 3, sizeof(void *), (void*) &d_upper);
+	clSetKernelArg(clKernel, 4, sizeof(void *), (void*) &d_lower);
+	clSetKernelArg(clKernel, 5, sizeof(void *), (void*) &d_separation);
+	clSetKernelArg(clKernel, 6, sizeof(void *), (void*) &d_drift);
+	clSetKernelArg(clKernel, 7, sizeof(void *), (void*) &d_max_drift);
+	clSetKernelArg(clKernel, 8, sizeof(void *), (void*) &d_partial_centers);
+	clSetKernelArg(clKernel, 9, sizeof(void *), (void*) &d_partial_len);
+	clSetKernelArg(clKernel, 10, sizeof(void *), (void*) &d_partial_delta);
+	clSetKernelArg(clKernel, 11, sizeof(void *), (void*) &d_partial_skipped);
+	clSetKernelArg(clKernel, 12, sizeof(cl_int), (void*) &n_points);
+	clSetKernelArg(clKernel, 13, sizeof(cl_int), (void*) &n_clusters);
+	clSetKernelArg(clKernel, 14, sizeof(cl_int), (void*) &n_features);
+	clSetKernelArg(clKernel, 15, sizeof(cl_int), (void*) &prune);
+
+	size_t gs[1] = {(size_t)n_groups * WG_SIZE}; 
+	size_t ls[1] = {(size_t)WG_SIZE}; 
+
+	clStatus = clEnqueueNDRangeKernel(clCommandQueue, clKernel, 1, NULL, gs, ls, 0, 0, 0);
+	CL_ERR();
+
+	clSetKernelArg(clKernelReduce, 0, sizeof(void *), (void*) &d_partial_centers);
+	clSetKernelArg(clKernelReduce, 1, sizeof(void *), (void*) &d_partial_len);
+	clSetKernelArg(clKernelReduce, 2, sizeof(void *), (void*) &d_partial_delta);
+	clSetKernelArg(clKernelReduce, 3, sizeof(void *), (void*) &d_partial_skipped);
+	clSetKernelArg(clKernelReduce, 4, sizeof(void *), (void*) &d_cluster);
+	clSetKernelArg(clKernelReduce, 5, sizeof(void *), (void*) &d_drift);
+	clSetKernelArg(clKernelReduce, 6, sizeof(void *), (void*) &d_stats);
+	clSetKernelArg(clKernelReduce, 7, sizeof(cl_int), (void*) &n_groups);
+	clSetKernelArg(clKernelReduce, 8, sizeof(cl_int), (void*) &n_clusters);
+
+	size_t gs_reduce[1] = {(size_t)WG_SIZE};
+	size_t ls_reduce[1] = {(size_t)WG_SIZE};
+
+	clStatus = clEnqueueNDRangeKernel(clCommandQueue, clKernelReduce, 1, NULL, gs_reduce, ls_reduce, 0, 0, 0);
+	CL_ERR();
+
+	kmeansSeparation(n_clusters);
+	clFinish(clCommandQueue);
+
+	timer.stop("Kernel");
+	time[0] = timer.getTime("Kernel");
+
+
+	/* only the new centres and the counters come back every iteration */
+	clStatus = clEnqueueReadBuffer(clCommandQueue, d_cluster, 1, 0, n_clusters * n_features * sizeof(float), clusters[0], 0, 0, 0);
+	CL_ERR();
+	clStatus = clEnqueueReadBuffer(clCommandQueue, d_stats, 1, 0, 2 * sizeof(int), stats, 0, 0, 0);
+	CL_ERR();
+	skipped[0] = stats[1];
+
+
+	if(stats[0] == 0){
+		clStatus = clEnqueueReadBuffer(clCommandQueue, d_membership, 1, 0, n_points * sizeof(int), membership, 0, 0, 0);
+		CL_ERR();
+
+		if(check_output){
+			int temp;
+			FILE *fp = fopen("output/output.txt", "r");
+			for(int i = 0; i < n_points; i++){
+				fscanf(fp, "%d", &temp);
+				if(membership[i] != temp){
+					printf("failed!!\n");
+					break;
+				}
+			}
+			printf("pass!!\n");
+		}
+	}
+
+	return stats[0];
+}
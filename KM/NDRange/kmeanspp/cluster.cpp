@@ -0,0 +1,69 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <float.h>
+#include <omp.h>
+#include "kmeans.h"
+
+#define AOCL_ALIGNMENT 64
+#include <malloc.h>
+
+float	min_rmse_ref = FLT_MAX;		
+extern double wtime(void);
+	/* reference min_rmse value */
+
+/*---< cluster() >-----------------------------------------------------------*/
+void cluster(int      npoints,				/* number of data points */
+            int      nfeatures,				/* number of attributes for each point */
+            float  **features,				/* array: [npoints][nfeatures] */                  
+            int      nclusters,				/* range of min to max number of clusters */
+            float    threshold,				/* loop terminating factor */
+            float ***cluster_centres,		/* out: [best_nclusters][nfeatures] */
+			int		 nloops					/* number of iteration for each number of clusters */
+			)
+{    
+	int		index =0;						/* number of iteration to reach the best RMSE */
+	int		rmse;							/* RMSE for each clustering */
+    int    *membership;						/* which cluster a data point belongs to */
+    float **tmp_cluster_centres;			/* hold coordinates of cluster centers */
+	int		i, seeding;
+	float	stats[3][5];					/* per seeding mode, see kmeans_clustering() */
+	
+	/* allocate memory for membership */
+	membership = (int*) _aligned_malloc(npoints * sizeof(int), AOCL_ALIGNMENT);
+
+	/* allocate device memory, invert data array */
+	allocate(npoints, nfeatures, nclusters, features);
+
+	/* iterate nloops times for each number of clusters */
+	for(i = 0; i < nloops; i++)
+	{
+		for(seeding = SEED_FIRST_K; seeding <= SEED_KMEANS_PARALLEL; seeding++)
+		{
+			printf("\n================= %s =================\n", seed_name[seeding]);
+			tmp_cluster_centres = kmeans_clustering(features,
+													nfeatures,
+													npoints,
+													nclusters,
+													threshold,
+													membership,
+													seeding,
+													stats[seeding]);
+			if (*cluster_centres) {
+				_aligned_free((*cluster_centres)[0]);
+				_aligned_free(*cluster_centres);
+			}
+			*cluster_centres = tmp_cluster_centres;
+		}
+	}		
+	deallocateMemory();						/* free device memory (@ kmeans_cuda.cu) */
+
+	printf("\n%-10s %10s %12s %12s %14s %14s\n", "seeding", "iterations", "seeding ms", "total ms", "seed cost", "final cost");
+	for(seeding = SEED_FIRST_K; seeding <= SEED_KMEANS_PARALLEL; seeding++)
+		printf("%-10s %10d %12.3f %12.3f %14.6g %14.6g\n", seed_name[seeding], (int) stats[seeding][0],
+			stats[seeding][1], stats[seeding][2], stats[seeding][3], stats[seeding][4]);
+	
+    _aligned_free(membership);
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef _H_FUZZY_KMEANS
+#define _H_FUZZY_KMEANS
+
+#ifndef FLT_MAX
+#define FLT_MAX 3.40282347e+38
+#endif
+
+/* rmse.c */
+float   euclid_dist_2        (float*, float*, int);
+int     find_nearest_point   (float* , int, float**, int);
+float	rms_err(float**, int, int, float**, int);
+void    cluster(int, int, float**, int, float, float***, int);
+int setup(int argc, char** argv);
+int allocate(int npoints, int nfeatures, int nclusters, float **feature);
+void deallocateMemory();
+int	kmeansOCL(int nfeatures, int npoints, int nclusters, int *membership, float **clusters, int iteration, float* time);
+float** kmeans_clustering(float **feature, int nfeatures, int npoints, int nclusters, float threshold, int *membership, int seeding, float *stats);
+
+/* seeding.cpp */
+#define SEED_FIRST_K        0	/* the first nclusters points, as output/output.txt */
+#define SEED_KMEANSPP       1	/* k-means++ */
+#define SEED_KMEANS_PARALLEL 2	/* k-means|| */
+extern const char *seed_name[];
+float   seed_centres(float **feature, int nfeatures, int npoints, int nclusters, int seeding, float **clusters);
+float   centres_cost(int nfeatures, int npoints, int nclusters, float **clusters);
+
+/* kmeans.cpp, seeding on the device */
+int     seedGroupsOCL();
+void    seedResetOCL(int npoints);
+void    seedUpdateOCL(float *seeds, int nseeds, int offset, int npoints, int nfeatures, float *partial_cost);
+int     seedGroupDistOCL(int group, int npoints, float *min_dist, int *first);
+void    seedDistOCL(int npoints, float *min_dist);
+void    seedNearestOCL(int npoints, int *nearest);
+
+#endif
+
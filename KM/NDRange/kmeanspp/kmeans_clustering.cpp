@@ -0,0 +1,100 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <float.h>
+#include <math.h>
+#include <omp.h>
+#include "kmeans.h"
+#define RANDOM_MAX 2147483647
+
+#define AOCL_ALIGNMENT 64
+#include <malloc.h>
+
+#include "AOCLUtils/aocl_utils.h"
+
+extern int check_output;
+
+/*----< kmeans_clustering() >---------------------------------------------*/
+float** kmeans_clustering(float **feature,    /* in: [npoints][nfeatures] */
+                          int     nfeatures,
+                          int     npoints,
+                          int     nclusters,
+                          float   threshold,
+                          int    *membership, /* out: [npoints] */
+                          int     seeding,    /* SEED_FIRST_K, SEED_KMEANSPP or SEED_KMEANS_PARALLEL */
+                          float  *stats)      /* out: [iterations, seeding ms, total ms, seed cost, final cost] */
+{    
+    int      i;
+	int		 loop=0;
+    float    delta;				/* if the point moved */
+    float  **clusters;			/* out: [nclusters][nfeatures] */
+	int		 c = 0;
+	float	 *time;
+	float	 total_time, total_reduce_time;
+	float	 seed_cost;
+	int		 check_saved = check_output;
+
+	/* nclusters should never be > npoints
+	   that would guarantee a cluster without points */
+	if (nclusters > npoints)
+		nclusters = npoints;
+    /* allocate space for and initialize returning variable clusters[] */
+	clusters    = (float**) _aligned_malloc(nclusters *             sizeof(float*), AOCL_ALIGNMENT);
+	clusters[0] = (float*)  _aligned_malloc(nclusters * nfeatures * sizeof(float), AOCL_ALIGNMENT);
+    for (i=1; i<nclusters; i++)
+        clusters[i] = clusters[i-1] + nfeatures;
+
+	const double start_time = aocl_utils::getCurrentTimestamp();
+
+	/* pick the initial cluster centers */
+	seed_cost = seed_centres(feature, nfeatures, npoints, nclusters, seeding, clusters);
+
+	const double seed_time = aocl_utils::getCurrentTimestamp();
+
+	/* initialize the membership to -1 for all */
+    for (i=0; i < npoints; i++)
+	  membership[i] = -1;
+
+	/* output/output.txt only holds the result of the first-k seeds */
+	if (seeding != SEED_FIRST_K)
+		check_output = 0;
+
+	time			= (float*) calloc (2, sizeof(float));
+
+	total_time = 0.0;
+	total_reduce_time = 0.0;
+
+	/* iterate until convergence */
+	do {
+        delta	   = 0.0;
+		// CUDA
+		delta = (float) kmeansOCL(nfeatures,		/* number of attributes for each point */
+								   npoints,			/* number of data points */
+								   nclusters,		/* number of clusters */
+								   membership,		/* which cluster the point belongs to */
+								   clusters,		/* in/out: [nclusters][nfeatures] */
+								   c,				/* iteration number */
+								   time);
+
+		total_time += time[0];
+		total_reduce_time += time[1];
+		c++;
+    } while ((delta > threshold) && (loop++ < 500));	/* makes sure loop terminates */
+
+	const double end_time = aocl_utils::getCurrentTimestamp();
+	check_output = check_saved;
+
+	stats[0] = (float) c;
+	stats[1] = (float) ((seed_time - start_time) * 1e3);
+	stats[2] = (float) ((end_time - start_time) * 1e3);
+	stats[3] = seed_cost;
+	stats[4] = centres_cost(nfeatures, npoints, nclusters, clusters);
+
+	printf("%s seeding: cost %.6g in %0.3f ms\n", seed_name[seeding], seed_cost, stats[1]);
+	printf("iterated %d times\n", c);
+	printf("Kernel Time (ms): %0.3f\n", total_time / c);
+	printf("Device Reduction Time (ms): %0.3f\n", total_reduce_time / c);
+	printf("Time to convergence, seeding included (ms): %0.3f\n", stats[2]);
+	printf("Final cost: %.6g\n", stats[4]);
+    free(time);
+    return clusters;
+}
@@ -0,0 +1,134 @@
+#define _CRT_SECURE_NO_DEPRECATE 1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <fcntl.h>
+#include <omp.h>
+#include "kmeans.h"
+#include <unistd.h>
+#include <time.h>
+
+#define AOCL_ALIGNMENT 64
+#include <malloc.h>
+
+extern double wtime(void);
+
+int		check_output = 1;		/* output/output.txt only holds the result for input/input.txt */
+
+
+/* Synthetic input: nclusters Gaussian blobs in the value range of input.txt */
+static void synthetic_input(float *buf, int npoints, int nfeatures, int nclusters)
+{
+	float *centres = (float*) malloc(nclusters * nfeatures * sizeof(float));
+	srand(1);
+	for (int i = 0; i < nclusters * nfeatures; i++)
+		centres[i] = 1024.0f * rand() / RAND_MAX;
+	for (int i = 0; i < npoints; i++) {
+		int c = rand() % nclusters;
+		for (int j = 0; j < nfeatures; j++) {
+			/* Box-Muller, sigma = 16 */
+			float u1 = (rand() + 1.0f) / (RAND_MAX + 2.0f);
+			float u2 = (rand() + 1.0f) / (RAND_MAX + 2.0f);
+			buf[i * nfeatures + j] = centres[c * nfeatures + j] + 16.0f * sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+		}
+	}
+	free(centres);
+}
+
+
+/*---< main() >-------------------------------------------------------------*/
+int setup(int argc, char **argv) {
+
+		char   *filename = "input/input.txt";	
+		float  *buf;
+		char	line[1024];
+		float	threshold = 0.001;		
+		int		nclusters=128;					// 128 clusters
+		int		nfeatures = 8;					// 8 features
+		int		npoints = 25600;				// 25600 points
+		float	len;		         
+		float **features;
+		float **cluster_centres=NULL;
+		int		nloops = 1;					
+		int		isOutput = 0;
+
+	/* host <npoints> clusters a synthetic data set instead of input/input.txt */
+	if (argc > 1) {
+		npoints      = atoi(argv[1]);
+		check_output = 0;
+	}
+
+
+
+    /* allocate space for features[] and read attributes of all objects */
+	buf         = (float*) _aligned_malloc(npoints*nfeatures*sizeof(float), AOCL_ALIGNMENT);
+	features    = (float**)_aligned_malloc(npoints*          sizeof(float*), AOCL_ALIGNMENT);
+	features[0] = (float*) _aligned_malloc(npoints*nfeatures*sizeof(float), AOCL_ALIGNMENT);
+    for (int i=1; i<npoints; i++)
+        features[i] = features[i-1] + nfeatures;
+    
+
+
+	if (check_output) {
+		float temp;
+		FILE *fp = fopen(filename, "r");
+		for(int i = 0; i < npoints * nfeatures; i++){
+			fscanf(fp, "%f", &temp);
+			buf[i] = temp;
+		}
+	} else {
+		synthetic_input(buf, npoints, nfeatures, nclusters);
+	}
+
+	printf("\nI/O completed\n");
+	printf("\nNumber of objects: %d\n", npoints);
+	printf("Number of features: %d\n", nfeatures);	
+
+	/* ============== I/O end ==============*/
+	// error check for clusters
+	if (npoints < nclusters)
+	{
+		printf("Error: nclusters(%d) > npoints(%d) -- cannot proceed\n", nclusters, npoints);
+		exit(0);
+	}
+
+	memcpy(features[0], buf, npoints*nfeatures*sizeof(float)); /* now features holds 2-dimensional array of features */
+	_aligned_free(buf);
+
+
+	/* ======================= core of the clustering ===================*/
+
+	cluster_centres = NULL;
+    cluster(npoints,				/* number of data points */
+			nfeatures,				/* number of features for each point */
+			features,				/* array: [npoints][nfeatures] */
+			nclusters,				/* range of min to max number of clusters */
+			threshold,				/* loop termination factor */
+			&cluster_centres,		/* return: [best_nclusters][nfeatures] */  
+			nloops);				/* number of iteration for each number of clusters */		   
+
+
+	/* =============== Command Line Output =============== */
+
+	/* cluster center coordinates:displayed only for when k=1*/
+	if(isOutput == 1) {
+		printf("\n================= Centroid Coordinates =================\n");
+		for(int i = 0; i < nclusters; i++){
+			printf("%d:", i);
+			for(int j = 0; j < nfeatures; j++){
+				printf(" %.2f", cluster_centres[i][j]);
+			}
+			printf("\n\n");
+		}
+	}	
+
+	
+
+	/* free up memory */
+	_aligned_free(features[0]);
+	_aligned_free(features);    
+    return(0);
+}
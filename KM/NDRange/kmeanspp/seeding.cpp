@@ -0,0 +1,220 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+#include "kmeans.h"
+
+#define AOCL_ALIGNMENT 64
+#include <malloc.h>
+
+#define PARALLEL_ROUNDS     5	/* k-means|| sampling rounds */
+#define PARALLEL_OVERSAMPLE 2	/* k-means|| expects this many times nclusters candidates per round */
+
+const char *seed_name[] = { "first-k", "k-means++", "k-means||" };
+
+/* xorshift64*, rand() only has 15 bits on MSVC */
+static unsigned long long rng_state = 88172645463325252ULL;
+
+static double rng_uniform()
+{
+	rng_state ^= rng_state >> 12;
+	rng_state ^= rng_state << 25;
+	rng_state ^= rng_state >> 27;
+	return (double) ((rng_state * 2685821657736338717ULL) >> 11) / 9007199254740992.0;	/* [0, 1) */
+}
+
+static float sum_cost(float *partial_cost, int ngroups)
+{
+	double cost = 0;
+	for (int g = 0; g < ngroups; g++)
+		cost += partial_cost[g];
+	return (float) cost;
+}
+
+/* Index i with probability w[i] / sum(w), or -1 if all weights are zero */
+static int sample_weighted(float *w, int n)
+{
+	double total = 0;
+	for (int i = 0; i < n; i++)
+		total += w[i];
+	if (total <= 0)
+		return -1;
+
+	double r = rng_uniform() * total;
+	int    last = -1;
+	for (int i = 0; i < n; i++) {
+		if (w[i] <= 0)
+			continue;
+		last = i;
+		r -= w[i];
+		if (r < 0)
+			break;
+	}
+	return last;	/* rounding can leave r >= 0 after the last non-zero weight */
+}
+
+/* k-means++: every new seed is drawn with probability proportional to the
+   squared distance to the nearest seed so far. The device keeps those
+   distances and their per-group sums; the host draws a work-group from the
+   sums and reads back only that group's distances to draw the point. */
+static void seed_kmeanspp(float **feature, int nfeatures, int npoints, int nclusters, float **clusters, float *partial_cost)
+{
+	int    ngroups = seedGroupsOCL();
+	float *dist    = (float*) _aligned_malloc(npoints * sizeof(float), AOCL_ALIGNMENT);
+
+	int p = (int) (rng_uniform() * npoints);
+	memcpy(clusters[0], feature[p], nfeatures * sizeof(float));
+	seedResetOCL(npoints);
+	seedUpdateOCL(clusters[0], 1, 0, npoints, nfeatures, partial_cost);
+
+	for (int i = 1; i < nclusters; i++) {
+		int g = sample_weighted(partial_cost, ngroups);
+		if (g < 0) {
+			/* every point sits on a seed already */
+			p = (int) (rng_uniform() * npoints);
+		} else {
+			int first;
+			int count = seedGroupDistOCL(g, npoints, dist, &first);
+			int j     = sample_weighted(dist, count);
+			p = first + (j < 0 ? 0 : j);
+		}
+		memcpy(clusters[i], feature[p], nfeatures * sizeof(float));
+		seedUpdateOCL(clusters[i], 1, i, npoints, nfeatures, partial_cost);
+	}
+
+	_aligned_free(dist);
+}
+
+/* k-means|| (Bahmani et al.): a few rounds each add about
+   PARALLEL_OVERSAMPLE * nclusters candidates, every point independently with
+   probability proportional to its distance, so one device pass per round
+   replaces one pass per centre. The candidates are weighted by the number of
+   points nearest to them and reduced to nclusters with weighted k-means++
+   on the host. */
+static void seed_parallel(float **feature, int nfeatures, int npoints, int nclusters, float **clusters, float *partial_cost)
+{
+	int    ngroups  = seedGroupsOCL();
+	/* room for twice the expected number of candidates plus a uniform top-up */
+	int    max_cand = 1 + 2 * PARALLEL_ROUNDS * PARALLEL_OVERSAMPLE * nclusters + nclusters;
+	int    ncand    = 0;
+	int   *cand     = (int*)   _aligned_malloc(max_cand * sizeof(int), AOCL_ALIGNMENT);
+	float *cand_f   = (float*) _aligned_malloc(max_cand * nfeatures * sizeof(float), AOCL_ALIGNMENT);
+	float *weight   = (float*) calloc(max_cand, sizeof(float));
+	float *dist     = (float*) _aligned_malloc(npoints * sizeof(float), AOCL_ALIGNMENT);
+	int   *nearest  = (int*)   _aligned_malloc(npoints * sizeof(int), AOCL_ALIGNMENT);
+	float *best     = (float*) _aligned_malloc(max_cand * sizeof(float), AOCL_ALIGNMENT);
+	int    i, j, l, c, r;
+
+	cand[ncand++] = (int) (rng_uniform() * npoints);
+	memcpy(cand_f, feature[cand[0]], nfeatures * sizeof(float));
+	seedResetOCL(npoints);
+	seedUpdateOCL(cand_f, 1, 0, npoints, nfeatures, partial_cost);
+
+	for (r = 0; r < PARALLEL_ROUNDS; r++) {
+		float  cost  = sum_cost(partial_cost, ngroups);
+		int    first = ncand;
+
+		if (cost <= 0)
+			break;
+		double scale = (double) PARALLEL_OVERSAMPLE * nclusters / cost;
+		seedDistOCL(npoints, dist);
+		for (i = 0; i < npoints && ncand < max_cand - nclusters; i++) {
+			if (dist[i] > 0 && rng_uniform() < scale * dist[i]) {
+				memcpy(cand_f + ncand * nfeatures, feature[i], nfeatures * sizeof(float));
+				cand[ncand++] = i;
+			}
+		}
+		seedUpdateOCL(cand_f + first * nfeatures, ncand - first, first, npoints, nfeatures, partial_cost);
+	}
+
+	/* too few candidates (tiny or degenerate input): top up uniformly */
+	while (ncand < nclusters) {
+		i = (int) (rng_uniform() * npoints);
+		memcpy(cand_f + ncand * nfeatures, feature[i], nfeatures * sizeof(float));
+		seedUpdateOCL(cand_f + ncand * nfeatures, 1, ncand, npoints, nfeatures, partial_cost);
+		cand[ncand++] = i;
+	}
+
+	/* weight of a candidate = number of points nearest to it */
+	seedNearestOCL(npoints, nearest);
+	for (i = 0; i < npoints; i++)
+		weight[nearest[i]] += 1.0f;
+
+	/* weighted k-means++ over the candidates */
+	for (i = 0; i < ncand; i++)
+		best[i] = FLT_MAX;
+	for (c = 0; c < nclusters; c++) {
+		j = sample_weighted(c == 0 ? weight : dist, ncand);
+		if (j < 0)
+			j = (int) (rng_uniform() * ncand);
+		memcpy(clusters[c], cand_f + j * nfeatures, nfeatures * sizeof(float));
+
+		for (i = 0; i < ncand; i++) {
+			float ans = 0;
+			for (l = 0; l < nfeatures; l++) {
+				float sub_tmp = cand_f[i * nfeatures + l] - clusters[c][l];
+				ans += sub_tmp * sub_tmp;
+			}
+			if (ans < best[i])
+				best[i] = ans;
+			dist[i] = weight[i] * best[i];
+		}
+	}
+
+	printf("k-means||: %d candidates from %d rounds\n", ncand, r);
+
+	_aligned_free(cand);
+	_aligned_free(cand_f);
+	free(weight);
+	_aligned_free(dist);
+	_aligned_free(nearest);
+	_aligned_free(best);
+}
+
+/*----< centres_cost() >---------------------------------------------------*/
+/* Sum of squared distances of every point to its nearest centre */
+float centres_cost(int nfeatures, int npoints, int nclusters, float **clusters)
+{
+	int    ngroups      = seedGroupsOCL();
+	float *partial_cost = (float*) _aligned_malloc(ngroups * sizeof(float), AOCL_ALIGNMENT);
+	float  cost;
+
+	seedResetOCL(npoints);
+	seedUpdateOCL(clusters[0], nclusters, 0, npoints, nfeatures, partial_cost);
+	cost = sum_cost(partial_cost, ngroups);
+
+	_aligned_free(partial_cost);
+	return cost;
+}
+
+/*----< seed_centres() >---------------------------------------------------*/
+/* Fills clusters[] with the initial centres of the given seeding mode and
+   returns their cost, the sum of squared distances of every point to its
+   nearest initial centre. Needs allocate() to have run. */
+float seed_centres(float **feature,    /* in: [npoints][nfeatures] */
+                   int     nfeatures,
+                   int     npoints,
+                   int     nclusters,
+                   int     seeding,
+                   float **clusters)   /* out: [nclusters][nfeatures] */
+{
+	int    ngroups      = seedGroupsOCL();
+	float *partial_cost = (float*) _aligned_malloc(ngroups * sizeof(float), AOCL_ALIGNMENT);
+
+	switch (seeding) {
+	case SEED_KMEANSPP:
+		seed_kmeanspp(feature, nfeatures, npoints, nclusters, clusters, partial_cost);
+		break;
+	case SEED_KMEANS_PARALLEL:
+		seed_parallel(feature, nfeatures, npoints, nclusters, clusters, partial_cost);
+		break;
+	default:
+		for (int i = 0; i < nclusters; i++)
+			memcpy(clusters[i], feature[i], nfeatures * sizeof(float));
+		break;
+	}
+
+	_aligned_free(partial_cost);
+	return centres_cost(nfeatures, npoints, nclusters, clusters);
+}
@@ -0,0 +1,48 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <float.h>
+#include <omp.h>
+#include "kmeans.h"
+
+#define AOCL_ALIGNMENT 64
+#include <malloc.h>
+
+/*---< cluster() >-----------------------------------------------------------*/
+void cluster(const char *filename,			/* stream of [npoints][nfeatures] raw floats */
+            long long npoints,				/* number of data points */
+            int      nfeatures,				/* number of attributes for each point */
+            int      nclusters,				/* number of clusters */
+            int      batch,					/* points per mini-batch */
+            int      epochs,				/* mini-batch passes over the stream */
+            int      full_batch,			/* also run full-batch k-means as the reference */
+            float ***cluster_centres		/* out: [nclusters][nfeatures] */
+			)
+{    
+	double	mb_stats[3];
+	double	fb_stats[4];
+	float **fb_centres;
+
+	/* allocate device memory, open the stream */
+	allocate(filename, npoints, nfeatures, nclusters, batch);
+
+	printf("\n================= mini-batch, %d points per batch =================\n", batch);
+	*cluster_centres = kmeans_minibatch(nfeatures, npoints, nclusters, epochs, mb_stats);
+	printf("Mini-batch: %d epochs in %0.3f ms, %.4g points/s, inertia %.6g\n",
+		epochs, mb_stats[0] * 1e3, mb_stats[1], mb_stats[2]);
+
+	if (full_batch) {
+		printf("\n================= full batch =================\n");
+		fb_centres = kmeans_fullbatch(nfeatures, npoints, nclusters, fb_stats);
+		printf("Full batch: %d passes in %0.3f ms, %.4g points/s, inertia %.6g\n",
+			(int) fb_stats[3], fb_stats[0] * 1e3, fb_stats[1], fb_stats[2]);
+		printf("Mini-batch inertia vs full batch: %+.3f%%, time %.2fx\n",
+			100.0 * (mb_stats[2] - fb_stats[2]) / fb_stats[2], fb_stats[0] / mb_stats[0]);
+		_aligned_free(fb_centres[0]);
+		_aligned_free(fb_centres);
+	}
+
+	deallocateMemory();						/* free device memory */
+}
@@ -0,0 +1,446 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <iostream>
+#include <string>
+#include "kmeans.h"
+#include "timer.h"
+
+#include <windows.h>
+
+#define AOCL_ALIGNMENT 64
+#include <malloc.h>
+
+#ifndef FLT_MAX
+#define FLT_MAX 3.40282347e+38
+#endif
+#ifdef RD_WG_SIZE_0_0
+        #define BLOCK_SIZE RD_WG_SIZE_0_0
+#elif defined(RD_WG_SIZE_0)
+        #define BLOCK_SIZE RD_WG_SIZE_0
+#elif defined(RD_WG_SIZE)
+        #define BLOCK_SIZE RD_WG_SIZE
+#else
+        #define BLOCK_SIZE 256
+#endif
+#ifdef RD_WG_SIZE_1_0
+     #define BLOCK_SIZE2 RD_WG_SIZE_1_0
+#elif defined(RD_WG_SIZE_1)
+     #define BLOCK_SIZE2 RD_WG_SIZE_1
+#elif defined(RD_WG_SIZE)
+     #define BLOCK_SIZE2 RD_WG_SIZE
+#else
+     #define BLOCK_SIZE2 256
+#endif
+
+#include <CL/cl.h>
+#include <fstream>
+#include <iostream>
+
+#include "CL/opencl.h"
+#include "AOCLUtils/aocl_utils.h"
+
+using namespace aocl_utils;
+
+// Allocation error checking
+#define ERR_1(v1)                                                                                                      \
+    if(v1 == NULL) {                                                                                                   \
+        fprintf(stderr, "Allocation error at %s, %d\n", __FILE__, __LINE__);                                           \
+        exit(-1);                                                                                                      \
+    }
+#define ERR_2(v1,v2) ERR_1(v1) ERR_1(v2)
+#define ERR_3(v1,v2,v3) ERR_2(v1,v2) ERR_1(v3)
+#define ERR_4(v1,v2,v3,v4) ERR_3(v1,v2,v3) ERR_1(v4)
+#define ERR_5(v1,v2,v3,v4,v5) ERR_4(v1,v2,v3,v4) ERR_1(v5)
+#define ERR_6(v1,v2,v3,v4,v5,v6) ERR_5(v1,v2,v3,v4,v5) ERR_1(v6)
+#define GET_ERR_MACRO(_1,_2,_3,_4,_5,_6,NAME,...) NAME
+#define ALLOC_ERR(...) GET_ERR_MACRO(__VA_ARGS__,ERR_6,ERR_5,ERR_4,ERR_3,ERR_2,ERR_1)(__VA_ARGS__)
+
+#define CL_ERR()                                                                                                       \
+    if(clStatus != CL_SUCCESS) {                                                                                       \
+        fprintf(stderr, "OpenCL error: %d\n at %s, %d\n", clStatus, __FILE__, __LINE__);                               \
+        exit(-1);                                                                                                      \
+    }
+
+
+
+// local variables
+static cl_context	    clContext;
+static cl_command_queue clCommandQueue;		/* kernels */
+static cl_command_queue clQueueIO;			/* batch uploads, overlapped with the kernels */
+static cl_program       clProgram;
+static cl_kernel        clKernel;
+static cl_kernel        clKernelMiniBatch;
+static cl_kernel        clKernelAccumulate;
+static cl_kernel        clKernelFullUpdate;
+static cl_device_id		clDeviceID;
+
+Timer timer;
+
+static int shutdown()
+{
+	// release resources
+	if( clKernel ) clReleaseKernel( clKernel );
+	if( clKernelMiniBatch ) clReleaseKernel( clKernelMiniBatch );
+	if( clKernelAccumulate ) clReleaseKernel( clKernelAccumulate );
+	if( clKernelFullUpdate ) clReleaseKernel( clKernelFullUpdate );
+	if( clProgram ) clReleaseProgram( clProgram );
+	if( clQueueIO ) clReleaseCommandQueue( clQueueIO );
+	if( clCommandQueue ) clReleaseCommandQueue( clCommandQueue );
+	if( clContext ) clReleaseContext( clContext );
+	// reset all variables
+	clCommandQueue = 0;
+	clQueueIO = 0;
+	clContext = 0;
+	return 0;
+}
+
+
+cl_mem d_feature[2];		/* double-buffered batch */
+cl_mem d_cluster;
+cl_mem d_counts;
+cl_mem d_partial_centers;
+cl_mem d_partial_len;
+cl_mem d_partial_cost;
+cl_mem d_sums;
+cl_mem d_sums_c;
+cl_mem d_len;
+cl_mem d_cost;
+cl_mem d_moved;
+
+// Work-group size of kmeans_kernel_c, must match WG_SIZE in minibatch.cl
+#define WG_SIZE 128
+static int n_groups;
+
+static FILE      *stream;			/* [npoints][nfeatures] raw floats */
+static long long  stream_points;
+static int        stream_features;
+static int        stream_clusters;
+static int        batch_points;
+static float     *batch_buf[2];		/* host staging of the two batches in flight */
+
+
+int allocate(const char *filename, long long n_points, int n_features, int n_clusters, int n_batch)
+{
+	cl_int  clStatus;
+
+
+	// Get the OpenCL platform.
+	cl_platform_id clPlatform = NULL;
+	clPlatform = findPlatform("Intel(R) FPGA");
+	if(clPlatform == NULL) {
+		printf("ERROR: Unable to find Intel(R) FPGA OpenCL platform.\n");
+	}
+
+
+	// Query the available OpenCL device.
+    cl_uint clNumDevices;
+    clStatus = clGetDeviceIDs(clPlatform, CL_DEVICE_TYPE_ALL, 0, NULL, &clNumDevices);
+    CL_ERR();
+    cl_device_id *clDevices = new cl_device_id[clNumDevices];
+    clStatus                = clGetDeviceIDs(clPlatform, CL_DEVICE_TYPE_ALL, clNumDevices, clDevices, NULL);
+    CL_ERR();
+
+	printf("Platform: %s\n",getPlatformName(clPlatform).c_str());
+	printf("Using %d device(s)\n",clNumDevices);
+	for(unsigned i = 0; i < clNumDevices; ++i) {
+		printf("  %s\n", getDeviceName(clDevices[i]).c_str());
+	}
+
+
+	// Create the context.
+	clContext = clCreateContext(NULL, clNumDevices, clDevices, &oclContextCallback, NULL, &clStatus);
+    CL_ERR();
+    char device_name_[100];
+    clGetDeviceInfo(clDevices[0], CL_DEVICE_NAME, 100, &device_name_, NULL);
+    clDeviceID = clDevices[0];
+    fprintf(stderr, "%s\t", device_name_);
+	
+	
+	// create command queues for the first device: one for the kernels, one
+	// for the uploads so that the next batch transfers during assignment
+	clCommandQueue = clCreateCommandQueue( clContext, clDevices[0], 0, &clStatus );
+	CL_ERR();
+	clQueueIO = clCreateCommandQueue( clContext, clDevices[0], 0, &clStatus );
+	CL_ERR();
+
+
+	// Create the program.
+	std::string binary_file = getBoardBinaryFile("minibatch", clDeviceID);
+	printf("\nUsing AOCX:%s\n",binary_file.c_str());
+	clProgram = createProgramFromBinary(clContext, binary_file.c_str(), &clDeviceID, 1);	
+	CL_ERR();
+
+
+	// Build the program that was just created.
+    clStatus = clBuildProgram(clProgram, 0, NULL, "", NULL, NULL);  
+    if(clStatus == CL_BUILD_PROGRAM_FAILURE) {
+        // Determine the size of the log
+        size_t log_size;
+        clGetProgramBuildInfo(clProgram, clDevices[0], CL_PROGRAM_BUILD_LOG, 0, NULL, &log_size);
+        // Allocate memory for the log
+        char *log = (char *)malloc(log_size);
+        // Get the log
+        clGetProgramBuildInfo(clProgram, clDevices[0], CL_PROGRAM_BUILD_LOG, log_size, log, NULL);
+        // Print the log
+        fprintf(stderr, "%s\t", log);
+    }
+    CL_ERR();
+
+
+	// Kernel.
+    clKernel  = clCreateKernel(clProgram, "kmeans_kernel_c", &clStatus);
+    CL_ERR();
+    clKernelMiniBatch = clCreateKernel(clProgram, "kmeans_minibatch_update", &clStatus);
+    CL_ERR();
+    clKernelAccumulate = clCreateKernel(clProgram, "kmeans_accumulate", &clStatus);
+    CL_ERR();
+    clKernelFullUpdate = clCreateKernel(clProgram, "kmeans_full_update", &clStatus);
+    CL_ERR();
+
+	if(n_clusters > WG_SIZE) {
+		printf("Error: nclusters(%d) > work-group size(%d) -- cannot proceed\n", n_clusters, WG_SIZE);
+		exit(0);
+	}
+	n_groups = (n_batch + WG_SIZE - 1) / WG_SIZE;
+
+
+	// Only two batches are ever resident on the device
+	d_feature[0] = clCreateBuffer(clContext, CL_MEM_READ_ONLY, n_batch * n_features * sizeof(float), NULL, 0 );
+	d_feature[1] = clCreateBuffer(clContext, CL_MEM_READ_ONLY, n_batch * n_features * sizeof(float), NULL, 0 );
+	d_cluster = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_clusters * n_features  * sizeof(float), NULL, 0 );
+	d_counts  = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_clusters * sizeof(int), NULL, 0 );
+
+	// Per-group partial results are laid out with the compile-time stride NUM_CLUSTERS of the kernel
+	d_partial_centers = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_groups * WG_SIZE * n_features * sizeof(float), NULL, 0 );
+	d_partial_len     = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_groups * WG_SIZE * sizeof(int), NULL, 0 );
+	d_partial_cost    = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_groups * sizeof(float), NULL, 0 );
+
+	// Running sums of a full pass
+	d_sums   = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_clusters * n_features * sizeof(float), NULL, 0 );
+	d_sums_c = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_clusters * n_features * sizeof(float), NULL, 0 );
+	d_len    = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_clusters * sizeof(int), NULL, 0 );
+	d_cost   = clCreateBuffer(clContext, CL_MEM_READ_WRITE, 2 * sizeof(float), NULL, 0 );
+	d_moved  = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_clusters * sizeof(float), NULL, 0 );
+
+	batch_buf[0] = (float*) _aligned_malloc(n_batch * n_features * sizeof(float), AOCL_ALIGNMENT);
+	batch_buf[1] = (float*) _aligned_malloc(n_batch * n_features * sizeof(float), AOCL_ALIGNMENT);
+	ALLOC_ERR(batch_buf[0], batch_buf[1]);
+
+	stream = fopen(filename, "rb");
+	ALLOC_ERR(stream);
+	stream_points   = n_points;
+	stream_features = n_features;
+	stream_clusters = n_clusters;
+	batch_points    = n_batch;
+
+	delete [] clDevices;
+	return 0;
+}
+
+
+void deallocateMemory()
+{
+	clReleaseMemObject(d_feature[0]);
+	clReleaseMemObject(d_feature[1]);
+	clReleaseMemObject(d_cluster);
+	clReleaseMemObject(d_counts);
+	clReleaseMemObject(d_partial_centers);
+	clReleaseMemObject(d_partial_len);
+	clReleaseMemObject(d_partial_cost);
+	clReleaseMemObject(d_sums);
+	clReleaseMemObject(d_sums_c);
+	clReleaseMemObject(d_len);
+	clReleaseMemObject(d_cost);
+	clReleaseMemObject(d_moved);
+	_aligned_free(batch_buf[0]);
+	_aligned_free(batch_buf[1]);
+	fclose(stream);
+}
+
+
+int main( int argc, char** argv) 
+{
+	setup(argc, argv);
+	shutdown();
+}
+
+
+/* Reads count points starting at point first of the stream */
+void readPoints(long long first, int count, float *buf)
+{
+	_fseeki64(stream, first * stream_features * sizeof(float), SEEK_SET);
+	if (fread(buf, sizeof(float), (size_t) count * stream_features, stream) != (size_t) count * stream_features) {
+		fprintf(stderr, "Read error at point %lld\n", first);
+		exit(-1);
+	}
+}
+
+
+/* Uploads the centres; reset also clears the per-centre counts of the
+   mini-batch learning rate */
+void setClustersOCL(float **clusters, int reset)
+{
+	cl_int  clStatus;
+
+	clStatus = clEnqueueWriteBuffer(clCommandQueue, d_cluster, 1, 0, stream_clusters * stream_features * sizeof(float), clusters[0], 0, 0, 0);
+	CL_ERR();
+	if (reset) {
+		int *zero = (int*) calloc(stream_clusters, sizeof(int));
+		clStatus = clEnqueueWriteBuffer(clCommandQueue, d_counts, 1, 0, stream_clusters * sizeof(int), zero, 0, 0, 0);
+		CL_ERR();
+		free(zero);
+	}
+}
+
+
+void getClustersOCL(float **clusters)
+{
+	cl_int  clStatus;
+
+	clStatus = clEnqueueReadBuffer(clCommandQueue, d_cluster, 1, 0, stream_clusters * stream_features * sizeof(float), clusters[0], 0, 0, 0);
+	CL_ERR();
+}
+
+
+/*---< streamPassOCL() >-----------------------------------------------------*/
+/* One pass over the whole stream, batch by batch. The batches alternate
+   between two host staging buffers and two device buffers: while batch b is
+   assigned on clCommandQueue, batch b+1 is read from disk and uploaded on
+   clQueueIO. A buffer is only refilled once the kernel that used it two
+   batches ago has finished.
+
+   update == 1: mini-batch update of the centres after every batch.
+   update == 0: the centres stay fixed; the sums, counts and cost of the
+                pass are accumulated for kmeansFullUpdateOCL().
+
+   Returns the wall time of the pass in seconds; with update == 0 *cost is
+   the sum of squared distances of all points to the fixed centres. */
+double streamPassOCL(int update, double *cost)
+{
+	cl_int    clStatus;
+	cl_event  write_done[2]  = {0, 0};
+	cl_event  kernel_done[2] = {0, 0};
+	long long n_batches = (stream_points + batch_points - 1) / batch_points;
+	int       n_features = stream_features;
+	int       n_clusters = stream_clusters;
+
+	const double start_time = getCurrentTimestamp();
+
+	_fseeki64(stream, 0, SEEK_SET);
+
+	for (long long b = 0; b < n_batches; b++) {
+		int s     = (int) (b & 1);
+		int count = (int) (stream_points - b * batch_points < batch_points ? stream_points - b * batch_points : batch_points);
+		int first = (b == 0);
+
+		// the host buffer is free once its previous upload has completed
+		if (write_done[s]) {
+			clWaitForEvents(1, &write_done[s]);
+			clReleaseEvent(write_done[s]);
+		}
+		if (fread(batch_buf[s], sizeof(float), (size_t) count * n_features, stream) != (size_t) count * n_features) {
+			fprintf(stderr, "Read error in batch %lld\n", b);
+			exit(-1);
+		}
+
+		// the device buffer is free once the kernel of two batches ago has completed
+		clStatus = clEnqueueWriteBuffer(clQueueIO, d_feature[s], CL_FALSE, 0, count * n_features * sizeof(float), batch_buf[s],
+										kernel_done[s] ? 1 : 0, kernel_done[s] ? &kernel_done[s] : NULL, &write_done[s]);
+		CL_ERR();
+		if (kernel_done[s])
+			clReleaseEvent(kernel_done[s]);
+		clFlush(clQueueIO);
+
+		clSetKernelArg(clKernel, 0, sizeof(void *), (void*) &d_feature[s]);
+		clSetKernelArg(clKernel, 1, sizeof(void *), (void*) &d_cluster);
+		clSetKernelArg(clKernel, 2, sizeof(void *), (void*) &d_partial_centers);
+		clSetKernelArg(clKernel, 3, sizeof(void *), (void*) &d_partial_len);
+		clSetKernelArg(clKernel, 4, sizeof(void *), (void*) &d_partial_cost);
+		clSetKernelArg(clKernel, 5, sizeof(cl_int), (void*) &count);
+		clSetKernelArg(clKernel, 6, sizeof(cl_int), (void*) &n_clusters);
+
+		size_t gs[1] = {(size_t)((count + WG_SIZE - 1) / WG_SIZE) * WG_SIZE};
+		size_t ls[1] = {(size_t)WG_SIZE};
+		int    groups = (int) (gs[0] / WG_SIZE);
+
+		clStatus = clEnqueueNDRangeKernel(clCommandQueue, clKernel, 1, NULL, gs, ls, 1, &write_done[s], &kernel_done[s]);
+		CL_ERR();
+
+		size_t gs_reduce[1] = {(size_t)WG_SIZE};
+		size_t ls_reduce[1] = {(size_t)WG_SIZE};
+
+		if (update) {
+			clSetKernelArg(clKernelMiniBatch, 0, sizeof(void *), (void*) &d_partial_centers);
+			clSetKernelArg(clKernelMiniBatch, 1, sizeof(void *), (void*) &d_partial_len);
+			clSetKernelArg(clKernelMiniBatch, 2, sizeof(void *), (void*) &d_cluster);
+			clSetKernelArg(clKernelMiniBatch, 3, sizeof(void *), (void*) &d_counts);
+			clSetKernelArg(clKernelMiniBatch, 4, sizeof(cl_int), (void*) &groups);
+			clSetKernelArg(clKernelMiniBatch, 5, sizeof(cl_int), (void*) &n_clusters);
+
+			clStatus = clEnqueueNDRangeKernel(clCommandQueue, clKernelMiniBatch, 1, NULL, gs_reduce, ls_reduce, 0, 0, 0);
+			CL_ERR();
+		} else {
+			clSetKernelArg(clKernelAccumulate, 0, sizeof(void *), (void*) &d_partial_centers);
+			clSetKernelArg(clKernelAccumulate, 1, sizeof(void *), (void*) &d_partial_len);
+			clSetKernelArg(clKernelAccumulate, 2, sizeof(void *), (void*) &d_partial_cost);
+			clSetKernelArg(clKernelAccumulate, 3, sizeof(void *), (void*) &d_sums);
+			clSetKernelArg(clKernelAccumulate, 4, sizeof(void *), (void*) &d_sums_c);
+			clSetKernelArg(clKernelAccumulate, 5, sizeof(void *), (void*) &d_len);
+			clSetKernelArg(clKernelAccumulate, 6, sizeof(void *), (void*) &d_cost);
+			clSetKernelArg(clKernelAccumulate, 7, sizeof(cl_int), (void*) &groups);
+			clSetKernelArg(clKernelAccumulate, 8, sizeof(cl_int), (void*) &n_clusters);
+			clSetKernelArg(clKernelAccumulate, 9, sizeof(cl_int), (void*) &first);
+
+			clStatus = clEnqueueNDRangeKernel(clCommandQueue, clKernelAccumulate, 1, NULL, gs_reduce, ls_reduce, 0, 0, 0);
+			CL_ERR();
+		}
+		clFlush(clCommandQueue);
+	}
+
+	clFinish(clQueueIO);
+	clFinish(clCommandQueue);
+	for (int s = 0; s < 2; s++) {
+		if (write_done[s]) clReleaseEvent(write_done[s]);
+		if (kernel_done[s]) clReleaseEvent(kernel_done[s]);
+	}
+
+	if (!update && cost) {
+		float c[2];
+		clStatus = clEnqueueReadBuffer(clCommandQueue, d_cost, 1, 0, 2 * sizeof(float), c, 0, 0, 0);
+		CL_ERR();
+		*cost = (double) c[0] - c[1];
+	}
+
+	return getCurrentTimestamp() - start_time;
+}
+
+
+/* Full-batch (Lloyd) step after a streamPassOCL(0, ...): the centres become
+   the means of the pass. Returns the total squared centre movement. */
+float kmeansFullUpdateOCL()
+{
+	cl_int  clStatus;
+	float  *moved = (float*) _aligned_malloc(stream_clusters * sizeof(float), AOCL_ALIGNMENT);
+	float   total = 0;
+
+	clSetKernelArg(clKernelFullUpdate, 0, sizeof(void *), (void*) &d_sums);
+	clSetKernelArg(clKernelFullUpdate, 1, sizeof(void *), (void*) &d_len);
+	clSetKernelArg(clKernelFullUpdate, 2, sizeof(void *), (void*) &d_cluster);
+	clSetKernelArg(clKernelFullUpdate, 3, sizeof(void *), (void*) &d_moved);
+	clSetKernelArg(clKernelFullUpdate, 4, sizeof(cl_int), (void*) &stream_clusters);
+
+	size_t gs[1] = {(size_t)WG_SIZE};
+	size_t ls[1] = {(size_t)WG_SIZE};
+
+	clStatus = clEnqueueNDRangeKernel(clCommandQueue, clKernelFullUpdate, 1, NULL, gs, ls, 0, 0, 0);
+	CL_ERR();
+	clStatus = clEnqueueReadBuffer(clCommandQueue, d_moved, 1, 0, stream_clusters * sizeof(float), moved, 0, 0, 0);
+	CL_ERR();
+
+	for (int i = 0; i < stream_clusters; i++)
+		total += moved[i];
+	_aligned_free(moved);
+	return total;
+}
@@ -0,0 +1,24 @@
+#ifndef _H_FUZZY_KMEANS
+#define _H_FUZZY_KMEANS
+
+#ifndef FLT_MAX
+#define FLT_MAX 3.40282347e+38
+#endif
+
+/* rmse.c */
+float   euclid_dist_2        (float*, float*, int);
+int     find_nearest_point   (float* , int, float**, int);
+float	rms_err(float**, int, int, float**, int);
+void    cluster(const char *filename, long long npoints, int nfeatures, int nclusters, int batch, int epochs, int full_batch, float ***cluster_centres);
+int setup(int argc, char** argv);
+int allocate(const char *filename, long long npoints, int nfeatures, int nclusters, int batch);
+void deallocateMemory();
+void    readPoints(long long first, int count, float *buf);
+void    setClustersOCL(float **clusters, int reset);
+void    getClustersOCL(float **clusters);
+double  streamPassOCL(int update, double *cost);
+float   kmeansFullUpdateOCL();
+float** kmeans_minibatch(int nfeatures, long long npoints, int nclusters, int epochs, double *stats);
+float** kmeans_fullbatch(int nfeatures, long long npoints, int nclusters, double *stats);
+
+#endif
@@ -0,0 +1,88 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <float.h>
+#include <math.h>
+#include <omp.h>
+#include "kmeans.h"
+#include "AOCLUtils/aocl_utils.h"
+
+#define AOCL_ALIGNMENT 64
+#include <malloc.h>
+
+/* The first nclusters points of the stream are the initial centres, as in
+   the in-memory designs */
+static float** initial_centres(int nfeatures, int nclusters)
+{
+	float **clusters;
+	int     i;
+
+	clusters    = (float**) _aligned_malloc(nclusters *             sizeof(float*), AOCL_ALIGNMENT);
+	clusters[0] = (float*)  _aligned_malloc(nclusters * nfeatures * sizeof(float), AOCL_ALIGNMENT);
+    for (i=1; i<nclusters; i++)
+        clusters[i] = clusters[i-1] + nfeatures;
+	readPoints(0, nclusters, clusters[0]);
+	return clusters;
+}
+
+/*----< kmeans_minibatch() >----------------------------------------------*/
+/* epochs streaming passes of mini-batch updates, then one pass with the
+   final centres to measure their inertia */
+float** kmeans_minibatch(int       nfeatures,
+                         long long npoints,
+                         int       nclusters,
+                         int       epochs,
+                         double   *stats)   /* out: [training s, points/s, inertia] */
+{
+	float **clusters = initial_centres(nfeatures, nclusters);
+	double  train_time = 0.0;
+	double  inertia;
+
+	setClustersOCL(clusters, 1);
+
+	for (int e = 0; e < epochs; e++) {
+		double t = streamPassOCL(1, NULL);
+		train_time += t;
+		printf("mini-batch epoch %d: %0.3f ms, %.4g points/s\n", e, t * 1e3, npoints / t);
+	}
+	streamPassOCL(0, &inertia);
+	getClustersOCL(clusters);
+
+	stats[0] = train_time;
+	stats[1] = epochs * npoints / train_time;
+	stats[2] = inertia;
+	return clusters;
+}
+
+/*----< kmeans_fullbatch() >----------------------------------------------*/
+/* Out-of-core Lloyd iterations: one streaming pass per iteration until no
+   centre moves any more. Stops at the same 500 iteration cap as the
+   in-memory designs. */
+float** kmeans_fullbatch(int       nfeatures,
+                         long long npoints,
+                         int       nclusters,
+                         double   *stats)   /* out: [total s, points/s, inertia, iterations] */
+{
+	float **clusters = initial_centres(nfeatures, nclusters);
+	double  total_time = 0.0;
+	double  inertia;
+	float   moved;
+	int		c = 0;
+
+	setClustersOCL(clusters, 1);
+
+	do {
+		total_time += streamPassOCL(0, &inertia);
+		moved = kmeansFullUpdateOCL();
+		c++;
+	} while ((moved > 0.0f) && (c <= 500));
+
+	/* the last pass ran with the final centres, its cost is their inertia */
+	getClustersOCL(clusters);
+	printf("full batch: iterated %d times, %0.3f ms per pass\n", c, total_time * 1e3 / c);
+
+	stats[0] = total_time;
+	stats[1] = c * npoints / total_time;
+	stats[2] = inertia;
+	stats[3] = c;
+	return clusters;
+}
@@ -0,0 +1,249 @@
+#ifndef FLT_MAX
+#define FLT_MAX 3.40282347e+38
+#endif
+#define NUM_CLUSTERS 128
+#define NUM_FEATURE  8
+#define WG_SIZE      128
+
+// Assignment kernel for one batch of streamed points. No membership is kept
+// across batches; every work-group emits the partial sums and counts of its
+// own points per cluster and the sum of their squared distances.
+// Requires nclusters <= NUM_CLUSTERS <= WG_SIZE.
+__kernel
+__attribute((reqd_work_group_size(WG_SIZE,1,1)))
+void kmeans_kernel_c(__global float  *restrict feature,
+			  __global float  *restrict clusters,
+			  __global float  *restrict partial_centers,	/* [ngroups][NUM_CLUSTERS][NUM_FEATURE] */
+			  __global int    *restrict partial_len,		/* [ngroups][NUM_CLUSTERS] */
+			  __global float  *restrict partial_cost,		/* [ngroups] */
+			    int     npoints,
+				int     nclusters ) {
+
+	unsigned int point_id = get_global_id(0);
+	unsigned int local_id = get_local_id(0);
+	unsigned int group_id = get_group_id(0);
+    int index = 0;
+
+	__local float l_clusters[NUM_CLUSTERS*NUM_FEATURE];
+	__local float l_points[WG_SIZE*NUM_FEATURE];
+	__local int   l_index[WG_SIZE];
+	__local float l_cost[WG_SIZE];
+
+	if (local_id < nclusters){
+
+		l_clusters[local_id*NUM_FEATURE+0] = clusters[local_id*NUM_FEATURE+0];
+		l_clusters[local_id*NUM_FEATURE+1] = clusters[local_id*NUM_FEATURE+1];
+		l_clusters[local_id*NUM_FEATURE+2] = clusters[local_id*NUM_FEATURE+2];
+		l_clusters[local_id*NUM_FEATURE+3] = clusters[local_id*NUM_FEATURE+3];
+		l_clusters[local_id*NUM_FEATURE+4] = clusters[local_id*NUM_FEATURE+4];
+		l_clusters[local_id*NUM_FEATURE+5] = clusters[local_id*NUM_FEATURE+5];
+		l_clusters[local_id*NUM_FEATURE+6] = clusters[local_id*NUM_FEATURE+6];
+		l_clusters[local_id*NUM_FEATURE+7] = clusters[local_id*NUM_FEATURE+7];
+	}
+
+	// The last batch is usually partial: padded work-items carry no point
+	bool valid = point_id < npoints;
+
+	float p_feature[NUM_FEATURE];
+	#pragma unroll
+	for (int l = 0; l < NUM_FEATURE; l++){
+		p_feature[l] = valid ? feature[point_id * NUM_FEATURE + l] : 0.0f;
+	}
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+	float min_dist = FLT_MAX;
+
+	#pragma unroll 8
+	for (int i=0; i < nclusters; i++) {
+
+		float ans  = 0;
+
+		#pragma unroll
+		for (int l = 0; l < NUM_FEATURE; l++){
+			float cluster_tmp = l_clusters[i*NUM_FEATURE+l];
+			float feature_tmp = p_feature[l];
+			float sub_tmp = feature_tmp - cluster_tmp;
+			ans += sub_tmp * sub_tmp;
+		}
+
+		if (ans < min_dist) {
+			min_dist = ans;
+			index    = i;
+		}
+	}
+
+	// Stage the assignment of this work-group in local memory
+	l_index[local_id] = valid ? index : -1;
+	l_cost[local_id]  = valid ? min_dist : 0.0f;
+	#pragma unroll
+	for (int l = 0; l < NUM_FEATURE; l++){
+		l_points[local_id*NUM_FEATURE+l] = p_feature[l];
+	}
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+	// Work-item c accumulates cluster c over the points of this work-group
+	if (local_id < nclusters){
+
+		float sum[NUM_FEATURE];
+		int   len = 0;
+		#pragma unroll
+		for (int l = 0; l < NUM_FEATURE; l++)
+			sum[l] = 0.0f;
+
+		for (int j = 0; j < WG_SIZE; j++){
+			if (l_index[j] == local_id){
+				len++;
+				#pragma unroll
+				for (int l = 0; l < NUM_FEATURE; l++)
+					sum[l] += l_points[j*NUM_FEATURE+l];
+			}
+		}
+
+		#pragma unroll
+		for (int l = 0; l < NUM_FEATURE; l++)
+			partial_centers[(group_id*NUM_CLUSTERS + local_id)*NUM_FEATURE + l] = sum[l];
+		partial_len[group_id*NUM_CLUSTERS + local_id] = len;
+	}
+
+	if (local_id == 0){
+		float cost = 0;
+		for (int j = 0; j < WG_SIZE; j++)
+			cost += l_cost[j];
+		partial_cost[group_id] = cost;
+	}
+}
+
+
+// Mini-batch update (Sculley, "Web-scale k-means clustering"). One work-item
+// per cluster folds the batch partials and moves its centre towards the batch
+// mean with the per-centre learning rate n / counts, where counts is the
+// number of points the centre has absorbed so far, this batch included.
+__kernel
+void kmeans_minibatch_update(__global float  *restrict partial_centers,
+			  __global int    *restrict partial_len,
+			  __global float  *restrict clusters,
+			  __global int    *restrict counts,			/* [nclusters] */
+			    int     ngroups,
+				int     nclusters ) {
+
+	unsigned int cluster_id = get_global_id(0);
+
+	if (cluster_id < nclusters){
+
+		float sum[NUM_FEATURE];
+		int   len = 0;
+		#pragma unroll
+		for (int l = 0; l < NUM_FEATURE; l++)
+			sum[l] = 0.0f;
+
+		for (int g = 0; g < ngroups; g++){
+			len += partial_len[g*NUM_CLUSTERS + cluster_id];
+			#pragma unroll
+			for (int l = 0; l < NUM_FEATURE; l++)
+				sum[l] += partial_centers[(g*NUM_CLUSTERS + cluster_id)*NUM_FEATURE + l];
+		}
+
+		if (len > 0){
+			int   n   = counts[cluster_id] + len;
+			float eta = (float) len / n;
+			#pragma unroll
+			for (int l = 0; l < NUM_FEATURE; l++){
+				float center = clusters[cluster_id*NUM_FEATURE + l];
+				clusters[cluster_id*NUM_FEATURE + l] = center + eta * (sum[l] / len - center);
+			}
+			counts[cluster_id] = n;
+		}
+	}
+}
+
+
+// Full-batch accumulation. One work-item per cluster folds the batch
+// partials into the running sums of the pass; work-item 0 also folds the
+// cost. Passes run over hundreds of millions of points, so the float sums
+// carry a Kahan compensation term. first == 1 restarts the pass.
+__kernel
+void kmeans_accumulate(__global float  *restrict partial_centers,
+			  __global int    *restrict partial_len,
+			  __global float  *restrict partial_cost,
+			  __global float  *restrict sums,			/* [nclusters][NUM_FEATURE] */
+			  __global float  *restrict sums_c,			/* [nclusters][NUM_FEATURE], compensation */
+			  __global int    *restrict len,			/* [nclusters] */
+			  __global float  *restrict cost,			/* [2]: sum, compensation */
+			    int     ngroups,
+				int     nclusters,
+				int     first ) {
+
+	unsigned int cluster_id = get_global_id(0);
+
+	if (cluster_id < nclusters){
+
+		float sum[NUM_FEATURE];
+		int   n = 0;
+		#pragma unroll
+		for (int l = 0; l < NUM_FEATURE; l++)
+			sum[l] = 0.0f;
+
+		for (int g = 0; g < ngroups; g++){
+			n += partial_len[g*NUM_CLUSTERS + cluster_id];
+			#pragma unroll
+			for (int l = 0; l < NUM_FEATURE; l++)
+				sum[l] += partial_centers[(g*NUM_CLUSTERS + cluster_id)*NUM_FEATURE + l];
+		}
+
+		#pragma unroll
+		for (int l = 0; l < NUM_FEATURE; l++){
+			float s = first ? 0.0f : sums[cluster_id*NUM_FEATURE + l];
+			float c = first ? 0.0f : sums_c[cluster_id*NUM_FEATURE + l];
+			float y = sum[l] - c;
+			float t = s + y;
+			sums_c[cluster_id*NUM_FEATURE + l] = (t - s) - y;
+			sums[cluster_id*NUM_FEATURE + l]   = t;
+		}
+		len[cluster_id] = (first ? 0 : len[cluster_id]) + n;
+	}
+
+	if (cluster_id == 0){
+		float batch = 0;
+		for (int g = 0; g < ngroups; g++)
+			batch += partial_cost[g];
+
+		float s = first ? 0.0f : cost[0];
+		float c = first ? 0.0f : cost[1];
+		float y = batch - c;
+		float t = s + y;
+		cost[1] = (t - s) - y;
+		cost[0] = t;
+	}
+}
+
+
+// Full-batch update after a pass: one work-item per cluster writes the mean
+// of its points in place and how far the centre moved (squared); clusters
+// without points keep their previous centre.
+__kernel
+void kmeans_full_update(__global float  *restrict sums,
+			  __global int    *restrict len,
+			  __global float  *restrict clusters,
+			  __global float  *restrict moved,			/* [nclusters] */
+				int     nclusters ) {
+
+	unsigned int cluster_id = get_global_id(0);
+
+	if (cluster_id < nclusters){
+
+		float ans = 0;
+		int   n   = len[cluster_id];
+		if (n > 0){
+			#pragma unroll
+			for (int l = 0; l < NUM_FEATURE; l++){
+				float center  = sums[cluster_id*NUM_FEATURE + l] / n;
+				float sub_tmp = center - clusters[cluster_id*NUM_FEATURE + l];
+				ans += sub_tmp * sub_tmp;
+				clusters[cluster_id*NUM_FEATURE + l] = center;
+			}
+		}
+		moved[cluster_id] = ans;
+	}
+}
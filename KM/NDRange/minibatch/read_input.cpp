@@ -0,0 +1,170 @@
+#define _CRT_SECURE_NO_DEPRECATE 1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <fcntl.h>
+#include <omp.h>
+#include "kmeans.h"
+#include <unistd.h>
+#include <time.h>
+
+#define AOCL_ALIGNMENT 64
+#include <malloc.h>
+
+#define GEN_CHUNK 65536		/* points generated per write */
+
+
+/* Converts the text input (one point per line) to the raw float stream */
+static long long convert_input(const char *text, const char *binary, int nfeatures)
+{
+	float      temp;
+	long long  n = 0;
+	FILE      *in  = fopen(text, "r");
+	FILE      *out = fopen(binary, "wb");
+
+	if (in == NULL || out == NULL) {
+		printf("Error: cannot convert %s to %s\n", text, binary);
+		exit(0);
+	}
+	while (fscanf(in, "%f", &temp) == 1) {
+		fwrite(&temp, sizeof(float), 1, out);
+		n++;
+	}
+	fclose(in);
+	fclose(out);
+	return n / nfeatures;
+}
+
+/* Synthetic stream: nclusters Gaussian blobs in the value range of
+   input.txt, written in chunks so that it can exceed host memory */
+static void generate_input(const char *binary, long long npoints, int nfeatures, int nclusters)
+{
+	float *centres = (float*) malloc(nclusters * nfeatures * sizeof(float));
+	float *buf     = (float*) malloc(GEN_CHUNK * nfeatures * sizeof(float));
+	FILE  *out     = fopen(binary, "wb");
+
+	if (out == NULL) {
+		printf("Error: cannot write %s\n", binary);
+		exit(0);
+	}
+	srand(1);
+	for (int i = 0; i < nclusters * nfeatures; i++)
+		centres[i] = 1024.0f * rand() / RAND_MAX;
+	for (long long first = 0; first < npoints; first += GEN_CHUNK) {
+		int count = (int) (npoints - first < GEN_CHUNK ? npoints - first : GEN_CHUNK);
+		for (int i = 0; i < count; i++) {
+			int c = rand() % nclusters;
+			for (int j = 0; j < nfeatures; j++) {
+				/* Box-Muller, sigma = 16 */
+				float u1 = (rand() + 1.0f) / (RAND_MAX + 2.0f);
+				float u2 = (rand() + 1.0f) / (RAND_MAX + 2.0f);
+				buf[i * nfeatures + j] = centres[c * nfeatures + j] + 16.0f * sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+			}
+		}
+		fwrite(buf, sizeof(float), (size_t) count * nfeatures, out);
+	}
+	fclose(out);
+	free(buf);
+	free(centres);
+}
+
+static long long stream_length(const char *binary, int nfeatures)
+{
+	FILE *fp = fopen(binary, "rb");
+	if (fp == NULL) {
+		printf("Error: cannot open %s\n", binary);
+		exit(0);
+	}
+	_fseeki64(fp, 0, SEEK_END);
+	long long bytes = _ftelli64(fp);
+	fclose(fp);
+	return bytes / (nfeatures * sizeof(float));
+}
+
+
+/*---< main() >-------------------------------------------------------------*/
+/* host                         streams input/input.txt (converted to input/input.bin)
+   host <file>                  streams <file>, raw [npoints][8] floats
+   host -gen <npoints> <file>   writes a synthetic stream to <file> first
+   options: -batch <points> -epochs <n> -nofull                              */
+int setup(int argc, char **argv) {
+
+		char   *filename = "input/input.bin";
+		int		nclusters=128;					// 128 clusters
+		int		nfeatures = 8;					// 8 features
+		long long npoints = 0;
+		long long gen_points = 0;
+		int		batch = 8192;					// points per mini-batch
+		int		epochs = 3;						// mini-batch passes
+		int		full_batch = 1;					// full-batch reference
+		float **cluster_centres=NULL;
+		int		isOutput = 0;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-gen") && i + 2 < argc) {
+			gen_points = atoll(argv[++i]);
+			filename   = argv[++i];
+		} else if (!strcmp(argv[i], "-batch") && i + 1 < argc) {
+			batch = atoi(argv[++i]);
+		} else if (!strcmp(argv[i], "-epochs") && i + 1 < argc) {
+			epochs = atoi(argv[++i]);
+		} else if (!strcmp(argv[i], "-nofull")) {
+			full_batch = 0;
+		} else {
+			filename = argv[i];
+		}
+	}
+
+	if (gen_points > 0)
+		generate_input(filename, gen_points, nfeatures, nclusters);
+	else if (argc == 1)
+		convert_input("input/input.txt", filename, nfeatures);
+	npoints = stream_length(filename, nfeatures);
+
+	printf("\nI/O completed\n");
+	printf("\nNumber of objects: %lld\n", npoints);
+	printf("Number of features: %d\n", nfeatures);
+
+	/* ============== I/O end ==============*/
+	// error check for clusters
+	if (npoints < nclusters || batch < nclusters)
+	{
+		printf("Error: nclusters(%d) > npoints(%lld) or batch(%d) -- cannot proceed\n", nclusters, npoints, batch);
+		exit(0);
+	}
+
+
+	/* ======================= core of the clustering ===================*/
+
+	cluster_centres = NULL;
+    cluster(filename,				/* stream of points */
+			npoints,				/* number of data points */
+			nfeatures,				/* number of features for each point */
+			nclusters,				/* number of clusters */
+			batch,					/* points per mini-batch */
+			epochs,					/* mini-batch passes */
+			full_batch,				/* full-batch reference */
+			&cluster_centres);		/* return: [nclusters][nfeatures] */
+
+
+	/* =============== Command Line Output =============== */
+
+	/* cluster center coordinates:displayed only for when k=1*/
+	if(isOutput == 1) {
+		printf("\n================= Centroid Coordinates =================\n");
+		for(int i = 0; i < nclusters; i++){
+			printf("%d:", i);
+			for(int j = 0; j < nfeatures; j++){
+				printf(" %.2f", cluster_centres[i][j]);
+			}
+			printf("\n\n");
+		}
+	}
+
+	_aligned_free(cluster_centres[0]);
+	_aligned_free(cluster_centres);
+    return(0);
+}
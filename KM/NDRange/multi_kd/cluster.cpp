@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <float.h>
+#include <omp.h>
+#include "kmeans.h"
+
+#define AOCL_ALIGNMENT 64
+#include <malloc.h>
+
+float	min_rmse_ref = FLT_MAX;		
+extern double wtime(void);
+	/* reference min_rmse value */
+
+/*---< cluster() >-----------------------------------------------------------*/
+void cluster(int      npoints,				/* number of data points */
+            int      nfeatures,				/* number of attributes for each point */
+            float  **features,				/* array: [npoints][nfeatures] */                  
+            int      nclusters,				/* range of min to max number of clusters */
+            float    threshold,				/* loop terminating factor */
+            float ***cluster_centres,		/* out: [best_nclusters][nfeatures] */
+			int		 nloops					/* number of iteration for each number of clusters */
+			)
+{    
+	int		index =0;						/* number of iteration to reach the best RMSE */
+	int		rmse;							/* RMSE for each clustering */
+    int    *membership;						/* which cluster a data point belongs to */
+    float **tmp_cluster_centres;			/* hold coordinates of cluster centers */
+	int		i;
+	float	kernel_time;
+	
+	/* allocate memory for membership */
+	membership = (int*) _aligned_malloc(npoints * sizeof(int), AOCL_ALIGNMENT);
+
+	/* allocate device memory, invert data array */
+	allocate(npoints, nfeatures, nclusters, features);
+
+	/* iterate nloops times for each number of clusters */
+	for(i = 0; i < nloops; i++)
+	{
+		/* initialize initial cluster centers, CUDA calls (@ kmeans_cuda.cu) */
+		tmp_cluster_centres = kmeans_clustering(features,
+												nfeatures,
+												npoints,
+												nclusters,
+												threshold,
+												membership,
+												500,
+												&kernel_time);
+		if (*cluster_centres) {
+			free((*cluster_centres)[0]);
+			free(*cluster_centres);
+		}
+		*cluster_centres = tmp_cluster_centres;	        					
+	}		
+	deallocateMemory();						/* free device memory (@ kmeans_cuda.cu) */
+	
+    _aligned_free(membership);
+}
+
+
+#define BENCH_LOOPS 10
+
+/*---< benchmark() >---------------------------------------------------------*/
+/* Runs BENCH_LOOPS iterations with the kernel selected for (nclusters,
+   nfeatures), after checking one assignment against the CPU. */
+void benchmark(int      npoints,
+               int      nfeatures,
+               int      nclusters,
+               float  **features)
+{
+	int    *membership = (int*) _aligned_malloc(npoints * sizeof(int), AOCL_ALIGNMENT);
+	int    *new_centers_len = (int*) calloc(nclusters, sizeof(int));
+	float **clusters;
+	float **new_centers;
+	float   kernel_time;
+	int     i, j, k, agree = 0;
+
+	clusters       = (float**) _aligned_malloc(nclusters * sizeof(float*), AOCL_ALIGNMENT);
+	new_centers    = (float**) _aligned_malloc(nclusters * sizeof(float*), AOCL_ALIGNMENT);
+	new_centers[0] = (float*)  calloc(nclusters * nfeatures, sizeof(float));
+	for (i = 1; i < nclusters; i++)
+		new_centers[i] = new_centers[i-1] + nfeatures;
+	/* same seeds as kmeans_clustering: the first nclusters points */
+	for (i = 0; i < nclusters; i++)
+		clusters[i] = features[i];
+	for (i = 0; i < npoints; i++)
+		membership[i] = -1;
+
+	allocate(npoints, nfeatures, nclusters, features);
+
+	/* one assignment checked against the CPU */
+	kmeansOCL(features, nfeatures, npoints, nclusters, membership, clusters, new_centers_len, new_centers, &kernel_time);
+	for (i = 0; i < npoints; i++) {
+		float min_dist = FLT_MAX;
+		int   index    = 0;
+		for (j = 0; j < nclusters; j++) {
+			float ans = 0;
+			for (k = 0; k < nfeatures; k++) {
+				float sub_tmp = features[i][k] - clusters[j][k];
+				ans += sub_tmp * sub_tmp;
+			}
+			if (ans < min_dist) {
+				min_dist = ans;
+				index    = j;
+			}
+		}
+		agree += (membership[i] == index);
+	}
+
+	float **centres = kmeans_clustering(features, nfeatures, npoints, nclusters, 0.0f, membership, BENCH_LOOPS, &kernel_time);
+	deallocateMemory();
+
+	printf("bench k = %4d, d = %2d: %8.3f ms/iteration, %7.2f GFLOPS, membership agreement %d of %d\n",
+		nclusters, nfeatures, kernel_time,
+		3.0 * npoints * nclusters * nfeatures / (kernel_time * 1e6), agree, npoints);
+
+	_aligned_free(centres[0]);
+	_aligned_free(centres);
+	free(new_centers[0]);
+	_aligned_free(new_centers);
+	_aligned_free(clusters);
+	free(new_centers_len);
+	_aligned_free(membership);
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+// Assignment kernel specialised for K clusters of D features.
+// Included once per (K, D) pair by multi_kd.cl with K and D defined.
+// The whole centroid table lives on chip and the feature loop is fully
+// unrolled; nclusters may be smaller than K, nfeatures must equal D.
+
+#define KM_KERNEL_NAME_(k, d) kmeans_kernel_k##k##_d##d
+#define KM_KERNEL_NAME(k, d)  KM_KERNEL_NAME_(k, d)
+
+__kernel
+__attribute((reqd_work_group_size(WG_SIZE,1,1)))
+void KM_KERNEL_NAME(K, D)(__global float  *restrict feature,
+			  __global float  *restrict clusters,
+			  __global int    *restrict membership,
+			    int     npoints,
+				int     nclusters,
+				int     nfeatures ) {
+
+	unsigned int point_id = get_global_id(0);
+	unsigned int local_id = get_local_id(0);
+    int index = 0;
+
+	__local float l_clusters[K*D];
+	for (int i = local_id; i < nclusters*D; i += WG_SIZE){
+		l_clusters[i] = clusters[i];
+	}
+
+	// The last work-group may be partial: padded work-items carry no point
+	bool valid = point_id < npoints;
+
+	float p_feature[D];
+	#pragma unroll
+	for (int l = 0; l < D; l++){
+		p_feature[l] = valid ? feature[point_id * D + l] : 0.0f;
+	}
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+	float min_dist = FLT_MAX;
+
+	for (int i=0; i < nclusters; i++) {
+
+		float ans  = 0;
+
+		#pragma unroll
+		for (int l = 0; l < D; l++){
+			float cluster_tmp = l_clusters[i*D+l];
+			float feature_tmp = p_feature[l];
+			float sub_tmp = feature_tmp - cluster_tmp;
+			ans += sub_tmp * sub_tmp;
+		}
+
+		if (ans < min_dist) {
+			min_dist = ans;
+			index    = i;
+		}
+	}
+
+	if (valid)
+		membership[point_id] = index;
+}
+
+#undef KM_KERNEL_NAME
+#undef KM_KERNEL_NAME_
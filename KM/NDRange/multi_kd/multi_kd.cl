@@ -0,0 +1,106 @@
+#ifndef FLT_MAX
+#define FLT_MAX 3.40282347e+38
+#endif
+#define WG_SIZE      128
+#define TILE_FLOATS  8192	// on-chip centroid capacity, in floats
+
+// Specialised kernels: kmeans_kernel_k<K>_d<D>, one per (K, D) pair with
+// K * D <= TILE_FLOATS. The host picks the smallest K >= nclusters with
+// D == nfeatures and falls back to kmeans_kernel_tiled otherwise. Remove the
+// pairs you do not need to save area; the host skips missing kernels.
+
+#define K 16
+#define D 2
+#include "kmeans_kd.h"
+#undef D
+#define D 8
+#include "kmeans_kd.h"
+#undef D
+#define D 64
+#include "kmeans_kd.h"
+#undef D
+#undef K
+
+#define K 128
+#define D 2
+#include "kmeans_kd.h"
+#undef D
+#define D 8
+#include "kmeans_kd.h"
+#undef D
+#define D 64
+#include "kmeans_kd.h"
+#undef D
+#undef K
+
+#define K 1024
+#define D 2
+#include "kmeans_kd.h"
+#undef D
+#define D 8
+#include "kmeans_kd.h"
+#undef D
+#undef K
+
+
+// Generic fallback for any nclusters and nfeatures. The centroid table is
+// streamed through on-chip memory in tiles of TILE_FLOATS / nfeatures
+// clusters; the features of the work-group's points stay in l_points
+// (WG_SIZE * nfeatures floats, sized by the host).
+__kernel
+__attribute((reqd_work_group_size(WG_SIZE,1,1)))
+void kmeans_kernel_tiled(__global float  *restrict feature,
+			  __global float  *restrict clusters,
+			  __global int    *restrict membership,
+			    int     npoints,
+				int     nclusters,
+				int     nfeatures,
+			  __local  float  *restrict l_points ) {
+
+	unsigned int point_id = get_global_id(0);
+	unsigned int local_id = get_local_id(0);
+    int index = 0;
+
+	__local float l_tile[TILE_FLOATS];
+
+	bool valid = point_id < npoints;
+
+	__local float *p_feature = l_points + local_id * nfeatures;
+	for (int l = 0; l < nfeatures; l++){
+		p_feature[l] = valid ? feature[point_id * nfeatures + l] : 0.0f;
+	}
+
+	const int tile_k = TILE_FLOATS / nfeatures;
+	float min_dist = FLT_MAX;
+
+	for (int c0 = 0; c0 < nclusters; c0 += tile_k) {
+
+		const int nk = min(tile_k, nclusters - c0);
+
+		barrier(CLK_LOCAL_MEM_FENCE); // previous tile fully consumed
+		for (int i = local_id; i < nk*nfeatures; i += WG_SIZE){
+			l_tile[i] = clusters[c0*nfeatures + i];
+		}
+		barrier(CLK_LOCAL_MEM_FENCE);
+
+		for (int i = 0; i < nk; i++) {
+
+			float ans  = 0;
+
+			for (int l = 0; l < nfeatures; l++){
+				float cluster_tmp = l_tile[i*nfeatures+l];
+				float feature_tmp = p_feature[l];
+				float sub_tmp = feature_tmp - cluster_tmp;
+				ans += sub_tmp * sub_tmp;
+			}
+
+			if (ans < min_dist) {
+				min_dist = ans;
+				index    = c0 + i;
+			}
+		}
+	}
+
+	if (valid)
+		membership[point_id] = index;
+}
@@ -0,0 +1,70 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <float.h>
+#include <omp.h>
+#include "kmeans.h"
+
+#define AOCL_ALIGNMENT 64
+#include <malloc.h>
+
+float	min_rmse_ref = FLT_MAX;		
+	/* reference min_rmse value */
+
+/*---< cluster() >-----------------------------------------------------------*/
+void cluster(int      npoints,				/* number of data points */
+            int      nfeatures,				/* number of attributes for each point */
+            float  **features,				/* array: [npoints][nfeatures] */                  
+            int      nclusters,				/* range of min to max number of clusters */
+            float    threshold,				/* loop terminating factor */
+            float ***cluster_centres,		/* out: [best_nclusters][nfeatures] */
+			int		 nloops,				/* number of iteration for each number of clusters */
+			int		 nrestarts				/* independent restarts per loop */
+			)
+{    
+    int    *membership;						/* which cluster a data point belongs to */
+    float **tmp_cluster_centres;			/* hold coordinates of cluster centers */
+	int		i, batched;
+	float	stats[2][5];					/* serial, batched; see kmeans_clustering() */
+	
+	/* allocate memory for membership */
+	membership = (int*) _aligned_malloc(npoints * sizeof(int), AOCL_ALIGNMENT);
+
+	/* allocate device memory for nrestarts restarts, upload the features once */
+	allocate(npoints, nfeatures, nclusters, features, nrestarts);
+
+	/* iterate nloops times for each number of clusters */
+	for(i = 0; i < nloops; i++)
+	{
+		/* one restart per launch, then all restarts in one launch */
+		for(batched = 0; batched <= 1; batched++)
+		{
+			printf("\n================= %d restarts, %s =================\n", nrestarts, batched ? "batched" : "serial");
+			tmp_cluster_centres = kmeans_clustering(features,
+													nfeatures,
+													npoints,
+													nclusters,
+													threshold,
+													membership,
+													nrestarts,
+													batched ? nrestarts : 1,
+													stats[batched]);
+			if (*cluster_centres) {
+				_aligned_free((*cluster_centres)[0]);
+				_aligned_free(*cluster_centres);
+			}
+			*cluster_centres = tmp_cluster_centres;
+		}
+
+		printf("\n%-8s %12s %12s %8s %10s %10s\n", "mode", "time ms", "restarts/s", "best", "RMSE", "iterations");
+		for(batched = 0; batched <= 1; batched++)
+			printf("%-8s %12.3f %12.2f %8d %10.4f %10d\n", batched ? "batched" : "serial", stats[batched][0],
+				stats[batched][1], (int) stats[batched][2], stats[batched][3], (int) stats[batched][4]);
+		printf("speedup: %.2fx\n", stats[1][1] / stats[0][1]);
+	}		
+	deallocateMemory();						/* free device memory */
+	
+    _aligned_free(membership);
+}
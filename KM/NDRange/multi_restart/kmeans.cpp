@@ -0,0 +1,392 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <iostream>
+#include <string>
+#include "kmeans.h"
+#include "timer.h"
+
+#include <windows.h>
+
+#define AOCL_ALIGNMENT 64
+#include <malloc.h>
+
+#ifndef FLT_MAX
+#define FLT_MAX 3.40282347e+38
+#endif
+#ifdef RD_WG_SIZE_0_0
+        #define BLOCK_SIZE RD_WG_SIZE_0_0
+#elif defined(RD_WG_SIZE_0)
+        #define BLOCK_SIZE RD_WG_SIZE_0
+#elif defined(RD_WG_SIZE)
+        #define BLOCK_SIZE RD_WG_SIZE
+#else
+        #define BLOCK_SIZE 256
+#endif
+#ifdef RD_WG_SIZE_1_0
+     #define BLOCK_SIZE2 RD_WG_SIZE_1_0
+#elif defined(RD_WG_SIZE_1)
+     #define BLOCK_SIZE2 RD_WG_SIZE_1
+#elif defined(RD_WG_SIZE)
+     #define BLOCK_SIZE2 RD_WG_SIZE
+#else
+     #define BLOCK_SIZE2 256
+#endif
+
+#include <CL/cl.h>
+#include <fstream>
+#include <iostream>
+
+#include "CL/opencl.h"
+#include "AOCLUtils/aocl_utils.h"
+
+using namespace aocl_utils;
+
+// Allocation error checking
+#define ERR_1(v1)                                                                                                      \
+    if(v1 == NULL) {                                                                                                   \
+        fprintf(stderr, "Allocation error at %s, %d\n", __FILE__, __LINE__);                                           \
+        exit(-1);                                                                                                      \
+    }
+#define ERR_2(v1,v2) ERR_1(v1) ERR_1(v2)
+#define ERR_3(v1,v2,v3) ERR_2(v1,v2) ERR_1(v3)
+#define ERR_4(v1,v2,v3,v4) ERR_3(v1,v2,v3) ERR_1(v4)
+#define ERR_5(v1,v2,v3,v4,v5) ERR_4(v1,v2,v3,v4) ERR_1(v5)
+#define ERR_6(v1,v2,v3,v4,v5,v6) ERR_5(v1,v2,v3,v4,v5) ERR_1(v6)
+#define GET_ERR_MACRO(_1,_2,_3,_4,_5,_6,NAME,...) NAME
+#define ALLOC_ERR(...) GET_ERR_MACRO(__VA_ARGS__,ERR_6,ERR_5,ERR_4,ERR_3,ERR_2,ERR_1)(__VA_ARGS__)
+
+#define CL_ERR()                                                                                                       \
+    if(clStatus != CL_SUCCESS) {                                                                                       \
+        fprintf(stderr, "OpenCL error: %d\n at %s, %d\n", clStatus, __FILE__, __LINE__);                               \
+        exit(-1);                                                                                                      \
+    }
+
+
+
+// local variables
+static cl_context	    clContext;
+static cl_command_queue clCommandQueue;
+static cl_program       clProgram;
+static cl_kernel        clKernel;
+static cl_kernel        clKernelReduce;
+static cl_device_id		clDeviceID;
+
+Timer timer;
+
+static int shutdown()
+{
+	// release resources
+	if( clKernel ) clReleaseKernel( clKernel );
+	if( clKernelReduce ) clReleaseKernel( clKernelReduce );
+	if( clProgram ) clReleaseProgram( clProgram );
+	if( clCommandQueue ) clReleaseCommandQueue( clCommandQueue );
+	if( clContext ) clReleaseContext( clContext );
+	// reset all variables
+	clCommandQueue = 0;
+	clContext = 0;
+	return 0;
+}
+
+
+cl_mem d_feature;
+cl_mem d_cluster;
+cl_mem d_membership;
+cl_mem d_active;
+cl_mem d_partial_centers;
+cl_mem d_partial_len;
+cl_mem d_partial_delta;
+cl_mem d_partial_cost;
+cl_mem d_delta;
+cl_mem d_cost;
+
+// Work-group size of the kernels, must match WG_SIZE in multi_restart.cl
+#define WG_SIZE 128
+static int n_groups;
+static int max_restarts;
+
+int   *membership_init;		/* [max_restarts][npoints], all -1 */
+int   *h_active;
+int   *h_delta;
+
+extern int check_output;
+
+
+int allocate(int n_points, int n_features, int n_clusters, float **feature, int n_restarts)
+{
+	cl_int  clStatus;
+
+
+	// Get the OpenCL platform.
+	cl_platform_id clPlatform = NULL;
+	clPlatform = findPlatform("Intel(R) FPGA");
+	if(clPlatform == NULL) {
+		printf("ERROR: Unable to find Intel(R) FPGA OpenCL platform.\n");
+	}
+
+
+	// Query the available OpenCL device.
+    cl_uint clNumDevices;
+    clStatus = clGetDeviceIDs(clPlatform, CL_DEVICE_TYPE_ALL, 0, NULL, &clNumDevices);
+    CL_ERR();
+    cl_device_id *clDevices = new cl_device_id[clNumDevices];
+    clStatus                = clGetDeviceIDs(clPlatform, CL_DEVICE_TYPE_ALL, clNumDevices, clDevices, NULL);
+    CL_ERR();
+
+	printf("Platform: %s\n",getPlatformName(clPlatform).c_str());
+	printf("Using %d device(s)\n",clNumDevices);
+	for(unsigned i = 0; i < clNumDevices; ++i) {
+		printf("  %s\n", getDeviceName(clDevices[i]).c_str());
+	}
+
+
+	// Create the context.
+	clContext = clCreateContext(NULL, clNumDevices, clDevices, &oclContextCallback, NULL, &clStatus);
+    CL_ERR();
+    char device_name_[100];
+    clGetDeviceInfo(clDevices[0], CL_DEVICE_NAME, 100, &device_name_, NULL);
+    clDeviceID = clDevices[0];
+    fprintf(stderr, "%s\t", device_name_);
+	
+	
+	// create command queue for the first device
+	clCommandQueue = clCreateCommandQueue( clContext, clDevices[0], 0, &clStatus );
+	CL_ERR();
+
+
+	// Create the program.
+	std::string binary_file = getBoardBinaryFile("multi_restart", clDeviceID);
+	printf("\nUsing AOCX:%s\n",binary_file.c_str());
+	clProgram = createProgramFromBinary(clContext, binary_file.c_str(), &clDeviceID, 1);	
+	CL_ERR();
+
+
+    char clOptions[50];
+    sprintf(clOptions, "-I.");
+
+	// Build the program that was just created.
+    clStatus = clBuildProgram(clProgram, 0, NULL, "", NULL, NULL);  
+    if(clStatus == CL_BUILD_PROGRAM_FAILURE) {
+        // Determine the size of the log
+        size_t log_size;
+        clGetProgramBuildInfo(clProgram, clDevices[0], CL_PROGRAM_BUILD_LOG, 0, NULL, &log_size);
+        // Allocate memory for the log
+        char *log = (char *)malloc(log_size);
+        // Get the log
+        clGetProgramBuildInfo(clProgram, clDevices[0], CL_PROGRAM_BUILD_LOG, log_size, log, NULL);
+        // Print the log
+        fprintf(stderr, "%s\t", log);
+    }
+    CL_ERR();
+
+
+	// Kernel.
+    clKernel  = clCreateKernel(clProgram, "kmeans_kernel_c", &clStatus);
+    CL_ERR();
+    clKernelReduce = clCreateKernel(clProgram, "kmeans_reduce", &clStatus);
+    CL_ERR();
+
+
+
+	if(n_clusters > WG_SIZE) {
+		printf("Error: nclusters(%d) > work-group size(%d) -- cannot proceed\n", n_clusters, WG_SIZE);
+		exit(0);
+	}
+	n_groups     = (n_points + WG_SIZE - 1) / WG_SIZE;
+	max_restarts = n_restarts;
+
+
+	// Features are uploaded once and shared by every restart
+	d_feature    = clCreateBuffer(clContext, CL_MEM_READ_ONLY, n_points * n_features * sizeof(float), NULL, 0 );
+	d_cluster    = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_restarts * n_clusters * n_features * sizeof(float), NULL, 0 );
+	d_membership = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_restarts * n_points * sizeof(int), NULL, 0 );
+	d_active     = clCreateBuffer(clContext, CL_MEM_READ_ONLY, n_restarts * sizeof(int), NULL, 0 );
+
+	// Per-group partial results are laid out with the compile-time stride NUM_CLUSTERS of the kernel
+	d_partial_centers = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_restarts * n_groups * WG_SIZE * n_features * sizeof(float), NULL, 0 );
+	d_partial_len     = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_restarts * n_groups * WG_SIZE * sizeof(int), NULL, 0 );
+	d_partial_delta   = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_restarts * n_groups * sizeof(int), NULL, 0 );
+	d_partial_cost    = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_restarts * n_groups * sizeof(float), NULL, 0 );
+	d_delta           = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_restarts * sizeof(int), NULL, 0 );
+	d_cost            = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_restarts * sizeof(float), NULL, 0 );
+
+
+	//write buffers
+	clStatus = clEnqueueWriteBuffer(clCommandQueue, d_feature, 1, 0, n_points * n_features * sizeof(float), feature[0], 0, 0, 0);
+	CL_ERR();
+
+	membership_init = (int*) _aligned_malloc(n_restarts * n_points * sizeof(int), AOCL_ALIGNMENT);
+	h_active        = (int*) _aligned_malloc(n_restarts * sizeof(int), AOCL_ALIGNMENT);
+	h_delta         = (int*) _aligned_malloc(n_restarts * sizeof(int), AOCL_ALIGNMENT);
+	ALLOC_ERR(membership_init, h_active, h_delta);
+	for (int i = 0; i < n_restarts * n_points; i++)
+		membership_init[i] = -1;
+
+	delete [] clDevices;
+	return 0;
+}
+
+
+void deallocateMemory()
+{
+	clReleaseMemObject(d_feature);
+	clReleaseMemObject(d_cluster);
+	clReleaseMemObject(d_membership);
+	clReleaseMemObject(d_active);
+	clReleaseMemObject(d_partial_centers);
+	clReleaseMemObject(d_partial_len);
+	clReleaseMemObject(d_partial_delta);
+	clReleaseMemObject(d_partial_cost);
+	clReleaseMemObject(d_delta);
+	clReleaseMemObject(d_cost);
+	_aligned_free(membership_init);
+	_aligned_free(h_active);
+	_aligned_free(h_delta);
+}
+
+
+int main( int argc, char** argv) 
+{
+	setup(argc, argv);
+	shutdown();
+}
+
+
+/*---< kmeansBatchOCL() >----------------------------------------------------*/
+/* Runs n_restarts independent k-means to convergence over the resident
+   features, one assignment and one reduction launch per iteration for the
+   whole batch. A restart stops when its changed-point count drops to the
+   threshold; the batch stops when every restart has (or at 500 iterations).
+   Returns the number of iterations of the batch. */
+int	kmeansBatchOCL(int     n_features,
+           int     n_points,
+           int     n_clusters,
+           int     n_restarts,
+           float   threshold,
+		   float  *clusters,		/* in/out: [n_restarts][n_clusters][n_features] */
+		   int    *iterations,		/* out: [n_restarts] */
+		   float  *cost,			/* out: [n_restarts], sum of squared distances */
+		   float  *time)			/* out: [assignment, reduction] in ms, summed over iterations */
+{ 
+	int     c = 0, running = n_restarts;
+	cl_int  clStatus;
+
+	if (n_restarts > max_restarts) {
+		printf("Error: nrestarts(%d) > allocated(%d) -- cannot proceed\n", n_restarts, max_restarts);
+		exit(0);
+	}
+
+	for (int r = 0; r < n_restarts; r++)
+		h_active[r] = 1;
+
+	clStatus = clEnqueueWriteBuffer(clCommandQueue, d_cluster, 1, 0, n_restarts * n_clusters * n_features * sizeof(float), clusters, 0, 0, 0);
+	CL_ERR();
+	clStatus = clEnqueueWriteBuffer(clCommandQueue, d_membership, 1, 0, n_restarts * n_points * sizeof(int), membership_init, 0, 0, 0);
+	CL_ERR();
+	clStatus = clEnqueueWriteBuffer(clCommandQueue, d_active, 1, 0, n_restarts * sizeof(int), h_active, 0, 0, 0);
+	CL_ERR();
+	clFinish(clCommandQueue);
+
+	time[0] = time[1] = 0.0f;
+
+	do {
+		timer.start("Kernel");
+
+		clSetKernelArg(clKernel, 0, sizeof(void *), (void*) &d_feature);
+		clSetKernelArg(clKernel, 1, sizeof(void *), (void*) &d_cluster);
+		clSetKernelArg(clKernel, 2, sizeof(void *), (void*) &d_membership);
+		clSetKernelArg(clKernel, 3, sizeof(void *), (void*) &d_active);
+		clSetKernelArg(clKernel, 4, sizeof(void *), (void*) &d_partial_centers);
+		clSetKernelArg(clKernel, 5, sizeof(void *), (void*) &d_partial_len);
+		clSetKernelArg(clKernel, 6, sizeof(void *), (void*) &d_partial_delta);
+		clSetKernelArg(clKernel, 7, sizeof(void *), (void*) &d_partial_cost);
+		clSetKernelArg(clKernel, 8, sizeof(cl_int), (void*) &n_points);
+		clSetKernelArg(clKernel, 9, sizeof(cl_int), (void*) &n_clusters);
+		clSetKernelArg(clKernel, 10, sizeof(cl_int), (void*) &n_restarts);
+
+		size_t gs[1] = {(size_t)n_groups * WG_SIZE};
+		size_t ls[1] = {(size_t)WG_SIZE};
+
+		clStatus = clEnqueueNDRangeKernel(clCommandQueue, clKernel, 1, NULL, gs, ls, 0, 0, 0);
+		CL_ERR();
+		clFinish(clCommandQueue);
+
+		timer.stop("Kernel");
+		time[0] += timer.getTime("Kernel");
+
+
+		timer.start("Reduction");
+
+		clSetKernelArg(clKernelReduce, 0, sizeof(void *), (void*) &d_partial_centers);
+		clSetKernelArg(clKernelReduce, 1, sizeof(void *), (void*) &d_partial_len);
+		clSetKernelArg(clKernelReduce, 2, sizeof(void *), (void*) &d_partial_delta);
+		clSetKernelArg(clKernelReduce, 3, sizeof(void *), (void*) &d_partial_cost);
+		clSetKernelArg(clKernelReduce, 4, sizeof(void *), (void*) &d_cluster);
+		clSetKernelArg(clKernelReduce, 5, sizeof(void *), (void*) &d_active);
+		clSetKernelArg(clKernelReduce, 6, sizeof(void *), (void*) &d_delta);
+		clSetKernelArg(clKernelReduce, 7, sizeof(void *), (void*) &d_cost);
+		clSetKernelArg(clKernelReduce, 8, sizeof(cl_int), (void*) &n_groups);
+		clSetKernelArg(clKernelReduce, 9, sizeof(cl_int), (void*) &n_clusters);
+
+		size_t gs_reduce[1] = {(size_t)n_restarts * WG_SIZE};
+		size_t ls_reduce[1] = {(size_t)WG_SIZE};
+
+		clStatus = clEnqueueNDRangeKernel(clCommandQueue, clKernelReduce, 1, NULL, gs_reduce, ls_reduce, 0, 0, 0);
+		CL_ERR();
+
+		/* only the per-restart counts come back every iteration */
+		clStatus = clEnqueueReadBuffer(clCommandQueue, d_delta, 1, 0, n_restarts * sizeof(int), h_delta, 0, 0, 0);
+		CL_ERR();
+
+		timer.stop("Reduction");
+		time[1] += timer.getTime("Reduction");
+
+		c++;
+		int retired = 0;
+		for (int r = 0; r < n_restarts; r++) {
+			if (h_active[r] && (h_delta[r] <= threshold || c > 500)) {
+				h_active[r]   = 0;
+				iterations[r] = c;
+				running--;
+				retired = 1;
+			}
+		}
+		if (retired && running) {
+			clStatus = clEnqueueWriteBuffer(clCommandQueue, d_active, 1, 0, n_restarts * sizeof(int), h_active, 0, 0, 0);
+			CL_ERR();
+		}
+	} while (running);
+
+	clStatus = clEnqueueReadBuffer(clCommandQueue, d_cluster, 1, 0, n_restarts * n_clusters * n_features * sizeof(float), clusters, 0, 0, 0);
+	CL_ERR();
+	clStatus = clEnqueueReadBuffer(clCommandQueue, d_cost, 1, 0, n_restarts * sizeof(float), cost, 0, 0, 0);
+	CL_ERR();
+
+	return c;
+}
+
+
+/* Membership of one restart of the last batch; checks it against
+   output/output.txt when the input is input/input.txt and the restart used
+   the first-k seeds */
+void getMembershipOCL(int restart, int n_points, int *membership, int check)
+{
+	cl_int  clStatus;
+
+	clStatus = clEnqueueReadBuffer(clCommandQueue, d_membership, 1, restart * n_points * sizeof(int), n_points * sizeof(int), membership, 0, 0, 0);
+	CL_ERR();
+
+	if (check && check_output) {
+		int temp;
+		FILE *fp = fopen("output/output.txt", "r");
+		for(int i = 0; i < n_points; i++){
+			fscanf(fp, "%d", &temp);
+			if(membership[i] != temp){
+				printf("failed!!\n");
+				break;
+			}
+		}
+		printf("pass!!\n");
+	}
+}
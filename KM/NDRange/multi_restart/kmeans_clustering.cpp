@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+#include <omp.h>
+#include "kmeans.h"
+#include "AOCLUtils/aocl_utils.h"
+
+#define AOCL_ALIGNMENT 64
+#include <malloc.h>
+
+/* xorshift64*, rand() only has 15 bits on MSVC */
+static unsigned long long rng_state;
+
+static unsigned int rng_next()
+{
+	rng_state ^= rng_state >> 12;
+	rng_state ^= rng_state << 25;
+	rng_state ^= rng_state >> 27;
+	return (unsigned int) ((rng_state * 2685821657736338717ULL) >> 32);
+}
+
+/* Initial centres of restart r. Restart 0 takes the first nclusters points,
+   like every other design, so its result can be checked against
+   output/output.txt; the others take nclusters distinct random points. */
+static void seed_restart(float **feature, int nfeatures, int npoints, int nclusters, int r, float *clusters, int *initial)
+{
+	int i, n, temp, initial_points = npoints;
+
+	for (i = 0; i < npoints; i++)
+		initial[i] = i;
+	rng_state = 88172645463325252ULL + r;
+
+	for (i = 0; i < nclusters; i++) {
+		n = r == 0 ? i : i + (int) (rng_next() % (unsigned int) (initial_points - i));
+		memcpy(clusters + i * nfeatures, feature[initial[n]], nfeatures * sizeof(float));
+		/* move the pick out of the remaining range */
+		temp = initial[n];
+		initial[n] = initial[i];
+		initial[i] = temp;
+	}
+}
+
+/*----< kmeans_clustering() >---------------------------------------------*/
+/* Runs nrestarts independent k-means, batch restarts per device launch,
+   and keeps the one with the lowest RMSE. */
+float** kmeans_clustering(float **feature,    /* in: [npoints][nfeatures] */
+                          int     nfeatures,
+                          int     npoints,
+                          int     nclusters,
+                          float   threshold,
+                          int    *membership, /* out: [npoints] of the best restart */
+                          int     nrestarts,
+                          int     batch,      /* restarts per launch */
+                          float  *stats)      /* out: [ms, restarts/s, best restart, best RMSE, iterations] */
+{    
+    int      i;
+    float  **clusters;			/* out: [nclusters][nfeatures] */
+	float	*all_clusters;		/* [nrestarts][nclusters][nfeatures] */
+	float	*cost;				/* [nrestarts] */
+	int		*iterations;		/* [nrestarts] */
+	int		*initial;
+	float	 time[2];
+	float	 total_time = 0.0, total_reduce_time = 0.0;
+	int		 total_iterations = 0;
+	int		 best = -1;
+
+	/* nclusters should never be > npoints
+	   that would guarantee a cluster without points */
+	if (nclusters > npoints)
+		nclusters = npoints;
+	/* allocate space for and initialize returning variable clusters[] */
+	clusters    = (float**) _aligned_malloc(nclusters *             sizeof(float*), AOCL_ALIGNMENT);
+	clusters[0] = (float*)  _aligned_malloc(nclusters * nfeatures * sizeof(float), AOCL_ALIGNMENT);
+    for (i=1; i<nclusters; i++)
+        clusters[i] = clusters[i-1] + nfeatures;
+
+	all_clusters = (float*) _aligned_malloc(nrestarts * nclusters * nfeatures * sizeof(float), AOCL_ALIGNMENT);
+	cost         = (float*) _aligned_malloc(nrestarts * sizeof(float), AOCL_ALIGNMENT);
+	iterations   = (int*)   _aligned_malloc(nrestarts * sizeof(int), AOCL_ALIGNMENT);
+	initial      = (int*)   _aligned_malloc(npoints * sizeof(int), AOCL_ALIGNMENT);
+
+	for (i = 0; i < nrestarts; i++)
+		seed_restart(feature, nfeatures, npoints, nclusters, i, all_clusters + i * nclusters * nfeatures, initial);
+
+	const double start_time = aocl_utils::getCurrentTimestamp();
+
+	for (int first = 0; first < nrestarts; first += batch) {
+		int count = nrestarts - first < batch ? nrestarts - first : batch;
+
+		total_iterations += kmeansBatchOCL(nfeatures, npoints, nclusters, count, threshold,
+										   all_clusters + first * nclusters * nfeatures,
+										   iterations + first, cost + first, time);
+		total_time += time[0];
+		total_reduce_time += time[1];
+
+		/* the membership of a batch is only resident until the next one */
+		if (first == 0)
+			getMembershipOCL(0, npoints, membership, 1);
+		int batch_best = first;
+		for (i = first; i < first + count; i++)
+			if (cost[i] < cost[batch_best])
+				batch_best = i;
+		if (best < 0 || cost[batch_best] < cost[best]) {
+			best = batch_best;
+			if (best != 0)
+				getMembershipOCL(best - first, npoints, membership, 0);
+		}
+	}
+
+	const double end_time = aocl_utils::getCurrentTimestamp();
+
+	for (i = 0; i < nrestarts; i++)
+		printf("restart %2d: iterated %3d times, RMSE %.4f\n", i, iterations[i], sqrtf(cost[i] / npoints));
+	printf("Kernel Time (ms): %0.3f\n", total_time);
+	printf("Reduction Time (ms): %0.3f\n", total_reduce_time);
+
+	memcpy(clusters[0], all_clusters + best * nclusters * nfeatures, nclusters * nfeatures * sizeof(float));
+	stats[0] = (float) ((end_time - start_time) * 1e3);
+	stats[1] = (float) (nrestarts / (end_time - start_time));
+	stats[2] = (float) best;
+	stats[3] = sqrtf(cost[best] / npoints);
+	stats[4] = (float) total_iterations;
+
+	_aligned_free(all_clusters);
+	_aligned_free(cost);
+	_aligned_free(iterations);
+	_aligned_free(initial);
+    return clusters;
+}
+
+
@@ -0,0 +1,199 @@
+#ifndef FLT_MAX
+#define FLT_MAX 3.40282347e+38
+#endif
+#define NUM_CLUSTERS 128
+#define NUM_FEATURE  8
+#define WG_SIZE      128
+
+// Batched restarts. Every work-item reads its point once and assigns it
+// under each of the nrestarts independent centroid sets, so the feature
+// traffic is shared by all restarts of the batch. Per restart r the kernel
+// keeps its own membership and emits the same per-group partial sums,
+// counts and changed points as device_reduce, plus the partial cost.
+// Restarts with active[r] == 0 have converged and are skipped.
+// Requires nclusters <= NUM_CLUSTERS <= WG_SIZE.
+__kernel
+__attribute((reqd_work_group_size(WG_SIZE,1,1)))
+void kmeans_kernel_c(__global float  *restrict feature,
+			  __global float  *restrict clusters,			/* [nrestarts][nclusters][NUM_FEATURE] */
+			  __global int    *restrict membership,			/* [nrestarts][npoints] */
+			  __global int    *restrict active,				/* [nrestarts] */
+			  __global float  *restrict partial_centers,	/* [nrestarts][ngroups][NUM_CLUSTERS][NUM_FEATURE] */
+			  __global int    *restrict partial_len,		/* [nrestarts][ngroups][NUM_CLUSTERS] */
+			  __global int    *restrict partial_delta,		/* [nrestarts][ngroups] */
+			  __global float  *restrict partial_cost,		/* [nrestarts][ngroups] */
+			    int     npoints,
+				int     nclusters,
+				int     nrestarts ) {
+
+	unsigned int point_id = get_global_id(0);
+	unsigned int local_id = get_local_id(0);
+	unsigned int group_id = get_group_id(0);
+	unsigned int ngroups  = get_num_groups(0);
+
+	__local float l_clusters[NUM_CLUSTERS*NUM_FEATURE];
+	__local float l_points[WG_SIZE*NUM_FEATURE];
+	__local int   l_index[WG_SIZE];
+	__local int   l_changed[WG_SIZE];
+	__local float l_cost[WG_SIZE];
+
+	// The last work-group may be partial: padded work-items carry no point
+	bool valid = point_id < npoints;
+
+	// The point is loaded once for all restarts
+	float p_feature[NUM_FEATURE];
+	#pragma unroll
+	for (int l = 0; l < NUM_FEATURE; l++){
+		p_feature[l] = valid ? feature[point_id * NUM_FEATURE + l] : 0.0f;
+		l_points[local_id*NUM_FEATURE+l] = p_feature[l];
+	}
+
+	for (int r = 0; r < nrestarts; r++) {
+
+		// uniform across the work-group, so the barriers below are safe
+		if (!active[r])
+			continue;
+
+		if (local_id < nclusters){
+			#pragma unroll
+			for (int l = 0; l < NUM_FEATURE; l++)
+				l_clusters[local_id*NUM_FEATURE+l] = clusters[(r*nclusters + local_id)*NUM_FEATURE + l];
+		}
+
+	    barrier(CLK_LOCAL_MEM_FENCE);
+
+		float min_dist = FLT_MAX;
+	    int   index    = 0;
+
+		#pragma unroll 8
+		for (int i=0; i < nclusters; i++) {
+
+			float ans  = 0;
+
+			#pragma unroll
+			for (int l = 0; l < NUM_FEATURE; l++){
+				float cluster_tmp = l_clusters[i*NUM_FEATURE+l];
+				float feature_tmp = p_feature[l];
+				float sub_tmp = feature_tmp - cluster_tmp;
+				ans += sub_tmp * sub_tmp;
+			}
+
+			if (ans < min_dist) {
+				min_dist = ans;
+				index    = i;
+			}
+		}
+
+		int changed = 0;
+		if (valid) {
+			changed = (membership[r*npoints + point_id] != index);
+			membership[r*npoints + point_id] = index;
+		} else {
+			index    = -1;
+			min_dist = 0.0f;
+		}
+
+		// Stage the assignment of this work-group in local memory
+		l_index[local_id]   = index;
+		l_changed[local_id] = changed;
+		l_cost[local_id]    = min_dist;
+
+	    barrier(CLK_LOCAL_MEM_FENCE);
+
+		// Work-item c accumulates cluster c over the points of this work-group
+		if (local_id < nclusters){
+
+			float sum[NUM_FEATURE];
+			int   len = 0;
+			#pragma unroll
+			for (int l = 0; l < NUM_FEATURE; l++)
+				sum[l] = 0.0f;
+
+			for (int j = 0; j < WG_SIZE; j++){
+				if (l_index[j] == local_id){
+					len++;
+					#pragma unroll
+					for (int l = 0; l < NUM_FEATURE; l++)
+						sum[l] += l_points[j*NUM_FEATURE+l];
+				}
+			}
+
+			#pragma unroll
+			for (int l = 0; l < NUM_FEATURE; l++)
+				partial_centers[((r*ngroups + group_id)*NUM_CLUSTERS + local_id)*NUM_FEATURE + l] = sum[l];
+			partial_len[(r*ngroups + group_id)*NUM_CLUSTERS + local_id] = len;
+		}
+
+		if (local_id == 0){
+			int   delta = 0;
+			float cost  = 0;
+			for (int j = 0; j < WG_SIZE; j++){
+				delta += l_changed[j];
+				cost  += l_cost[j];
+			}
+			partial_delta[r*ngroups + group_id] = delta;
+			partial_cost[r*ngroups + group_id]  = cost;
+		}
+
+		// l_clusters and l_index are reused by the next restart
+	    barrier(CLK_LOCAL_MEM_FENCE);
+	}
+}
+
+
+// Reduction kernel, one work-group per restart and one work-item per
+// cluster. Folds the partial sums of restart r and writes its new centres
+// in place; work-item 0 also folds the changed points and the cost of the
+// assignment. Converged restarts are left untouched.
+__kernel
+__attribute((reqd_work_group_size(WG_SIZE,1,1)))
+void kmeans_reduce(__global float  *restrict partial_centers,
+			  __global int    *restrict partial_len,
+			  __global int    *restrict partial_delta,
+			  __global float  *restrict partial_cost,
+			  __global float  *restrict clusters,
+			  __global int    *restrict active,
+			  __global int    *restrict delta,			/* [nrestarts] */
+			  __global float  *restrict cost,			/* [nrestarts] */
+			    int     ngroups,
+				int     nclusters ) {
+
+	unsigned int cluster_id = get_local_id(0);
+	unsigned int r          = get_group_id(0);
+
+	if (!active[r])
+		return;
+
+	if (cluster_id < nclusters){
+
+		float sum[NUM_FEATURE];
+		int   len = 0;
+		#pragma unroll
+		for (int l = 0; l < NUM_FEATURE; l++)
+			sum[l] = 0.0f;
+
+		for (int g = 0; g < ngroups; g++){
+			len += partial_len[(r*ngroups + g)*NUM_CLUSTERS + cluster_id];
+			#pragma unroll
+			for (int l = 0; l < NUM_FEATURE; l++)
+				sum[l] += partial_centers[((r*ngroups + g)*NUM_CLUSTERS + cluster_id)*NUM_FEATURE + l];
+		}
+
+		if (len > 0){
+			#pragma unroll
+			for (int l = 0; l < NUM_FEATURE; l++)
+				clusters[(r*nclusters + cluster_id)*NUM_FEATURE + l] = sum[l] / len;
+		}
+	}
+
+	if (cluster_id == 0){
+		int   d = 0;
+		float c = 0;
+		for (int g = 0; g < ngroups; g++){
+			d += partial_delta[r*ngroups + g];
+			c += partial_cost[r*ngroups + g];
+		}
+		delta[r] = d;
+		cost[r]  = c;
+	}
+}
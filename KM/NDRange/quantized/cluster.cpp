@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <float.h>
+#include <omp.h>
+#include "kmeans.h"
+
+#define AOCL_ALIGNMENT 64
+#include <malloc.h>
+
+static float **alloc_2d(int rows, int cols)
+{
+	float **a = (float**) _aligned_malloc(rows * sizeof(float*), AOCL_ALIGNMENT);
+	a[0]      = (float*)  _aligned_malloc(rows * cols * sizeof(float), AOCL_ALIGNMENT);
+	for (int i = 1; i < rows; i++)
+		a[i] = a[i-1] + cols;
+	return a;
+}
+
+static void free_2d(float **a)
+{
+	_aligned_free(a[0]);
+	_aligned_free(a);
+}
+
+/* RMSE of an assignment, always measured on the float features */
+static float assignment_rmse(float **features, int nfeatures, int npoints, float **centres, int *membership)
+{
+	double sum = 0.0;
+	for (int i = 0; i < npoints; i++)
+		for (int l = 0; l < nfeatures; l++) {
+			float d = features[i][l] - centres[membership[i]][l];
+			sum += d * d;
+		}
+	return (float) sqrt(sum / npoints);
+}
+
+static int agreement(int *a, int *b, int npoints)
+{
+	int agree = 0;
+	for (int i = 0; i < npoints; i++)
+		agree += (a[i] == b[i]);
+	return agree;
+}
+
+/*---< cluster() >-----------------------------------------------------------*/
+/* Clusters the same data with the FP32, FP16 and INT16 assignment kernels
+   from the same first-k seeds. Besides speed, every narrow format reports
+   how many points it assigns like FP32 in a single pass over the final FP32
+   centres, which isolates the precision loss, and how many final labels
+   match after its own convergence, which also includes the drift of the
+   whole trajectory. */
+void cluster(int      npoints,				/* number of data points */
+            int      nfeatures,				/* number of attributes for each point */
+            float  **features,				/* array: [npoints][nfeatures] */                  
+            int      nclusters,				/* number of clusters */
+            float    threshold,				/* loop terminating factor */
+            float ***cluster_centres,		/* out: [nclusters][nfeatures], FP32 result */
+			int		 nloops,				/* number of runs of each format */
+			km_quantizer *q					/* codes of the int16 format */
+			)
+{    
+	int		i, j, f;
+    int    *membership;						/* which cluster a data point belongs to */
+	int    *membership_ref;					/* converged FP32 membership */
+	int    *single_pass;					/* one pass over the FP32 centres */
+	float **view;							/* features as seen by the current format */
+	float **centres;
+	float **centres_ref;
+	int		iterations[NUM_FORMATS];
+	int		agree_pass[NUM_FORMATS];
+	int		agree_final[NUM_FORMATS];
+	float	kernel_ms[NUM_FORMATS];
+	float	rmse[NUM_FORMATS];
+	float	time;
+
+	membership     = (int*) _aligned_malloc(npoints * sizeof(int), AOCL_ALIGNMENT);
+	membership_ref = (int*) _aligned_malloc(npoints * sizeof(int), AOCL_ALIGNMENT);
+	single_pass    = (int*) _aligned_malloc(npoints * sizeof(int), AOCL_ALIGNMENT);
+	view           = alloc_2d(npoints, nfeatures);
+	centres        = alloc_2d(nclusters, nfeatures);
+	centres_ref    = alloc_2d(nclusters, nfeatures);
+
+	/* allocate device memory, upload every format once */
+	allocate(npoints, nfeatures, nclusters, features, q);
+
+	/* FP32 runs first: it is the reference of the narrow formats */
+	for (f = 0; f < NUM_FORMATS; f++)
+	{
+		printf("\n================= %s =================\n", format_name[f]);
+		feature_view(f, q, features, nfeatures, npoints, view);
+
+		for (i = 0; i < nloops; i++)
+		{
+			/* the first nclusters points, as in the baseline */
+			for (j = 0; j < nclusters; j++)
+				memcpy(centres[j], features[j], nfeatures * sizeof(float));
+			iterations[f] = kmeans_clustering(view, nfeatures, npoints, nclusters, threshold,
+											  membership, centres, f, q, &kernel_ms[f]);
+		}
+		rmse[f] = assignment_rmse(features, nfeatures, npoints, centres, membership);
+
+		if (f == FORMAT_F32) {
+			memcpy(membership_ref, membership, npoints * sizeof(int));
+			memcpy(centres_ref[0], centres[0], nclusters * nfeatures * sizeof(float));
+		}
+
+		kmeansOCL(f, nfeatures, npoints, nclusters, single_pass, centres_ref, q, &time);
+		agree_pass[f]  = agreement(single_pass, membership_ref, npoints);
+		agree_final[f] = agreement(membership, membership_ref, npoints);
+	}
+	deallocateMemory();						/* free device memory */
+
+	printf("\n%-6s %10s %6s %11s %12s %10s %14s %14s\n",
+		   "format", "bytes/pt", "iters", "kernel ms", "Mpoints/s", "rmse", "1-pass agree", "final agree");
+	for (f = 0; f < NUM_FORMATS; f++)
+		printf("%-6s %10d %6d %11.3f %12.2f %10.4f %13.3f%% %13.3f%%\n",
+			   format_name[f], nfeatures * format_bytes[f], iterations[f], kernel_ms[f],
+			   kernel_ms[f] > 0.0f ? npoints / (kernel_ms[f] * 1e3) : 0.0,
+			   rmse[f], 100.0 * agree_pass[f] / npoints, 100.0 * agree_final[f] / npoints);
+
+	if (*cluster_centres)
+		free_2d(*cluster_centres);
+	*cluster_centres = centres_ref;
+
+	free_2d(centres);
+	free_2d(view);
+	_aligned_free(single_pass);
+	_aligned_free(membership_ref);
+    _aligned_free(membership);
+}
@@ -0,0 +1,286 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <iostream>
+#include <string>
+#include "kmeans.h"
+#include "timer.h"
+
+#include <windows.h>
+
+#define AOCL_ALIGNMENT 64
+#include <malloc.h>
+
+#ifndef FLT_MAX
+#define FLT_MAX 3.40282347e+38
+#endif
+#ifdef RD_WG_SIZE_0_0
+        #define BLOCK_SIZE RD_WG_SIZE_0_0
+#elif defined(RD_WG_SIZE_0)
+        #define BLOCK_SIZE RD_WG_SIZE_0
+#elif defined(RD_WG_SIZE)
+        #define BLOCK_SIZE RD_WG_SIZE
+#else
+        #define BLOCK_SIZE 256
+#endif
+#ifdef RD_WG_SIZE_1_0
+     #define BLOCK_SIZE2 RD_WG_SIZE_1_0
+#elif defined(RD_WG_SIZE_1)
+     #define BLOCK_SIZE2 RD_WG_SIZE_1
+#elif defined(RD_WG_SIZE)
+     #define BLOCK_SIZE2 RD_WG_SIZE
+#else
+     #define BLOCK_SIZE2 256
+#endif
+
+#include <CL/cl.h>
+#include <fstream>
+#include <iostream>
+
+#include "CL/opencl.h"
+#include "AOCLUtils/aocl_utils.h"
+
+using namespace aocl_utils;
+
+// Allocation error checking
+#define ERR_1(v1)                                                                                                      \
+    if(v1 == NULL) {                                                                                                   \
+        fprintf(stderr, "Allocation error at %s, %d\n", __FILE__, __LINE__);                                           \
+        exit(-1);                                                                                                      \
+    }
+#define ERR_2(v1,v2) ERR_1(v1) ERR_1(v2)
+#define ERR_3(v1,v2,v3) ERR_2(v1,v2) ERR_1(v3)
+#define ERR_4(v1,v2,v3,v4) ERR_3(v1,v2,v3) ERR_1(v4)
+#define ERR_5(v1,v2,v3,v4,v5) ERR_4(v1,v2,v3,v4) ERR_1(v5)
+#define ERR_6(v1,v2,v3,v4,v5,v6) ERR_5(v1,v2,v3,v4,v5) ERR_1(v6)
+#define GET_ERR_MACRO(_1,_2,_3,_4,_5,_6,NAME,...) NAME
+#define ALLOC_ERR(...) GET_ERR_MACRO(__VA_ARGS__,ERR_6,ERR_5,ERR_4,ERR_3,ERR_2,ERR_1)(__VA_ARGS__)
+
+#define CL_ERR()                                                                                                       \
+    if(clStatus != CL_SUCCESS) {                                                                                       \
+        fprintf(stderr, "OpenCL error: %d\n at %s, %d\n", clStatus, __FILE__, __LINE__);                               \
+        exit(-1);                                                                                                      \
+    }
+
+
+
+// local variables
+static cl_context	    clContext;
+static cl_command_queue clCommandQueue;
+static cl_program       clProgram;
+static cl_kernel        clKernel[NUM_FORMATS];
+static cl_device_id		clDeviceID;
+
+static const char *kernel_name[NUM_FORMATS] = { "kmeans_assign_f32", "kmeans_assign_f16", "kmeans_assign_i16" };
+
+Timer timer;
+
+static int shutdown()
+{
+	// release resources
+	for (int f = 0; f < NUM_FORMATS; f++)
+		if( clKernel[f] ) clReleaseKernel( clKernel[f] );
+	if( clProgram ) clReleaseProgram( clProgram );
+	if( clCommandQueue ) clReleaseCommandQueue( clCommandQueue );
+	if( clContext ) clReleaseContext( clContext );
+	// reset all variables
+	clCommandQueue = 0;
+	clContext = 0;
+	return 0;
+}
+
+
+cl_mem d_feature[NUM_FORMATS];		/* one resident copy per storage format */
+cl_mem d_cluster;
+cl_mem d_cluster_i16;
+cl_mem d_membership;
+
+// Work-group size of the assignment kernels, must match WG_SIZE in quantized.cl
+#define WG_SIZE 128
+static int n_groups;
+
+short *clusters_i16;
+
+
+int allocate(int n_points, int n_features, int n_clusters, float **feature, km_quantizer *q)
+{
+	cl_int  clStatus;
+
+
+	// Get the OpenCL platform.
+	cl_platform_id clPlatform = NULL;
+	clPlatform = findPlatform("Intel(R) FPGA");
+	if(clPlatform == NULL) {
+		printf("ERROR: Unable to find Intel(R) FPGA OpenCL platform.\n");
+	}
+
+
+	// Query the available OpenCL device.
+    cl_uint clNumDevices;
+    clStatus = clGetDeviceIDs(clPlatform, CL_DEVICE_TYPE_ALL, 0, NULL, &clNumDevices);
+    CL_ERR();
+    cl_device_id *clDevices = new cl_device_id[clNumDevices];
+    clStatus                = clGetDeviceIDs(clPlatform, CL_DEVICE_TYPE_ALL, clNumDevices, clDevices, NULL);
+    CL_ERR();
+
+	printf("Platform: %s\n",getPlatformName(clPlatform).c_str());
+	printf("Using %d device(s)\n",clNumDevices);
+	for(unsigned i = 0; i < clNumDevices; ++i) {
+		printf("  %s\n", getDeviceName(clDevices[i]).c_str());
+	}
+
+
+	// Create the context.
+	clContext = clCreateContext(NULL, clNumDevices, clDevices, &oclContextCallback, NULL, &clStatus);
+    CL_ERR();
+    char device_name_[100];
+    clGetDeviceInfo(clDevices[0], CL_DEVICE_NAME, 100, &device_name_, NULL);
+    clDeviceID = clDevices[0];
+    fprintf(stderr, "%s\t", device_name_);
+	
+	
+	// create command queue for the first device
+	clCommandQueue = clCreateCommandQueue( clContext, clDevices[0], 0, &clStatus );
+	CL_ERR();
+
+
+	// Create the program.
+	std::string binary_file = getBoardBinaryFile("quantized", clDeviceID);
+	printf("\nUsing AOCX:%s\n",binary_file.c_str());
+	clProgram = createProgramFromBinary(clContext, binary_file.c_str(), &clDeviceID, 1);	
+	CL_ERR();
+
+
+	// Build the program that was just created.
+    clStatus = clBuildProgram(clProgram, 0, NULL, "", NULL, NULL);  
+    if(clStatus == CL_BUILD_PROGRAM_FAILURE) {
+        // Determine the size of the log
+        size_t log_size;
+        clGetProgramBuildInfo(clProgram, clDevices[0], CL_PROGRAM_BUILD_LOG, 0, NULL, &log_size);
+        // Allocate memory for the log
+        char *log = (char *)malloc(log_size);
+        // Get the log
+        clGetProgramBuildInfo(clProgram, clDevices[0], CL_PROGRAM_BUILD_LOG, log_size, log, NULL);
+        // Print the log
+        fprintf(stderr, "%s\t", log);
+    }
+    CL_ERR();
+
+
+	// Kernels, one per feature format.
+	for (int f = 0; f < NUM_FORMATS; f++) {
+		clKernel[f] = clCreateKernel(clProgram, kernel_name[f], &clStatus);
+		CL_ERR();
+	}
+
+	if(n_clusters > WG_SIZE) {
+		printf("Error: nclusters(%d) > work-group size(%d) -- cannot proceed\n", n_clusters, WG_SIZE);
+		exit(0);
+	}
+	n_groups = (n_points + WG_SIZE - 1) / WG_SIZE;
+
+
+	for (int f = 0; f < NUM_FORMATS; f++) {
+		d_feature[f] = clCreateBuffer(clContext, CL_MEM_READ_ONLY, n_points * n_features * format_bytes[f], NULL, &clStatus);
+		CL_ERR();
+	}
+	d_cluster     = clCreateBuffer(clContext, CL_MEM_READ_ONLY, n_clusters * n_features * sizeof(float), NULL, 0 );
+	d_cluster_i16 = clCreateBuffer(clContext, CL_MEM_READ_ONLY, n_clusters * n_features * sizeof(short), NULL, 0 );
+	d_membership  = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_points * sizeof(int), NULL, 0 );
+
+
+	// Narrow copies are encoded once on the host; every format is uploaded once
+	unsigned short *feature_f16 = (unsigned short*) _aligned_malloc(n_points * n_features * sizeof(short), AOCL_ALIGNMENT);
+	short          *feature_i16 = (short*)          _aligned_malloc(n_points * n_features * sizeof(short), AOCL_ALIGNMENT);
+	ALLOC_ERR(feature_f16, feature_i16);
+	for(int j = 0; j < n_points; j ++){
+		for(int i = 0; i < n_features; i ++){
+			feature_f16[j * n_features + i] = float_to_half(feature[j][i]);
+			feature_i16[j * n_features + i] = quantize(q, i, feature[j][i]);
+		}
+	}
+
+	//write buffers
+	clStatus = clEnqueueWriteBuffer(clCommandQueue, d_feature[FORMAT_F32], 1, 0, n_points * n_features * sizeof(float), feature[0], 0, 0, 0);
+	CL_ERR();
+	clStatus = clEnqueueWriteBuffer(clCommandQueue, d_feature[FORMAT_F16], 1, 0, n_points * n_features * sizeof(short), feature_f16, 0, 0, 0);
+	CL_ERR();
+	clStatus = clEnqueueWriteBuffer(clCommandQueue, d_feature[FORMAT_I16], 1, 0, n_points * n_features * sizeof(short), feature_i16, 0, 0, 0);
+	CL_ERR();
+
+	_aligned_free(feature_f16);
+	_aligned_free(feature_i16);
+
+	clusters_i16 = (short*) _aligned_malloc(n_clusters * n_features * sizeof(short), AOCL_ALIGNMENT);
+	ALLOC_ERR(clusters_i16);
+	return 0;
+}
+
+
+void deallocateMemory()
+{
+	for (int f = 0; f < NUM_FORMATS; f++)
+		clReleaseMemObject(d_feature[f]);
+	clReleaseMemObject(d_cluster);
+	clReleaseMemObject(d_cluster_i16);
+	clReleaseMemObject(d_membership);
+	_aligned_free(clusters_i16);
+}
+
+
+int main( int argc, char** argv) 
+{
+	setup(argc, argv);
+	shutdown();
+}
+
+
+/* One assignment pass in the given feature format. Only the centres go
+   down and the membership comes back; the update is done by the host. */
+void	kmeansOCL(int     format,		/* FORMAT_F32, FORMAT_F16 or FORMAT_I16 */
+           int     n_features,
+           int     n_points,
+           int     n_clusters,
+           int    *membership,		/* out: [npoints] */
+		   float **clusters,		/* in: [nclusters][nfeatures] */
+		   km_quantizer *q,			/* codes of the int16 format */
+		   float   *time)			/* out: kernel time in ms */
+{ 
+	cl_int  clStatus;
+
+	/* int16 centres are quantised with the scale and offsets of the features */
+	if (format == FORMAT_I16) {
+		for (int i = 0; i < n_clusters; i++)
+			for (int l = 0; l < n_features; l++)
+				clusters_i16[i * n_features + l] = quantize(q, l, clusters[i][l]);
+		clStatus = clEnqueueWriteBuffer(clCommandQueue, d_cluster_i16, 1, 0, n_clusters * n_features * sizeof(short), clusters_i16, 0, 0, 0);
+	} else {
+		clStatus = clEnqueueWriteBuffer(clCommandQueue, d_cluster, 1, 0, n_clusters * n_features * sizeof(float), clusters[0], 0, 0, 0);
+	}
+	CL_ERR();
+
+
+	timer.start("Kernel");
+
+	cl_kernel kernel = clKernel[format];
+	clSetKernelArg(kernel, 0, sizeof(void *), (void*) &d_feature[format]);
+	clSetKernelArg(kernel, 1, sizeof(void *), (void*) (format == FORMAT_I16 ? &d_cluster_i16 : &d_cluster));
+	clSetKernelArg(kernel, 2, sizeof(void *), (void*) &d_membership);
+	clSetKernelArg(kernel, 3, sizeof(cl_int), (void*) &n_points);
+	clSetKernelArg(kernel, 4, sizeof(cl_int), (void*) &n_clusters);
+
+	size_t gs[1] = {(size_t)n_groups * WG_SIZE}; 
+	size_t ls[1] = {(size_t)WG_SIZE}; 
+
+	clStatus = clEnqueueNDRangeKernel(clCommandQueue, kernel, 1, NULL, gs, ls, 0, 0, 0);
+	CL_ERR();
+	clFinish(clCommandQueue);
+
+	timer.stop("Kernel");
+	time[0] = timer.getTime("Kernel");
+
+
+	clStatus = clEnqueueReadBuffer(clCommandQueue, d_membership, 1, 0, n_points * sizeof(int), membership, 0, 0, 0);
+	CL_ERR();
+}
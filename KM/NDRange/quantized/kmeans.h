@@ -0,0 +1,44 @@
+#ifndef _H_FUZZY_KMEANS
+#define _H_FUZZY_KMEANS
+
+#ifndef FLT_MAX
+#define FLT_MAX 3.40282347e+38
+#endif
+
+/* feature storage formats, one assignment kernel each */
+#define FORMAT_F32  0
+#define FORMAT_F16  1
+#define FORMAT_I16  2
+#define NUM_FORMATS 3
+
+/* Linear quantiser of the int16 format. All features share one scale so
+   that squared distances between codes stay proportional to the real ones;
+   each feature has its own offset. */
+typedef struct {
+	int     bits;		/* code width, 2..16 */
+	float   scale;		/* feature units per code step */
+	float  *offset;		/* [nfeatures]: value of the lowest code */
+} km_quantizer;
+
+/* rmse.c */
+float   euclid_dist_2        (float*, float*, int);
+int     find_nearest_point   (float* , int, float**, int);
+float	rms_err(float**, int, int, float**, int);
+void    cluster(int, int, float**, int, float, float***, int, km_quantizer*);
+int setup(int argc, char** argv);
+int allocate(int npoints, int nfeatures, int nclusters, float **feature, km_quantizer *q);
+void deallocateMemory();
+void	kmeansOCL(int format, int nfeatures, int npoints, int nclusters, int *membership, float **clusters, km_quantizer *q, float *time);
+int     kmeans_clustering(float **view, int nfeatures, int npoints, int nclusters, float threshold, int *membership, float **clusters, int format, km_quantizer *q, float *kernel_time);
+
+/* quantizer.cpp */
+extern const char *format_name[];
+extern const int   format_bytes[];
+void    quantizer_fit(km_quantizer *q, float **feature, int nfeatures, int npoints, int bits, float scale);
+short   quantize(km_quantizer *q, int l, float x);
+float   dequantize(km_quantizer *q, int l, short code);
+unsigned short float_to_half(float x);
+float   half_to_float(unsigned short h);
+void    feature_view(int format, km_quantizer *q, float **feature, int nfeatures, int npoints, float **view);
+
+#endif
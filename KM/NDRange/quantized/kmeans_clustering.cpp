@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <float.h>
+#include <math.h>
+#include <omp.h>
+#include "kmeans.h"
+#include "AOCLUtils/aocl_utils.h"
+
+#define AOCL_ALIGNMENT 64
+#include <malloc.h>
+
+/*----< kmeans_clustering() >---------------------------------------------*/
+/* Lloyd iterations with the assignment in the given feature format. The new
+   centres are the means of view[], the features decoded from that format,
+   so the run sees exactly the data a narrow device copy holds. Returns the
+   number of iterations. */
+int kmeans_clustering(float **view,       /* in: [npoints][nfeatures], decoded */
+                      int     nfeatures,
+                      int     npoints,
+                      int     nclusters,
+                      float   threshold,
+                      int    *membership, /* out: [npoints] */
+                      float **clusters,   /* in: seeds, out: [nclusters][nfeatures] */
+                      int     format,
+                      km_quantizer *q,
+                      float  *kernel_time) /* out: mean kernel time in ms */
+{    
+    int      i, j, index;
+	int		 loop=0;
+    float    delta;				/* if the point moved */
+    int     *new_membership;
+    int     *new_centers_len;	/* [nclusters]: no. of points in each cluster */
+    float  **new_centers;		/* [nclusters][nfeatures] */
+	int		 c = 0;
+	float	 time;
+	float	 total_time;
+
+	new_membership  = (int*)    _aligned_malloc(npoints * sizeof(int), AOCL_ALIGNMENT);
+	new_centers_len = (int*)    _aligned_malloc(nclusters * sizeof(int), AOCL_ALIGNMENT);
+	new_centers     = (float**) _aligned_malloc(nclusters * sizeof(float*), AOCL_ALIGNMENT);
+	new_centers[0]  = (float*)  _aligned_malloc(nclusters * nfeatures * sizeof(float), AOCL_ALIGNMENT);
+	for (i=1; i<nclusters; i++)
+		new_centers[i] = new_centers[i-1] + nfeatures;
+
+	/* initialize the membership to -1 for all */
+    for (i=0; i < npoints; i++)
+	  membership[i] = -1;
+
+	total_time = 0.0;
+
+	/* iterate until convergence */
+	do {
+        delta = 0.0;
+		kmeansOCL(format, nfeatures, npoints, nclusters, new_membership, clusters, q, &time);
+		total_time += time;
+
+		for (i = 0; i < nclusters; i++) {
+			new_centers_len[i] = 0;
+			for (j = 0; j < nfeatures; j++)
+				new_centers[i][j] = 0.0f;
+		}
+		for (i = 0; i < npoints; i++) {
+			index = new_membership[i];
+			if (membership[i] != index)
+				delta += 1.0f;
+			membership[i] = index;
+			new_centers_len[index]++;
+			for (j = 0; j < nfeatures; j++)
+				new_centers[index][j] += view[i][j];
+		}
+
+		/* clusters without points keep their previous centre */
+		for (i = 0; i < nclusters; i++) {
+			if (new_centers_len[i] > 0)
+				for (j = 0; j < nfeatures; j++)
+					clusters[i][j] = new_centers[i][j] / new_centers_len[i];
+		}
+		c++;
+    } while ((delta > threshold) && (loop++ < 500));	/* makes sure loop terminates */
+	
+	printf("%s: iterated %d times\n", format_name[format], c);
+	printf("%s: Kernel Time (ms): %0.3f\n", format_name[format], total_time / c);
+
+	kernel_time[0] = total_time / c;
+
+	_aligned_free(new_centers[0]);
+	_aligned_free(new_centers);
+	_aligned_free(new_centers_len);
+	_aligned_free(new_membership);
+    return c;
+}
@@ -0,0 +1,181 @@
+#ifndef FLT_MAX
+#define FLT_MAX 3.40282347e+38
+#endif
+#define NUM_CLUSTERS 128
+#define NUM_FEATURE  8
+#define WG_SIZE      128
+
+// Assignment kernels for three feature storage formats. All three keep one
+// point per work-item and the centroid table in local memory, and differ
+// only in how features are stored and how the distance is accumulated.
+// Requires nclusters <= NUM_CLUSTERS <= WG_SIZE.
+
+
+// FP32 reference.
+__kernel
+__attribute((reqd_work_group_size(WG_SIZE,1,1)))
+void kmeans_assign_f32(__global const float *restrict feature,	/* [npoints][NUM_FEATURE] */
+			  __global const float *restrict clusters,				/* [nclusters][NUM_FEATURE] */
+			  __global int         *restrict membership,
+			    int     npoints,
+				int     nclusters ) {
+
+	unsigned int point_id = get_global_id(0);
+	unsigned int local_id = get_local_id(0);
+    int index = 0;
+
+	__local float l_clusters[NUM_CLUSTERS*NUM_FEATURE];
+
+	if (local_id < nclusters){
+		#pragma unroll
+		for (int l = 0; l < NUM_FEATURE; l++)
+			l_clusters[local_id*NUM_FEATURE+l] = clusters[local_id*NUM_FEATURE+l];
+	}
+
+	bool valid = point_id < npoints;
+
+	float p_feature[NUM_FEATURE];
+	#pragma unroll
+	for (int l = 0; l < NUM_FEATURE; l++){
+		p_feature[l] = valid ? feature[point_id * NUM_FEATURE + l] : 0.0f;
+	}
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+	float min_dist = FLT_MAX;
+
+	#pragma unroll 8
+	for (int i=0; i < nclusters; i++) {
+
+		float ans  = 0;
+
+		#pragma unroll
+		for (int l = 0; l < NUM_FEATURE; l++){
+			float sub_tmp = p_feature[l] - l_clusters[i*NUM_FEATURE+l];
+			ans += sub_tmp * sub_tmp;
+		}
+
+		if (ans < min_dist) {
+			min_dist = ans;
+			index    = i;
+		}
+	}
+
+	if (valid)
+		membership[point_id] = index;
+}
+
+
+// FP16 storage: features are stored as half and widened to float on load
+// (vload_half needs no cl_khr_fp16), so feature traffic is halved while the
+// centres, differences and the accumulator stay FP32.
+__kernel
+__attribute((reqd_work_group_size(WG_SIZE,1,1)))
+void kmeans_assign_f16(__global const half  *restrict feature,	/* [npoints][NUM_FEATURE] */
+			  __global const float *restrict clusters,				/* [nclusters][NUM_FEATURE] */
+			  __global int         *restrict membership,
+			    int     npoints,
+				int     nclusters ) {
+
+	unsigned int point_id = get_global_id(0);
+	unsigned int local_id = get_local_id(0);
+    int index = 0;
+
+	__local float l_clusters[NUM_CLUSTERS*NUM_FEATURE];
+
+	if (local_id < nclusters){
+		#pragma unroll
+		for (int l = 0; l < NUM_FEATURE; l++)
+			l_clusters[local_id*NUM_FEATURE+l] = clusters[local_id*NUM_FEATURE+l];
+	}
+
+	bool valid = point_id < npoints;
+
+	float p_feature[NUM_FEATURE];
+	#pragma unroll
+	for (int l = 0; l < NUM_FEATURE; l++){
+		p_feature[l] = valid ? vload_half(point_id * NUM_FEATURE + l, feature) : 0.0f;
+	}
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+	float min_dist = FLT_MAX;
+
+	#pragma unroll 8
+	for (int i=0; i < nclusters; i++) {
+
+		float ans  = 0;
+
+		#pragma unroll
+		for (int l = 0; l < NUM_FEATURE; l++){
+			float sub_tmp = p_feature[l] - l_clusters[i*NUM_FEATURE+l];
+			ans += sub_tmp * sub_tmp;
+		}
+
+		if (ans < min_dist) {
+			min_dist = ans;
+			index    = i;
+		}
+	}
+
+	if (valid)
+		membership[point_id] = index;
+}
+
+
+// Fixed-point storage: features and centres are 16-bit codes of the host
+// quantiser (one scale for all features, so the metric is preserved).
+// Differences are 32-bit and squares are summed in a 64-bit accumulator,
+// which cannot overflow for codes of up to 16 bits.
+__kernel
+__attribute((reqd_work_group_size(WG_SIZE,1,1)))
+void kmeans_assign_i16(__global const short *restrict feature,	/* [npoints][NUM_FEATURE] */
+			  __global const short *restrict clusters,				/* [nclusters][NUM_FEATURE] */
+			  __global int         *restrict membership,
+			    int     npoints,
+				int     nclusters ) {
+
+	unsigned int point_id = get_global_id(0);
+	unsigned int local_id = get_local_id(0);
+    int index = 0;
+
+	__local short l_clusters[NUM_CLUSTERS*NUM_FEATURE];
+
+	if (local_id < nclusters){
+		#pragma unroll
+		for (int l = 0; l < NUM_FEATURE; l++)
+			l_clusters[local_id*NUM_FEATURE+l] = clusters[local_id*NUM_FEATURE+l];
+	}
+
+	bool valid = point_id < npoints;
+
+	int p_feature[NUM_FEATURE];
+	#pragma unroll
+	for (int l = 0; l < NUM_FEATURE; l++){
+		p_feature[l] = valid ? feature[point_id * NUM_FEATURE + l] : 0;
+	}
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+	ulong min_dist = 0xFFFFFFFFFFFFFFFFUL;
+
+	#pragma unroll 8
+	for (int i=0; i < nclusters; i++) {
+
+		ulong ans  = 0;
+
+		#pragma unroll
+		for (int l = 0; l < NUM_FEATURE; l++){
+			uint sub_tmp = abs(p_feature[l] - (int) l_clusters[i*NUM_FEATURE+l]);
+			ans += (ulong) (sub_tmp * sub_tmp);	// < 2^32 for 16-bit codes
+		}
+
+		if (ans < min_dist) {
+			min_dist = ans;
+			index    = i;
+		}
+	}
+
+	if (valid)
+		membership[point_id] = index;
+}
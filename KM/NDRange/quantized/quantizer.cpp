@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+#include "kmeans.h"
+
+const char *format_name[]  = { "fp32", "fp16", "int16" };
+const int   format_bytes[] = { 4, 2, 2 };	/* per feature */
+
+/*----< quantizer_fit() >--------------------------------------------------*/
+/* Fits the offsets to the per-feature minimum. With scale <= 0 the scale is
+   fitted too, so that the widest feature range spans all 2^bits codes;
+   otherwise the given scale (e.g. the sensor resolution) is kept and values
+   outside the code range are clamped. */
+void quantizer_fit(km_quantizer *q, float **feature, int nfeatures, int npoints, int bits, float scale)
+{
+	float range = 0.0f;
+
+	q->bits   = bits;
+	q->offset = (float*) malloc(nfeatures * sizeof(float));
+
+	for (int l = 0; l < nfeatures; l++) {
+		float lo = FLT_MAX, hi = -FLT_MAX;
+		for (int i = 0; i < npoints; i++) {
+			lo = fminf(lo, feature[i][l]);
+			hi = fmaxf(hi, feature[i][l]);
+		}
+		q->offset[l] = lo;
+		range = fmaxf(range, hi - lo);
+	}
+
+	if (scale > 0.0f)
+		q->scale = scale;
+	else
+		q->scale = range > 0.0f ? range / ((1 << bits) - 1) : 1.0f;
+
+	printf("quantizer: %d bits, scale %g\n", q->bits, q->scale);
+}
+
+/* Codes are centred on zero so that 16-bit codes fit a short */
+short quantize(km_quantizer *q, int l, float x)
+{
+	int levels = 1 << q->bits;
+	int code   = (int) floorf((x - q->offset[l]) / q->scale + 0.5f);
+
+	if (code < 0)
+		code = 0;
+	if (code > levels - 1)
+		code = levels - 1;
+	return (short) (code - levels / 2);
+}
+
+float dequantize(km_quantizer *q, int l, short code)
+{
+	return (code + (1 << q->bits) / 2) * q->scale + q->offset[l];
+}
+
+/* IEEE 754 binary16 conversion with round to nearest even */
+unsigned short float_to_half(float x)
+{
+	unsigned int   f;
+	memcpy(&f, &x, sizeof(f));
+	unsigned short sign = (unsigned short) ((f >> 16) & 0x8000);
+	int            exp  = (int) ((f >> 23) & 0xFF) - 127 + 15;
+	unsigned int   mant = f & 0x7FFFFF;
+
+	if (((f >> 23) & 0xFF) == 0xFF)							/* inf, nan */
+		return sign | 0x7C00 | (mant ? 0x200 : 0);
+	if (exp >= 31)											/* overflow */
+		return sign | 0x7C00;
+	if (exp <= 0) {											/* subnormal or zero */
+		if (exp < -10)
+			return sign;
+		mant |= 0x800000;
+		unsigned int shift = 14 - exp;
+		unsigned int half  = mant >> shift;
+		unsigned int rest  = mant & ((1u << shift) - 1);
+		unsigned int mid   = 1u << (shift - 1);
+		if (rest > mid || (rest == mid && (half & 1)))
+			half++;
+		return sign | (unsigned short) half;
+	}
+
+	unsigned int half = ((unsigned int) exp << 10) | (mant >> 13);
+	unsigned int rest = mant & 0x1FFF;
+	if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+		half++;												/* may carry into the exponent, which is right */
+	return sign | (unsigned short) half;
+}
+
+float half_to_float(unsigned short h)
+{
+	unsigned int sign = (unsigned int) (h & 0x8000) << 16;
+	unsigned int exp  = (h >> 10) & 0x1F;
+	unsigned int mant = h & 0x3FF;
+	unsigned int f;
+
+	if (exp == 0x1F) {
+		f = sign | 0x7F800000 | (mant << 13);
+	} else if (exp == 0) {
+		if (mant == 0) {
+			f = sign;
+		} else {											/* normalise the subnormal */
+			exp = 127 - 15 + 1;
+			while (!(mant & 0x400)) {
+				mant <<= 1;
+				exp--;
+			}
+			f = sign | (exp << 23) | ((mant & 0x3FF) << 13);
+		}
+	} else {
+		f = sign | ((exp - 15 + 127) << 23) | (mant << 13);
+	}
+
+	float x;
+	memcpy(&x, &f, sizeof(x));
+	return x;
+}
+
+/* The features as the kernel of the given format sees them, back in float:
+   the host reduction averages these, as a device holding only the narrow
+   copy would. view[] must hold npoints rows of nfeatures. */
+void feature_view(int format, km_quantizer *q, float **feature, int nfeatures, int npoints, float **view)
+{
+	for (int i = 0; i < npoints; i++) {
+		for (int l = 0; l < nfeatures; l++) {
+			float x = feature[i][l];
+			if (format == FORMAT_F16)
+				x = half_to_float(float_to_half(x));
+			else if (format == FORMAT_I16)
+				x = dequantize(q, l, quantize(q, l, x));
+			view[i][l] = x;
+		}
+	}
+}
@@ -0,0 +1,356 @@
+#ifndef FLT_MAX
+#define FLT_MAX 3.40282347e+38
+#endif
+#define NUM_CLUSTERS 128
+#define NUM_FEATURE  8
+
+// Device side of CPU/device co-execution. The device takes the points
+// [0, ndev) of every iteration and the host CPU the rest; ndev is chosen by
+// the host each iteration. The slice is split over the four compute kernels
+// as in 1-4_transpose_ul8-1-1, with the remainder going to kernel 3. Each
+// compute kernel also accumulates the per-cluster sums, counts and changed
+// points of its quarter, so the host only merges 4 partial results with
+// its own instead of re-reading the features.
+
+	channel float8 c_feature[4];
+
+__kernel 
+void kmeans_in(__global float  *restrict feature,
+				int     ndev ) {
+
+	int size = ndev / 4;
+	for (int i = 0; i < size; i ++){
+
+		write_channel_altera(c_feature[0], ((__global float8*)feature)[i]);
+		write_channel_altera(c_feature[1], ((__global float8*)feature)[i + size]);
+		write_channel_altera(c_feature[2], ((__global float8*)feature)[i + 2 * size]);
+		write_channel_altera(c_feature[3], ((__global float8*)feature)[i + 3 * size]);
+
+	}
+
+	// remainder of the slice, in order after the quarter of kernel 3
+	for (int i = 4 * size; i < ndev; i ++){
+		write_channel_altera(c_feature[3], ((__global float8*)feature)[i]);
+	}
+}
+
+
+__kernel 
+void kmeans_kernel_0(__global float  *restrict clusters,
+				__global int    *restrict membership,
+				__global float  *restrict partial_centers,	/* [4][NUM_CLUSTERS][NUM_FEATURE] */
+				__global int    *restrict partial_len,		/* [4][NUM_CLUSTERS] */
+				__global int    *restrict partial_delta,	/* [4] */
+			    int     ndev,
+				int     nclusters,
+				int     nfeatures ) {
+
+	int index = 0;
+	int delta = 0;
+
+	float l_clusters[NUM_CLUSTERS*NUM_FEATURE];
+	float l_sums[NUM_CLUSTERS*NUM_FEATURE];
+	int   l_len[NUM_CLUSTERS];
+	for (int i = 0; i < nclusters * nfeatures; i ++){
+		l_clusters[i] = clusters[i];
+		l_sums[i]     = 0.0f;
+	}
+	for (int i = 0; i < nclusters; i ++){
+		l_len[i] = 0;
+	}
+
+	int cut1 = ndev / 4;
+	for (int point_id = 0; point_id < cut1; point_id ++) {
+	
+		float p_feature[NUM_FEATURE];
+		float8 f = read_channel_altera(c_feature[0]);
+		p_feature[0] = f.s0;
+		p_feature[1] = f.s1;
+		p_feature[2] = f.s2;
+		p_feature[3] = f.s3;
+		p_feature[4] = f.s4;
+		p_feature[5] = f.s5;
+		p_feature[6] = f.s6;
+		p_feature[7] = f.s7;
+		
+		float min_dist = FLT_MAX;
+			
+		for (int i=0; i < nclusters; i++) {
+				
+			float dist = 0;
+			float ans  = 0;
+
+			#pragma unroll 8
+			for (int l = 0; l < nfeatures; l++){
+				float cluster_tmp = l_clusters[i*nfeatures+l];
+				float feature_tmp = p_feature[l];
+				float sub_tmp = feature_tmp - cluster_tmp;
+				ans += sub_tmp * sub_tmp; 
+			}
+
+			dist = ans;
+			if (dist < min_dist) {
+				min_dist = dist;
+				index    = i;	
+			}
+		}
+
+		delta += (membership[point_id] != index);
+		membership[point_id] = index;
+
+		l_len[index]++;
+		#pragma unroll 8
+		for (int l = 0; l < nfeatures; l++){
+			l_sums[index*nfeatures+l] += p_feature[l];
+		}
+	}	 
+
+	for (int i = 0; i < nclusters * nfeatures; i ++){
+		partial_centers[0 * NUM_CLUSTERS * NUM_FEATURE + i] = l_sums[i];
+	}
+	for (int i = 0; i < nclusters; i ++){
+		partial_len[0 * NUM_CLUSTERS + i] = l_len[i];
+	}
+	partial_delta[0] = delta;
+}
+
+__kernel 
+void kmeans_kernel_1(__global float  *restrict clusters,
+				__global int    *restrict membership,
+				__global float  *restrict partial_centers,	/* [4][NUM_CLUSTERS][NUM_FEATURE] */
+				__global int    *restrict partial_len,		/* [4][NUM_CLUSTERS] */
+				__global int    *restrict partial_delta,	/* [4] */
+			    int     ndev,
+				int     nclusters,
+				int     nfeatures ) {
+
+	int index = 0;
+	int delta = 0;
+
+	float l_clusters[NUM_CLUSTERS*NUM_FEATURE];
+	float l_sums[NUM_CLUSTERS*NUM_FEATURE];
+	int   l_len[NUM_CLUSTERS];
+	for (int i = 0; i < nclusters * nfeatures; i ++){
+		l_clusters[i] = clusters[i];
+		l_sums[i]     = 0.0f;
+	}
+	for (int i = 0; i < nclusters; i ++){
+		l_len[i] = 0;
+	}
+
+	int cut1 = ndev / 4;
+	int cut2 = 2 * cut1;
+	for (int point_id = cut1; point_id < cut2; point_id ++) {
+	
+		float p_feature[NUM_FEATURE];
+		float8 f = read_channel_altera(c_feature[1]);
+		p_feature[0] = f.s0;
+		p_feature[1] = f.s1;
+		p_feature[2] = f.s2;
+		p_feature[3] = f.s3;
+		p_feature[4] = f.s4;
+		p_feature[5] = f.s5;
+		p_feature[6] = f.s6;
+		p_feature[7] = f.s7;
+		
+		float min_dist = FLT_MAX;
+			
+		for (int i=0; i < nclusters; i++) {
+				
+			float dist = 0;
+			float ans  = 0;
+
+			#pragma unroll 8
+			for (int l = 0; l < nfeatures; l++){
+				float cluster_tmp = l_clusters[i*nfeatures+l];
+				float feature_tmp = p_feature[l];
+				float sub_tmp = feature_tmp - cluster_tmp;
+				ans += sub_tmp * sub_tmp; 
+			}
+
+			dist = ans;
+			if (dist < min_dist) {
+				min_dist = dist;
+				index    = i;	
+			}
+		}
+
+		delta += (membership[point_id] != index);
+		membership[point_id] = index;
+
+		l_len[index]++;
+		#pragma unroll 8
+		for (int l = 0; l < nfeatures; l++){
+			l_sums[index*nfeatures+l] += p_feature[l];
+		}
+	}	 
+
+	for (int i = 0; i < nclusters * nfeatures; i ++){
+		partial_centers[1 * NUM_CLUSTERS * NUM_FEATURE + i] = l_sums[i];
+	}
+	for (int i = 0; i < nclusters; i ++){
+		partial_len[1 * NUM_CLUSTERS + i] = l_len[i];
+	}
+	partial_delta[1] = delta;
+}
+
+__kernel 
+void kmeans_kernel_2(__global float  *restrict clusters,
+				__global int    *restrict membership,
+				__global float  *restrict partial_centers,	/* [4][NUM_CLUSTERS][NUM_FEATURE] */
+				__global int    *restrict partial_len,		/* [4][NUM_CLUSTERS] */
+				__global int    *restrict partial_delta,	/* [4] */
+			    int     ndev,
+				int     nclusters,
+				int     nfeatures ) {
+
+	int index = 0;
+	int delta = 0;
+
+	float l_clusters[NUM_CLUSTERS*NUM_FEATURE];
+	float l_sums[NUM_CLUSTERS*NUM_FEATURE];
+	int   l_len[NUM_CLUSTERS];
+	for (int i = 0; i < nclusters * nfeatures; i ++){
+		l_clusters[i] = clusters[i];
+		l_sums[i]     = 0.0f;
+	}
+	for (int i = 0; i < nclusters; i ++){
+		l_len[i] = 0;
+	}
+
+	int cut1 = ndev / 4;
+	int cut2 = 2 * cut1;
+	int cut3 = 3 * cut1;
+	for (int point_id = cut2; point_id < cut3; point_id ++) {
+	
+		float p_feature[NUM_FEATURE];
+		float8 f = read_channel_altera(c_feature[2]);
+		p_feature[0] = f.s0;
+		p_feature[1] = f.s1;
+		p_feature[2] = f.s2;
+		p_feature[3] = f.s3;
+		p_feature[4] = f.s4;
+		p_feature[5] = f.s5;
+		p_feature[6] = f.s6;
+		p_feature[7] = f.s7;
+		
+		float min_dist = FLT_MAX;
+			
+		for (int i=0; i < nclusters; i++) {
+				
+			float dist = 0;
+			float ans  = 0;
+
+			#pragma unroll 8
+			for (int l = 0; l < nfeatures; l++){
+				float cluster_tmp = l_clusters[i*nfeatures+l];
+				float feature_tmp = p_feature[l];
+				float sub_tmp = feature_tmp - cluster_tmp;
+				ans += sub_tmp * sub_tmp; 
+			}
+
+			dist = ans;
+			if (dist < min_dist) {
+				min_dist = dist;
+				index    = i;	
+			}
+		}
+
+		delta += (membership[point_id] != index);
+		membership[point_id] = index;
+
+		l_len[index]++;
+		#pragma unroll 8
+		for (int l = 0; l < nfeatures; l++){
+			l_sums[index*nfeatures+l] += p_feature[l];
+		}
+	}	 
+
+	for (int i = 0; i < nclusters * nfeatures; i ++){
+		partial_centers[2 * NUM_CLUSTERS * NUM_FEATURE + i] = l_sums[i];
+	}
+	for (int i = 0; i < nclusters; i ++){
+		partial_len[2 * NUM_CLUSTERS + i] = l_len[i];
+	}
+	partial_delta[2] = delta;
+}
+
+__kernel 
+void kmeans_kernel_3(__global float  *restrict clusters,
+				__global int    *restrict membership,
+				__global float  *restrict partial_centers,	/* [4][NUM_CLUSTERS][NUM_FEATURE] */
+				__global int    *restrict partial_len,		/* [4][NUM_CLUSTERS] */
+				__global int    *restrict partial_delta,	/* [4] */
+			    int     ndev,
+				int     nclusters,
+				int     nfeatures ) {
+
+	int index = 0;
+	int delta = 0;
+
+	float l_clusters[NUM_CLUSTERS*NUM_FEATURE];
+	float l_sums[NUM_CLUSTERS*NUM_FEATURE];
+	int   l_len[NUM_CLUSTERS];
+	for (int i = 0; i < nclusters * nfeatures; i ++){
+		l_clusters[i] = clusters[i];
+		l_sums[i]     = 0.0f;
+	}
+	for (int i = 0; i < nclusters; i ++){
+		l_len[i] = 0;
+	}
+
+	int cut1 = ndev / 4;
+	int cut3 = 3 * cut1;
+	for (int point_id = cut3; point_id < ndev; point_id ++) {
+	
+		float p_feature[NUM_FEATURE];
+		float8 f = read_channel_altera(c_feature[3]);
+		p_feature[0] = f.s0;
+		p_feature[1] = f.s1;
+		p_feature[2] = f.s2;
+		p_feature[3] = f.s3;
+		p_feature[4] = f.s4;
+		p_feature[5] = f.s5;
+		p_feature[6] = f.s6;
+		p_feature[7] = f.s7;
+		
+		float min_dist = FLT_MAX;
+			
+		for (int i=0; i < nclusters; i++) {
+				
+			float dist = 0;
+			float ans  = 0;
+
+			#pragma unroll 8
+			for (int l = 0; l < nfeatures; l++){
+				float cluster_tmp = l_clusters[i*nfeatures+l];
+				float feature_tmp = p_feature[l];
+				float sub_tmp = feature_tmp - cluster_tmp;
+				ans += sub_tmp * sub_tmp; 
+			}
+
+			dist = ans;
+			if (dist < min_dist) {
+				min_dist = dist;
+				index    = i;	
+			}
+		}
+
+		delta += (membership[point_id] != index);
+		membership[point_id] = index;
+
+		l_len[index]++;
+		#pragma unroll 8
+		for (int l = 0; l < nfeatures; l++){
+			l_sums[index*nfeatures+l] += p_feature[l];
+		}
+	}	 
+
+	for (int i = 0; i < nclusters * nfeatures; i ++){
+		partial_centers[3 * NUM_CLUSTERS * NUM_FEATURE + i] = l_sums[i];
+	}
+	for (int i = 0; i < nclusters; i ++){
+		partial_len[3 * NUM_CLUSTERS + i] = l_len[i];
+	}
+	partial_delta[3] = delta;
+}
@@ -0,0 +1,100 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <omp.h>
+#include "kmeans.h"
+
+#define AOCL_ALIGNMENT 64
+#include <malloc.h>
+
+/*----< kmeans_assign_cpu() >---------------------------------------------*/
+/* CPU side of the co-execution: assigns the points [first, last) and adds
+   their sums and counts to new_centers / new_centers_len, exactly what the
+   device kernels emit for their slice. The centres are transposed to
+   [nfeatures][nclusters] so that the distances of one point to all centres
+   are computed with unit-stride vector operations over the clusters; per
+   centre the features are still summed in the order of the kernel, so both
+   sides pick the same nearest centre. Threads accumulate privately and
+   merge once. Returns the number of points whose membership changed. */
+int kmeans_assign_cpu(float **feature,		/* in: [npoints][nfeatures] */
+					  int     nfeatures,
+					  int     first,
+					  int     last,
+					  int     nclusters,
+					  float **clusters,		/* in: [nclusters][nfeatures] */
+					  int    *membership,	/* in/out: [npoints] */
+					  int    *new_centers_len,
+					  float **new_centers)
+{
+	int    delta = 0;
+	float *centres_t;
+
+	if (first >= last)
+		return 0;
+
+	centres_t = (float*) _aligned_malloc(nfeatures * nclusters * sizeof(float), AOCL_ALIGNMENT);
+	for (int k = 0; k < nclusters; k++)
+		for (int l = 0; l < nfeatures; l++)
+			centres_t[l * nclusters + k] = clusters[k][l];
+
+	#pragma omp parallel reduction(+:delta)
+	{
+		float *dist = (float*) _aligned_malloc(nclusters * sizeof(float), AOCL_ALIGNMENT);
+		float *sums = (float*) calloc(nclusters * nfeatures, sizeof(float));
+		int   *len  = (int*)   calloc(nclusters, sizeof(int));
+
+		#pragma omp for schedule(static)
+		for (int i = first; i < last; i++) {
+			const float *p = feature[i];
+
+			#pragma omp simd
+			for (int k = 0; k < nclusters; k++)
+				dist[k] = 0.0f;
+
+			for (int l = 0; l < nfeatures; l++) {
+				const float  x = p[l];
+				const float *c = centres_t + l * nclusters;
+				#pragma omp simd
+				for (int k = 0; k < nclusters; k++) {
+					float sub_tmp = x - c[k];
+					dist[k] += sub_tmp * sub_tmp;
+				}
+			}
+
+			/* first minimum, as in the kernel */
+			int   index    = 0;
+			float min_dist = FLT_MAX;
+			for (int k = 0; k < nclusters; k++) {
+				if (dist[k] < min_dist) {
+					min_dist = dist[k];
+					index    = k;
+				}
+			}
+
+			if (membership[i] != index) {
+				delta++;
+				membership[i] = index;
+			}
+			len[index]++;
+			for (int l = 0; l < nfeatures; l++)
+				sums[index * nfeatures + l] += p[l];
+		}
+
+		#pragma omp critical
+		{
+			for (int k = 0; k < nclusters; k++) {
+				new_centers_len[k] += len[k];
+				for (int l = 0; l < nfeatures; l++)
+					new_centers[k][l] += sums[k * nfeatures + l];
+			}
+		}
+
+		_aligned_free(dist);
+		free(sums);
+		free(len);
+	}
+
+	_aligned_free(centres_t);
+	return delta;
+}
@@ -0,0 +1,421 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <iostream>
+#include <string>
+#include "kmeans.h"
+#include "timer.h"
+
+#include <windows.h>
+
+#define AOCL_ALIGNMENT 64
+#include <malloc.h>
+
+#ifndef FLT_MAX
+#define FLT_MAX 3.40282347e+38
+#endif
+#ifdef RD_WG_SIZE_0_0
+        #define BLOCK_SIZE RD_WG_SIZE_0_0
+#elif defined(RD_WG_SIZE_0)
+        #define BLOCK_SIZE RD_WG_SIZE_0
+#elif defined(RD_WG_SIZE)
+        #define BLOCK_SIZE RD_WG_SIZE
+#else
+        #define BLOCK_SIZE 256
+#endif
+#ifdef RD_WG_SIZE_1_0
+     #define BLOCK_SIZE2 RD_WG_SIZE_1_0
+#elif defined(RD_WG_SIZE_1)
+     #define BLOCK_SIZE2 RD_WG_SIZE_1
+#elif defined(RD_WG_SIZE)
+     #define BLOCK_SIZE2 RD_WG_SIZE
+#else
+     #define BLOCK_SIZE2 256
+#endif
+
+#include <CL/cl.h>
+#include <fstream>
+#include <iostream>
+
+#include "CL/opencl.h"
+#include "AOCLUtils/aocl_utils.h"
+
+using namespace aocl_utils;
+
+// Allocation error checking
+#define ERR_1(v1)                                                                                                      \
+    if(v1 == NULL) {                                                                                                   \
+        fprintf(stderr, "Allocation error at %s, %d\n", __FILE__, __LINE__);                                           \
+        exit(-1);                                                                                                      \
+    }
+#define ERR_2(v1,v2) ERR_1(v1) ERR_1(v2)
+#define ERR_3(v1,v2,v3) ERR_2(v1,v2) ERR_1(v3)
+#define ERR_4(v1,v2,v3,v4) ERR_3(v1,v2,v3) ERR_1(v4)
+#define ERR_5(v1,v2,v3,v4,v5) ERR_4(v1,v2,v3,v4) ERR_1(v5)
+#define ERR_6(v1,v2,v3,v4,v5,v6) ERR_5(v1,v2,v3,v4,v5) ERR_1(v6)
+#define GET_ERR_MACRO(_1,_2,_3,_4,_5,_6,NAME,...) NAME
+#define ALLOC_ERR(...) GET_ERR_MACRO(__VA_ARGS__,ERR_6,ERR_5,ERR_4,ERR_3,ERR_2,ERR_1)(__VA_ARGS__)
+
+#define CL_ERR()                                                                                                       \
+    if(clStatus != CL_SUCCESS) {                                                                                       \
+        fprintf(stderr, "OpenCL error: %d\n at %s, %d\n", clStatus, __FILE__, __LINE__);                               \
+        exit(-1);                                                                                                      \
+    }
+
+
+// local variables
+static cl_context	    clContext;
+static cl_command_queue clCommandQueue_in;
+static cl_command_queue clCommandQueue[4];		/* one per compute kernel */
+
+static cl_program       clProgram;
+static cl_kernel        clKernel_in;
+static cl_kernel        clKernel[4];
+
+static cl_device_id		clDeviceID;
+
+Timer timer;
+
+static int shutdown()
+{
+	// release resources
+	if( clCommandQueue_in ) clReleaseCommandQueue( clCommandQueue_in );
+	for (int k = 0; k < 4; k++)
+		if( clCommandQueue[k] ) clReleaseCommandQueue( clCommandQueue[k] );
+	
+	if( clContext ) clReleaseContext( clContext );
+	// reset all variables
+	clCommandQueue_in = 0;
+	for (int k = 0; k < 4; k++)
+		clCommandQueue[k] = 0;
+	
+	clContext = 0;
+	return 0;
+}
+
+
+cl_mem d_feature;
+cl_mem d_cluster;
+cl_mem d_membership;
+cl_mem d_partial_centers;
+cl_mem d_partial_len;
+cl_mem d_partial_delta;
+
+#define NUM_CLUSTERS 128	/* stride of the partial results, must match coexec_1-4.cl */
+
+float *partial_centers;
+int   *partial_len;
+
+// Split of the points: the device takes [0, n_dev), the CPU [n_dev, npoints)
+static int   n_dev;
+static int   n_dev_next;
+static int   n_dev_min, n_dev_max;
+static float dev_split;			/* initial device fraction */
+static int   dev_rebalance;		/* re-balance from the measured rates */
+
+
+int allocate(int n_points, int n_features, int n_clusters, float **feature, float split, int rebalance)
+{
+	cl_int  clStatus;
+
+
+	// Get the OpenCL platform.
+	cl_platform_id clPlatform = NULL;
+	clPlatform = findPlatform("Intel(R) FPGA");
+	if(clPlatform == NULL) {
+		printf("ERROR: Unable to find Intel(R) FPGA OpenCL platform.\n");
+	}
+
+	// Query the available OpenCL device.
+    cl_uint clNumDevices;
+    clStatus = clGetDeviceIDs(clPlatform, CL_DEVICE_TYPE_ALL, 0, NULL, &clNumDevices);
+    CL_ERR();
+    cl_device_id *clDevices = new cl_device_id[clNumDevices];
+    clStatus                = clGetDeviceIDs(clPlatform, CL_DEVICE_TYPE_ALL, clNumDevices, clDevices, NULL);
+    CL_ERR();
+
+	printf("Platform: %s\n",getPlatformName(clPlatform).c_str());
+	printf("Using %d device(s)\n",clNumDevices);
+	for(unsigned i = 0; i < clNumDevices; ++i) {
+		printf("  %s\n", getDeviceName(clDevices[i]).c_str());
+	}
+
+
+	// Create the context.
+	clContext = clCreateContext(NULL, clNumDevices, clDevices, &oclContextCallback, NULL, &clStatus);
+    CL_ERR();
+    char device_name_[100];
+    clGetDeviceInfo(clDevices[0], CL_DEVICE_NAME, 100, &device_name_, NULL);
+    clDeviceID = clDevices[0];
+    fprintf(stderr, "%s\t", device_name_);
+
+
+	
+	// create command queues for the first device; profiling gives the device
+	// time of the slice while the host is busy with its own share
+	clCommandQueue_in = clCreateCommandQueue( clContext, clDevices[0], CL_QUEUE_PROFILING_ENABLE, &clStatus );
+	CL_ERR();
+	for (int k = 0; k < 4; k++) {
+		clCommandQueue[k] = clCreateCommandQueue( clContext, clDevices[0], CL_QUEUE_PROFILING_ENABLE, &clStatus );
+		CL_ERR();
+	}
+
+
+
+	// Create the program.
+	std::string binary_file = getBoardBinaryFile("coexec_1-4", clDeviceID);
+	printf("\nUsing AOCX:%s\n",binary_file.c_str());
+	clProgram = createProgramFromBinary(clContext, binary_file.c_str(), &clDeviceID, 1);	
+	CL_ERR();
+
+
+	// Build the program that was just created.
+    clStatus = clBuildProgram(clProgram, 0, NULL, "", NULL, NULL);  
+    if(clStatus == CL_BUILD_PROGRAM_FAILURE) {
+        // Determine the size of the log
+        size_t log_size;
+        clGetProgramBuildInfo(clProgram, clDevices[0], CL_PROGRAM_BUILD_LOG, 0, NULL, &log_size);
+        // Allocate memory for the log
+        char *log = (char *)malloc(log_size);
+        // Get the log
+        clGetProgramBuildInfo(clProgram, clDevices[0], CL_PROGRAM_BUILD_LOG, log_size, log, NULL);
+        // Print the log
+        fprintf(stderr, "%s\t", log);
+    }
+    CL_ERR();
+
+
+
+	// Kernel.
+	clKernel_in  = clCreateKernel(clProgram, "kmeans_in", &clStatus);
+	CL_ERR();
+	for (int k = 0; k < 4; k++) {
+		char name[32];
+		sprintf(name, "kmeans_kernel_%d", k);
+		clKernel[k] = clCreateKernel(clProgram, name, &clStatus);
+		CL_ERR();
+	}
+
+	if(n_clusters > NUM_CLUSTERS) {
+		printf("Error: nclusters(%d) > NUM_CLUSTERS(%d) -- cannot proceed\n", n_clusters, NUM_CLUSTERS);
+		exit(0);
+	}
+
+
+	d_feature = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_points * n_features * sizeof(float), NULL, 0 );
+	d_cluster = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_clusters * n_features  * sizeof(float), NULL, 0 );
+	d_membership = clCreateBuffer(clContext, CL_MEM_READ_WRITE, n_points * sizeof(int), NULL, 0 );
+	d_partial_centers = clCreateBuffer(clContext, CL_MEM_READ_WRITE, 4 * NUM_CLUSTERS * n_features * sizeof(float), NULL, 0 );
+	d_partial_len     = clCreateBuffer(clContext, CL_MEM_READ_WRITE, 4 * NUM_CLUSTERS * sizeof(int), NULL, 0 );
+	d_partial_delta   = clCreateBuffer(clContext, CL_MEM_READ_WRITE, 4 * sizeof(int), NULL, 0 );
+
+
+	//write buffers
+	clStatus = clEnqueueWriteBuffer(clCommandQueue[0], d_feature, 1, 0, n_points * n_features * sizeof(float), feature[0], 0, 0, 0);
+	CL_ERR();
+
+	partial_centers = (float*) _aligned_malloc(4 * NUM_CLUSTERS * n_features * sizeof(float), AOCL_ALIGNMENT);
+	partial_len     = (int*)   _aligned_malloc(4 * NUM_CLUSTERS * sizeof(int), AOCL_ALIGNMENT);
+	ALLOC_ERR(partial_centers, partial_len);
+
+	/* when re-balancing, each side keeps at least 1% of the points so that
+	   its rate can still be measured */
+	dev_split     = split;
+	dev_rebalance = rebalance;
+	n_dev_min     = rebalance ? n_points / 100 : 0;
+	n_dev_max     = rebalance ? n_points - n_points / 100 : n_points;
+	return 0;
+}
+
+
+void deallocateMemory()
+{
+	clReleaseMemObject(d_feature);
+	clReleaseMemObject(d_cluster);
+	clReleaseMemObject(d_membership);
+	clReleaseMemObject(d_partial_centers);
+	clReleaseMemObject(d_partial_len);
+	clReleaseMemObject(d_partial_delta);
+	_aligned_free(partial_centers);
+	_aligned_free(partial_len);
+}
+
+
+int main( int argc, char** argv) 
+{
+	setup(argc, argv);
+	shutdown();
+}
+
+
+static int clamp_split(double n)
+{
+	int v = (int) (n + 0.5);
+	if (v < n_dev_min) v = n_dev_min;
+	if (v > n_dev_max) v = n_dev_max;
+	return v;
+}
+
+
+/* Moves the split to n_dev_next. The membership of the points that change
+   sides is handed over, since each side compares against the previous
+   assignment of its own points. */
+static void move_split(int *membership)
+{
+	cl_int  clStatus;
+
+	if (n_dev_next < n_dev) {			/* the CPU takes [n_dev_next, n_dev) */
+		clStatus = clEnqueueReadBuffer(clCommandQueue[0], d_membership, 1, n_dev_next * sizeof(int),
+									   (n_dev - n_dev_next) * sizeof(int), membership + n_dev_next, 0, 0, 0);
+		CL_ERR();
+	} else if (n_dev_next > n_dev) {	/* the device takes [n_dev, n_dev_next) */
+		clStatus = clEnqueueWriteBuffer(clCommandQueue[0], d_membership, 1, n_dev * sizeof(int),
+										(n_dev_next - n_dev) * sizeof(int), membership + n_dev, 0, 0, 0);
+		CL_ERR();
+	}
+	n_dev = n_dev_next;
+}
+
+
+int	kmeansOCL(float **feature,    /* in: [npoints][nfeatures] */
+           int     n_features,
+           int     n_points,
+           int     n_clusters,
+           int    *membership,
+		   float **clusters,
+		   int     *new_centers_len,
+           float  **new_centers,
+		   int      iteration,
+		   float   *time,			/* out: [3] iteration, device and CPU time in ms */
+		   int     *ndev)			/* out: points assigned on the device */
+{ 
+	int delta = 0;
+	int i, j, k;
+	int partial_delta[4];
+	cl_int  clStatus;
+	cl_event ev_in, ev_kernel[4];
+
+	if (iteration == 0) {
+		/* membership starts at -1 on both sides */
+		n_dev = n_dev_next = clamp_split(dev_split * n_points);
+		clStatus = clEnqueueWriteBuffer(clCommandQueue[0], d_membership, 1, 0, n_points * sizeof(int), membership, 0, 0, 0);
+		CL_ERR();
+	} else {
+		move_split(membership);
+	}
+
+	clStatus = clEnqueueWriteBuffer(clCommandQueue[0], d_cluster, 1, 0, n_clusters * n_features * sizeof(float), clusters[0], 0, 0, 0);
+	clFinish(clCommandQueue[0]);
+	CL_ERR();
+	
+	
+	timer.start("Kernel");
+
+	/* device slice, in flight while the CPU works on its own */
+	if (n_dev > 0) {
+		clSetKernelArg(clKernel_in, 0, sizeof(void *), (void*) &d_feature);
+		clSetKernelArg(clKernel_in, 1, sizeof(cl_int), (void*) &n_dev);
+
+		clStatus = clEnqueueTask(clCommandQueue_in, clKernel_in, 0, 0, &ev_in);
+		CL_ERR();
+		clFlush(clCommandQueue_in);
+
+		for (k = 0; k < 4; k++) {
+			clSetKernelArg(clKernel[k], 0, sizeof(void *), (void*) &d_cluster);
+			clSetKernelArg(clKernel[k], 1, sizeof(void *), (void*) &d_membership);
+			clSetKernelArg(clKernel[k], 2, sizeof(void *), (void*) &d_partial_centers);
+			clSetKernelArg(clKernel[k], 3, sizeof(void *), (void*) &d_partial_len);
+			clSetKernelArg(clKernel[k], 4, sizeof(void *), (void*) &d_partial_delta);
+			clSetKernelArg(clKernel[k], 5, sizeof(cl_int), (void*) &n_dev);
+			clSetKernelArg(clKernel[k], 6, sizeof(cl_int), (void*) &n_clusters);
+			clSetKernelArg(clKernel[k], 7, sizeof(cl_int), (void*) &n_features);
+
+			clStatus = clEnqueueTask(clCommandQueue[k], clKernel[k], 0, 0, &ev_kernel[k]);
+			CL_ERR();
+			clFlush(clCommandQueue[k]);
+		}
+	}
+
+	/* CPU slice, sums go straight into new_centers */
+	double cpu_start = getCurrentTimestamp();
+	delta += kmeans_assign_cpu(feature, n_features, n_dev, n_points, n_clusters, clusters,
+							   membership, new_centers_len, new_centers);
+	double cpu_time = getCurrentTimestamp() - cpu_start;
+
+	clFinish(clCommandQueue_in);
+	for (k = 0; k < 4; k++)
+		clFinish(clCommandQueue[k]);
+	
+	timer.stop("Kernel");
+
+	time[0] = timer.getTime("Kernel");
+	time[1] = 0.0f;
+	time[2] = (float) (cpu_time * 1e3);
+
+
+	/* merge the partial results of the 4 compute kernels */
+	if (n_dev > 0) {
+		cl_ulong start, end, last = 0;
+		clGetEventProfilingInfo(ev_in, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, NULL);
+		for (k = 0; k < 4; k++) {
+			clGetEventProfilingInfo(ev_kernel[k], CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, NULL);
+			if (end > last)
+				last = end;
+			clReleaseEvent(ev_kernel[k]);
+		}
+		clReleaseEvent(ev_in);
+		time[1] = (float) ((last - start) * 1e-6);
+
+		clStatus = clEnqueueReadBuffer(clCommandQueue[0], d_partial_centers, 1, 0, 4 * NUM_CLUSTERS * n_features * sizeof(float), partial_centers, 0, 0, 0);
+		CL_ERR();
+		clStatus = clEnqueueReadBuffer(clCommandQueue[0], d_partial_len, 1, 0, 4 * NUM_CLUSTERS * sizeof(int), partial_len, 0, 0, 0);
+		CL_ERR();
+		clStatus = clEnqueueReadBuffer(clCommandQueue[0], d_partial_delta, 1, 0, 4 * sizeof(int), partial_delta, 0, 0, 0);
+		CL_ERR();
+
+		for (k = 0; k < 4; k++) {
+			delta += partial_delta[k];
+			for (i = 0; i < n_clusters; i++) {
+				new_centers_len[i] += partial_len[k * NUM_CLUSTERS + i];
+				for (j = 0; j < n_features; j++)
+					new_centers[i][j] += partial_centers[(k * NUM_CLUSTERS + i) * n_features + j];
+			}
+		}
+	}
+	ndev[0] = n_dev;
+
+
+	/* Re-balance for the next iteration so that both sides finish together:
+	   the device share follows the measured rates, damped by half a step to
+	   keep timing noise from making the split oscillate. */
+	if (dev_rebalance && n_dev > 0 && n_dev < n_points && time[1] > 0.0f && time[2] > 0.0f) {
+		double rate_dev = n_dev / time[1];
+		double rate_cpu = (n_points - n_dev) / time[2];
+		double target   = n_points * rate_dev / (rate_dev + rate_cpu);
+		n_dev_next = clamp_split(0.5 * n_dev + 0.5 * target);
+	}
+
+
+	if(delta == 0){
+		/* the device part of the final assignment */
+		if (n_dev > 0) {
+			clStatus = clEnqueueReadBuffer(clCommandQueue[0], d_membership, 1, 0, n_dev * sizeof(int), membership, 0, 0, 0);
+			CL_ERR();
+		}
+
+		int temp;
+		FILE *fp = fopen("output/output.txt", "r");
+		for(int i = 0; i < n_points; i++){
+			fscanf(fp, "%d", &temp);
+			if(membership[i] != temp){
+				printf("failed!!\n");
+				break;
+			}
+		}
+		printf("pass!!\n");
+	}
+
+
+	return delta;
+}
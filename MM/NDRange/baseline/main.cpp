@@ -13,7 +13,15 @@
 // be used), but the code can be generalized to support different device types
 // easily.
 //
-// Verification is performed against the same computation on the host CPU.
+// Verification is performed against the same computation on the host CPU
+// (-verify=<mode>):
+//  full       cache-blocked, vectorised reference on all threads, checked
+//             block-row by block-row as it is computed (the default)
+//  freivalds  randomised check of C r against A (B r), O(n^2); the default
+//             above FREIVALDS_MIN multiply-adds
+//  scalar     the plain triple loop, then a pass over C
+//  none
+// -verify_bench times the modes on the host alone at several sizes.
 ///////////////////////////////////////////////////////////////////////////////////
 
 #include <stdio.h>
@@ -26,6 +34,20 @@
 #define BLOCK_SIZE 64 // default value
 #endif
 
+// Cache blocking of the reference: a REF_KC x REF_NC block of B is reused
+// from the cache by all rows of a block-row.
+#ifndef REF_KC
+#define REF_KC 256
+#endif
+#ifndef REF_NC
+#define REF_NC 512
+#endif
+
+// Sizes (M * K * N) from which -verify defaults to freivalds.
+#ifndef FREIVALDS_MIN
+#define FREIVALDS_MIN (1ull << 33)
+#endif
+
 using namespace aocl_utils;
 
 // OpenCL runtime configuration
@@ -53,6 +75,7 @@ scoped_aligned_ptr<float> input_b;
 scoped_array<scoped_aligned_ptr<float> > output; // num_devices elements
 scoped_array<float> ref_output;
 scoped_array<unsigned> rows_per_device; // num_devices elements
+std::string verify_mode;
 
 // Function prototypes
 float rand_float();
@@ -60,7 +83,11 @@ bool init_opencl();
 void init_problem();
 void run();
 void compute_reference();
-void verify();
+bool verify();
+bool verify_scalar();
+bool verify_blocked();
+bool verify_freivalds(unsigned trials);
+void verify_bench();
 void cleanup();
 
 // Entry point.
@@ -75,6 +102,20 @@ int main(int argc, char **argv) {
   if(options.has("bw")) {
     B_width = options.get<unsigned>("bw");
   }
+  if(options.has("verify")) {
+    verify_mode = options.get<std::string>("verify");
+  }
+  else {
+    verify_mode = (unsigned long long) A_height * A_width * B_width < FREIVALDS_MIN ? "full" : "freivalds";
+  }
+  if(verify_mode != "full" && verify_mode != "freivalds" && verify_mode != "scalar" && verify_mode != "none") {
+    printf("Unknown -verify mode: %s\n", verify_mode.c_str());
+    return -1;
+  }
+  if(options.has("verify_bench")) {
+    verify_bench();
+    return 0;
+  }
 
   printf("Matrix sizes:\n  A: %d x %d\n  B: %d x %d\n  C: %d x %d\n",
       A_height, A_width, B_height, B_width, C_height, C_width);
@@ -341,10 +382,34 @@ void run() {
   }
 
   // Verify results.
-  compute_reference();
   verify();
 }
 
+// Verifies C with the selected mode and reports the time taken.
+bool verify() {
+  if(verify_mode == "none") {
+    return true;
+  }
+
+  printf("Verifying (%s)\n", verify_mode.c_str());
+  const double start_time = getCurrentTimestamp();
+
+  bool pass;
+  if(verify_mode == "freivalds") {
+    pass = verify_freivalds(2);
+  }
+  else if(verify_mode == "scalar") {
+    pass = verify_scalar();
+  }
+  else {
+    pass = verify_blocked();
+  }
+
+  printf("Verification: %s\n", pass ? "PASS" : "FAIL");
+  printf("Verify Time: %0.3f ms\n", (getCurrentTimestamp() - start_time) * 1e3);
+  return pass;
+}
+
 void compute_reference() {
   // Compute the reference output.
   printf("Computing reference output\n");
@@ -364,13 +429,14 @@ void compute_reference() {
   }
 }
 
-void verify() {
-  printf("Verifying\n");
+// The triple loop, then the comparison as a second pass.
+bool verify_scalar() {
+  compute_reference();
 
   // Compute the L^2-Norm of the difference between the output and reference
   // output matrices and compare it against the L^2-Norm of the reference.
-  float diff = 0.0f;
-  float ref = 0.0f;
+  double diff = 0.0;
+  double ref = 0.0;
   for(unsigned y = 0, dev_index = 0; y < C_height; ++dev_index) {
     for(unsigned yy = 0; yy < rows_per_device[dev_index]; ++yy, ++y) {
       for(unsigned x = 0; x < C_width; ++x) {
@@ -383,14 +449,207 @@ void verify() {
     }
   }
 
-  const float diff_l2norm = sqrtf(diff);
-  const float ref_l2norm = sqrtf(ref);
-  const float error = diff_l2norm / ref_l2norm;
-  const bool pass = error < 1e-6;
-  printf("Verification: %s\n", pass ? "PASS" : "FAIL");
-  if(!pass) {
+  const double error = sqrt(diff) / sqrt(ref);
+  if(error >= 1e-6) {
+    printf("Error (L^2-Norm): %0.3g\n", error);
+  }
+  return error < 1e-6;
+}
+
+// Reference rows [yy0, yy0 + BLOCK_SIZE) of the rows of device dev_index
+// into ref (BLOCK_SIZE x C_width). B is walked in REF_KC x REF_NC blocks
+// that stay in cache over the block-row; for every row and k the inner
+// loop adds a[k] * B[k][x..x+REF_NC) to the row, which the compiler
+// vectorises. The sums run over k in the same order as the triple loop.
+static void reference_block(unsigned dev_index, unsigned yy0, float *ref) {
+  for(unsigned j = 0; j < BLOCK_SIZE * C_width; ++j) {
+    ref[j] = 0.0f;
+  }
+
+  for(unsigned x0 = 0; x0 < C_width; x0 += REF_NC) {
+    const unsigned nc = C_width - x0 < REF_NC ? C_width - x0 : REF_NC;
+    for(unsigned k0 = 0; k0 < A_width; k0 += REF_KC) {
+      const unsigned kc = A_width - k0 < REF_KC ? A_width - k0 : REF_KC;
+      for(unsigned yy = 0; yy < BLOCK_SIZE; ++yy) {
+        const float *a = input_a[dev_index] + (yy0 + yy) * A_width + k0;
+        float *r = ref + yy * C_width + x0;
+        for(unsigned k = 0; k < kc; ++k) {
+          const float a_k = a[k];
+          const float *b = input_b + (k0 + k) * B_width + x0;
+          #pragma omp simd
+          for(unsigned x = 0; x < nc; ++x) {
+            r[x] += a_k * b[x];
+          }
+        }
+      }
+    }
+  }
+}
+
+// Same check as verify_scalar, with the reference computed one block-row
+// at a time on all threads and compared while it is still in cache; no
+// reference matrix is stored.
+bool verify_blocked() {
+  // Block-rows, in the order of the devices.
+  const int num_block_rows = C_height / BLOCK_SIZE;
+  scoped_array<unsigned> block_dev(num_block_rows);
+  scoped_array<unsigned> block_row(num_block_rows);
+  for(unsigned dev_index = 0, b = 0; dev_index < num_devices; ++dev_index) {
+    for(unsigned yy = 0; yy < rows_per_device[dev_index]; yy += BLOCK_SIZE, ++b) {
+      block_dev[b] = dev_index;
+      block_row[b] = yy;
+    }
+  }
+
+  double diff = 0.0;
+  double ref = 0.0;
+
+  #pragma omp parallel reduction(+:diff, ref)
+  {
+    scoped_aligned_ptr<float> ref_block(BLOCK_SIZE * C_width);
+
+    #pragma omp for schedule(dynamic)
+    for(int b = 0; b < num_block_rows; ++b) {
+      reference_block(block_dev[b], block_row[b], ref_block);
+
+      const float *o = output[block_dev[b]] + block_row[b] * C_width;
+      for(unsigned j = 0; j < BLOCK_SIZE * C_width; ++j) {
+        const float d = o[j] - ref_block[j];
+        diff += d * d;
+        ref += ref_block[j] * ref_block[j];
+      }
+    }
+  }
+
+  const double error = sqrt(diff) / sqrt(ref);
+  if(error >= 1e-6) {
     printf("Error (L^2-Norm): %0.3g\n", error);
   }
+  return error < 1e-6;
+}
+
+// Freivalds' check: for random vectors r, compares C r with A (B r), which
+// costs O(n^2) instead of O(n^3). Both sides are summed in double, so they
+// are compared against the exact product rather than the float sums of the
+// kernel; the bound allows for the rounding of those sums over K. A wrong
+// block or row of C moves C r far beyond it.
+bool verify_freivalds(unsigned trials) {
+  scoped_array<double> r(C_width);
+  scoped_array<double> br(B_height);
+  double worst = 0.0;
+
+  for(unsigned t = 0; t < trials; ++t) {
+    for(unsigned x = 0; x < C_width; ++x) {
+      r[x] = double(rand()) / RAND_MAX * 2.0 - 1.0;
+    }
+
+    // B r
+    #pragma omp parallel for
+    for(int k = 0; k < int(B_height); ++k) {
+      double sum = 0.0;
+      for(unsigned x = 0; x < B_width; ++x) {
+        sum += input_b[k * B_width + x] * r[x];
+      }
+      br[k] = sum;
+    }
+
+    // C r against A (B r), row by row.
+    double diff = 0.0;
+    double ref = 0.0;
+    #pragma omp parallel for reduction(+:diff, ref)
+    for(int y = 0; y < int(C_height); ++y) {
+      unsigned dev_index = 0, yy = y;
+      while(yy >= rows_per_device[dev_index]) {
+        yy -= rows_per_device[dev_index++];
+      }
+
+      double abr = 0.0, cr = 0.0;
+      for(unsigned k = 0; k < A_width; ++k) {
+        abr += input_a[dev_index][yy * A_width + k] * br[k];
+      }
+      for(unsigned x = 0; x < C_width; ++x) {
+        cr += output[dev_index][yy * C_width + x] * r[x];
+      }
+      diff += (cr - abr) * (cr - abr);
+      ref += abr * abr;
+    }
+
+    const double error = sqrt(diff) / sqrt(ref);
+    worst = error > worst ? error : worst;
+  }
+
+  if(worst >= 1e-5) {
+    printf("Error (L^2-Norm of C r): %0.3g\n", worst);
+  }
+  return worst < 1e-5;
+}
+
+// Times the verify modes on the host alone. C is set to the product
+// beforehand, the way the device would leave it; the scalar mode is only
+// run up to the baseline size.
+void verify_bench() {
+  static const unsigned sizes[][3] = {
+    { 512,  512,  512}, {1024, 1024, 1024}, {2048, 1024, 1024},
+    {2048, 2048, 2048}, {4096, 4096, 4096}
+  };
+  const unsigned num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+  const std::string modes[3] = {"scalar", "full", "freivalds"};
+
+  scoped_array<double> times(num_sizes * 3);
+  scoped_array<bool> passed(num_sizes * 3);
+
+  num_devices = 1;
+  rows_per_device.reset(1);
+  input_a.reset(1);
+  output.reset(1);
+
+  for(unsigned s = 0; s < num_sizes; ++s) {
+    A_height = sizes[s][0];
+    A_width  = sizes[s][1];
+    B_width  = sizes[s][2];
+    printf("\n==== %u x %u x %u ====\n", A_height, A_width, B_width);
+
+    rows_per_device[0] = C_height;
+    input_a[0].reset(A_height * A_width);
+    input_b.reset(B_height * B_width);
+    output[0].reset(C_height * C_width);
+    for(unsigned j = 0; j < A_height * A_width; ++j) {
+      input_a[0][j] = rand_float();
+    }
+    for(unsigned j = 0; j < B_height * B_width; ++j) {
+      input_b[j] = rand_float();
+    }
+    #pragma omp parallel for
+    for(int b = 0; b < int(C_height / BLOCK_SIZE); ++b) {
+      reference_block(0, b * BLOCK_SIZE, output[0] + b * BLOCK_SIZE * C_width);
+    }
+
+    for(unsigned m = 0; m < 3; ++m) {
+      times[s * 3 + m] = -1.0;
+      if(modes[m] == "scalar" && (unsigned long long) A_height * A_width * B_width > 2048ull * 1024 * 1024) {
+        continue;
+      }
+      verify_mode = modes[m];
+      const double start_time = getCurrentTimestamp();
+      passed[s * 3 + m] = verify();
+      times[s * 3 + m] = getCurrentTimestamp() - start_time;
+    }
+    ref_output.reset();
+  }
+
+  printf("\nVerify time (ms)\n%6s %6s %6s %12s %12s %12s\n", "M", "K", "N", "scalar", "full", "freivalds");
+  for(unsigned s = 0; s < num_sizes; ++s) {
+    printf("%6u %6u %6u", sizes[s][0], sizes[s][1], sizes[s][2]);
+    for(unsigned m = 0; m < 3; ++m) {
+      if(times[s * 3 + m] < 0.0) {
+        printf(" %12s", "-");
+      }
+      else {
+        printf(" %7.1f %4s", times[s * 3 + m] * 1e3, passed[s * 3 + m] ? "PASS" : "FAIL");
+      }
+    }
+    printf("\n");
+  }
 }
 
 // Free the resources allocated during initialization
@@ -0,0 +1,80 @@
+#ifndef BLOCK_SIZE
+#define BLOCK_SIZE 32 // default value
+#endif
+
+// Fields of one batch entry in the descriptor array, see main.cpp.
+#define DESC_M        0
+#define DESC_K        1
+#define DESC_N        2
+#define DESC_A_OFFSET 3
+#define DESC_B_OFFSET 4
+#define DESC_C_OFFSET 5
+#define DESC_FIELDS   6
+
+
+// Batched C = A * B over many small matrices in one launch. Dimension 2 of
+// the NDRange selects the batch entry, dimensions 0 and 1 the block of its
+// C as in padded.cl. The NDRange covers the largest entry of the batch;
+// work-groups that fall outside a smaller entry return before the first
+// barrier, which is safe since the whole work-group takes the same branch.
+// Edge tiles are zero-filled like in padded.cl, so any size is allowed.
+__kernel 
+__attribute((reqd_work_group_size(BLOCK_SIZE,BLOCK_SIZE,1)))
+
+void matrixMultBatched( // Packed input and output matrices of the batch
+                 __global float *restrict C,
+                 __global float *A,
+                 __global float *B, 
+                 // Batch descriptor, DESC_FIELDS ints per entry.
+                 __global const int *restrict desc,
+                 // Entry of work-group (x, y, 0).
+                 int first)
+{
+    __local float A_local[BLOCK_SIZE][BLOCK_SIZE];
+    __local float B_local[BLOCK_SIZE][BLOCK_SIZE];
+
+    __global const int *entry = desc + (first + get_group_id(2)) * DESC_FIELDS;
+    const int C_height = entry[DESC_M];
+    const int A_width  = entry[DESC_K];
+    const int B_width  = entry[DESC_N];
+    
+    int block_x = get_group_id(0);
+    int block_y = get_group_id(1);
+
+    if (BLOCK_SIZE * block_y >= C_height || BLOCK_SIZE * block_x >= B_width)
+        return;
+
+    __global float *a = A + entry[DESC_A_OFFSET];
+    __global float *b = B + entry[DESC_B_OFFSET];
+    __global float *c = C + entry[DESC_C_OFFSET];
+    
+    int local_x = get_local_id(0);
+    int local_y = get_local_id(1);
+    
+    int row = BLOCK_SIZE * block_y + local_y;    // row of A and C
+    int col = BLOCK_SIZE * block_x + local_x;    // column of B and C
+
+    float running_sum = 0.0f;
+   
+    for (int k = 0; k < A_width; k += BLOCK_SIZE)
+    {
+        int a_col = k + local_x;
+        int b_row = k + local_y;
+
+        A_local[local_y][local_x] = (row < C_height && a_col < A_width) ? a[row * A_width + a_col] : 0.0f;
+        B_local[local_x][local_y] = (b_row < A_width && col < B_width) ? b[b_row * B_width + col] : 0.0f;
+	
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        #pragma unroll
+        for (int kk = 0; kk < BLOCK_SIZE; ++kk)
+        {
+            running_sum += A_local[local_y][kk] * B_local[local_x][kk];
+        }
+       
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    
+    if (row < C_height && col < B_width)
+        c[row * B_width + col] = running_sum;
+}
@@ -0,0 +1,683 @@
+///////////////////////////////////////////////////////////////////////////////////
+// This host program executes a batched matrix multiplication kernel to perform:
+//  C[i] = A[i] * B[i]   for every entry i of a batch
+// where A[i] is a M x K matrix, B[i] is a K x N matrix and C[i] is a M x N
+// matrix, with M, K and N set per entry. The matrices of the batch are packed
+// into one buffer each for A, B and C, and a batch descriptor gives the sizes
+// and offsets of every entry, so the whole batch takes one kernel launch and
+// one transfer per buffer instead of one of each per matrix.
+//
+// Two ways of building a batch are provided:
+//  - make_strided_batch: count entries of one size at fixed strides. A
+//    stride of 0 shares one matrix across the batch, e.g. one B of weights.
+//  - make_batch: entries of any size, packed one after the other (the
+//    pointer-array form, with offsets in place of pointers).
+//
+// If there are several OpenCL devices, the entries are split into
+// contiguous ranges of about equal work, one range per device.
+//
+// Options:
+//  -n=<size> -count=<entries>  strided batch of count n x n x n products
+//  -mixed                      count entries of random sizes from 32 to 256
+//  -sweep                      throughput over batch counts and sizes
+// Each run also launches the same batch one entry per launch, which is how
+// the single-matrix hosts work, to show what the batching saves.
+//
+// Verification is performed against the same computation on the host CPU.
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <limits.h>
+#include "CL/opencl.h"
+#include "AOCLUtils/aocl_utils.h"
+
+#ifndef BLOCK_SIZE
+#define BLOCK_SIZE 32 // default value
+#endif
+
+using namespace aocl_utils;
+
+// One entry of a batch, C = A * B with A m x k, B k x n and C m x n, all
+// row-major. The offsets are in floats from the start of the packed A, B
+// and C buffers. Passed to the kernel as it is, 6 ints per entry (see the
+// DESC_* fields of batched.cl).
+struct gemm_desc {
+  cl_int m, k, n;
+  cl_int a_offset, b_offset, c_offset;
+};
+
+// Batch descriptor: the entries and the sizes of the packed buffers.
+struct gemm_batch {
+  unsigned count;
+  scoped_array<gemm_desc> entry; // count elements
+  size_t a_size, b_size, c_size; // floats
+};
+
+// OpenCL runtime configuration
+cl_platform_id platform = NULL;
+unsigned num_devices = 0;
+unsigned num_active = 0; // devices with at least one entry
+scoped_array<cl_device_id> device; // num_devices elements
+cl_context context = NULL;
+scoped_array<cl_command_queue> queue; // num_devices elements
+cl_program program = NULL;
+scoped_array<cl_kernel> kernel; // num_devices elements
+scoped_array<cl_mem> desc_buf; // num_devices elements
+scoped_array<cl_mem> input_a_buf; // num_devices elements
+scoped_array<cl_mem> input_b_buf; // num_devices elements
+scoped_array<cl_mem> output_buf; // num_devices elements
+
+// Problem data.
+unsigned size  = 64;
+unsigned count = 1024;
+gemm_batch batch;
+
+scoped_aligned_ptr<float> input_a; // batch.a_size elements
+scoped_aligned_ptr<float> input_b; // batch.b_size elements
+scoped_aligned_ptr<float> output;  // batch.c_size elements
+scoped_array<float> ref_output;
+
+// Per-device share of the batch: entries [first_entry, first_entry +
+// entries_per_device) and the ranges of the packed buffers they use.
+// The descriptor of each device is rebased to its ranges.
+scoped_array<unsigned> first_entry; // num_devices elements
+scoped_array<unsigned> entries_per_device; // num_devices elements
+scoped_array<size_t> a_base, a_len; // num_devices elements
+scoped_array<size_t> b_base, b_len; // num_devices elements
+scoped_array<size_t> c_base, c_len; // num_devices elements
+scoped_array<unsigned> max_m, max_n; // num_devices elements
+scoped_array<scoped_array<gemm_desc> > device_desc; // num_devices elements
+
+// Batches of the sweep are skipped above this size, A, B and C together.
+const size_t max_batch_bytes = size_t(512) << 20;
+
+// Function prototypes
+float rand_float();
+bool make_strided_batch(gemm_batch &b, unsigned count, unsigned m, unsigned k, unsigned n,
+    size_t stride_a, size_t stride_b, size_t stride_c);
+bool make_batch(gemm_batch &b, unsigned count, const unsigned (*sizes)[3]);
+double batch_flops(const gemm_batch &b);
+bool init_opencl();
+void init_problem();
+double run(bool one_per_launch);
+void compute_reference();
+bool verify();
+void cleanup_problem();
+void cleanup();
+
+// Entry point.
+int main(int argc, char **argv) {
+  Options options(argc, argv);
+  if(options.has("n")) {
+    size = options.get<unsigned>("n");
+  }
+  if(options.has("count")) {
+    count = options.get<unsigned>("count");
+  }
+  const bool mixed = options.has("mixed");
+  const bool sweep = options.has("sweep");
+
+  if(size == 0 || count == 0) {
+    printf("Matrix size and batch count must be non-zero.\n");
+    return -1;
+  }
+
+  // Initialize OpenCL.
+  if(!init_opencl()) {
+    return -1;
+  }
+
+  if(!sweep) {
+    if(mixed) {
+      scoped_array<unsigned[3]> sizes(count);
+      for(unsigned i = 0; i < count; ++i) {
+        for(unsigned j = 0; j < 3; ++j) {
+          sizes[i][j] = 32 + rand() % 225;
+        }
+      }
+      if(!make_batch(batch, count, sizes)) {
+        printf("Batch too large: the offsets of gemm_desc are limited to 2^31 floats.\n");
+        cleanup();
+        return -1;
+      }
+      printf("Batch: %u entries of 32 to 256 x 32 to 256 x 32 to 256\n", count);
+    }
+    else {
+      if(!make_strided_batch(batch, count, size, size, size,
+          size_t(size) * size, size_t(size) * size, size_t(size) * size)) {
+        printf("Batch too large: the offsets of gemm_desc are limited to 2^31 floats.\n");
+        cleanup();
+        return -1;
+      }
+      printf("Batch: %u entries of %u x %u x %u\n", count, size, size, size);
+    }
+
+    init_problem();
+    const double batched = run(false);
+    compute_reference();
+    verify();
+    const double looped = run(true);
+    printf("Batched: %0.2f GFLOPS, one per launch: %0.2f GFLOPS (%0.1fx)\n",
+        batched, looped, batched / looped);
+    cleanup_problem();
+  }
+  else {
+    static const unsigned sweep_sizes[] = {32, 64, 128, 256};
+    static const unsigned sweep_counts[] = {1, 16, 256, 4096};
+    const unsigned num_sizes = sizeof(sweep_sizes) / sizeof(sweep_sizes[0]);
+    const unsigned num_counts = sizeof(sweep_counts) / sizeof(sweep_counts[0]);
+    scoped_array<double> batched(num_sizes * num_counts);
+    scoped_array<double> looped(num_sizes * num_counts);
+    scoped_array<int> passed(num_sizes * num_counts); // -1 when skipped
+
+    for(unsigned s = 0; s < num_sizes; ++s) {
+      for(unsigned c = 0; c < num_counts; ++c) {
+        const unsigned n = sweep_sizes[s];
+        const unsigned r = s * num_counts + c;
+        passed[r] = -1;
+        if(3.0 * sweep_counts[c] * n * n * sizeof(float) > max_batch_bytes) {
+          continue;
+        }
+        printf("\n==== %u x %u x %u, %u entries ====\n", n, n, n, sweep_counts[c]);
+
+        if(!make_strided_batch(batch, sweep_counts[c], n, n, n,
+            size_t(n) * n, size_t(n) * n, size_t(n) * n)) {
+          continue;
+        }
+        init_problem();
+        batched[r] = run(false);
+        compute_reference();
+        passed[r] = verify();
+        looped[r] = run(true);
+        cleanup_problem();
+      }
+    }
+
+    printf("\n%6s %6s %10s %10s %8s %6s\n", "size", "count", "batched", "looped", "speedup", "check");
+    for(unsigned s = 0; s < num_sizes; ++s) {
+      for(unsigned c = 0; c < num_counts; ++c) {
+        const unsigned r = s * num_counts + c;
+        if(passed[r] < 0) {
+          printf("%6u %6u %10s %10s %8s %6s\n", sweep_sizes[s], sweep_counts[c], "-", "-", "-", "skip");
+          continue;
+        }
+        printf("%6u %6u %10.2f %10.2f %7.1fx %6s\n", sweep_sizes[s], sweep_counts[c],
+            batched[r], looped[r], batched[r] / looped[r], passed[r] ? "PASS" : "FAIL");
+      }
+    }
+    printf("(GFLOPS; looped launches the same batch one entry per launch)\n");
+  }
+
+  // Free the resources allocated
+  cleanup();
+
+  return 0;
+}
+
+/////// HELPER FUNCTIONS ///////
+
+// Randomly generate a floating-point number between -10 and 10.
+float rand_float() {
+  return float(rand()) / float(RAND_MAX) * 20.0f - 10.0f;
+}
+
+// Rounds n up to a whole number of blocks.
+static unsigned round_up(unsigned n) {
+  return (n + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+}
+
+// Whether a packed buffer of size floats can be indexed with the cl_int
+// offsets of gemm_desc.
+static bool fits_offset(size_t size) {
+  return size <= size_t(INT_MAX);
+}
+
+// Builds a batch of count m x k x n entries; entry i starts i * stride
+// floats into each packed buffer. Returns false, leaving b unchanged, if a
+// buffer would exceed the cl_int offsets of gemm_desc.
+bool make_strided_batch(gemm_batch &b, unsigned count, unsigned m, unsigned k, unsigned n,
+    size_t stride_a, size_t stride_b, size_t stride_c) {
+  const size_t a_size = (count - 1) * stride_a + size_t(m) * k;
+  const size_t b_size = (count - 1) * stride_b + size_t(k) * n;
+  const size_t c_size = (count - 1) * stride_c + size_t(m) * n;
+  if(!fits_offset(a_size) || !fits_offset(b_size) || !fits_offset(c_size)) {
+    return false;
+  }
+  b.count = count;
+  b.entry.reset(count);
+  for(unsigned i = 0; i < count; ++i) {
+    gemm_desc &e = b.entry[i];
+    e.m = m;
+    e.k = k;
+    e.n = n;
+    e.a_offset = cl_int(i * stride_a);
+    e.b_offset = cl_int(i * stride_b);
+    e.c_offset = cl_int(i * stride_c);
+  }
+  b.a_size = a_size;
+  b.b_size = b_size;
+  b.c_size = c_size;
+  return true;
+}
+
+// Builds a batch of count entries of sizes {m, k, n}, packed one after the
+// other. Returns false if a buffer would exceed the cl_int offsets of
+// gemm_desc.
+bool make_batch(gemm_batch &b, unsigned count, const unsigned (*sizes)[3]) {
+  size_t a_size = 0, b_size = 0, c_size = 0;
+  for(unsigned i = 0; i < count; ++i) {
+    a_size += size_t(sizes[i][0]) * sizes[i][1];
+    b_size += size_t(sizes[i][1]) * sizes[i][2];
+    c_size += size_t(sizes[i][0]) * sizes[i][2];
+  }
+  if(!fits_offset(a_size) || !fits_offset(b_size) || !fits_offset(c_size)) {
+    return false;
+  }
+  b.count = count;
+  b.entry.reset(count);
+  b.a_size = b.b_size = b.c_size = 0;
+  for(unsigned i = 0; i < count; ++i) {
+    gemm_desc &e = b.entry[i];
+    e.m = sizes[i][0];
+    e.k = sizes[i][1];
+    e.n = sizes[i][2];
+    e.a_offset = cl_int(b.a_size);
+    e.b_offset = cl_int(b.b_size);
+    e.c_offset = cl_int(b.c_size);
+    b.a_size += size_t(e.m) * e.k;
+    b.b_size += size_t(e.k) * e.n;
+    b.c_size += size_t(e.m) * e.n;
+  }
+  return true;
+}
+
+double batch_flops(const gemm_batch &b) {
+  double flops = 0.0;
+  for(unsigned i = 0; i < b.count; ++i) {
+    flops += 2.0 * b.entry[i].m * b.entry[i].k * b.entry[i].n;
+  }
+  return flops;
+}
+
+// Initializes the OpenCL objects that do not depend on the batch.
+bool init_opencl() {
+  cl_int status;
+
+  printf("Initializing OpenCL\n");
+
+  if(!setCwdToExeDir()) {
+    return false;
+  }
+
+  // Get the OpenCL platform.
+  platform = findPlatform("Intel(R) FPGA");
+  if(platform == NULL) {
+    printf("ERROR: Unable to find Intel(R) FPGA OpenCL platform.\n");
+    return false;
+  }
+
+  // Query the available OpenCL device.
+  device.reset(getDevices(platform, CL_DEVICE_TYPE_ALL, &num_devices));
+  printf("Platform: %s\n", getPlatformName(platform).c_str());
+  printf("Using %d device(s)\n", num_devices);
+  for(unsigned i = 0; i < num_devices; ++i) {
+    printf("  %s\n", getDeviceName(device[i]).c_str());
+  }
+
+  // Create the context.
+  context = clCreateContext(NULL, num_devices, device, &oclContextCallback, NULL, &status);
+  checkError(status, "Failed to create context");
+
+  // Create the program for all device. Use the first device as the
+  // representative device (assuming all device are of the same type).  
+  std::string binary_file = getBoardBinaryFile("batched", device[0]);
+  printf("Using AOCX: %s\n", binary_file.c_str());
+  program = createProgramFromBinary(context, binary_file.c_str(), device, num_devices);
+
+  // Build the program that was just created.
+  status = clBuildProgram(program, 0, NULL, "", NULL, NULL);
+  checkError(status, "Failed to build program");
+
+  // Create per-device objects.
+  queue.reset(num_devices);
+  kernel.reset(num_devices);
+  first_entry.reset(num_devices);
+  entries_per_device.reset(num_devices);
+  a_base.reset(num_devices);
+  a_len.reset(num_devices);
+  b_base.reset(num_devices);
+  b_len.reset(num_devices);
+  c_base.reset(num_devices);
+  c_len.reset(num_devices);
+  max_m.reset(num_devices);
+  max_n.reset(num_devices);
+  device_desc.reset(num_devices);
+  desc_buf.reset(num_devices);
+  input_a_buf.reset(num_devices);
+  input_b_buf.reset(num_devices);
+  output_buf.reset(num_devices);
+
+  for(unsigned i = 0; i < num_devices; ++i) {
+    // Command queue.
+    queue[i] = clCreateCommandQueue(context, device[i], CL_QUEUE_PROFILING_ENABLE, &status);
+    checkError(status, "Failed to create command queue");
+
+    // Kernel.
+    const char *kernel_name = "matrixMultBatched";
+    kernel[i] = clCreateKernel(program, kernel_name, &status);
+    checkError(status, "Failed to create kernel");
+
+    desc_buf[i] = NULL;
+    input_a_buf[i] = NULL;
+    input_b_buf[i] = NULL;
+    output_buf[i] = NULL;
+  }
+
+  return true;
+}
+
+// Splits the batch over the devices and creates the buffers and the data.
+void init_problem() {
+  cl_int status;
+
+  if(num_devices == 0) {
+    checkError(-1, "No devices");
+  }
+
+  // Contiguous ranges of entries, closed once they reach their share of
+  // the total work.
+  num_active = num_devices < batch.count ? num_devices : batch.count;
+  const double total = batch_flops(batch);
+  double done = 0.0;
+
+  for(unsigned i = 0, e = 0; i < num_active; ++i) {
+    first_entry[i] = e;
+    const double target = total * (i + 1) / num_active;
+    do {
+      done += 2.0 * batch.entry[e].m * batch.entry[e].k * batch.entry[e].n;
+      e++;
+    } while(e < batch.count - (num_active - 1 - i) && (done < target || i == num_active - 1));
+    entries_per_device[i] = e - first_entry[i];
+
+    // Ranges of the packed buffers used by these entries; with a stride of
+    // 0 the entries share their matrix, so take the extent of all of them.
+    a_base[i] = b_base[i] = c_base[i] = ~size_t(0);
+    size_t a_end = 0, b_end = 0, c_end = 0;
+    max_m[i] = max_n[i] = 0;
+    for(unsigned j = first_entry[i]; j < e; ++j) {
+      const gemm_desc &d = batch.entry[j];
+      a_base[i] = size_t(d.a_offset) < a_base[i] ? d.a_offset : a_base[i];
+      b_base[i] = size_t(d.b_offset) < b_base[i] ? d.b_offset : b_base[i];
+      c_base[i] = size_t(d.c_offset) < c_base[i] ? d.c_offset : c_base[i];
+      a_end = d.a_offset + size_t(d.m) * d.k > a_end ? d.a_offset + size_t(d.m) * d.k : a_end;
+      b_end = d.b_offset + size_t(d.k) * d.n > b_end ? d.b_offset + size_t(d.k) * d.n : b_end;
+      c_end = d.c_offset + size_t(d.m) * d.n > c_end ? d.c_offset + size_t(d.m) * d.n : c_end;
+      max_m[i] = unsigned(d.m) > max_m[i] ? d.m : max_m[i];
+      max_n[i] = unsigned(d.n) > max_n[i] ? d.n : max_n[i];
+    }
+    a_len[i] = a_end - a_base[i];
+    b_len[i] = b_end - b_base[i];
+    c_len[i] = c_end - c_base[i];
+
+    // Descriptor of the device, rebased to its ranges.
+    device_desc[i].reset(entries_per_device[i]);
+    for(unsigned j = 0; j < entries_per_device[i]; ++j) {
+      gemm_desc d = batch.entry[first_entry[i] + j];
+      d.a_offset -= cl_int(a_base[i]);
+      d.b_offset -= cl_int(b_base[i]);
+      d.c_offset -= cl_int(c_base[i]);
+      device_desc[i][j] = d;
+    }
+
+    desc_buf[i] = clCreateBuffer(context, CL_MEM_READ_ONLY, 
+        entries_per_device[i] * sizeof(gemm_desc), NULL, &status);
+    checkError(status, "Failed to create buffer for the batch descriptor");
+
+    // Input buffers. We specifically assign A to the first bank of
+    // global memory and B to the second one.
+    input_a_buf[i] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_BANK_1_ALTERA, 
+        a_len[i] * sizeof(float), NULL, &status);
+    checkError(status, "Failed to create buffer for input A");
+
+    input_b_buf[i] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_BANK_2_ALTERA, 
+        b_len[i] * sizeof(float), NULL, &status);
+    checkError(status, "Failed to create buffer for input B");
+
+    // Output buffer.
+    output_buf[i] = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_BANK_1_ALTERA, 
+        c_len[i] * sizeof(float), NULL, &status);
+    checkError(status, "Failed to create buffer for output");
+  }
+
+  // Generate the packed input matrices.
+  printf("Generating input matrices\n");
+  input_a.reset(batch.a_size);
+  input_b.reset(batch.b_size);
+  output.reset(batch.c_size);
+  for(size_t j = 0; j < batch.a_size; ++j) {
+    input_a[j] = rand_float();
+  }
+  for(size_t j = 0; j < batch.b_size; ++j) {
+    input_b[j] = rand_float();
+  }
+}
+
+// Runs the batch, in one launch per device or with one_per_launch in one
+// launch per entry; returns the throughput in GFLOPS.
+double run(bool one_per_launch) {
+  cl_int status;
+
+  // Transfer the descriptors and the inputs to each device, one transfer
+  // per buffer for the whole batch.
+  for(unsigned i = 0; i < num_active; ++i) {
+    status = clEnqueueWriteBuffer(queue[i], desc_buf[i], CL_FALSE,
+        0, entries_per_device[i] * sizeof(gemm_desc), device_desc[i], 0, NULL, NULL);
+    checkError(status, "Failed to transfer the batch descriptor");
+
+    status = clEnqueueWriteBuffer(queue[i], input_a_buf[i], CL_FALSE,
+        0, a_len[i] * sizeof(float), input_a + a_base[i], 0, NULL, NULL);
+    checkError(status, "Failed to transfer input A");
+
+    status = clEnqueueWriteBuffer(queue[i], input_b_buf[i], CL_FALSE,
+        0, b_len[i] * sizeof(float), input_b + b_base[i], 0, NULL, NULL);
+    checkError(status, "Failed to transfer input B");
+  }
+
+  // Wait for all queues to finish.
+  for(unsigned i = 0; i < num_active; ++i) {
+    clFinish(queue[i]);
+  }
+
+  // Launch kernels.
+  // This is the portion of time that we'll be measuring for throughput
+  // benchmarking.
+  scoped_array<cl_event> kernel_event(num_active);
+
+  const double start_time = getCurrentTimestamp();
+
+  for(unsigned i = 0; i < num_active; ++i) {
+    // Set kernel arguments.
+    unsigned argi = 0;
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(cl_mem), &output_buf[i]);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(cl_mem), &input_a_buf[i]);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(cl_mem), &input_b_buf[i]);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(cl_mem), &desc_buf[i]);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    const size_t local_work_size[3] = {BLOCK_SIZE, BLOCK_SIZE, 1};
+
+    if(!one_per_launch) {
+      // Enqueue kernel.
+      // One work-group per block of C of the largest entry, times the
+      // number of entries; the kernel skips the blocks a smaller entry
+      // does not have.
+      const cl_int first = 0;
+      status = clSetKernelArg(kernel[i], argi++, sizeof(first), &first);
+      checkError(status, "Failed to set argument %d", argi - 1);
+
+      const size_t global_work_size[3] = {round_up(max_n[i]), round_up(max_m[i]), entries_per_device[i]};
+      printf("Launching for device %d (global size: %d, %d, %d)\n", i,
+          (int) global_work_size[0], (int) global_work_size[1], (int) global_work_size[2]);
+
+      status = clEnqueueNDRangeKernel(queue[i], kernel[i], 3, NULL,
+          global_work_size, local_work_size, 0, NULL, &kernel_event[i]);
+      checkError(status, "Failed to launch kernel");
+    }
+    else {
+      // The same work as one NDRange per entry, sized to the entry.
+      for(unsigned j = 0; j < entries_per_device[i]; ++j) {
+        const cl_int first = j;
+        status = clSetKernelArg(kernel[i], argi, sizeof(first), &first);
+        checkError(status, "Failed to set argument %d", argi);
+
+        const size_t global_work_size[3] = {round_up(device_desc[i][j].n), round_up(device_desc[i][j].m), 1};
+        status = clEnqueueNDRangeKernel(queue[i], kernel[i], 3, NULL,
+            global_work_size, local_work_size, 0, NULL,
+            j + 1 == entries_per_device[i] ? &kernel_event[i] : NULL);
+        checkError(status, "Failed to launch kernel");
+      }
+    }
+  }
+
+  // Wait for all kernels to finish.
+  clWaitForEvents(num_active, kernel_event);
+
+  const double stop_time = getCurrentTimestamp();
+
+  const double kernel_time = stop_time - start_time;
+
+
+  // Wall-clock time taken.
+  printf("Kernel Time (%s): %0.3f ms\n", one_per_launch ? "one entry per launch" : "batched", kernel_time * 1e3);
+
+  // Get kernel times using the OpenCL event profiling API; for one entry
+  // per launch this is only the last launch.
+  if(!one_per_launch) {
+    for(unsigned i = 0; i < num_active; ++i) {
+      cl_ulong time_ns = getStartEndTime(kernel_event[i]);
+      printf("Kernel Time (using event): %0.3f ms\n", double(time_ns) * 1e-6);
+    }
+  }
+
+  // Compute the throughput (GFLOPS) of the real matrices.
+  const double flops = batch_flops(batch) / kernel_time;
+  printf("Throughput: %0.2f GFLOPS\n\n", flops * 1e-9);
+
+  // Release kernel events.
+  for(unsigned i = 0; i < num_active; ++i) {
+    clReleaseEvent(kernel_event[i]);
+  }
+
+  // Read the result.
+  for(unsigned i = 0; i < num_active; ++i) {
+    status = clEnqueueReadBuffer(queue[i], output_buf[i], CL_TRUE,
+        0, c_len[i] * sizeof(float), output + c_base[i], 0, NULL, NULL);
+    checkError(status, "Failed to read output matrix");
+  }
+
+  return flops * 1e-9;
+}
+
+void compute_reference() {
+  // Compute the reference output.
+  printf("Computing reference output\n");
+  ref_output.reset(batch.c_size);
+
+  for(unsigned i = 0; i < batch.count; ++i) {
+    const gemm_desc &e = batch.entry[i];
+    const float *a = input_a + e.a_offset;
+    const float *b = input_b + e.b_offset;
+    float *c = ref_output + e.c_offset;
+    for(int y = 0; y < e.m; ++y) {
+      for(int x = 0; x < e.n; ++x) {
+        // Compute result for C(y, x)
+        float sum = 0.0f;
+        for(int k = 0; k < e.k; ++k) {
+          sum += a[y * e.k + k] * b[k * e.n + x];
+        }
+        c[y * e.n + x] = sum;
+      }
+    }
+  }
+}
+
+bool verify() {
+  printf("Verifying\n");
+
+  // Compute the L^2-Norm of the difference between the output and reference
+  // output matrices and compare it against the L^2-Norm of the reference.
+  float diff = 0.0f;
+  float ref = 0.0f;
+  for(unsigned i = 0; i < batch.count; ++i) {
+    const gemm_desc &e = batch.entry[i];
+    for(int j = 0; j < e.m * e.n; ++j) {
+      const float o = output[e.c_offset + j];
+      const float r = ref_output[e.c_offset + j];
+      const float d = o - r;
+      diff += d * d;
+      ref += r * r;
+    }
+  }
+
+  const float diff_l2norm = sqrtf(diff);
+  const float ref_l2norm = sqrtf(ref);
+  const float error = diff_l2norm / ref_l2norm;
+  const bool pass = error < 1e-6;
+  printf("Verification: %s\n", pass ? "PASS" : "FAIL");
+  if(!pass) {
+    printf("Error (L^2-Norm): %0.3g\n", error);
+  }
+  return pass;
+}
+
+// Frees the buffers of the current batch.
+void cleanup_problem() {
+  for(unsigned i = 0; i < num_devices; ++i) {
+    if(desc_buf && desc_buf[i]) {
+      clReleaseMemObject(desc_buf[i]);
+      desc_buf[i] = NULL;
+    }
+    if(input_a_buf && input_a_buf[i]) {
+      clReleaseMemObject(input_a_buf[i]);
+      input_a_buf[i] = NULL;
+    }
+    if(input_b_buf && input_b_buf[i]) {
+      clReleaseMemObject(input_b_buf[i]);
+      input_b_buf[i] = NULL;
+    }
+    if(output_buf && output_buf[i]) {
+      clReleaseMemObject(output_buf[i]);
+      output_buf[i] = NULL;
+    }
+  }
+}
+
+// Free the resources allocated during initialization
+void cleanup() {
+  cleanup_problem();
+
+  for(unsigned i = 0; i < num_devices; ++i) {
+    if(kernel && kernel[i]) {
+      clReleaseKernel(kernel[i]);
+    }
+    if(queue && queue[i]) {
+      clReleaseCommandQueue(queue[i]);
+    }
+  }
+
+  if(program) {
+    clReleaseProgram(program);
+  }
+  if(context) {
+    clReleaseContext(context);
+  }
+}
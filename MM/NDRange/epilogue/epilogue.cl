@@ -0,0 +1,85 @@
+#ifndef SIMD_WORK_ITEMS
+#define SIMD_WORK_ITEMS 4 // default value
+#endif
+
+#ifndef BLOCK_SIZE
+#define BLOCK_SIZE 64 // default value
+#endif
+
+// Epilogue flags.
+#define EPILOGUE_BIAS 1 // add bias[col]
+#define EPILOGUE_RELU 2 // max(x, 0), after the bias
+
+
+// C = epilogue(alpha * op(A) * op(B) + beta * C), with op(X) = X or X^T.
+// op(A) has the rows of C and op(B) its columns; lda and ldb are the row
+// lengths of A and B as stored. A transposed operand is staged with the
+// roles of local_x and local_y swapped, so that its global reads stay
+// along rows and it lands in local memory in the same layout as the plain
+// one; the inner loop is that of baseline.cl. With beta == 0, C is only
+// written, as in BLAS.
+__kernel 
+__attribute((reqd_work_group_size(BLOCK_SIZE,BLOCK_SIZE,1)))
+
+void gemm( // Input and output matrices
+                 __global float *restrict C,
+                 __global const float *A,
+                 __global const float *B,
+                 __global const float *restrict bias,
+                 // Sizes of matrices.
+                 int K, int lda, int ldb,
+                 int trans_a, int trans_b,
+                 float alpha, float beta,
+                 int epilogue)
+{
+    __local float A_local[BLOCK_SIZE][BLOCK_SIZE];
+    __local float B_local[BLOCK_SIZE][BLOCK_SIZE];
+    
+    int block_x = get_group_id(0);
+    int block_y = get_group_id(1);
+    
+    int local_x = get_local_id(0);
+    int local_y = get_local_id(1);
+
+    int row0 = BLOCK_SIZE * block_y;    // first row of the block of C
+    int col0 = BLOCK_SIZE * block_x;    // first column
+
+    float running_sum = 0.0f;
+   
+    for (int k = 0; k < K; k += BLOCK_SIZE)
+    {
+        // A_local[r][kk] = op(A)[row0 + r][k + kk]
+        if (!trans_a)
+            A_local[local_y][local_x] = A[(row0 + local_y) * lda + k + local_x];
+        else
+            A_local[local_x][local_y] = A[(k + local_y) * lda + row0 + local_x];
+
+        // B_local[c][kk] = op(B)[k + kk][col0 + c]
+        if (!trans_b)
+            B_local[local_x][local_y] = B[(k + local_y) * ldb + col0 + local_x];
+        else
+            B_local[local_y][local_x] = B[(col0 + local_y) * ldb + k + local_x];
+	
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        for (int kk = 0; kk < BLOCK_SIZE; ++kk)
+        {
+            running_sum += A_local[local_y][kk] * B_local[local_x][kk];
+        }
+       
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    int col = get_global_id(0);
+    int c   = get_global_id(1) * get_global_size(0) + col;
+
+    float result = alpha * running_sum;
+    if (beta != 0.0f)
+        result += beta * C[c];
+    if (epilogue & EPILOGUE_BIAS)
+        result += bias[col];
+    if (epilogue & EPILOGUE_RELU)
+        result = fmax(result, 0.0f);
+
+    C[c] = result;
+}
@@ -0,0 +1,660 @@
+///////////////////////////////////////////////////////////////////////////////////
+// This host program executes a GEMM kernel to perform:
+//  C = epilogue(alpha * op(A) * op(B) + beta * C)
+// where op(X) is X or X^T, op(A) is a N x K matrix, op(B) is a K x M matrix
+// and C is a N x M matrix, and the epilogue optionally adds a bias per
+// column of C and applies a ReLU. All dimensions must be a multiple of
+// BLOCK_SIZE, which affects the underlying kernel.
+//
+// Options: -ta and -tb pass A and B transposed (A stored K x N, B stored
+// M x K), -alpha=<a>, -beta=<b>, -bias, -relu.
+//
+// With -bench, a set of configurations is run both fused and the way a
+// pipeline without these options does it: transposed operands are copied
+// to row-major on the host, the plain product is computed, and scaling,
+// bias and activation are separate passes over C on the host. Both are
+// timed end to end, from the stored operands to the final C on the host.
+//
+// This host program supports partitioning the problem across multiple OpenCL
+// devices if available. If there are M available devices, the problem is
+// divided so that each device operates on N/M rows, in whole blocks.
+//
+// Verification is performed against the same computation on the host CPU.
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "CL/opencl.h"
+#include "AOCLUtils/aocl_utils.h"
+
+#ifndef BLOCK_SIZE
+#define BLOCK_SIZE 64 // default value
+#endif
+
+// Epilogue flags, as in epilogue.cl.
+#define EPILOGUE_BIAS 1
+#define EPILOGUE_RELU 2
+
+using namespace aocl_utils;
+
+// One GEMM configuration.
+struct gemm_config {
+  const char *name;
+  bool trans_a, trans_b;
+  float alpha, beta;
+  int epilogue;
+};
+
+// Configurations of the benchmark.
+static const gemm_config bench_configs[] = {
+  {"plain",          false, false, 1.0f, 0.0f,  0},
+  {"alpha, beta",    false, false, 0.5f, 0.25f, 0},
+  {"bias, relu",     false, false, 1.0f, 0.0f,  EPILOGUE_BIAS | EPILOGUE_RELU},
+  {"A^T, B^T",       true,  true,  1.0f, 0.0f,  0},
+  {"all",            true,  true,  0.5f, 0.25f, EPILOGUE_BIAS | EPILOGUE_RELU}
+};
+
+// Host time of each stage of a run, in seconds.
+struct stage_times {
+  double transpose; // host copies of transposed operands to row-major
+  double upload;    // operands, and C when beta != 0
+  double kernel;
+  double download;
+  double passes;    // host passes for alpha, beta, bias and activation
+  double total() const { return transpose + upload + kernel + download + passes; }
+};
+
+// OpenCL runtime configuration
+cl_platform_id platform = NULL;
+unsigned num_devices = 0;
+scoped_array<cl_device_id> device; // num_devices elements
+cl_context context = NULL;
+scoped_array<cl_command_queue> queue; // num_devices elements
+cl_program program = NULL;
+scoped_array<cl_kernel> kernel; // num_devices elements
+scoped_array<cl_mem> input_a_buf; // num_devices elements
+scoped_array<cl_mem> input_b_buf; // num_devices elements
+scoped_array<cl_mem> bias_buf; // num_devices elements
+scoped_array<cl_mem> output_buf; // num_devices elements
+
+// Problem data.
+unsigned A_height = 2048;
+unsigned A_width  = 1024;
+const unsigned &B_height = A_width;
+unsigned B_width  = 1024;
+const unsigned &C_height = A_height;
+const unsigned &C_width  = B_width;
+
+// op(A), op(B) and the C before the product, row-major.
+scoped_aligned_ptr<float> input_a;
+scoped_aligned_ptr<float> input_b;
+scoped_aligned_ptr<float> input_c;
+scoped_aligned_ptr<float> bias; // C_width elements
+
+// A and B as stored for the current configuration: the rows of op(A) of
+// each device, transposed or not, and B transposed or not.
+scoped_array<scoped_aligned_ptr<float> > stored_a; // num_devices elements
+scoped_aligned_ptr<float> stored_b;
+
+scoped_aligned_ptr<float> output; // whole C
+scoped_array<float> product; // op(A) * op(B)
+scoped_array<float> ref_output;
+scoped_array<unsigned> rows_per_device; // num_devices elements
+scoped_array<unsigned> first_row; // num_devices elements
+
+// Function prototypes
+float rand_float();
+bool init_opencl();
+void init_problem();
+void store_operands(const gemm_config &config);
+stage_times run_fused(const gemm_config &config);
+stage_times run_separate(const gemm_config &config);
+void compute_product();
+bool verify(const gemm_config &config);
+void cleanup();
+
+// Entry point.
+int main(int argc, char **argv) {
+  Options options(argc, argv);
+  if(options.has("ah")) {
+    A_height = options.get<unsigned>("ah");
+  }
+  if(options.has("aw")) {
+    A_width = options.get<unsigned>("aw");
+  }
+  if(options.has("bw")) {
+    B_width = options.get<unsigned>("bw");
+  }
+
+  gemm_config config = {"options", options.has("ta"), options.has("tb"), 1.0f, 0.0f, 0};
+  if(options.has("alpha")) {
+    config.alpha = options.get<float>("alpha");
+  }
+  if(options.has("beta")) {
+    config.beta = options.get<float>("beta");
+  }
+  if(options.has("bias")) {
+    config.epilogue |= EPILOGUE_BIAS;
+  }
+  if(options.has("relu")) {
+    config.epilogue |= EPILOGUE_RELU;
+  }
+  const bool bench = options.has("bench");
+
+  printf("Matrix sizes:\n  op(A): %d x %d\n  op(B): %d x %d\n  C: %d x %d\n",
+      A_height, A_width, B_height, B_width, C_height, C_width);
+
+  // Spot check matrix sizes. They all must be a multiple of BLOCK_SIZE,
+  // although it is relatively straightforward to handle non-multiples
+  // by adding padding. For simplicity, this example does not pad.
+  if((A_height % BLOCK_SIZE) != 0 || (A_width % BLOCK_SIZE) != 0 ||
+     (B_height % BLOCK_SIZE) != 0 || (B_width % BLOCK_SIZE) != 0 ||
+     (C_height % BLOCK_SIZE) != 0 || (C_width % BLOCK_SIZE) != 0) {
+    printf("Matrix sizes must be a multiple of %d.\n", BLOCK_SIZE);
+    return -1;
+  }
+
+  // Initialize OpenCL.
+  if(!init_opencl()) {
+    return -1;
+  }
+
+  // Initialize the problem data. The product does not depend on how the
+  // operands are stored, so it is computed once.
+  init_problem();
+  compute_product();
+
+  if(!bench) {
+    printf("\ntrans_a %d, trans_b %d, alpha %g, beta %g, bias %d, relu %d\n",
+        config.trans_a, config.trans_b, config.alpha, config.beta,
+        (config.epilogue & EPILOGUE_BIAS) != 0, (config.epilogue & EPILOGUE_RELU) != 0);
+    store_operands(config);
+    const stage_times t = run_fused(config);
+    printf("Kernel Time: %0.3f ms\n", t.kernel * 1e3);
+    printf("Throughput: %0.2f GFLOPS\n", 2.0 * C_width * C_height * A_width / t.kernel * 1e-9);
+    verify(config);
+  }
+  else {
+    const unsigned num_configs = sizeof(bench_configs) / sizeof(bench_configs[0]);
+    scoped_array<stage_times> fused(num_configs), separate(num_configs);
+    scoped_array<bool> fused_pass(num_configs), separate_pass(num_configs);
+
+    for(unsigned c = 0; c < num_configs; ++c) {
+      printf("\n==== %s ====\n", bench_configs[c].name);
+      store_operands(bench_configs[c]);
+      fused[c] = run_fused(bench_configs[c]);
+      fused_pass[c] = verify(bench_configs[c]);
+      separate[c] = run_separate(bench_configs[c]);
+      separate_pass[c] = verify(bench_configs[c]);
+    }
+
+    printf("\nEnd-to-end time (ms)\n");
+    printf("%-12s %10s %10s %10s %10s %10s %8s %6s\n", "", "fused", "kernel",
+        "separate", "transpose", "passes", "speedup", "check");
+    for(unsigned c = 0; c < num_configs; ++c) {
+      printf("%-12s %10.2f %10.2f %10.2f %10.2f %10.2f %7.2fx %6s\n", bench_configs[c].name,
+          fused[c].total() * 1e3, fused[c].kernel * 1e3, separate[c].total() * 1e3,
+          separate[c].transpose * 1e3, separate[c].passes * 1e3, separate[c].total() / fused[c].total(),
+          fused_pass[c] && separate_pass[c] ? "PASS" : "FAIL");
+    }
+  }
+
+  // Free the resources allocated
+  cleanup();
+
+  return 0;
+}
+
+/////// HELPER FUNCTIONS ///////
+
+// Randomly generate a floating-point number between -10 and 10.
+float rand_float() {
+  return float(rand()) / float(RAND_MAX) * 20.0f - 10.0f;
+}
+
+// Initializes the OpenCL objects.
+bool init_opencl() {
+  cl_int status;
+
+  printf("Initializing OpenCL\n");
+
+  if(!setCwdToExeDir()) {
+    return false;
+  }
+
+  // Get the OpenCL platform.
+  platform = findPlatform("Intel(R) FPGA");
+  if(platform == NULL) {
+    printf("ERROR: Unable to find Intel(R) FPGA OpenCL platform.\n");
+    return false;
+  }
+
+  // Query the available OpenCL device.
+  device.reset(getDevices(platform, CL_DEVICE_TYPE_ALL, &num_devices));
+  printf("Platform: %s\n", getPlatformName(platform).c_str());
+  printf("Using %d device(s)\n", num_devices);
+  for(unsigned i = 0; i < num_devices; ++i) {
+    printf("  %s\n", getDeviceName(device[i]).c_str());
+  }
+
+  // Create the context.
+  context = clCreateContext(NULL, num_devices, device, &oclContextCallback, NULL, &status);
+  checkError(status, "Failed to create context");
+
+  // Create the program for all device. Use the first device as the
+  // representative device (assuming all device are of the same type).  
+  std::string binary_file = getBoardBinaryFile("epilogue", device[0]);
+  printf("Using AOCX: %s\n", binary_file.c_str());
+  program = createProgramFromBinary(context, binary_file.c_str(), device, num_devices);
+
+  // Build the program that was just created.
+  status = clBuildProgram(program, 0, NULL, "", NULL, NULL);
+  checkError(status, "Failed to build program");
+
+  // Create per-device objects.
+  queue.reset(num_devices);
+  kernel.reset(num_devices);
+  rows_per_device.reset(num_devices);
+  first_row.reset(num_devices);
+  input_a_buf.reset(num_devices);
+  input_b_buf.reset(num_devices);
+  bias_buf.reset(num_devices);
+  output_buf.reset(num_devices);
+
+  const unsigned num_block_rows = C_height / BLOCK_SIZE;
+
+  for(unsigned i = 0, row = 0; i < num_devices; ++i) {
+    // Command queue.
+    queue[i] = clCreateCommandQueue(context, device[i], CL_QUEUE_PROFILING_ENABLE, &status);
+    checkError(status, "Failed to create command queue");
+
+    // Kernel.
+    const char *kernel_name = "gemm";
+    kernel[i] = clCreateKernel(program, kernel_name, &status);
+    checkError(status, "Failed to create kernel");
+
+    // Determine the number of rows processed by this device.
+    // First do this computation in block-rows.
+    rows_per_device[i] = num_block_rows / num_devices; // this is the number of block-rows
+
+    // Spread out the remainder of the block-rows over the first
+    // N % num_devices.
+    if(i < (num_block_rows % num_devices)) {
+      rows_per_device[i]++;
+    }
+
+    // Multiply by BLOCK_SIZE to get the actual number of rows.
+    rows_per_device[i] *= BLOCK_SIZE;
+    first_row[i] = row;
+    row += rows_per_device[i];
+
+    // Input buffers.
+    // For matrix A, each device only needs the rows of op(A) corresponding
+    // to the rows of the output matrix. We specifically
+    // assign this buffer to the first bank of global memory.
+    input_a_buf[i] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_BANK_1_ALTERA, 
+        rows_per_device[i] * A_width * sizeof(float), NULL, &status);
+    checkError(status, "Failed to create buffer for input A");
+
+    // For matrix B, each device needs the whole matrix. We specifically
+    // assign this buffer to the second bank of global memory.
+    input_b_buf[i] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_BANK_2_ALTERA, 
+        B_height * B_width * sizeof(float), NULL, &status);
+    checkError(status, "Failed to create buffer for input B");
+
+    bias_buf[i] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_BANK_2_ALTERA, 
+        C_width * sizeof(float), NULL, &status);
+    checkError(status, "Failed to create buffer for bias");
+
+    // Output buffer, read as well when beta != 0.
+    output_buf[i] = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_BANK_1_ALTERA, 
+        rows_per_device[i] * C_width * sizeof(float), NULL, &status);
+    checkError(status, "Failed to create buffer for output");
+  }
+
+  return true;
+}
+
+// Initialize the data for the problem. Requires num_devices to be known.
+void init_problem() {
+  if(num_devices == 0) {
+    checkError(-1, "No devices");
+  }
+
+  printf("Generating input matrices\n");
+  input_a.reset(A_height * A_width);
+  input_b.reset(B_height * B_width);
+  input_c.reset(C_height * C_width);
+  output.reset(C_height * C_width);
+  bias.reset(C_width);
+  for(unsigned j = 0; j < A_height * A_width; ++j) {
+    input_a[j] = rand_float();
+  }
+  for(unsigned j = 0; j < B_height * B_width; ++j) {
+    input_b[j] = rand_float();
+  }
+  for(unsigned j = 0; j < C_height * C_width; ++j) {
+    input_c[j] = rand_float();
+  }
+  for(unsigned j = 0; j < C_width; ++j) {
+    bias[j] = rand_float();
+  }
+
+  stored_a.reset(num_devices);
+  for(unsigned i = 0; i < num_devices; ++i) {
+    stored_a[i].reset(rows_per_device[i] * A_width);
+  }
+  stored_b.reset(B_height * B_width);
+}
+
+// Lays out A and B as they arrive for the configuration: the rows of op(A)
+// of device i as rows_per_device[i] x K, or as K x rows_per_device[i] with
+// trans_a; B as K x M, or as M x K with trans_b. Not timed.
+void store_operands(const gemm_config &config) {
+  for(unsigned i = 0; i < num_devices; ++i) {
+    const unsigned rows = rows_per_device[i];
+    for(unsigned y = 0; y < rows; ++y) {
+      for(unsigned k = 0; k < A_width; ++k) {
+        const float a = input_a[(first_row[i] + y) * A_width + k];
+        stored_a[i][config.trans_a ? k * rows + y : y * A_width + k] = a;
+      }
+    }
+  }
+  for(unsigned k = 0; k < B_height; ++k) {
+    for(unsigned x = 0; x < B_width; ++x) {
+      stored_b[config.trans_b ? x * B_height + k : k * B_width + x] = input_b[k * B_width + x];
+    }
+  }
+}
+
+// Uploads the operands, runs the kernel and reads C. The C of the
+// previous run is replaced by input_c first, as the kernel reads it when
+// beta != 0.
+static void run_kernel(const gemm_config &config, const float *const *a, const float *b, stage_times &t) {
+  cl_int status;
+
+  for(unsigned j = 0; j < C_height * C_width; ++j) {
+    output[j] = input_c[j];
+  }
+
+  double time = getCurrentTimestamp();
+
+  // Transfer inputs to each device. Each of the host buffers supplied to
+  // clEnqueueWriteBuffer here is already aligned to ensure that DMA is used
+  // for the host-to-device transfer.
+  for(unsigned i = 0; i < num_devices; ++i) {
+    status = clEnqueueWriteBuffer(queue[i], input_a_buf[i], CL_FALSE,
+        0, rows_per_device[i] * A_width * sizeof(float), a[i], 0, NULL, NULL);
+    checkError(status, "Failed to transfer input A");
+
+    status = clEnqueueWriteBuffer(queue[i], input_b_buf[i], CL_FALSE,
+        0, B_width * B_height * sizeof(float), b, 0, NULL, NULL);
+    checkError(status, "Failed to transfer input B");
+
+    if(config.epilogue & EPILOGUE_BIAS) {
+      status = clEnqueueWriteBuffer(queue[i], bias_buf[i], CL_FALSE,
+          0, C_width * sizeof(float), bias, 0, NULL, NULL);
+      checkError(status, "Failed to transfer bias");
+    }
+
+    if(config.beta != 0.0f) {
+      status = clEnqueueWriteBuffer(queue[i], output_buf[i], CL_FALSE,
+          0, rows_per_device[i] * C_width * sizeof(float), output + first_row[i] * C_width, 0, NULL, NULL);
+      checkError(status, "Failed to transfer input C");
+    }
+  }
+
+  // Wait for all queues to finish.
+  for(unsigned i = 0; i < num_devices; ++i) {
+    clFinish(queue[i]);
+  }
+
+  t.upload = getCurrentTimestamp() - time;
+
+  // Launch kernels.
+  scoped_array<cl_event> kernel_event(num_devices);
+
+  time = getCurrentTimestamp();
+
+  for(unsigned i = 0; i < num_devices; ++i) {
+    const cl_int K = A_width;
+    const cl_int lda = config.trans_a ? rows_per_device[i] : A_width;
+    const cl_int ldb = config.trans_b ? B_height : B_width;
+    const cl_int trans_a = config.trans_a, trans_b = config.trans_b;
+    const cl_int epilogue = config.epilogue;
+
+    // Set kernel arguments.
+    unsigned argi = 0;
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(cl_mem), &output_buf[i]);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(cl_mem), &input_a_buf[i]);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(cl_mem), &input_b_buf[i]);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(cl_mem), &bias_buf[i]);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(K), &K);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(lda), &lda);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(ldb), &ldb);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(trans_a), &trans_a);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(trans_b), &trans_b);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(config.alpha), &config.alpha);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(config.beta), &config.beta);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(epilogue), &epilogue);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    // Enqueue kernel.
+    const size_t global_work_size[2] = {C_width, rows_per_device[i]};
+    const size_t local_work_size[2]  = {BLOCK_SIZE, BLOCK_SIZE};
+
+	status = clEnqueueNDRangeKernel(queue[i], kernel[i], 2, NULL,
+        global_work_size, local_work_size, 0, NULL, &kernel_event[i]);
+    checkError(status, "Failed to launch kernel");
+  }
+
+  // Wait for all kernels to finish.
+  clWaitForEvents(num_devices, kernel_event);
+
+  t.kernel = getCurrentTimestamp() - time;
+
+  // Release kernel events.
+  for(unsigned i = 0; i < num_devices; ++i) {
+    clReleaseEvent(kernel_event[i]);
+  }
+
+  // Read the result.
+  time = getCurrentTimestamp();
+  for(unsigned i = 0; i < num_devices; ++i) {
+    status = clEnqueueReadBuffer(queue[i], output_buf[i], CL_TRUE,
+        0, rows_per_device[i] * C_width * sizeof(float), output + first_row[i] * C_width, 0, NULL, NULL);
+    checkError(status, "Failed to read output matrix");
+  }
+  t.download = getCurrentTimestamp() - time;
+}
+
+// Everything in the kernel: the stored operands go up as they are.
+stage_times run_fused(const gemm_config &config) {
+  stage_times t = {0.0, 0.0, 0.0, 0.0, 0.0};
+  scoped_array<const float *> a(num_devices);
+  for(unsigned i = 0; i < num_devices; ++i) {
+    a[i] = stored_a[i];
+  }
+
+  run_kernel(config, a, stored_b, t);
+  printf("Fused: %0.3f ms (kernel %0.3f ms)\n", t.total() * 1e3, t.kernel * 1e3);
+  return t;
+}
+
+// The plain product plus host passes: transposed operands are copied to
+// row-major first, and every term of the epilogue is one pass over C.
+stage_times run_separate(const gemm_config &config) {
+  stage_times t = {0.0, 0.0, 0.0, 0.0, 0.0};
+  const gemm_config plain = {"plain", false, false, 1.0f, 0.0f, 0};
+
+  double time = getCurrentTimestamp();
+
+  scoped_array<scoped_aligned_ptr<float> > row_major_a(num_devices);
+  scoped_array<const float *> a(num_devices);
+  for(unsigned i = 0; i < num_devices; ++i) {
+    a[i] = stored_a[i];
+    if(config.trans_a) {
+      const unsigned rows = rows_per_device[i];
+      row_major_a[i].reset(rows * A_width);
+      for(unsigned y = 0; y < rows; ++y) {
+        for(unsigned k = 0; k < A_width; ++k) {
+          row_major_a[i][y * A_width + k] = stored_a[i][k * rows + y];
+        }
+      }
+      a[i] = row_major_a[i];
+    }
+  }
+
+  scoped_aligned_ptr<float> row_major_b;
+  const float *b = stored_b;
+  if(config.trans_b) {
+    row_major_b.reset(B_height * B_width);
+    for(unsigned k = 0; k < B_height; ++k) {
+      for(unsigned x = 0; x < B_width; ++x) {
+        row_major_b[k * B_width + x] = stored_b[x * B_height + k];
+      }
+    }
+    b = row_major_b;
+  }
+
+  t.transpose = getCurrentTimestamp() - time;
+
+  run_kernel(plain, a, b, t);
+
+  time = getCurrentTimestamp();
+
+  if(config.alpha != 1.0f || config.beta != 0.0f) {
+    for(unsigned j = 0; j < C_height * C_width; ++j) {
+      output[j] = config.alpha * output[j] + config.beta * input_c[j];
+    }
+  }
+  if(config.epilogue & EPILOGUE_BIAS) {
+    for(unsigned y = 0; y < C_height; ++y) {
+      for(unsigned x = 0; x < C_width; ++x) {
+        output[y * C_width + x] += bias[x];
+      }
+    }
+  }
+  if(config.epilogue & EPILOGUE_RELU) {
+    for(unsigned j = 0; j < C_height * C_width; ++j) {
+      output[j] = output[j] > 0.0f ? output[j] : 0.0f;
+    }
+  }
+
+  t.passes = getCurrentTimestamp() - time;
+
+  printf("Separate: %0.3f ms (kernel %0.3f ms)\n", t.total() * 1e3, t.kernel * 1e3);
+  return t;
+}
+
+void compute_product() {
+  // Compute the reference product.
+  printf("Computing reference output\n");
+  product.reset(C_height * C_width);
+  ref_output.reset(C_height * C_width);
+
+  for(unsigned y = 0; y < C_height; ++y) {
+    for(unsigned x = 0; x < C_width; ++x) {
+      // Compute result for C(y, x)
+      float sum = 0.0f;
+      for(unsigned k = 0; k < A_width; ++k) {
+        sum += input_a[y * A_width + k] * input_b[k * B_width + x];
+      }
+      product[y * C_width + x] = sum;
+    }
+  }
+}
+
+bool verify(const gemm_config &config) {
+  printf("Verifying\n");
+
+  // The reference of the configuration, from the product.
+  for(unsigned y = 0; y < C_height; ++y) {
+    for(unsigned x = 0; x < C_width; ++x) {
+      float r = config.alpha * product[y * C_width + x];
+      if(config.beta != 0.0f) {
+        r += config.beta * input_c[y * C_width + x];
+      }
+      if(config.epilogue & EPILOGUE_BIAS) {
+        r += bias[x];
+      }
+      if(config.epilogue & EPILOGUE_RELU) {
+        r = r > 0.0f ? r : 0.0f;
+      }
+      ref_output[y * C_width + x] = r;
+    }
+  }
+
+  // Compute the L^2-Norm of the difference between the output and reference
+  // output matrices and compare it against the L^2-Norm of the reference.
+  double diff = 0.0;
+  double ref = 0.0;
+  for(unsigned j = 0; j < C_height * C_width; ++j) {
+    const double d = output[j] - ref_output[j];
+    diff += d * d;
+    ref += double(ref_output[j]) * ref_output[j];
+  }
+
+  const double error = sqrt(diff) / sqrt(ref);
+  const bool pass = error < 1e-6;
+  printf("Verification: %s\n", pass ? "PASS" : "FAIL");
+  if(!pass) {
+    printf("Error (L^2-Norm): %0.3g\n", error);
+  }
+  return pass;
+}
+
+// Free the resources allocated during initialization
+void cleanup() {
+  for(unsigned i = 0; i < num_devices; ++i) {
+    if(kernel && kernel[i]) {
+      clReleaseKernel(kernel[i]);
+    }
+    if(queue && queue[i]) {
+      clReleaseCommandQueue(queue[i]);
+    }
+    if(input_a_buf && input_a_buf[i]) {
+      clReleaseMemObject(input_a_buf[i]);
+    }
+    if(input_b_buf && input_b_buf[i]) {
+      clReleaseMemObject(input_b_buf[i]);
+    }
+    if(bias_buf && bias_buf[i]) {
+      clReleaseMemObject(bias_buf[i]);
+    }
+    if(output_buf && output_buf[i]) {
+      clReleaseMemObject(output_buf[i]);
+    }
+  }
+
+  if(program) {
+    clReleaseProgram(program);
+  }
+  if(context) {
+    clReleaseContext(context);
+  }
+}
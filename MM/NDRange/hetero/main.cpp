@@ -0,0 +1,570 @@
+///////////////////////////////////////////////////////////////////////////////////
+// This host program executes a matrix multiplication kernel to perform:
+//  C = A * B
+// where A is a N x K matrix, B is a K x M matrix and C is a N x M matrix.
+// All dimensions must be a multiple of BLOCK_SIZE, which affects the
+// underlying kernel.
+//
+// The host CPU computes a share of the block-rows of C at the same time as
+// the OpenCL devices compute the rest. The CPU GEMM is cache-blocked and
+// multi-threaded with OpenMP, and its inner loop is vectorised. Devices
+// and CPU read A in place and write their rows straight into one C.
+//
+// The split comes from measured rates. First the CPU alone and then the
+// devices alone run the whole product; the CPU gets the share of
+// block-rows given by its GFLOPS. Each combined run then re-measures both
+// sides and moves the split (-tune=<rounds>, 2 by default). -cpu_share=<f>
+// fixes the split instead.
+//
+// Like in baseline, the timed part is the compute; inputs are on the
+// devices beforehand.
+//
+// Verification is performed against the same computation on the host CPU.
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <omp.h>
+#include "CL/opencl.h"
+#include "AOCLUtils/aocl_utils.h"
+
+#ifndef BLOCK_SIZE
+#define BLOCK_SIZE 64 // default value
+#endif
+
+// Cache blocking of the CPU GEMM: a KC x NC block of B is reused from the
+// cache by all rows of a thread's block-row.
+#ifndef CPU_KC
+#define CPU_KC 256
+#endif
+#ifndef CPU_NC
+#define CPU_NC 512
+#endif
+
+using namespace aocl_utils;
+
+// OpenCL runtime configuration
+cl_platform_id platform = NULL;
+unsigned num_devices = 0;
+scoped_array<cl_device_id> device; // num_devices elements
+cl_context context = NULL;
+scoped_array<cl_command_queue> queue; // num_devices elements
+cl_program program = NULL;
+scoped_array<cl_kernel> kernel; // num_devices elements
+scoped_array<cl_mem> input_a_buf; // num_devices elements
+scoped_array<cl_mem> input_b_buf; // num_devices elements
+scoped_array<cl_mem> output_buf; // num_devices elements
+
+// Problem data.
+unsigned A_height = 2048;
+unsigned A_width  = 1024;
+const unsigned &B_height = A_width;
+unsigned B_width  = 1024;
+const unsigned &C_height = A_height;
+const unsigned &C_width  = B_width;
+
+scoped_aligned_ptr<float> input_a; // whole A
+scoped_aligned_ptr<float> input_b;
+scoped_aligned_ptr<float> output; // whole C
+scoped_array<float> ref_output;
+
+// Current split: rows [0, cpu_rows) on the CPU, then rows_per_device[i]
+// rows from first_row[i] on device i.
+unsigned cpu_rows = 0;
+scoped_array<unsigned> rows_per_device; // num_devices elements
+scoped_array<unsigned> first_row; // num_devices elements
+
+// Results of one run.
+struct run_stats {
+  double gflops;        // whole product, wall clock
+  double cpu_gflops;    // CPU rows over CPU time
+  double device_gflops; // device rows over the slowest device
+};
+
+// Function prototypes
+float rand_float();
+bool init_opencl();
+void init_problem();
+void set_split(unsigned cpu_block_rows);
+void cpu_gemm(unsigned row_begin, unsigned row_end);
+run_stats run();
+void compute_reference();
+bool verify();
+void cleanup();
+
+// Entry point.
+int main(int argc, char **argv) {
+  Options options(argc, argv);
+  if(options.has("ah")) {
+    A_height = options.get<unsigned>("ah");
+  }
+  if(options.has("aw")) {
+    A_width = options.get<unsigned>("aw");
+  }
+  if(options.has("bw")) {
+    B_width = options.get<unsigned>("bw");
+  }
+  const int tune_rounds = options.has("tune") ? options.get<int>("tune") : 2;
+  const double fixed_share = options.has("cpu_share") ? options.get<double>("cpu_share") : -1.0;
+
+  printf("Matrix sizes:\n  A: %d x %d\n  B: %d x %d\n  C: %d x %d\n",
+      A_height, A_width, B_height, B_width, C_height, C_width);
+
+  // Spot check matrix sizes. They all must be a multiple of BLOCK_SIZE,
+  // although it is relatively straightforward to handle non-multiples
+  // by adding padding. For simplicity, this example does not pad.
+  if((A_height % BLOCK_SIZE) != 0 || (A_width % BLOCK_SIZE) != 0 ||
+     (B_height % BLOCK_SIZE) != 0 || (B_width % BLOCK_SIZE) != 0 ||
+     (C_height % BLOCK_SIZE) != 0 || (C_width % BLOCK_SIZE) != 0) {
+    printf("Matrix sizes must be a multiple of %d.\n", BLOCK_SIZE);
+    return -1;
+  }
+
+  // Initialize OpenCL.
+  if(!init_opencl()) {
+    return -1;
+  }
+
+  // Initialize the problem data.
+  init_problem();
+  compute_reference();
+
+  const unsigned num_block_rows = C_height / BLOCK_SIZE;
+  printf("CPU: %d thread(s)\n", omp_get_max_threads());
+
+  // CPU alone and devices alone, which also give the rates of the split.
+  printf("\n==== CPU only ====\n");
+  set_split(num_block_rows);
+  const run_stats cpu_only = run();
+  const bool cpu_pass = verify();
+
+  printf("\n==== Device(s) only ====\n");
+  set_split(0);
+  const run_stats device_only = run();
+  const bool device_pass = verify();
+
+  // The CPU share of the rows that makes both sides finish together.
+  double cpu_rate = cpu_only.cpu_gflops, device_rate = device_only.device_gflops;
+  double share = fixed_share >= 0.0 ? fixed_share : cpu_rate / (cpu_rate + device_rate);
+
+  run_stats combined;
+  bool combined_pass = true;
+  for(int round = 0; ; ++round) {
+    unsigned cpu_block_rows = unsigned(share * num_block_rows + 0.5);
+    cpu_block_rows = cpu_block_rows > num_block_rows ? num_block_rows : cpu_block_rows;
+
+    printf("\n==== Combined, CPU share %0.1f%% (%d of %d block-rows) ====\n",
+        100.0 * share, cpu_block_rows, num_block_rows);
+    set_split(cpu_block_rows);
+    combined = run();
+    combined_pass = verify();
+
+    if(fixed_share >= 0.0 || round >= tune_rounds) {
+      break;
+    }
+
+    // Re-tune from the rates observed while both sides were running; a side
+    // without rows keeps its previous rate.
+    if(combined.cpu_gflops > 0.0) {
+      cpu_rate = combined.cpu_gflops;
+    }
+    if(combined.device_gflops > 0.0) {
+      device_rate = combined.device_gflops;
+    }
+    share = cpu_rate / (cpu_rate + device_rate);
+  }
+
+  printf("\n%-12s %10s %6s\n", "", "GFLOPS", "check");
+  printf("%-12s %10.2f %6s\n", "CPU only", cpu_only.gflops, cpu_pass ? "PASS" : "FAIL");
+  printf("%-12s %10.2f %6s\n", "device only", device_only.gflops, device_pass ? "PASS" : "FAIL");
+  printf("%-12s %10.2f %6s  (CPU share %0.1f%%)\n", "combined", combined.gflops,
+      combined_pass ? "PASS" : "FAIL", 100.0 * cpu_rows / C_height);
+
+  // Free the resources allocated
+  cleanup();
+
+  return 0;
+}
+
+/////// HELPER FUNCTIONS ///////
+
+// Randomly generate a floating-point number between -10 and 10.
+float rand_float() {
+  return float(rand()) / float(RAND_MAX) * 20.0f - 10.0f;
+}
+
+// Initializes the OpenCL objects.
+bool init_opencl() {
+  cl_int status;
+
+  printf("Initializing OpenCL\n");
+
+  if(!setCwdToExeDir()) {
+    return false;
+  }
+
+  // Get the OpenCL platform.
+  platform = findPlatform("Intel(R) FPGA");
+  if(platform == NULL) {
+    printf("ERROR: Unable to find Intel(R) FPGA OpenCL platform.\n");
+    return false;
+  }
+
+  // Query the available OpenCL device.
+  device.reset(getDevices(platform, CL_DEVICE_TYPE_ALL, &num_devices));
+  printf("Platform: %s\n", getPlatformName(platform).c_str());
+  printf("Using %d device(s)\n", num_devices);
+  for(unsigned i = 0; i < num_devices; ++i) {
+    printf("  %s\n", getDeviceName(device[i]).c_str());
+  }
+
+  // Create the context.
+  context = clCreateContext(NULL, num_devices, device, &oclContextCallback, NULL, &status);
+  checkError(status, "Failed to create context");
+
+  // Create the program for all device. Use the first device as the
+  // representative device (assuming all device are of the same type).  
+  std::string binary_file = getBoardBinaryFile("hetero", device[0]);
+  printf("Using AOCX: %s\n", binary_file.c_str());
+  program = createProgramFromBinary(context, binary_file.c_str(), device, num_devices);
+
+  // Build the program that was just created.
+  status = clBuildProgram(program, 0, NULL, "", NULL, NULL);
+  checkError(status, "Failed to build program");
+
+  // Create per-device objects.
+  queue.reset(num_devices);
+  kernel.reset(num_devices);
+  rows_per_device.reset(num_devices);
+  first_row.reset(num_devices);
+  input_a_buf.reset(num_devices);
+  input_b_buf.reset(num_devices);
+  output_buf.reset(num_devices);
+
+  // The buffers are sized for the largest share a device can get, which
+  // is with the CPU idle.
+  const unsigned num_block_rows = C_height / BLOCK_SIZE;
+  const unsigned max_rows = (num_block_rows + num_devices - 1) / num_devices * BLOCK_SIZE;
+
+  for(unsigned i = 0; i < num_devices; ++i) {
+    // Command queue.
+    queue[i] = clCreateCommandQueue(context, device[i], CL_QUEUE_PROFILING_ENABLE, &status);
+    checkError(status, "Failed to create command queue");
+
+    // Kernel.
+    const char *kernel_name = "matrixMult";
+    kernel[i] = clCreateKernel(program, kernel_name, &status);
+    checkError(status, "Failed to create kernel");
+
+    // Input buffers.
+    // For matrix A, each device only needs the rows corresponding
+    // to the rows of the output matrix. We specifically
+    // assign this buffer to the first bank of global memory.
+    input_a_buf[i] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_BANK_1_ALTERA, 
+        max_rows * A_width * sizeof(float), NULL, &status);
+    checkError(status, "Failed to create buffer for input A");
+
+    // For matrix B, each device needs the whole matrix. We specifically
+    // assign this buffer to the second bank of global memory.
+    input_b_buf[i] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_BANK_2_ALTERA, 
+        B_height * B_width * sizeof(float), NULL, &status);
+    checkError(status, "Failed to create buffer for input B");
+
+    // Output buffer. This is matrix C, for the rows that are computed by this
+    // device.
+    output_buf[i] = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_BANK_1_ALTERA, 
+        max_rows * C_width * sizeof(float), NULL, &status);
+    checkError(status, "Failed to create buffer for output");
+  }
+
+  return true;
+}
+
+// Initialize the data for the problem. A and C are kept whole, as the rows
+// of each side change with the split; every share starts on a block-row,
+// so the pointers into them stay aligned for DMA.
+void init_problem() {
+  if(num_devices == 0) {
+    checkError(-1, "No devices");
+  }
+
+  printf("Generating input matrices\n");
+  input_a.reset(A_height * A_width);
+  output.reset(C_height * C_width);
+  for(unsigned j = 0; j < A_height * A_width; ++j) {
+    input_a[j] = rand_float();
+  }
+
+  input_b.reset(B_height * B_width);
+  for(unsigned i = 0; i < B_height * B_width; ++i) {
+    input_b[i] = rand_float();
+  }
+}
+
+// Gives the first cpu_block_rows block-rows to the CPU and spreads the
+// rest over the devices.
+void set_split(unsigned cpu_block_rows) {
+  const unsigned num_block_rows = C_height / BLOCK_SIZE;
+  const unsigned device_block_rows = num_block_rows - cpu_block_rows;
+
+  cpu_rows = cpu_block_rows * BLOCK_SIZE;
+  for(unsigned i = 0, row = cpu_rows; i < num_devices; ++i) {
+    // Spread out the remainder of the block-rows over the first
+    // N % num_devices.
+    rows_per_device[i] = device_block_rows / num_devices;
+    if(i < (device_block_rows % num_devices)) {
+      rows_per_device[i]++;
+    }
+    rows_per_device[i] *= BLOCK_SIZE;
+    first_row[i] = row;
+    row += rows_per_device[i];
+  }
+}
+
+// C = A * B for rows [row_begin, row_end) on the CPU. The rows are dealt
+// to the threads one block-row at a time. Each thread walks B in KC x NC
+// blocks that stay in its cache while it sweeps its rows. For every row
+// and k the inner loop adds a[k] * B[k][j..j+NC) to C[i][j..j+NC), which
+// the compiler vectorises. The k order of the sums is that of the
+// reference.
+void cpu_gemm(unsigned row_begin, unsigned row_end) {
+  const int num_block_rows = (row_end - row_begin) / BLOCK_SIZE;
+
+  #pragma omp parallel for schedule(dynamic)
+  for(int block = 0; block < num_block_rows; ++block) {
+    const unsigned y0 = row_begin + block * BLOCK_SIZE;
+
+    for(unsigned y = y0; y < y0 + BLOCK_SIZE; ++y) {
+      float *c = output + y * C_width;
+      for(unsigned x = 0; x < C_width; ++x) {
+        c[x] = 0.0f;
+      }
+    }
+
+    for(unsigned x0 = 0; x0 < C_width; x0 += CPU_NC) {
+      const unsigned nc = C_width - x0 < CPU_NC ? C_width - x0 : CPU_NC;
+      for(unsigned k0 = 0; k0 < A_width; k0 += CPU_KC) {
+        const unsigned kc = A_width - k0 < CPU_KC ? A_width - k0 : CPU_KC;
+        for(unsigned y = y0; y < y0 + BLOCK_SIZE; ++y) {
+          const float *a = input_a + y * A_width + k0;
+          float *c = output + y * C_width + x0;
+          for(unsigned k = 0; k < kc; ++k) {
+            const float a_k = a[k];
+            const float *b = input_b + (k0 + k) * B_width + x0;
+            #pragma omp simd
+            for(unsigned x = 0; x < nc; ++x) {
+              c[x] += a_k * b[x];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// Runs the product with the current split; returns its throughput.
+run_stats run() {
+  cl_int status;
+
+  // Transfer inputs to each device. Each of the host buffers supplied to
+  // clEnqueueWriteBuffer here is already aligned to ensure that DMA is used
+  // for the host-to-device transfer.
+  for(unsigned i = 0; i < num_devices; ++i) {
+    if(rows_per_device[i] == 0) {
+      continue;
+    }
+
+    status = clEnqueueWriteBuffer(queue[i], input_a_buf[i], CL_FALSE,
+        0, rows_per_device[i] * A_width * sizeof(float), input_a + first_row[i] * A_width, 0, NULL, NULL);
+    checkError(status, "Failed to transfer input A");
+
+    status = clEnqueueWriteBuffer(queue[i], input_b_buf[i], CL_FALSE,
+        0, B_width * B_height * sizeof(float), input_b, 0, NULL, NULL);
+    checkError(status, "Failed to transfer input B");
+  }
+
+  // Wait for all queues to finish.
+  for(unsigned i = 0; i < num_devices; ++i) {
+    clFinish(queue[i]);
+  }
+
+  // Launch kernels, then run the CPU rows while they execute.
+  // This is the portion of time that we'll be measuring for throughput
+  // benchmarking.
+  scoped_array<cl_event> kernel_event(num_devices);
+  unsigned num_events = 0;
+
+  const double start_time = getCurrentTimestamp();
+
+  for(unsigned i = 0; i < num_devices; ++i) {
+    if(rows_per_device[i] == 0) {
+      continue;
+    }
+
+    // Set kernel arguments.
+    unsigned argi = 0;
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(cl_mem), &output_buf[i]);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(cl_mem), &input_a_buf[i]);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(cl_mem), &input_b_buf[i]);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(A_width), &A_width);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(B_width), &B_width);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    // Enqueue kernel.
+    const size_t global_work_size[2] = {C_width, rows_per_device[i]};
+    const size_t local_work_size[2]  = {BLOCK_SIZE, BLOCK_SIZE};
+    printf("Launching for device %d (global size: %d, %d)\n", i, (int) global_work_size[0], (int) global_work_size[1]);
+
+	status = clEnqueueNDRangeKernel(queue[i], kernel[i], 2, NULL,
+        global_work_size, local_work_size, 0, NULL, &kernel_event[num_events++]);
+    checkError(status, "Failed to launch kernel");
+
+    clFlush(queue[i]);
+  }
+
+  double cpu_time = 0.0;
+  if(cpu_rows > 0) {
+    cpu_gemm(0, cpu_rows);
+    cpu_time = getCurrentTimestamp() - start_time;
+  }
+
+  // Wait for all kernels to finish.
+  if(num_events > 0) {
+    clWaitForEvents(num_events, kernel_event);
+  }
+
+  const double stop_time = getCurrentTimestamp();
+
+  const double kernel_time = stop_time - start_time;
+
+
+  // Wall-clock time taken.
+  printf("Time: %0.3f ms\n", kernel_time * 1e3);
+  if(cpu_rows > 0) {
+    printf("CPU Time: %0.3f ms\n", cpu_time * 1e3);
+  }
+
+  // Get kernel times using the OpenCL event profiling API; the slowest
+  // device sets the device rate.
+  double device_time = 0.0;
+  for(unsigned i = 0; i < num_events; ++i) {
+    cl_ulong time_ns = getStartEndTime(kernel_event[i]);
+    printf("Kernel Time (using event): %0.3f ms\n", double(time_ns) * 1e-6);
+    device_time = time_ns * 1e-9 > device_time ? time_ns * 1e-9 : device_time;
+  }
+
+  // Compute the throughput (GFLOPS) of the whole product and of each side.
+  run_stats stats;
+  const double row_flops = 2.0 * C_width * A_width;
+  stats.gflops = row_flops * C_height / kernel_time * 1e-9;
+  stats.cpu_gflops = cpu_rows > 0 ? row_flops * cpu_rows / cpu_time * 1e-9 : 0.0;
+  stats.device_gflops = num_events > 0 ? row_flops * (C_height - cpu_rows) / device_time * 1e-9 : 0.0;
+  printf("\nThroughput: %0.2f GFLOPS (CPU %0.2f, device(s) %0.2f)\n\n",
+      stats.gflops, stats.cpu_gflops, stats.device_gflops);
+
+  // Release kernel events.
+  for(unsigned i = 0; i < num_events; ++i) {
+    clReleaseEvent(kernel_event[i]);
+  }
+
+  // Read the device rows into their place in C.
+  for(unsigned i = 0; i < num_devices; ++i) {
+    if(rows_per_device[i] == 0) {
+      continue;
+    }
+
+    status = clEnqueueReadBuffer(queue[i], output_buf[i], CL_TRUE,
+        0, rows_per_device[i] * C_width * sizeof(float), output + first_row[i] * C_width, 0, NULL, NULL);
+    checkError(status, "Failed to read output matrix");
+  }
+
+  return stats;
+}
+
+void compute_reference() {
+  // Compute the reference output.
+  printf("Computing reference output\n");
+  ref_output.reset(C_height * C_width);
+
+  for(unsigned y = 0; y < C_height; ++y) {
+    for(unsigned x = 0; x < C_width; ++x) {
+      // Compute result for C(y, x)
+      float sum = 0.0f;
+      for(unsigned k = 0; k < A_width; ++k) {
+        sum += input_a[y * A_width + k] * input_b[k * B_width + x];
+      }
+      ref_output[y * C_width + x] = sum;
+    }
+  }
+}
+
+bool verify() {
+  printf("Verifying\n");
+
+  // Compute the L^2-Norm of the difference between the output and reference
+  // output matrices and compare it against the L^2-Norm of the reference.
+  float diff = 0.0f;
+  float ref = 0.0f;
+  for(unsigned y = 0; y < C_height; ++y) {
+    for(unsigned x = 0; x < C_width; ++x) {
+      const float o = output[y * C_width + x];
+      const float r = ref_output[y * C_width + x];
+      const float d = o - r;
+      diff += d * d;
+      ref += r * r;
+    }
+  }
+
+  const float diff_l2norm = sqrtf(diff);
+  const float ref_l2norm = sqrtf(ref);
+  const float error = diff_l2norm / ref_l2norm;
+  const bool pass = error < 1e-6;
+  printf("Verification: %s\n", pass ? "PASS" : "FAIL");
+  if(!pass) {
+    printf("Error (L^2-Norm): %0.3g\n", error);
+  }
+
+  // Clear C, so the next run cannot pass on stale rows.
+  for(unsigned j = 0; j < C_height * C_width; ++j) {
+    output[j] = 0.0f;
+  }
+  return pass;
+}
+
+// Free the resources allocated during initialization
+void cleanup() {
+  for(unsigned i = 0; i < num_devices; ++i) {
+    if(kernel && kernel[i]) {
+      clReleaseKernel(kernel[i]);
+    }
+    if(queue && queue[i]) {
+      clReleaseCommandQueue(queue[i]);
+    }
+    if(input_a_buf && input_a_buf[i]) {
+      clReleaseMemObject(input_a_buf[i]);
+    }
+    if(input_b_buf && input_b_buf[i]) {
+      clReleaseMemObject(input_b_buf[i]);
+    }
+    if(output_buf && output_buf[i]) {
+      clReleaseMemObject(output_buf[i]);
+    }
+  }
+
+  if(program) {
+    clReleaseProgram(program);
+  }
+  if(context) {
+    clReleaseContext(context);
+  }
+}
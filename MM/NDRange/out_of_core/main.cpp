@@ -0,0 +1,607 @@
+///////////////////////////////////////////////////////////////////////////////////
+// This host program executes a matrix multiplication kernel to perform:
+//  C = A * B
+// where A is a N x K matrix, B is a K x M matrix and C is a N x M matrix,
+// out of core: the matrices do not have to fit in device memory.
+// All dimensions must be a multiple of BLOCK_SIZE, which affects the
+// underlying kernel.
+//
+// C is computed tile by tile. For each tile, K is streamed in panels: the
+// rows of A of the tile over one panel of K, and the panel of B over the
+// columns of the tile. The C tile stays on the device and the kernel
+// accumulates every panel into it, then the tile is read back. Panels and
+// C tiles are double-buffered, and each device has three queues, one each
+// for panel writes, kernels and tile reads. Events order them, so the next
+// panel is written and the previous tile is read while a panel is being
+// computed.
+//
+// The device memory in use is at most the budget (-budget=<MB>): two C
+// tiles and two panels each of A and B. The tile and panel sizes follow
+// from the budget unless set with -tile and -panel. The host keeps A, B
+// and C in the same blocked layout, so every panel and tile is one
+// contiguous, aligned transfer.
+//
+// If there are several devices, the C tiles are dealt out round-robin, and
+// each device streams only the panels of its own tiles; B is not
+// replicated.
+//
+// With -bench, square problems of 1/2, 2, 4 and 8 times the budget are run
+// back to back.
+//
+// Verification compares a random sample of C with a double-precision
+// reference on the host CPU; the full product is too large to recompute.
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include "CL/opencl.h"
+#include "AOCLUtils/aocl_utils.h"
+
+#ifndef BLOCK_SIZE
+#define BLOCK_SIZE 64 // default value
+#endif
+
+using namespace aocl_utils;
+
+// OpenCL runtime configuration
+cl_platform_id platform = NULL;
+unsigned num_devices = 0;
+unsigned num_active = 0; // devices with at least one tile of C
+scoped_array<cl_device_id> device; // num_devices elements
+cl_context context = NULL;
+scoped_array<cl_command_queue> write_queue; // num_devices elements
+scoped_array<cl_command_queue> compute_queue; // num_devices elements
+scoped_array<cl_command_queue> read_queue; // num_devices elements
+cl_program program = NULL;
+scoped_array<cl_kernel> kernel; // num_devices elements
+scoped_array<cl_mem> a_panel_buf; // 2 * num_devices elements
+scoped_array<cl_mem> b_panel_buf; // 2 * num_devices elements
+scoped_array<cl_mem> c_tile_buf; // 2 * num_devices elements
+
+// Problem data.
+unsigned A_height = 4096;
+unsigned A_width  = 4096;
+const unsigned &B_height = A_width;
+unsigned B_width  = 4096;
+const unsigned &C_height = A_height;
+const unsigned &C_width  = B_width;
+
+unsigned budget_mb = 128; // device memory budget
+unsigned tile_size = 0; // rows and columns of a C tile
+unsigned panel_size = 0; // width of a K-panel
+
+scoped_aligned_ptr<float> input_a; // blocked, see a_index()
+scoped_aligned_ptr<float> input_b; // blocked, see b_index()
+scoped_aligned_ptr<float> output; // blocked, see c_index()
+
+// Results of one run.
+struct run_stats {
+  double gflops;        // whole run, wall clock
+  double kernel_gflops; // kernels only, busiest device
+  double hidden;        // share of the transfer time overlapped with kernels
+  double traffic;       // bytes moved over the bytes of A, B and C
+};
+
+// Function prototypes
+float rand_float();
+bool init_opencl();
+void choose_tiles(unsigned tile, unsigned panel);
+void init_problem();
+run_stats run();
+bool verify();
+void cleanup_problem();
+void cleanup();
+
+// Entry point.
+int main(int argc, char **argv) {
+  Options options(argc, argv);
+  if(options.has("ah")) {
+    A_height = options.get<unsigned>("ah");
+  }
+  if(options.has("aw")) {
+    A_width = options.get<unsigned>("aw");
+  }
+  if(options.has("bw")) {
+    B_width = options.get<unsigned>("bw");
+  }
+  if(options.has("budget")) {
+    budget_mb = options.get<unsigned>("budget");
+  }
+  const unsigned tile = options.has("tile") ? options.get<unsigned>("tile") : 0;
+  const unsigned panel = options.has("panel") ? options.get<unsigned>("panel") : 0;
+  const bool bench = options.has("bench");
+
+  if((A_height % BLOCK_SIZE) != 0 || (A_width % BLOCK_SIZE) != 0 ||
+     (B_width % BLOCK_SIZE) != 0 || (tile % BLOCK_SIZE) != 0 || (panel % BLOCK_SIZE) != 0) {
+    printf("Matrix sizes, -tile and -panel must be a multiple of %d.\n", BLOCK_SIZE);
+    return -1;
+  }
+  if(A_height == 0 || A_width == 0 || B_width == 0 || budget_mb == 0) {
+    printf("Matrix sizes and the budget must be non-zero.\n");
+    return -1;
+  }
+
+  // Initialize OpenCL.
+  if(!init_opencl()) {
+    return -1;
+  }
+
+  if(!bench) {
+    printf("Matrix sizes:\n  A: %d x %d\n  B: %d x %d\n  C: %d x %d\n",
+        A_height, A_width, B_height, B_width, C_height, C_width);
+
+    choose_tiles(tile, panel);
+    init_problem();
+    run();
+    verify();
+    cleanup_problem();
+  }
+  else {
+    // Square problems with A, B and C together at these multiples of the
+    // budget.
+    static const double sweep_factors[] = {0.5, 2.0, 4.0, 8.0};
+    const unsigned num_sizes = sizeof(sweep_factors) / sizeof(sweep_factors[0]);
+    scoped_array<unsigned> sizes(num_sizes);
+    scoped_array<unsigned> tiles(num_sizes);
+    scoped_array<unsigned> panels(num_sizes);
+    scoped_array<run_stats> stats(num_sizes);
+    scoped_array<bool> passed(num_sizes);
+
+    for(unsigned s = 0; s < num_sizes; ++s) {
+      const double bytes = sweep_factors[s] * budget_mb * 1048576.0;
+      unsigned n = unsigned(sqrt(bytes / (3.0 * sizeof(float)))) / BLOCK_SIZE * BLOCK_SIZE;
+      n = n < BLOCK_SIZE ? BLOCK_SIZE : n;
+      A_height = A_width = B_width = sizes[s] = n;
+      printf("\n==== %u x %u x %u, %.1fx the budget ====\n", n, n, n, sweep_factors[s]);
+
+      choose_tiles(tile, panel);
+      tiles[s] = tile_size;
+      panels[s] = panel_size;
+      init_problem();
+      stats[s] = run();
+      passed[s] = verify();
+      cleanup_problem();
+    }
+
+    printf("\nBudget: %u MB\n", budget_mb);
+    printf("%6s %7s %6s %6s %10s %10s %8s %8s %6s\n", "size", "budget", "tile", "panel",
+        "GFLOPS", "kernel", "hidden", "traffic", "check");
+    for(unsigned s = 0; s < num_sizes; ++s) {
+      printf("%6u %6.1fx %6u %6u %10.2f %10.2f %7.1f%% %7.2fx %6s\n", sizes[s], sweep_factors[s],
+          tiles[s], panels[s], stats[s].gflops, stats[s].kernel_gflops, 100.0 * stats[s].hidden,
+          stats[s].traffic, passed[s] ? "PASS" : "FAIL");
+    }
+  }
+
+  // Free the resources allocated
+  cleanup();
+
+  return 0;
+}
+
+/////// HELPER FUNCTIONS ///////
+
+// Randomly generate a floating-point number between -10 and 10.
+float rand_float() {
+  return float(rand()) / float(RAND_MAX) * 20.0f - 10.0f;
+}
+
+static unsigned min_size(unsigned a, unsigned b) {
+  return a < b ? a : b;
+}
+
+// Blocked host layout. Each row-block of A (tile_size rows, fewer in the
+// last one) is stored panel after panel, every panel row-major; each
+// panel of B is stored tile after tile over the columns, every tile
+// row-major; and each row-block of C tile after tile, like B. So block
+// (i, p) of A starts at i0 * A_width + k0 * rows, with i0 and k0 its first
+// row and column and rows the height of the row-block.
+static size_t a_index(unsigned y, unsigned k) {
+  const unsigned i0 = y / tile_size * tile_size, k0 = k / panel_size * panel_size;
+  const unsigned rows = min_size(tile_size, A_height - i0), cols = min_size(panel_size, A_width - k0);
+  return size_t(i0) * A_width + size_t(k0) * rows + size_t(y - i0) * cols + (k - k0);
+}
+
+static size_t b_index(unsigned k, unsigned x) {
+  const unsigned k0 = k / panel_size * panel_size, j0 = x / tile_size * tile_size;
+  const unsigned rows = min_size(panel_size, B_height - k0), cols = min_size(tile_size, B_width - j0);
+  return size_t(k0) * B_width + size_t(j0) * rows + size_t(k - k0) * cols + (x - j0);
+}
+
+static size_t c_index(unsigned y, unsigned x) {
+  const unsigned i0 = y / tile_size * tile_size, j0 = x / tile_size * tile_size;
+  const unsigned rows = min_size(tile_size, C_height - i0), cols = min_size(tile_size, C_width - j0);
+  return size_t(i0) * C_width + size_t(j0) * rows + size_t(y - i0) * cols + (x - j0);
+}
+
+// Initializes the OpenCL objects that do not depend on the matrix sizes.
+bool init_opencl() {
+  cl_int status;
+
+  printf("Initializing OpenCL\n");
+
+  if(!setCwdToExeDir()) {
+    return false;
+  }
+
+  // Get the OpenCL platform.
+  platform = findPlatform("Intel(R) FPGA");
+  if(platform == NULL) {
+    printf("ERROR: Unable to find Intel(R) FPGA OpenCL platform.\n");
+    return false;
+  }
+
+  // Query the available OpenCL device.
+  device.reset(getDevices(platform, CL_DEVICE_TYPE_ALL, &num_devices));
+  printf("Platform: %s\n", getPlatformName(platform).c_str());
+  printf("Using %d device(s)\n", num_devices);
+  for(unsigned i = 0; i < num_devices; ++i) {
+    printf("  %s\n", getDeviceName(device[i]).c_str());
+  }
+
+  // Create the context.
+  context = clCreateContext(NULL, num_devices, device, &oclContextCallback, NULL, &status);
+  checkError(status, "Failed to create context");
+
+  // Create the program for all device. Use the first device as the
+  // representative device (assuming all device are of the same type).  
+  std::string binary_file = getBoardBinaryFile("out_of_core", device[0]);
+  printf("Using AOCX: %s\n", binary_file.c_str());
+  program = createProgramFromBinary(context, binary_file.c_str(), device, num_devices);
+
+  // Build the program that was just created.
+  status = clBuildProgram(program, 0, NULL, "", NULL, NULL);
+  checkError(status, "Failed to build program");
+
+  // Create per-device objects.
+  write_queue.reset(num_devices);
+  compute_queue.reset(num_devices);
+  read_queue.reset(num_devices);
+  kernel.reset(num_devices);
+  a_panel_buf.reset(2 * num_devices);
+  b_panel_buf.reset(2 * num_devices);
+  c_tile_buf.reset(2 * num_devices);
+
+  for(unsigned i = 0; i < num_devices; ++i) {
+    // Command queues.
+    write_queue[i] = clCreateCommandQueue(context, device[i], CL_QUEUE_PROFILING_ENABLE, &status);
+    checkError(status, "Failed to create command queue");
+
+    compute_queue[i] = clCreateCommandQueue(context, device[i], CL_QUEUE_PROFILING_ENABLE, &status);
+    checkError(status, "Failed to create command queue");
+
+    read_queue[i] = clCreateCommandQueue(context, device[i], CL_QUEUE_PROFILING_ENABLE, &status);
+    checkError(status, "Failed to create command queue");
+
+    // Kernel.
+    const char *kernel_name = "matrixMult";
+    kernel[i] = clCreateKernel(program, kernel_name, &status);
+    checkError(status, "Failed to create kernel");
+
+    for(unsigned s = 0; s < 2; ++s) {
+      a_panel_buf[2 * i + s] = NULL;
+      b_panel_buf[2 * i + s] = NULL;
+      c_tile_buf[2 * i + s] = NULL;
+    }
+  }
+
+  return true;
+}
+
+// Sets the tile and panel sizes. Two C tiles of T x T and two panels each
+// of A and B of T x T/2 take 16 T^2 bytes, so T is the largest multiple
+// of BLOCK_SIZE within the budget, clamped to the matrix; a non-zero tile
+// or panel is used as given.
+void choose_tiles(unsigned tile, unsigned panel) {
+  if(tile == 0) {
+    tile = unsigned(sqrt(budget_mb * 1048576.0 / 16.0)) / BLOCK_SIZE * BLOCK_SIZE;
+  }
+  tile = tile < BLOCK_SIZE ? BLOCK_SIZE : tile;
+  if(panel == 0) {
+    panel = tile / 2 / BLOCK_SIZE * BLOCK_SIZE;
+  }
+  panel = panel < BLOCK_SIZE ? BLOCK_SIZE : panel;
+
+  tile_size = min_size(tile, A_height > B_width ? A_height : B_width);
+  panel_size = min_size(panel, A_width);
+
+  const double used = 2.0 * sizeof(float) *
+      (double(tile_size) * tile_size + 2.0 * double(tile_size) * panel_size);
+  printf("Tile: %u x %u, panel: %u (%.1f of %u MB per device)\n",
+      tile_size, tile_size, panel_size, used / 1048576.0, budget_mb);
+}
+
+// Creates the device buffers and the blocked host data.
+void init_problem() {
+  cl_int status;
+
+  if(num_devices == 0) {
+    checkError(-1, "No devices");
+  }
+
+  const unsigned num_tiles = ((C_height + tile_size - 1) / tile_size) * ((C_width + tile_size - 1) / tile_size);
+  num_active = num_devices < num_tiles ? num_devices : num_tiles;
+
+  for(unsigned i = 0; i < num_active; ++i) {
+    for(unsigned s = 0; s < 2; ++s) {
+      // Panel buffers. We specifically assign A to the first bank of
+      // global memory and B to the second one.
+      a_panel_buf[2 * i + s] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_BANK_1_ALTERA, 
+          size_t(tile_size) * panel_size * sizeof(float), NULL, &status);
+      checkError(status, "Failed to create buffer for panel of A");
+
+      b_panel_buf[2 * i + s] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_BANK_2_ALTERA, 
+          size_t(panel_size) * tile_size * sizeof(float), NULL, &status);
+      checkError(status, "Failed to create buffer for panel of B");
+
+      // C tile, read and written by the kernel.
+      c_tile_buf[2 * i + s] = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_BANK_1_ALTERA, 
+          size_t(tile_size) * tile_size * sizeof(float), NULL, &status);
+      checkError(status, "Failed to create buffer for tile of C");
+    }
+  }
+
+  // Generate input matrices A and B. The values do not depend on the
+  // layout, so they are generated in blocked order directly.
+  printf("Generating input matrices\n");
+  input_a.reset(size_t(A_height) * A_width);
+  input_b.reset(size_t(B_height) * B_width);
+  output.reset(size_t(C_height) * C_width);
+  for(size_t j = 0; j < size_t(A_height) * A_width; ++j) {
+    input_a[j] = rand_float();
+  }
+  for(size_t j = 0; j < size_t(B_height) * B_width; ++j) {
+    input_b[j] = rand_float();
+  }
+}
+
+// Sum of the profiled times of the events, in seconds.
+static double busy_time(const std::vector<cl_event> &events) {
+  double t = 0.0;
+  for(unsigned i = 0; i < events.size(); ++i) {
+    t += getStartEndTime(events[i]) * 1e-9;
+  }
+  return t;
+}
+
+// Runs the whole product; returns its statistics.
+run_stats run() {
+  cl_int status;
+
+  const unsigned tiles_m = (C_height + tile_size - 1) / tile_size;
+  const unsigned tiles_n = (C_width + tile_size - 1) / tile_size;
+  const unsigned num_panels = (A_width + panel_size - 1) / panel_size;
+
+  scoped_array<std::vector<cl_event> > write_events(num_active);
+  scoped_array<std::vector<cl_event> > kernel_events(num_active);
+  scoped_array<std::vector<cl_event> > read_events(num_active);
+
+  // Everything is enqueued up front; the events carry the dependencies
+  // between the queues of a device. This is the portion of time that we'll
+  // be measuring for throughput benchmarking.
+  const double start_time = getCurrentTimestamp();
+
+  for(unsigned i = 0; i < num_active; ++i) {
+    cl_event kernel_done[2] = {NULL, NULL}; // last kernel reading panel slot s
+    cl_event tile_done[2] = {NULL, NULL}; // last read of C slot s
+    unsigned step = 0;
+
+    for(unsigned tile = i, t = 0; tile < tiles_m * tiles_n; tile += num_active, ++t) {
+      const unsigned i0 = tile / tiles_n * tile_size, j0 = tile % tiles_n * tile_size;
+      const unsigned rows = min_size(tile_size, C_height - i0), cols = min_size(tile_size, C_width - j0);
+      const unsigned cs = t % 2;
+      cl_event kernel_event = NULL;
+
+      for(unsigned p = 0; p < num_panels; ++p, ++step) {
+        const unsigned k0 = p * panel_size, kp = min_size(panel_size, A_width - k0);
+        const unsigned s = step % 2;
+
+        // Refill slot s once the kernel two steps back has read it.
+        cl_event write_event[2];
+        status = clEnqueueWriteBuffer(write_queue[i], a_panel_buf[2 * i + s], CL_FALSE,
+            0, size_t(rows) * kp * sizeof(float), input_a + a_index(i0, k0),
+            kernel_done[s] ? 1 : 0, kernel_done[s] ? &kernel_done[s] : NULL, &write_event[0]);
+        checkError(status, "Failed to transfer panel of A");
+
+        status = clEnqueueWriteBuffer(write_queue[i], b_panel_buf[2 * i + s], CL_FALSE,
+            0, size_t(kp) * cols * sizeof(float), input_b + b_index(k0, j0),
+            0, NULL, &write_event[1]);
+        checkError(status, "Failed to transfer panel of B");
+
+        write_events[i].push_back(write_event[0]);
+        write_events[i].push_back(write_event[1]);
+
+        // Set kernel arguments.
+        unsigned argi = 0;
+        const cl_int first = (p == 0);
+        const cl_int a_width = kp, b_width = cols;
+
+        status = clSetKernelArg(kernel[i], argi++, sizeof(cl_mem), &c_tile_buf[2 * i + cs]);
+        checkError(status, "Failed to set argument %d", argi - 1);
+
+        status = clSetKernelArg(kernel[i], argi++, sizeof(cl_mem), &a_panel_buf[2 * i + s]);
+        checkError(status, "Failed to set argument %d", argi - 1);
+
+        status = clSetKernelArg(kernel[i], argi++, sizeof(cl_mem), &b_panel_buf[2 * i + s]);
+        checkError(status, "Failed to set argument %d", argi - 1);
+
+        status = clSetKernelArg(kernel[i], argi++, sizeof(a_width), &a_width);
+        checkError(status, "Failed to set argument %d", argi - 1);
+
+        status = clSetKernelArg(kernel[i], argi++, sizeof(b_width), &b_width);
+        checkError(status, "Failed to set argument %d", argi - 1);
+
+        status = clSetKernelArg(kernel[i], argi++, sizeof(first), &first);
+        checkError(status, "Failed to set argument %d", argi - 1);
+
+        // Enqueue kernel once both panels are in, and on the first panel
+        // also once the previous tile in this C slot has been read back.
+        cl_event wait_list[3] = {write_event[0], write_event[1], tile_done[cs]};
+        const cl_uint num_wait = (p == 0 && tile_done[cs]) ? 3 : 2;
+        const size_t global_work_size[2] = {cols, rows};
+        const size_t local_work_size[2]  = {BLOCK_SIZE, BLOCK_SIZE};
+
+        status = clEnqueueNDRangeKernel(compute_queue[i], kernel[i], 2, NULL,
+            global_work_size, local_work_size, num_wait, wait_list, &kernel_event);
+        checkError(status, "Failed to launch kernel");
+
+        kernel_events[i].push_back(kernel_event);
+        kernel_done[s] = kernel_event;
+      }
+
+      // Read the finished tile.
+      cl_event read_event;
+      status = clEnqueueReadBuffer(read_queue[i], c_tile_buf[2 * i + cs], CL_FALSE,
+          0, size_t(rows) * cols * sizeof(float), output + c_index(i0, j0), 1, &kernel_event, &read_event);
+      checkError(status, "Failed to read tile of C");
+
+      read_events[i].push_back(read_event);
+      tile_done[cs] = read_event;
+    }
+
+    clFlush(write_queue[i]);
+    clFlush(compute_queue[i]);
+    clFlush(read_queue[i]);
+  }
+
+  // Wait for all queues to finish.
+  for(unsigned i = 0; i < num_active; ++i) {
+    clFinish(write_queue[i]);
+    clFinish(compute_queue[i]);
+    clFinish(read_queue[i]);
+  }
+
+  const double stop_time = getCurrentTimestamp();
+
+  const double total_time = stop_time - start_time;
+
+  // Wall-clock time taken.
+  printf("Total Time: %0.3f ms\n", total_time * 1e3);
+
+  // Kernel and transfer times using the OpenCL event profiling API. The
+  // transfer time that is not on the critical path was overlapped.
+  double max_kernel_time = 0.0, transfer_time = 0.0, hidden_time = 0.0;
+  for(unsigned i = 0; i < num_active; ++i) {
+    const double kernel_time = busy_time(kernel_events[i]);
+    const double xfer_time = busy_time(write_events[i]) + busy_time(read_events[i]);
+    double hidden = kernel_time + xfer_time - total_time;
+    hidden = hidden < 0.0 ? 0.0 : (hidden > xfer_time ? xfer_time : hidden);
+    printf("Device %d: kernels %0.3f ms, transfers %0.3f ms\n", i, kernel_time * 1e3, xfer_time * 1e3);
+
+    max_kernel_time = kernel_time > max_kernel_time ? kernel_time : max_kernel_time;
+    transfer_time += xfer_time;
+    hidden_time += hidden;
+  }
+
+  run_stats stats;
+  const double flops = 2.0 * C_width * C_height * A_width;
+  stats.gflops = flops / total_time * 1e-9;
+  stats.kernel_gflops = flops / max_kernel_time * 1e-9;
+  stats.hidden = transfer_time > 0.0 ? hidden_time / transfer_time : 0.0;
+
+  // A is sent once per column of tiles and B once per row of tiles.
+  stats.traffic = (double(A_height) * A_width * tiles_n + double(B_height) * B_width * tiles_m +
+      double(C_height) * C_width) / (double(A_height) * A_width + double(B_height) * B_width +
+      double(C_height) * C_width);
+
+  printf("\nThroughput: %0.2f GFLOPS (kernels alone: %0.2f GFLOPS)\n", stats.gflops, stats.kernel_gflops);
+  printf("Transfers overlapped: %0.1f%%, traffic: %0.2fx the matrices\n\n", 100.0 * stats.hidden, stats.traffic);
+
+  // Release events.
+  for(unsigned i = 0; i < num_active; ++i) {
+    for(unsigned j = 0; j < write_events[i].size(); ++j) {
+      clReleaseEvent(write_events[i][j]);
+    }
+    for(unsigned j = 0; j < kernel_events[i].size(); ++j) {
+      clReleaseEvent(kernel_events[i][j]);
+    }
+    for(unsigned j = 0; j < read_events[i].size(); ++j) {
+      clReleaseEvent(read_events[i][j]);
+    }
+  }
+
+  return stats;
+}
+
+bool verify() {
+  printf("Verifying\n");
+
+  // Compute the L^2-Norm of the difference between the output and the
+  // reference over a sample of C, the corners included, and compare it
+  // against the L^2-Norm of the reference. The reference is summed in
+  // double, so the bound allows for the rounding of the float sums over K
+  // on the device.
+  const unsigned num_samples = 4096;
+  double diff = 0.0;
+  double ref = 0.0;
+  for(unsigned s = 0; s < num_samples; ++s) {
+    unsigned y = rand() % C_height, x = rand() % C_width;
+    if(s < 4) {
+      y = (s & 1) ? C_height - 1 : 0;
+      x = (s & 2) ? C_width - 1 : 0;
+    }
+
+    double r = 0.0;
+    for(unsigned k = 0; k < A_width; ++k) {
+      r += double(input_a[a_index(y, k)]) * input_b[b_index(k, x)];
+    }
+    const double d = output[c_index(y, x)] - r;
+    diff += d * d;
+    ref += r * r;
+  }
+
+  const double error = sqrt(diff) / sqrt(ref);
+  const bool pass = error < 1e-5;
+  printf("Verification: %s\n", pass ? "PASS" : "FAIL");
+  if(!pass) {
+    printf("Error (L^2-Norm): %0.3g\n", error);
+  }
+  return pass;
+}
+
+// Frees the buffers of the current problem size.
+void cleanup_problem() {
+  for(unsigned i = 0; i < 2 * num_devices; ++i) {
+    if(a_panel_buf && a_panel_buf[i]) {
+      clReleaseMemObject(a_panel_buf[i]);
+      a_panel_buf[i] = NULL;
+    }
+    if(b_panel_buf && b_panel_buf[i]) {
+      clReleaseMemObject(b_panel_buf[i]);
+      b_panel_buf[i] = NULL;
+    }
+    if(c_tile_buf && c_tile_buf[i]) {
+      clReleaseMemObject(c_tile_buf[i]);
+      c_tile_buf[i] = NULL;
+    }
+  }
+}
+
+// Free the resources allocated during initialization
+void cleanup() {
+  cleanup_problem();
+
+  for(unsigned i = 0; i < num_devices; ++i) {
+    if(kernel && kernel[i]) {
+      clReleaseKernel(kernel[i]);
+    }
+    if(write_queue && write_queue[i]) {
+      clReleaseCommandQueue(write_queue[i]);
+    }
+    if(compute_queue && compute_queue[i]) {
+      clReleaseCommandQueue(compute_queue[i]);
+    }
+    if(read_queue && read_queue[i]) {
+      clReleaseCommandQueue(read_queue[i]);
+    }
+  }
+
+  if(program) {
+    clReleaseProgram(program);
+  }
+  if(context) {
+    clReleaseContext(context);
+  }
+}
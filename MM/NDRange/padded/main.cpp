@@ -0,0 +1,485 @@
+///////////////////////////////////////////////////////////////////////////////////
+// This host program executes a matrix multiplication kernel to perform:
+//  C = A * B
+// where A is a N x K matrix, B is a K x M matrix and C is a N x M matrix.
+// Unlike baseline, the dimensions can be arbitrary: the NDRange is rounded
+// up to whole BLOCK_SIZE x BLOCK_SIZE work-groups and the kernel handles the
+// edge tiles, so no padded copies of the matrices are made on the host.
+//
+// This host program supports partitioning the problem across multiple OpenCL
+// devices if available. If there are M available devices, the problem is
+// divided so that each device operates on about N/M rows, in whole blocks
+// of BLOCK_SIZE rows except for the last one. The host program
+// assumes that all devices are of the same type (that is, the same binary can
+// be used), but the code can be generalized to support different device types
+// easily.
+//
+// With -sweep, a list of aligned, odd and prime sizes is run back to back to
+// compare the effective throughput on ragged sizes with aligned ones.
+//
+// Verification is performed against the same computation on the host CPU.
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "CL/opencl.h"
+#include "AOCLUtils/aocl_utils.h"
+
+#ifndef BLOCK_SIZE
+#define BLOCK_SIZE 64 // default value
+#endif
+
+using namespace aocl_utils;
+
+// OpenCL runtime configuration
+cl_platform_id platform = NULL;
+unsigned num_devices = 0;
+unsigned num_active = 0; // devices with at least one row of C
+scoped_array<cl_device_id> device; // num_devices elements
+cl_context context = NULL;
+scoped_array<cl_command_queue> queue; // num_devices elements
+cl_program program = NULL;
+scoped_array<cl_kernel> kernel; // num_devices elements
+scoped_array<cl_mem> input_a_buf; // num_devices elements
+scoped_array<cl_mem> input_b_buf; // num_devices elements
+scoped_array<cl_mem> output_buf; // num_devices elements
+
+// Problem data.
+unsigned A_height = 2048;
+unsigned A_width  = 1024;
+const unsigned &B_height = A_width;
+unsigned B_width  = 1024;
+const unsigned &C_height = A_height;
+const unsigned &C_width  = B_width;
+
+scoped_array<scoped_aligned_ptr<float> > input_a; // num_devices elements
+scoped_aligned_ptr<float> input_b;
+scoped_array<scoped_aligned_ptr<float> > output; // num_devices elements
+scoped_array<float> ref_output;
+scoped_array<unsigned> rows_per_device; // num_devices elements
+
+// Sizes of the sweep, {A_height, A_width, B_width}: aligned sizes next to
+// odd and prime ones of about the same work.
+static const unsigned sweep_sizes[][3] = {
+  { 512,  512,  512}, { 509,  509,  509}, { 511,  513,  515},
+  {1024, 1024, 1024}, {1021, 1021, 1021}, {1000, 1000, 1000},
+  {2048, 1024, 1024}, {2039, 1021, 1031}, {2047, 1023, 1025},
+  {   1, 1024, 1024}, {1024,    3, 1024}, {  97,  101,  103}
+};
+
+// Function prototypes
+float rand_float();
+bool init_opencl();
+void init_problem();
+double run();
+void compute_reference();
+bool verify();
+void cleanup_problem();
+void cleanup();
+
+// Entry point.
+int main(int argc, char **argv) {
+  Options options(argc, argv);
+  if(options.has("ah")) {
+    A_height = options.get<unsigned>("ah");
+  }
+  if(options.has("aw")) {
+    A_width = options.get<unsigned>("aw");
+  }
+  if(options.has("bw")) {
+    B_width = options.get<unsigned>("bw");
+  }
+  const bool sweep = options.has("sweep");
+
+  if(A_height == 0 || A_width == 0 || B_width == 0) {
+    printf("Matrix sizes must be non-zero.\n");
+    return -1;
+  }
+
+  // Initialize OpenCL.
+  if(!init_opencl()) {
+    return -1;
+  }
+
+  if(!sweep) {
+    printf("Matrix sizes:\n  A: %d x %d\n  B: %d x %d\n  C: %d x %d\n",
+        A_height, A_width, B_height, B_width, C_height, C_width);
+
+    init_problem();
+    run();
+    compute_reference();
+    verify();
+    cleanup_problem();
+  }
+  else {
+    const unsigned num_sizes = sizeof(sweep_sizes) / sizeof(sweep_sizes[0]);
+    scoped_array<double> gflops(num_sizes);
+    scoped_array<bool> passed(num_sizes);
+
+    for(unsigned s = 0; s < num_sizes; ++s) {
+      A_height = sweep_sizes[s][0];
+      A_width  = sweep_sizes[s][1];
+      B_width  = sweep_sizes[s][2];
+      printf("\n==== %u x %u x %u ====\n", A_height, A_width, B_width);
+
+      init_problem();
+      gflops[s] = run();
+      compute_reference();
+      passed[s] = verify();
+      cleanup_problem();
+    }
+
+    // Tile efficiency is the share of the work in the rounded-up blocks
+    // that is real; it bounds what a ragged size can reach.
+    printf("\n%6s %6s %6s %8s %10s %10s %6s\n", "M", "K", "N", "aligned", "GFLOPS", "tile eff", "check");
+    for(unsigned s = 0; s < num_sizes; ++s) {
+      const double m = sweep_sizes[s][0], k = sweep_sizes[s][1], n = sweep_sizes[s][2];
+      const double mp = ceil(m / BLOCK_SIZE) * BLOCK_SIZE;
+      const double kp = ceil(k / BLOCK_SIZE) * BLOCK_SIZE;
+      const double np = ceil(n / BLOCK_SIZE) * BLOCK_SIZE;
+      const bool aligned = (m == mp && k == kp && n == np);
+      printf("%6u %6u %6u %8s %10.2f %9.1f%% %6s\n", sweep_sizes[s][0], sweep_sizes[s][1], sweep_sizes[s][2],
+          aligned ? "yes" : "no", gflops[s], 100.0 * (m * k * n) / (mp * kp * np), passed[s] ? "PASS" : "FAIL");
+    }
+  }
+
+  // Free the resources allocated
+  cleanup();
+
+  return 0;
+}
+
+/////// HELPER FUNCTIONS ///////
+
+// Randomly generate a floating-point number between -10 and 10.
+float rand_float() {
+  return float(rand()) / float(RAND_MAX) * 20.0f - 10.0f;
+}
+
+// Rounds n up to a whole number of blocks.
+static unsigned round_up(unsigned n) {
+  return (n + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+}
+
+// Initializes the OpenCL objects that do not depend on the matrix sizes.
+bool init_opencl() {
+  cl_int status;
+
+  printf("Initializing OpenCL\n");
+
+  if(!setCwdToExeDir()) {
+    return false;
+  }
+
+  // Get the OpenCL platform.
+  platform = findPlatform("Intel(R) FPGA");
+  if(platform == NULL) {
+    printf("ERROR: Unable to find Intel(R) FPGA OpenCL platform.\n");
+    return false;
+  }
+
+  // Query the available OpenCL device.
+  device.reset(getDevices(platform, CL_DEVICE_TYPE_ALL, &num_devices));
+  printf("Platform: %s\n", getPlatformName(platform).c_str());
+  printf("Using %d device(s)\n", num_devices);
+  for(unsigned i = 0; i < num_devices; ++i) {
+    printf("  %s\n", getDeviceName(device[i]).c_str());
+  }
+
+  // Create the context.
+  context = clCreateContext(NULL, num_devices, device, &oclContextCallback, NULL, &status);
+  checkError(status, "Failed to create context");
+
+  // Create the program for all device. Use the first device as the
+  // representative device (assuming all device are of the same type).  
+  std::string binary_file = getBoardBinaryFile("padded", device[0]);
+  printf("Using AOCX: %s\n", binary_file.c_str());
+  program = createProgramFromBinary(context, binary_file.c_str(), device, num_devices);
+
+  // Build the program that was just created.
+  status = clBuildProgram(program, 0, NULL, "", NULL, NULL);
+  checkError(status, "Failed to build program");
+
+  // Create per-device objects.
+  queue.reset(num_devices);
+  kernel.reset(num_devices);
+  rows_per_device.reset(num_devices);
+  input_a_buf.reset(num_devices);
+  input_b_buf.reset(num_devices);
+  output_buf.reset(num_devices);
+
+  for(unsigned i = 0; i < num_devices; ++i) {
+    // Command queue.
+    queue[i] = clCreateCommandQueue(context, device[i], CL_QUEUE_PROFILING_ENABLE, &status);
+    checkError(status, "Failed to create command queue");
+
+    // Kernel.
+    const char *kernel_name = "matrixMult";
+    kernel[i] = clCreateKernel(program, kernel_name, &status);
+    checkError(status, "Failed to create kernel");
+
+    input_a_buf[i] = NULL;
+    input_b_buf[i] = NULL;
+    output_buf[i] = NULL;
+  }
+
+  return true;
+}
+
+// Splits the rows of C over the devices and creates the buffers and the
+// data of the current problem size.
+void init_problem() {
+  cl_int status;
+
+  if(num_devices == 0) {
+    checkError(-1, "No devices");
+  }
+
+  // Whole block-rows per device, the remainder over the first devices; the
+  // last block-row may be partial, and with fewer block-rows than devices
+  // some devices stay idle.
+  const unsigned num_block_rows = (C_height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  num_active = num_devices < num_block_rows ? num_devices : num_block_rows;
+
+  for(unsigned i = 0, start = 0; i < num_active; ++i) {
+    unsigned blocks = num_block_rows / num_active;
+    if(i < (num_block_rows % num_active)) {
+      blocks++;
+    }
+    rows_per_device[i] = blocks * BLOCK_SIZE;
+    if(start + rows_per_device[i] > C_height) {
+      rows_per_device[i] = C_height - start;
+    }
+    start += rows_per_device[i];
+
+    // Input buffers.
+    // For matrix A, each device only needs the rows corresponding
+    // to the rows of the output matrix. We specifically
+    // assign this buffer to the first bank of global memory.
+    input_a_buf[i] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_BANK_1_ALTERA, 
+        rows_per_device[i] * A_width * sizeof(float), NULL, &status);
+    checkError(status, "Failed to create buffer for input A");
+
+    // For matrix B, each device needs the whole matrix. We specifically
+    // assign this buffer to the second bank of global memory.
+    input_b_buf[i] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_BANK_2_ALTERA, 
+        B_height * B_width * sizeof(float), NULL, &status);
+    checkError(status, "Failed to create buffer for input B");
+
+    // Output buffer, exactly the rows of C computed by this device.
+    output_buf[i] = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_BANK_1_ALTERA, 
+        rows_per_device[i] * C_width * sizeof(float), NULL, &status);
+    checkError(status, "Failed to create buffer for output");
+  }
+
+  // Generate input matrices A and B. For matrix A, we divide up the host
+  // buffers so that the buffers are aligned for each device. The whole of
+  // matrix B is used by each device, so it does not need to be divided.
+  printf("Generating input matrices\n");
+  input_a.reset(num_active);
+  output.reset(num_active);
+  for(unsigned i = 0; i < num_active; ++i) {
+    input_a[i].reset(rows_per_device[i] * A_width);
+    output[i].reset(rows_per_device[i] * C_width);
+
+    for(unsigned j = 0; j < rows_per_device[i] * A_width; ++j) {
+      input_a[i][j] = rand_float();
+    }
+  }
+
+  input_b.reset(B_height * B_width);
+  for(unsigned i = 0; i < B_height * B_width; ++i) {
+    input_b[i] = rand_float();
+  }
+}
+
+// Runs the current problem; returns the throughput in GFLOPS.
+double run() {
+  cl_int status;
+
+  // Transfer inputs to each device. Each of the host buffers supplied to
+  // clEnqueueWriteBuffer here is already aligned to ensure that DMA is used
+  // for the host-to-device transfer.
+  for(unsigned i = 0; i < num_active; ++i) {
+    status = clEnqueueWriteBuffer(queue[i], input_a_buf[i], CL_FALSE,
+        0, rows_per_device[i] * A_width * sizeof(float), input_a[i], 0, NULL, NULL);
+    checkError(status, "Failed to transfer input A");
+
+    status = clEnqueueWriteBuffer(queue[i], input_b_buf[i], CL_FALSE,
+        0, B_width * B_height * sizeof(float), input_b, 0, NULL, NULL);
+    checkError(status, "Failed to transfer input B");
+  }
+
+  // Wait for all queues to finish.
+  for(unsigned i = 0; i < num_active; ++i) {
+    clFinish(queue[i]);
+  }
+
+  // Launch kernels.
+  // This is the portion of time that we'll be measuring for throughput
+  // benchmarking.
+  scoped_array<cl_event> kernel_event(num_active);
+
+  const double start_time = getCurrentTimestamp();
+
+  for(unsigned i = 0; i < num_active; ++i) {
+    // Set kernel arguments.
+    unsigned argi = 0;
+    const unsigned rows = rows_per_device[i];
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(cl_mem), &output_buf[i]);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(cl_mem), &input_a_buf[i]);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(cl_mem), &input_b_buf[i]);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(rows), &rows);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(A_width), &A_width);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(kernel[i], argi++, sizeof(B_width), &B_width);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    // Enqueue kernel.
+    // The global work size is the output matrix rounded up to whole
+    // blocks; the work-items outside the matrix only help stage the edge
+    // tiles. The local work size is one block, so BLOCK_SIZE x BLOCK_SIZE.
+    const size_t global_work_size[2] = {round_up(C_width), round_up(rows)};
+    const size_t local_work_size[2]  = {BLOCK_SIZE, BLOCK_SIZE};
+    printf("Launching for device %d (global size: %d, %d)\n", i, (int) global_work_size[0], (int) global_work_size[1]);
+
+	status = clEnqueueNDRangeKernel(queue[i], kernel[i], 2, NULL,
+        global_work_size, local_work_size, 0, NULL, &kernel_event[i]);
+    checkError(status, "Failed to launch kernel");
+  }
+
+  // Wait for all kernels to finish.
+  clWaitForEvents(num_active, kernel_event);
+
+  const double stop_time = getCurrentTimestamp();
+
+  const double kernel_time = stop_time - start_time;
+
+
+  // Wall-clock time taken.
+  printf("Kernel Time: %0.3f ms\n", kernel_time * 1e3);
+
+  // Get kernel times using the OpenCL event profiling API.
+  for(unsigned i = 0; i < num_active; ++i) {
+    cl_ulong time_ns = getStartEndTime(kernel_event[i]);
+    printf("Kernel Time (using event): %0.3f ms\n", double(time_ns) * 1e-6);
+  }
+
+  // Compute the throughput (GFLOPS) of the real matrix, not of the
+  // rounded-up NDRange.
+  const double flops = 2.0 * C_width * C_height * A_width / kernel_time;
+  printf("\nThroughput: %0.2f GFLOPS\n\n", flops * 1e-9);
+
+  // Release kernel events.
+  for(unsigned i = 0; i < num_active; ++i) {
+    clReleaseEvent(kernel_event[i]);
+  }
+
+  // Read the result.
+  for(unsigned i = 0; i < num_active; ++i) {
+    status = clEnqueueReadBuffer(queue[i], output_buf[i], CL_TRUE,
+        0, rows_per_device[i] * C_width * sizeof(float), output[i], 0, NULL, NULL);
+    checkError(status, "Failed to read output matrix");
+  }
+
+  return flops * 1e-9;
+}
+
+void compute_reference() {
+  // Compute the reference output.
+  printf("Computing reference output\n");
+  ref_output.reset(C_height * C_width);
+
+  for(unsigned y = 0, dev_index = 0; y < C_height; ++dev_index) {
+    for(unsigned yy = 0; yy < rows_per_device[dev_index]; ++yy, ++y) {
+      for(unsigned x = 0; x < C_width; ++x) {
+        // Compute result for C(y, x)
+        float sum = 0.0f;
+        for(unsigned k = 0; k < A_width; ++k) {
+          sum += input_a[dev_index][yy * A_width + k] * input_b[k * B_width + x];
+        }
+        ref_output[y * C_width + x] = sum;
+      }
+    }
+  }
+}
+
+bool verify() {
+  printf("Verifying\n");
+
+  // Compute the L^2-Norm of the difference between the output and reference
+  // output matrices and compare it against the L^2-Norm of the reference.
+  float diff = 0.0f;
+  float ref = 0.0f;
+  for(unsigned y = 0, dev_index = 0; y < C_height; ++dev_index) {
+    for(unsigned yy = 0; yy < rows_per_device[dev_index]; ++yy, ++y) {
+      for(unsigned x = 0; x < C_width; ++x) {
+        const float o = output[dev_index][yy * C_width + x];
+        const float r = ref_output[y * C_width + x];
+        const float d = o - r;
+        diff += d * d;
+        ref += r * r;
+      }
+    }
+  }
+
+  const float diff_l2norm = sqrtf(diff);
+  const float ref_l2norm = sqrtf(ref);
+  const float error = diff_l2norm / ref_l2norm;
+  const bool pass = error < 1e-6;
+  printf("Verification: %s\n", pass ? "PASS" : "FAIL");
+  if(!pass) {
+    printf("Error (L^2-Norm): %0.3g\n", error);
+  }
+  return pass;
+}
+
+// Frees the buffers of the current problem size.
+void cleanup_problem() {
+  for(unsigned i = 0; i < num_devices; ++i) {
+    if(input_a_buf && input_a_buf[i]) {
+      clReleaseMemObject(input_a_buf[i]);
+      input_a_buf[i] = NULL;
+    }
+    if(input_b_buf && input_b_buf[i]) {
+      clReleaseMemObject(input_b_buf[i]);
+      input_b_buf[i] = NULL;
+    }
+    if(output_buf && output_buf[i]) {
+      clReleaseMemObject(output_buf[i]);
+      output_buf[i] = NULL;
+    }
+  }
+}
+
+// Free the resources allocated during initialization
+void cleanup() {
+  cleanup_problem();
+
+  for(unsigned i = 0; i < num_devices; ++i) {
+    if(kernel && kernel[i]) {
+      clReleaseKernel(kernel[i]);
+    }
+    if(queue && queue[i]) {
+      clReleaseCommandQueue(queue[i]);
+    }
+  }
+
+  if(program) {
+    clReleaseProgram(program);
+  }
+  if(context) {
+    clReleaseContext(context);
+  }
+}
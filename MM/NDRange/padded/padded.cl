@@ -0,0 +1,58 @@
+#ifndef SIMD_WORK_ITEMS
+#define SIMD_WORK_ITEMS 4 // default value
+#endif
+
+#ifndef BLOCK_SIZE
+#define BLOCK_SIZE 64 // default value
+#endif
+
+
+// Same blocking as baseline.cl, for any C_height x A_width x B_width. The
+// host rounds the NDRange up to whole blocks; edge tiles are zero-filled
+// when they are staged in local memory, so the inner product runs over full
+// blocks without bounds checks, and work-items outside C store nothing.
+__kernel 
+__attribute((reqd_work_group_size(BLOCK_SIZE,BLOCK_SIZE,1)))
+
+void matrixMult( // Input and output matrices
+                 __global float *restrict C,
+                 __global float *A,
+                 __global float *B, 
+                 // Sizes of matrices.
+                 int C_height, int A_width, int B_width)
+{
+    __local float A_local[BLOCK_SIZE][BLOCK_SIZE];
+    __local float B_local[BLOCK_SIZE][BLOCK_SIZE];
+    
+    int block_x = get_group_id(0);
+    int block_y = get_group_id(1);
+    
+    int local_x = get_local_id(0);
+    int local_y = get_local_id(1);
+    
+    int row = BLOCK_SIZE * block_y + local_y;    // row of A and C
+    int col = BLOCK_SIZE * block_x + local_x;    // column of B and C
+
+    float running_sum = 0.0f;
+   
+    for (int k = 0; k < A_width; k += BLOCK_SIZE)
+    {
+        int a_col = k + local_x;
+        int b_row = k + local_y;
+
+        A_local[local_y][local_x] = (row < C_height && a_col < A_width) ? A[row * A_width + a_col] : 0.0f;
+        B_local[local_x][local_y] = (b_row < A_width && col < B_width) ? B[b_row * B_width + col] : 0.0f;
+	
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        for (int kk = 0; kk < BLOCK_SIZE; ++kk)
+        {
+            running_sum += A_local[local_y][kk] * B_local[local_x][kk];
+        }
+       
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    
+    if (row < C_height && col < B_width)
+        C[row * B_width + col] = running_sum;
+}
@@ -0,0 +1,558 @@
+///////////////////////////////////////////////////////////////////////////////////
+// This host program executes a matrix multiplication kernel to perform:
+//  C = A * B
+// where A is a N x K matrix, B is a K x M matrix and C is a N x M matrix,
+// with A and B stored as FP32, FP16 or INT8. All dimensions must be a
+// multiple of BLOCK_SIZE, which affects the underlying kernel.
+//
+// quantized.cl instantiates the blocked kernel once per element type:
+//  f32  float inputs, float sums (as baseline)
+//  f16  half inputs, widened to float on load, float sums
+//  i8   signed 8-bit inputs, 32-bit integer sums
+// For f16 the host rounds A and B to half. For i8 it quantises A with one
+// symmetric scale per row and B with one per column, so every sum of the
+// kernel shares one scale. C is dequantised with the product of the two.
+//
+// Each type is checked against an FP32 reference of the unquantised
+// matrices, within its own tolerance, and its throughput is reported in
+// GOPS (one multiply and one add per term). -type=<f32|f16|i8> runs one
+// type only.
+//
+// This host program supports partitioning the problem across multiple OpenCL
+// devices if available. If there are M available devices, the problem is
+// divided so that each device operates on N/M rows, in whole blocks.
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "CL/opencl.h"
+#include "AOCLUtils/aocl_utils.h"
+
+#ifndef BLOCK_SIZE
+#define BLOCK_SIZE 64 // default value
+#endif
+
+using namespace aocl_utils;
+
+// Element types, in the order of their kernels.
+enum gemm_type { TYPE_F32, TYPE_F16, TYPE_I8, NUM_TYPES };
+
+struct type_info {
+  const char *name;
+  const char *kernel_name;
+  unsigned element_size; // bytes per element of A and B
+  double tolerance; // relative L^2 error against the FP32 reference
+};
+
+// The FP32 kernel sums in the order of the reference. Rounding to half
+// leaves a relative error of up to 2^-11 per input and the 8-bit codes one
+// of up to 1/254 of the largest element of the row or column; for random
+// inputs the error of C is a fraction of that.
+static const type_info types[NUM_TYPES] = {
+  {"f32", "matrixMult_f32", 4, 1e-6},
+  {"f16", "matrixMult_f16", 2, 1e-3},
+  {"i8",  "matrixMult_i8",  1, 2e-2}
+};
+
+// OpenCL runtime configuration
+cl_platform_id platform = NULL;
+unsigned num_devices = 0;
+scoped_array<cl_device_id> device; // num_devices elements
+cl_context context = NULL;
+scoped_array<cl_command_queue> queue; // num_devices elements
+cl_program program = NULL;
+scoped_array<cl_kernel> kernel; // NUM_TYPES * num_devices elements
+scoped_array<cl_mem> input_a_buf; // num_devices elements
+scoped_array<cl_mem> input_b_buf; // num_devices elements
+scoped_array<cl_mem> output_buf; // num_devices elements
+
+// Problem data.
+unsigned A_height = 2048;
+unsigned A_width  = 1024;
+const unsigned &B_height = A_width;
+unsigned B_width  = 1024;
+const unsigned &C_height = A_height;
+const unsigned &C_width  = B_width;
+
+scoped_aligned_ptr<float> input_a; // FP32 A, whole
+scoped_aligned_ptr<float> input_b; // FP32 B
+scoped_aligned_ptr<unsigned short> input_a_f16, input_b_f16;
+scoped_aligned_ptr<signed char> input_a_i8, input_b_i8;
+scoped_array<float> scale_a; // C_height elements, one per row of A
+scoped_array<float> scale_b; // C_width elements, one per column of B
+scoped_aligned_ptr<float> output; // float C, or int C before dequantising
+scoped_array<float> ref_output;
+scoped_array<unsigned> rows_per_device; // num_devices elements
+scoped_array<unsigned> first_row; // num_devices elements
+
+// Function prototypes
+float rand_float();
+unsigned short float_to_half(float x);
+bool init_opencl();
+void init_problem();
+void quantize();
+double run(gemm_type type);
+void dequantize(gemm_type type);
+void compute_reference();
+double verify();
+void cleanup();
+
+// Entry point.
+int main(int argc, char **argv) {
+  Options options(argc, argv);
+  if(options.has("ah")) {
+    A_height = options.get<unsigned>("ah");
+  }
+  if(options.has("aw")) {
+    A_width = options.get<unsigned>("aw");
+  }
+  if(options.has("bw")) {
+    B_width = options.get<unsigned>("bw");
+  }
+  int only_type = -1;
+  if(options.has("type")) {
+    const std::string name = options.get<std::string>("type");
+    for(int t = 0; t < NUM_TYPES; ++t) {
+      if(name == types[t].name) {
+        only_type = t;
+      }
+    }
+    if(only_type < 0) {
+      printf("Unknown -type: %s\n", name.c_str());
+      return -1;
+    }
+  }
+
+  printf("Matrix sizes:\n  A: %d x %d\n  B: %d x %d\n  C: %d x %d\n",
+      A_height, A_width, B_height, B_width, C_height, C_width);
+
+  // Spot check matrix sizes. They all must be a multiple of BLOCK_SIZE,
+  // although it is relatively straightforward to handle non-multiples
+  // by adding padding. For simplicity, this example does not pad.
+  if((A_height % BLOCK_SIZE) != 0 || (A_width % BLOCK_SIZE) != 0 ||
+     (B_height % BLOCK_SIZE) != 0 || (B_width % BLOCK_SIZE) != 0 ||
+     (C_height % BLOCK_SIZE) != 0 || (C_width % BLOCK_SIZE) != 0) {
+    printf("Matrix sizes must be a multiple of %d.\n", BLOCK_SIZE);
+    return -1;
+  }
+
+  // Initialize OpenCL.
+  if(!init_opencl()) {
+    return -1;
+  }
+
+  // Initialize the problem data: FP32 matrices, their FP16 and INT8 forms
+  // and the FP32 reference.
+  init_problem();
+  quantize();
+  compute_reference();
+
+  double gops[NUM_TYPES], error[NUM_TYPES];
+  for(int t = 0; t < NUM_TYPES; ++t) {
+    if(only_type >= 0 && t != only_type) {
+      continue;
+    }
+    printf("\n==== %s ====\n", types[t].name);
+    gops[t] = run(gemm_type(t));
+    dequantize(gemm_type(t));
+    error[t] = verify();
+  }
+
+  printf("\n%5s %10s %10s %12s %10s %6s\n", "type", "bytes/el", "GOPS", "L2 error", "tolerance", "check");
+  for(int t = 0; t < NUM_TYPES; ++t) {
+    if(only_type >= 0 && t != only_type) {
+      continue;
+    }
+    printf("%5s %10u %10.2f %12.3g %10.0e %6s\n", types[t].name, types[t].element_size, gops[t],
+        error[t], types[t].tolerance, error[t] < types[t].tolerance ? "PASS" : "FAIL");
+  }
+
+  // Free the resources allocated
+  cleanup();
+
+  return 0;
+}
+
+/////// HELPER FUNCTIONS ///////
+
+// Randomly generate a floating-point number between -10 and 10.
+float rand_float() {
+  return float(rand()) / float(RAND_MAX) * 20.0f - 10.0f;
+}
+
+// Rounds a float to the nearest half, ties to even.
+unsigned short float_to_half(float x) {
+  unsigned int f;
+  memcpy(&f, &x, sizeof(f));
+  const unsigned short sign = (unsigned short) ((f >> 16) & 0x8000);
+  const int exp = (int) ((f >> 23) & 0xFF) - 127 + 15;
+  unsigned int mant = f & 0x7FFFFF;
+
+  if(((f >> 23) & 0xFF) == 0xFF) { // inf, nan
+    return sign | 0x7C00 | (mant ? 0x200 : 0);
+  }
+  if(exp >= 31) { // overflow
+    return sign | 0x7C00;
+  }
+  if(exp <= 0) { // subnormal or zero
+    if(exp < -10) {
+      return sign;
+    }
+    mant |= 0x800000;
+    const unsigned int shift = 14 - exp;
+    unsigned int half = mant >> shift;
+    const unsigned int rest = mant & ((1u << shift) - 1);
+    const unsigned int mid = 1u << (shift - 1);
+    if(rest > mid || (rest == mid && (half & 1))) {
+      half++;
+    }
+    return sign | (unsigned short) half;
+  }
+
+  unsigned int half = ((unsigned int) exp << 10) | (mant >> 13);
+  const unsigned int rest = mant & 0x1FFF;
+  if(rest > 0x1000 || (rest == 0x1000 && (half & 1))) {
+    half++; // may carry into the exponent, which is right
+  }
+  return sign | (unsigned short) half;
+}
+
+// Initializes the OpenCL objects.
+bool init_opencl() {
+  cl_int status;
+
+  printf("Initializing OpenCL\n");
+
+  if(!setCwdToExeDir()) {
+    return false;
+  }
+
+  // Get the OpenCL platform.
+  platform = findPlatform("Intel(R) FPGA");
+  if(platform == NULL) {
+    printf("ERROR: Unable to find Intel(R) FPGA OpenCL platform.\n");
+    return false;
+  }
+
+  // Query the available OpenCL device.
+  device.reset(getDevices(platform, CL_DEVICE_TYPE_ALL, &num_devices));
+  printf("Platform: %s\n", getPlatformName(platform).c_str());
+  printf("Using %d device(s)\n", num_devices);
+  for(unsigned i = 0; i < num_devices; ++i) {
+    printf("  %s\n", getDeviceName(device[i]).c_str());
+  }
+
+  // Create the context.
+  context = clCreateContext(NULL, num_devices, device, &oclContextCallback, NULL, &status);
+  checkError(status, "Failed to create context");
+
+  // Create the program for all device. Use the first device as the
+  // representative device (assuming all device are of the same type).  
+  std::string binary_file = getBoardBinaryFile("quantized", device[0]);
+  printf("Using AOCX: %s\n", binary_file.c_str());
+  program = createProgramFromBinary(context, binary_file.c_str(), device, num_devices);
+
+  // Build the program that was just created.
+  status = clBuildProgram(program, 0, NULL, "", NULL, NULL);
+  checkError(status, "Failed to build program");
+
+  // Create per-device objects.
+  queue.reset(num_devices);
+  kernel.reset(NUM_TYPES * num_devices);
+  rows_per_device.reset(num_devices);
+  first_row.reset(num_devices);
+  input_a_buf.reset(num_devices);
+  input_b_buf.reset(num_devices);
+  output_buf.reset(num_devices);
+
+  const unsigned num_block_rows = C_height / BLOCK_SIZE;
+
+  for(unsigned i = 0, row = 0; i < num_devices; ++i) {
+    // Command queue.
+    queue[i] = clCreateCommandQueue(context, device[i], CL_QUEUE_PROFILING_ENABLE, &status);
+    checkError(status, "Failed to create command queue");
+
+    // Kernels, one per type.
+    for(unsigned t = 0; t < NUM_TYPES; ++t) {
+      kernel[t * num_devices + i] = clCreateKernel(program, types[t].kernel_name, &status);
+      checkError(status, "Failed to create kernel");
+    }
+
+    // Determine the number of rows processed by this device.
+    // First do this computation in block-rows.
+    rows_per_device[i] = num_block_rows / num_devices; // this is the number of block-rows
+
+    // Spread out the remainder of the block-rows over the first
+    // N % num_devices.
+    if(i < (num_block_rows % num_devices)) {
+      rows_per_device[i]++;
+    }
+
+    // Multiply by BLOCK_SIZE to get the actual number of rows.
+    rows_per_device[i] *= BLOCK_SIZE;
+    first_row[i] = row;
+    row += rows_per_device[i];
+
+    // The buffers are sized for FP32 and shared by all types; int32 C has
+    // the size of float C.
+    input_a_buf[i] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_BANK_1_ALTERA, 
+        rows_per_device[i] * A_width * sizeof(float), NULL, &status);
+    checkError(status, "Failed to create buffer for input A");
+
+    input_b_buf[i] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_BANK_2_ALTERA, 
+        B_height * B_width * sizeof(float), NULL, &status);
+    checkError(status, "Failed to create buffer for input B");
+
+    output_buf[i] = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_BANK_1_ALTERA, 
+        rows_per_device[i] * C_width * sizeof(float), NULL, &status);
+    checkError(status, "Failed to create buffer for output");
+  }
+
+  return true;
+}
+
+// Initialize the data for the problem. A is kept whole, and each device
+// transfers its rows from first_row[i] on.
+void init_problem() {
+  if(num_devices == 0) {
+    checkError(-1, "No devices");
+  }
+
+  printf("Generating input matrices\n");
+  input_a.reset(A_height * A_width);
+  output.reset(C_height * C_width);
+  for(unsigned j = 0; j < A_height * A_width; ++j) {
+    input_a[j] = rand_float();
+  }
+
+  input_b.reset(B_height * B_width);
+  for(unsigned j = 0; j < B_height * B_width; ++j) {
+    input_b[j] = rand_float();
+  }
+}
+
+// Rounds A and B to half, and quantises them to 8 bits: row y of A to
+// round(A[y][k] / scale_a[y]) with scale_a[y] = max_k |A[y][k]| / 127, and
+// likewise column x of B.
+void quantize() {
+  printf("Quantising\n");
+  input_a_f16.reset(A_height * A_width);
+  input_b_f16.reset(B_height * B_width);
+  for(unsigned j = 0; j < A_height * A_width; ++j) {
+    input_a_f16[j] = float_to_half(input_a[j]);
+  }
+  for(unsigned j = 0; j < B_height * B_width; ++j) {
+    input_b_f16[j] = float_to_half(input_b[j]);
+  }
+
+  input_a_i8.reset(A_height * A_width);
+  input_b_i8.reset(B_height * B_width);
+  scale_a.reset(C_height);
+  scale_b.reset(C_width);
+
+  for(unsigned y = 0; y < A_height; ++y) {
+    float max_abs = 0.0f;
+    for(unsigned k = 0; k < A_width; ++k) {
+      max_abs = fabsf(input_a[y * A_width + k]) > max_abs ? fabsf(input_a[y * A_width + k]) : max_abs;
+    }
+    scale_a[y] = max_abs > 0.0f ? max_abs / 127.0f : 1.0f;
+    for(unsigned k = 0; k < A_width; ++k) {
+      input_a_i8[y * A_width + k] = (signed char) floorf(input_a[y * A_width + k] / scale_a[y] + 0.5f);
+    }
+  }
+
+  for(unsigned x = 0; x < B_width; ++x) {
+    float max_abs = 0.0f;
+    for(unsigned k = 0; k < B_height; ++k) {
+      max_abs = fabsf(input_b[k * B_width + x]) > max_abs ? fabsf(input_b[k * B_width + x]) : max_abs;
+    }
+    scale_b[x] = max_abs > 0.0f ? max_abs / 127.0f : 1.0f;
+    for(unsigned k = 0; k < B_height; ++k) {
+      input_b_i8[k * B_width + x] = (signed char) floorf(input_b[k * B_width + x] / scale_b[x] + 0.5f);
+    }
+  }
+}
+
+// Runs the kernel of one type; returns its throughput in GOPS.
+double run(gemm_type type) {
+  cl_int status;
+
+  const unsigned element_size = types[type].element_size;
+  const char *a = type == TYPE_F32 ? (const char *) input_a.get() :
+                  type == TYPE_F16 ? (const char *) input_a_f16.get() : (const char *) input_a_i8.get();
+  const char *b = type == TYPE_F32 ? (const char *) input_b.get() :
+                  type == TYPE_F16 ? (const char *) input_b_f16.get() : (const char *) input_b_i8.get();
+
+  // Transfer inputs to each device, at the size of the type.
+  for(unsigned i = 0; i < num_devices; ++i) {
+    status = clEnqueueWriteBuffer(queue[i], input_a_buf[i], CL_FALSE,
+        0, rows_per_device[i] * A_width * element_size, a + first_row[i] * A_width * element_size, 0, NULL, NULL);
+    checkError(status, "Failed to transfer input A");
+
+    status = clEnqueueWriteBuffer(queue[i], input_b_buf[i], CL_FALSE,
+        0, B_width * B_height * element_size, b, 0, NULL, NULL);
+    checkError(status, "Failed to transfer input B");
+  }
+
+  // Wait for all queues to finish.
+  for(unsigned i = 0; i < num_devices; ++i) {
+    clFinish(queue[i]);
+  }
+
+  // Launch kernels.
+  // This is the portion of time that we'll be measuring for throughput
+  // benchmarking.
+  scoped_array<cl_event> kernel_event(num_devices);
+
+  const double start_time = getCurrentTimestamp();
+
+  for(unsigned i = 0; i < num_devices; ++i) {
+    cl_kernel k = kernel[type * num_devices + i];
+
+    // Set kernel arguments.
+    unsigned argi = 0;
+
+    status = clSetKernelArg(k, argi++, sizeof(cl_mem), &output_buf[i]);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(k, argi++, sizeof(cl_mem), &input_a_buf[i]);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(k, argi++, sizeof(cl_mem), &input_b_buf[i]);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(k, argi++, sizeof(A_width), &A_width);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    status = clSetKernelArg(k, argi++, sizeof(B_width), &B_width);
+    checkError(status, "Failed to set argument %d", argi - 1);
+
+    // Enqueue kernel.
+    const size_t global_work_size[2] = {C_width, rows_per_device[i]};
+    const size_t local_work_size[2]  = {BLOCK_SIZE, BLOCK_SIZE};
+    printf("Launching %s for device %d (global size: %d, %d)\n", types[type].kernel_name, i,
+        (int) global_work_size[0], (int) global_work_size[1]);
+
+	status = clEnqueueNDRangeKernel(queue[i], k, 2, NULL,
+        global_work_size, local_work_size, 0, NULL, &kernel_event[i]);
+    checkError(status, "Failed to launch kernel");
+  }
+
+  // Wait for all kernels to finish.
+  clWaitForEvents(num_devices, kernel_event);
+
+  const double stop_time = getCurrentTimestamp();
+
+  const double kernel_time = stop_time - start_time;
+
+
+  // Wall-clock time taken.
+  printf("Kernel Time: %0.3f ms\n", kernel_time * 1e3);
+
+  // Get kernel times using the OpenCL event profiling API.
+  for(unsigned i = 0; i < num_devices; ++i) {
+    cl_ulong time_ns = getStartEndTime(kernel_event[i]);
+    printf("Kernel Time (using event): %0.3f ms\n", double(time_ns) * 1e-6);
+  }
+
+  // Compute the throughput (GOPS).
+  const double ops = 2.0 * C_width * C_height * A_width / kernel_time;
+  printf("\nThroughput: %0.2f GOPS\n\n", ops * 1e-9);
+
+  // Release kernel events.
+  for(unsigned i = 0; i < num_devices; ++i) {
+    clReleaseEvent(kernel_event[i]);
+  }
+
+  // Read the result.
+  for(unsigned i = 0; i < num_devices; ++i) {
+    status = clEnqueueReadBuffer(queue[i], output_buf[i], CL_TRUE,
+        0, rows_per_device[i] * C_width * sizeof(float), output + first_row[i] * C_width, 0, NULL, NULL);
+    checkError(status, "Failed to read output matrix");
+  }
+
+  return ops * 1e-9;
+}
+
+// Turns the int32 sums of i8 back into floats, in place; f32 and f16
+// already produce float.
+void dequantize(gemm_type type) {
+  if(type != TYPE_I8) {
+    return;
+  }
+
+  for(unsigned y = 0; y < C_height; ++y) {
+    for(unsigned x = 0; x < C_width; ++x) {
+      cl_int sum;
+      memcpy(&sum, &output[y * C_width + x], sizeof(sum));
+      output[y * C_width + x] = float(sum) * scale_a[y] * scale_b[x];
+    }
+  }
+}
+
+void compute_reference() {
+  // Compute the reference output.
+  printf("Computing reference output\n");
+  ref_output.reset(C_height * C_width);
+
+  for(unsigned y = 0; y < C_height; ++y) {
+    for(unsigned x = 0; x < C_width; ++x) {
+      // Compute result for C(y, x)
+      float sum = 0.0f;
+      for(unsigned k = 0; k < A_width; ++k) {
+        sum += input_a[y * A_width + k] * input_b[k * B_width + x];
+      }
+      ref_output[y * C_width + x] = sum;
+    }
+  }
+}
+
+// Returns the L^2-Norm of the difference between the output and the FP32
+// reference, relative to the L^2-Norm of the reference.
+double verify() {
+  printf("Verifying\n");
+
+  double diff = 0.0;
+  double ref = 0.0;
+  for(unsigned j = 0; j < C_height * C_width; ++j) {
+    const double d = output[j] - ref_output[j];
+    diff += d * d;
+    ref += double(ref_output[j]) * ref_output[j];
+  }
+
+  const double error = sqrt(diff) / sqrt(ref);
+  printf("Error (L^2-Norm): %0.3g\n", error);
+  return error;
+}
+
+// Free the resources allocated during initialization
+void cleanup() {
+  for(unsigned i = 0; i < num_devices; ++i) {
+    for(unsigned t = 0; t < NUM_TYPES; ++t) {
+      if(kernel && kernel[t * num_devices + i]) {
+        clReleaseKernel(kernel[t * num_devices + i]);
+      }
+    }
+    if(queue && queue[i]) {
+      clReleaseCommandQueue(queue[i]);
+    }
+    if(input_a_buf && input_a_buf[i]) {
+      clReleaseMemObject(input_a_buf[i]);
+    }
+    if(input_b_buf && input_b_buf[i]) {
+      clReleaseMemObject(input_b_buf[i]);
+    }
+    if(output_buf && output_buf[i]) {
+      clReleaseMemObject(output_buf[i]);
+    }
+  }
+
+  if(program) {
+    clReleaseProgram(program);
+  }
+  if(context) {
+    clReleaseContext(context);
+  }
+}
@@ -0,0 +1,75 @@
+#ifndef SIMD_WORK_ITEMS
+#define SIMD_WORK_ITEMS 4 // default value
+#endif
+
+#ifndef BLOCK_SIZE
+#define BLOCK_SIZE 64 // default value
+#endif
+
+
+// The blocked kernel of baseline.cl as a template over the element type.
+// OpenCL C has no templates, so MATRIX_MULT instantiates it:
+//   NAME     kernel name
+//   IN_T     element type of A and B in global memory
+//   LOCAL_T  element type of the tiles in local memory
+//   ACC_T    accumulator and element type of C
+//   LOAD     LOAD(p, i) reads element i of an IN_T array as LOCAL_T
+#define MATRIX_MULT(NAME, IN_T, LOCAL_T, ACC_T, LOAD)                                     \
+__kernel                                                                                 \
+__attribute((reqd_work_group_size(BLOCK_SIZE,BLOCK_SIZE,1)))                             \
+void NAME( /* Input and output matrices */                                               \
+                 __global ACC_T *restrict C,                                             \
+                 __global const IN_T *A,                                                 \
+                 __global const IN_T *B,                                                 \
+                 /* Widths of matrices. */                                               \
+                 int A_width, int B_width)                                               \
+{                                                                                        \
+    __local LOCAL_T A_local[BLOCK_SIZE][BLOCK_SIZE];                                     \
+    __local LOCAL_T B_local[BLOCK_SIZE][BLOCK_SIZE];                                     \
+                                                                                         \
+    int block_x = get_group_id(0);                                                       \
+    int block_y = get_group_id(1);                                                       \
+                                                                                         \
+    int local_x = get_local_id(0);                                                       \
+    int local_y = get_local_id(1);                                                       \
+                                                                                         \
+    int a_start = A_width * BLOCK_SIZE * block_y;                                        \
+    int a_end   = a_start + A_width - 1;                                                 \
+    int b_start = BLOCK_SIZE * block_x;                                                  \
+                                                                                         \
+    ACC_T running_sum = 0;                                                               \
+                                                                                         \
+    for (int a = a_start, b = b_start; a <= a_end; a += BLOCK_SIZE, b += (BLOCK_SIZE * B_width)) \
+    {                                                                                    \
+        A_local[local_y][local_x] = LOAD(A, a + A_width * local_y + local_x);            \
+        B_local[local_x][local_y] = LOAD(B, b + B_width * local_y + local_x);            \
+                                                                                         \
+        barrier(CLK_LOCAL_MEM_FENCE);                                                    \
+                                                                                         \
+        for (int k = 0; k < BLOCK_SIZE; ++k)                                             \
+        {                                                                                \
+            running_sum += (ACC_T) A_local[local_y][k] * (ACC_T) B_local[local_x][k];    \
+        }                                                                                \
+                                                                                         \
+        barrier(CLK_LOCAL_MEM_FENCE);                                                    \
+    }                                                                                    \
+                                                                                         \
+    C[get_global_id(1) * get_global_size(0) + get_global_id(0)] = running_sum;           \
+}
+
+#define LOAD_ELEMENT(p, i) ((p)[i])
+#define LOAD_HALF(p, i)    vload_half((i), (p))
+
+
+// FP32, as baseline.cl.
+MATRIX_MULT(matrixMult_f32, float, float, float, LOAD_ELEMENT)
+
+// FP16 storage: A and B are half in global memory and widened to float as
+// the tiles are staged (vload_half needs no cl_khr_fp16), so the input
+// traffic is halved; products and sums stay FP32.
+MATRIX_MULT(matrixMult_f16, half, float, float, LOAD_HALF)
+
+// INT8 x INT8 -> INT32: the host quantises A per row and B per column and
+// dequantises C with the product of the two scales. |a * b| <= 2^14, so the
+// sum cannot overflow for A_width < 2^17.
+MATRIX_MULT(matrixMult_i8, char, char, int, LOAD_ELEMENT)
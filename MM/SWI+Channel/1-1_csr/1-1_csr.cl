@@ -0,0 +1,99 @@
+#ifndef A_ROW_MAX
+#define A_ROW_MAX 1024 // longest row of dense A
+#endif
+
+#ifndef C_ROW_MAX
+#define C_ROW_MAX 1024 // longest row of C
+#endif
+
+// One nonzero of A: its column and value.
+typedef struct {
+	int   col;
+	float val;
+} nonzero;
+
+	channel float   chan;
+	channel nonzero chan_csr;
+
+
+// Dense pipeline, as in 1-1.cl: A is streamed row by row and every element
+// of a row of C is a dot product against a column of B.
+__kernel 
+void in( __global float *A, int A_width, int C_height)
+{
+	for (int i = 0; i < A_width * C_height; i ++){
+		write_channel_altera(chan, A[i]);
+	}
+}
+
+
+__kernel 
+void matrixMult( // Input and output matrices
+                 __global float *restrict C,
+                 __global float *B, 
+                 // Widths of matrices.
+                 int A_width, int C_width, int C_height)
+{
+	float tA[A_ROW_MAX];
+
+	for (int i = 0; i < C_height; i ++){
+		
+		for (int k = 0; k < A_width; k++)
+			tA[k] = read_channel_altera(chan);
+
+		for (int j = 0; j < C_width; j ++){
+			float running_sum = 0.0f;
+			for (int k = 0; k < A_width; k++){
+				running_sum += tA[k] *	B[k * C_width + j];		
+			}
+			C[i * C_width + j] = running_sum;
+		}
+
+	}
+}
+
+
+// Sparse pipeline: A in CSR. in_csr streams the (column, value) pairs of
+// all rows in order; matrixMult_csr adds value * row col of B into the row
+// of C for each pair of a row, so only the nonzeros are read and
+// multiplied. row_ptr gives the number of pairs of each row. The sums run
+// over the columns of A in the same order as the dense pipeline.
+__kernel 
+void in_csr( __global const int *restrict col_idx, __global const float *restrict values, int nnz)
+{
+	for (int p = 0; p < nnz; p ++){
+		nonzero nz;
+		nz.col = col_idx[p];
+		nz.val = values[p];
+		write_channel_altera(chan_csr, nz);
+	}
+}
+
+
+__kernel 
+void matrixMult_csr( // Input and output matrices
+                 __global float *restrict C,
+                 __global float *B, 
+                 __global const int *restrict row_ptr,
+                 // Sizes of matrices.
+                 int C_width, int C_height)
+{
+	float tC[C_ROW_MAX];
+
+	for (int i = 0; i < C_height; i ++){
+
+		for (int j = 0; j < C_width; j ++)
+			tC[j] = 0.0f;
+
+		for (int p = row_ptr[i]; p < row_ptr[i + 1]; p ++){
+			nonzero nz = read_channel_altera(chan_csr);
+			for (int j = 0; j < C_width; j ++){
+				tC[j] += nz.val * B[nz.col * C_width + j];
+			}
+		}
+
+		for (int j = 0; j < C_width; j ++)
+			C[i * C_width + j] = tC[j];
+
+	}
+}
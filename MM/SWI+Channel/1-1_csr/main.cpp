@@ -0,0 +1,700 @@
+///////////////////////////////////////////////////////////////////////////////////
+// This host program executes a matrix multiplication kernel to perform:
+//  C = A * B
+// where A is a sparse N x K matrix, B is a dense K x M matrix and C is a
+// N x M matrix.
+//
+// A is sent to the device in CSR form (row pointers, column indices and
+// values). The input kernel streams the (column, value) pairs of the
+// nonzeros, and the compute kernel adds each value times the matching row
+// of B into the current row of C, so zeros of A cost neither bandwidth nor
+// multiplies. The same binary also holds the dense 1-1 pipeline, which is
+// run on the same matrices for comparison.
+//
+// This host program supports partitioning the problem across multiple OpenCL
+// devices if available. If there are M available devices, the problem is
+// divided so that each device operates on N/M rows, each with its own CSR
+// slice. The host program assumes that all devices are of the same type
+// (that is, the same binary can be used), but the code can be generalized
+// to support different device types easily.
+//
+// Options:
+//   -ah, -aw, -bw   matrix sizes (A is ah x aw, B is aw x bw)
+//   -sparsity=<f>   fraction of zeros in A, default 0.9
+//   -sweep          dense vs CSR over a range of sparsity levels
+//
+// Verification is performed against the same computation on the host CPU.
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "CL/opencl.h"
+#include "AOCLUtils/aocl_utils.h"
+
+
+
+
+
+#ifndef A_ROW_MAX
+#define A_ROW_MAX 1024 // must match the dense kernel
+#endif
+
+#ifndef C_ROW_MAX
+#define C_ROW_MAX 1024 // must match the CSR kernel
+#endif
+
+
+
+
+
+using namespace aocl_utils;
+
+// OpenCL runtime configuration
+cl_platform_id platform = NULL;
+unsigned num_devices = 0;
+scoped_array<cl_device_id> device; // num_devices elements
+cl_context context = NULL;
+
+scoped_array<cl_command_queue> queue_in; 
+scoped_array<cl_command_queue> queue;
+cl_program program = NULL;
+
+scoped_array<cl_kernel> kernel_in; // dense pipeline
+scoped_array<cl_kernel> kernel;
+scoped_array<cl_kernel> kernel_in_csr; // CSR pipeline
+scoped_array<cl_kernel> kernel_csr;
+scoped_array<cl_mem> input_a_buf; // num_devices elements
+scoped_array<cl_mem> row_ptr_buf; // num_devices elements
+scoped_array<cl_mem> col_idx_buf; // num_devices elements
+scoped_array<cl_mem> values_buf; // num_devices elements
+scoped_array<cl_mem> input_b_buf; // num_devices elements
+scoped_array<cl_mem> output_buf; // num_devices elements
+
+// Problem data.
+unsigned A_height = 2048;
+unsigned A_width  = 1024;
+const unsigned &B_height = A_width;
+unsigned B_width  = 1024;
+const unsigned &C_height = A_height;
+const unsigned &C_width  = B_width;
+
+// A sparse matrix in compressed sparse row form. Row i holds the nonzeros
+// row_ptr[i] .. row_ptr[i + 1] - 1, in increasing column order.
+struct csr_matrix {
+  unsigned rows;
+  unsigned cols;
+  unsigned nnz;
+  scoped_aligned_ptr<int> row_ptr; // rows + 1 elements
+  scoped_aligned_ptr<int> col_idx; // nnz elements
+  scoped_aligned_ptr<float> values; // nnz elements
+};
+
+scoped_array<scoped_aligned_ptr<float> > input_a; // num_devices elements
+scoped_array<csr_matrix> input_a_csr; // num_devices elements
+scoped_aligned_ptr<float> input_b;
+scoped_array<scoped_aligned_ptr<float> > output; // num_devices elements
+scoped_array<float> ref_output;
+scoped_array<unsigned> rows_per_device; // num_devices elements
+
+// Timings of one run of a pipeline.
+struct run_times {
+  double trans_time;
+  double kernel_time;
+};
+
+// Function prototypes
+float rand_float();
+bool init_opencl();
+void init_problem(float sparsity);
+void build_csr(csr_matrix &csr, const float *dense, unsigned rows, unsigned cols);
+double build_all_csr();
+unsigned total_nnz();
+run_times run_dense();
+run_times run_csr();
+void compute_reference();
+bool verify();
+void run(float sparsity);
+void sweep();
+void cleanup();
+
+// Entry point.
+int main(int argc, char **argv) {
+  Options options(argc, argv);
+  if(options.has("ah")) {
+    A_height = options.get<unsigned>("ah");
+  }
+  if(options.has("aw")) {
+    A_width = options.get<unsigned>("aw");
+  }
+  if(options.has("bw")) {
+    B_width = options.get<unsigned>("bw");
+  }
+  float sparsity = 0.9f;
+  if(options.has("sparsity")) {
+    sparsity = options.get<float>("sparsity");
+  }
+
+  printf("Matrix sizes:\n  A: %d x %d\n  B: %d x %d\n  C: %d x %d\n",
+      A_height, A_width, B_height, B_width, C_height, C_width);
+
+  if(A_height == 0 || A_width == 0 || B_width == 0) {
+    printf("Matrix sizes must be non-zero.\n");
+    return -1;
+  }
+
+  // The dense kernel buffers one row of A and the CSR kernel one row of C.
+  if(A_width > A_ROW_MAX || C_width > C_ROW_MAX) {
+    printf("Width of A must be at most %d and width of B at most %d.\n", A_ROW_MAX, C_ROW_MAX);
+    return -1;
+  }
+
+  if(sparsity < 0.0f || sparsity > 1.0f) {
+    printf("Sparsity must be between 0 and 1.\n");
+    return -1;
+  }
+
+  if(!init_opencl()) {
+    return -1;
+  }
+
+  if(options.has("sweep")) {
+    sweep();
+  } else {
+    run(sparsity);
+  }
+
+  cleanup();
+
+  return 0;
+}
+
+
+float rand_float() {
+  return float(rand()) / float(RAND_MAX) * 20.0f - 10.0f;
+}
+
+bool init_opencl() {
+  cl_int status;
+
+  printf("Initializing OpenCL\n");
+
+  if(!setCwdToExeDir()) {
+    return false;
+  }
+
+  platform = findPlatform("Intel(R) FPGA");
+  if(platform == NULL) {
+    printf("ERROR: Unable to find Intel(R) FPGA OpenCL platform.\n");
+    return false;
+  }
+
+  device.reset(getDevices(platform, CL_DEVICE_TYPE_ALL, &num_devices));
+  printf("Platform: %s\n", getPlatformName(platform).c_str());
+  printf("Using %d device(s)\n", num_devices);
+  for(unsigned i = 0; i < num_devices; ++i) {
+    printf("  %s\n", getDeviceName(device[i]).c_str());
+  }
+
+  context = clCreateContext(NULL, num_devices, device, &oclContextCallback, NULL, &status);
+  checkError(status, "Failed to create context");
+
+  
+  
+  
+  
+  
+  std::string binary_file = getBoardBinaryFile("1-1_csr", device[0]);
+  printf("Using AOCX: %s\n", binary_file.c_str());
+  program = createProgramFromBinary(context, binary_file.c_str(), device, num_devices);
+
+
+
+
+
+
+
+
+  status = clBuildProgram(program, 0, NULL, "", NULL, NULL);
+  checkError(status, "Failed to build program");
+
+  queue_in.reset(num_devices);
+  queue.reset(num_devices);
+
+  kernel_in.reset(num_devices);
+  kernel.reset(num_devices);
+  kernel_in_csr.reset(num_devices);
+  kernel_csr.reset(num_devices);
+  rows_per_device.reset(num_devices);
+  input_a_buf.reset(num_devices);
+  row_ptr_buf.reset(num_devices);
+  col_idx_buf.reset(num_devices);
+  values_buf.reset(num_devices);
+  input_b_buf.reset(num_devices);
+  output_buf.reset(num_devices);
+
+  // Both pipelines work row by row, so rows are split one by one; devices
+  // beyond the number of rows would stay idle.
+  if(num_devices > C_height) {
+    num_devices = C_height;
+  }
+
+  for(unsigned i = 0; i < num_devices; ++i) {
+
+	queue_in[i] = clCreateCommandQueue(context, device[i], CL_QUEUE_PROFILING_ENABLE, &status);
+    checkError(status, "Failed to create command queue");
+	queue[i] = clCreateCommandQueue(context, device[i], CL_QUEUE_PROFILING_ENABLE, &status);
+    checkError(status, "Failed to create command queue");
+
+
+
+	kernel_in[i] = clCreateKernel(program, "in", &status);
+    checkError(status, "Failed to create kernel");
+    kernel[i] = clCreateKernel(program, "matrixMult", &status);
+    checkError(status, "Failed to create kernel");
+	kernel_in_csr[i] = clCreateKernel(program, "in_csr", &status);
+    checkError(status, "Failed to create kernel");
+    kernel_csr[i] = clCreateKernel(program, "matrixMult_csr", &status);
+    checkError(status, "Failed to create kernel");
+
+    rows_per_device[i] = C_height / num_devices;
+
+    if(i < (C_height % num_devices)) {
+      rows_per_device[i]++;
+    }
+
+    input_a_buf[i] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_BANK_1_ALTERA, 
+        rows_per_device[i] * A_width * sizeof(float), NULL, &status);
+    checkError(status, "Failed to create buffer for input A");
+
+    // The CSR buffers are sized for a fully dense slice, so any sparsity
+    // level fits without reallocation.
+    row_ptr_buf[i] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_BANK_2_ALTERA, 
+        (rows_per_device[i] + 1) * sizeof(int), NULL, &status);
+    checkError(status, "Failed to create buffer for row pointers of A");
+
+    col_idx_buf[i] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_BANK_1_ALTERA, 
+        rows_per_device[i] * A_width * sizeof(int), NULL, &status);
+    checkError(status, "Failed to create buffer for column indices of A");
+
+    values_buf[i] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_BANK_1_ALTERA, 
+        rows_per_device[i] * A_width * sizeof(float), NULL, &status);
+    checkError(status, "Failed to create buffer for values of A");
+
+    input_b_buf[i] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_BANK_2_ALTERA, 
+        B_height * B_width * sizeof(float), NULL, &status);
+    checkError(status, "Failed to create buffer for input B");
+
+    output_buf[i] = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_BANK_1_ALTERA, 
+        rows_per_device[i] * C_width * sizeof(float), NULL, &status);
+    checkError(status, "Failed to create buffer for output");
+  }
+
+  return true;
+}
+
+// Generates A with each element zero with probability sparsity, and B.
+void init_problem(float sparsity) {
+  if(num_devices == 0) {
+    checkError(-1, "No devices");
+  }
+
+  printf("Generating input matrices (sparsity %0.3f)\n", sparsity);
+  srand(1);
+  input_a.reset(num_devices);
+  input_a_csr.reset(num_devices);
+  output.reset(num_devices);
+  for(unsigned i = 0; i < num_devices; ++i) {
+    input_a[i].reset(rows_per_device[i] * A_width);
+    output[i].reset(rows_per_device[i] * C_width);
+
+    for(unsigned j = 0; j < rows_per_device[i] * A_width; ++j) {
+      const bool zero = float(rand()) / float(RAND_MAX) < sparsity;
+      input_a[i][j] = zero ? 0.0f : rand_float();
+    }
+  }
+
+  input_b.reset(B_height * B_width);
+  for(unsigned i = 0; i < B_height * B_width; ++i) {
+    input_b[i] = rand_float();
+  }
+}
+
+// Builds the CSR form of a dense row-major rows x cols matrix: one pass
+// counts the nonzeros of every row, the second fills the arrays.
+void build_csr(csr_matrix &csr, const float *dense, unsigned rows, unsigned cols) {
+  csr.rows = rows;
+  csr.cols = cols;
+  csr.row_ptr.reset(rows + 1);
+
+  unsigned nnz = 0;
+  for(unsigned i = 0; i < rows; ++i) {
+    csr.row_ptr[i] = nnz;
+    for(unsigned k = 0; k < cols; ++k) {
+      if(dense[i * cols + k] != 0.0f) {
+        ++nnz;
+      }
+    }
+  }
+  csr.row_ptr[rows] = nnz;
+  csr.nnz = nnz;
+
+  // At least one element, so that an all-zero slice still has a buffer
+  // to point at.
+  csr.col_idx.reset(nnz > 0 ? nnz : 1);
+  csr.values.reset(nnz > 0 ? nnz : 1);
+
+  for(unsigned i = 0, p = 0; i < rows; ++i) {
+    for(unsigned k = 0; k < cols; ++k) {
+      const float a = dense[i * cols + k];
+      if(a != 0.0f) {
+        csr.col_idx[p] = k;
+        csr.values[p] = a;
+        ++p;
+      }
+    }
+  }
+}
+
+// Builds the CSR slice of every device; returns the time taken.
+double build_all_csr() {
+  const double start = getCurrentTimestamp();
+  for(unsigned i = 0; i < num_devices; ++i) {
+    build_csr(input_a_csr[i], input_a[i], rows_per_device[i], A_width);
+  }
+  return getCurrentTimestamp() - start;
+}
+
+unsigned total_nnz() {
+  unsigned nnz = 0;
+  for(unsigned i = 0; i < num_devices; ++i) {
+    nnz += input_a_csr[i].nnz;
+  }
+  return nnz;
+}
+
+
+// Dense pipeline, as in 1-1: streams every element of A.
+run_times run_dense() {
+  cl_int status;
+
+
+  const double time1=getCurrentTimestamp();
+
+  for(unsigned i = 0; i < num_devices; ++i) {
+    status = clEnqueueWriteBuffer(queue[i], input_a_buf[i], CL_FALSE,
+        0, rows_per_device[i] * A_width * sizeof(float), input_a[i], 0, NULL, NULL);
+    checkError(status, "Failed to transfer input A");
+
+    status = clEnqueueWriteBuffer(queue[i], input_b_buf[i], CL_FALSE,
+        0, B_width * B_height * sizeof(float), input_b, 0, NULL, NULL);
+    checkError(status, "Failed to transfer input B");
+  }
+
+  for(unsigned i = 0; i < num_devices; ++i) {
+    clFinish(queue[i]);
+  }
+
+  scoped_array<cl_event> kernel_event(num_devices);
+
+  const double time2 = getCurrentTimestamp();
+
+
+
+
+  for(unsigned i = 0; i < num_devices; ++i) {
+    
+    status = clSetKernelArg(kernel_in[i], 0, sizeof(cl_mem), &input_a_buf[i]);
+    status = clSetKernelArg(kernel_in[i], 1, sizeof(A_width), &A_width);
+	status = clSetKernelArg(kernel_in[i], 2, sizeof(rows_per_device[i]), &rows_per_device[i]);
+	status = clEnqueueTask(queue_in[i], kernel_in[i], 0, NULL, NULL);
+    checkError(status, "Failed to launch kernel");
+	
+	
+    status = clSetKernelArg(kernel[i], 0, sizeof(cl_mem), &output_buf[i]);
+    status = clSetKernelArg(kernel[i], 1, sizeof(cl_mem), &input_b_buf[i]);
+    status = clSetKernelArg(kernel[i], 2, sizeof(A_width), &A_width);
+    status = clSetKernelArg(kernel[i], 3, sizeof(B_width), &B_width);
+	status = clSetKernelArg(kernel[i], 4, sizeof(rows_per_device[i]), &rows_per_device[i]);
+	status = clEnqueueTask(queue[i], kernel[i], 0, NULL, &kernel_event[i]);
+    checkError(status, "Failed to launch kernel");
+
+  }
+
+  // Wait for all kernels to finish.
+  clWaitForEvents(num_devices, kernel_event);
+
+  const double time3 = getCurrentTimestamp();
+
+  for(unsigned i = 0; i < num_devices; ++i) {
+    clReleaseEvent(kernel_event[i]);
+  }
+
+  for(unsigned i = 0; i < num_devices; ++i) {
+    status = clEnqueueReadBuffer(queue[i], output_buf[i], CL_TRUE,
+        0, rows_per_device[i] * C_width * sizeof(float), output[i], 0, NULL, NULL);
+    checkError(status, "Failed to read output matrix");
+  }
+
+  run_times t;
+  t.trans_time = time2 - time1;
+  t.kernel_time = time3 - time2;
+  return t;
+}
+
+// CSR pipeline: streams only the nonzeros of A.
+run_times run_csr() {
+  cl_int status;
+
+
+  const double time1=getCurrentTimestamp();
+
+  for(unsigned i = 0; i < num_devices; ++i) {
+    const csr_matrix &a = input_a_csr[i];
+
+    status = clEnqueueWriteBuffer(queue[i], row_ptr_buf[i], CL_FALSE,
+        0, (a.rows + 1) * sizeof(int), a.row_ptr, 0, NULL, NULL);
+    checkError(status, "Failed to transfer row pointers of A");
+
+    if(a.nnz > 0) {
+      status = clEnqueueWriteBuffer(queue[i], col_idx_buf[i], CL_FALSE,
+          0, a.nnz * sizeof(int), a.col_idx, 0, NULL, NULL);
+      checkError(status, "Failed to transfer column indices of A");
+
+      status = clEnqueueWriteBuffer(queue[i], values_buf[i], CL_FALSE,
+          0, a.nnz * sizeof(float), a.values, 0, NULL, NULL);
+      checkError(status, "Failed to transfer values of A");
+    }
+
+    status = clEnqueueWriteBuffer(queue[i], input_b_buf[i], CL_FALSE,
+        0, B_width * B_height * sizeof(float), input_b, 0, NULL, NULL);
+    checkError(status, "Failed to transfer input B");
+  }
+
+  for(unsigned i = 0; i < num_devices; ++i) {
+    clFinish(queue[i]);
+  }
+
+  scoped_array<cl_event> kernel_event(num_devices);
+
+  const double time2 = getCurrentTimestamp();
+
+
+
+
+  for(unsigned i = 0; i < num_devices; ++i) {
+    const int nnz = input_a_csr[i].nnz;
+
+    status = clSetKernelArg(kernel_in_csr[i], 0, sizeof(cl_mem), &col_idx_buf[i]);
+    status = clSetKernelArg(kernel_in_csr[i], 1, sizeof(cl_mem), &values_buf[i]);
+	status = clSetKernelArg(kernel_in_csr[i], 2, sizeof(nnz), &nnz);
+	status = clEnqueueTask(queue_in[i], kernel_in_csr[i], 0, NULL, NULL);
+    checkError(status, "Failed to launch kernel");
+	
+	
+    status = clSetKernelArg(kernel_csr[i], 0, sizeof(cl_mem), &output_buf[i]);
+    status = clSetKernelArg(kernel_csr[i], 1, sizeof(cl_mem), &input_b_buf[i]);
+    status = clSetKernelArg(kernel_csr[i], 2, sizeof(cl_mem), &row_ptr_buf[i]);
+    status = clSetKernelArg(kernel_csr[i], 3, sizeof(B_width), &B_width);
+	status = clSetKernelArg(kernel_csr[i], 4, sizeof(rows_per_device[i]), &rows_per_device[i]);
+	status = clEnqueueTask(queue[i], kernel_csr[i], 0, NULL, &kernel_event[i]);
+    checkError(status, "Failed to launch kernel");
+
+  }
+
+  // Wait for all kernels to finish.
+  clWaitForEvents(num_devices, kernel_event);
+
+  const double time3 = getCurrentTimestamp();
+
+  for(unsigned i = 0; i < num_devices; ++i) {
+    clReleaseEvent(kernel_event[i]);
+  }
+
+  for(unsigned i = 0; i < num_devices; ++i) {
+    status = clEnqueueReadBuffer(queue[i], output_buf[i], CL_TRUE,
+        0, rows_per_device[i] * C_width * sizeof(float), output[i], 0, NULL, NULL);
+    checkError(status, "Failed to read output matrix");
+  }
+
+  run_times t;
+  t.trans_time = time2 - time1;
+  t.kernel_time = time3 - time2;
+  return t;
+}
+
+
+// One sparsity level, with the timings of both pipelines in detail.
+void run(float sparsity) {
+  init_problem(sparsity);
+
+  const double build_time = build_all_csr();
+  const unsigned nnz = total_nnz();
+  printf("Nonzeros of A: %u (%0.2f%%), CSR built in %0.3f ms\n",
+      nnz, 100.0 * nnz / (double(A_height) * A_width), build_time * 1e3);
+
+  compute_reference();
+
+  // There are C_width * C_height output values; the dense pipeline computes
+  // each with A_width multiplies and adds, the CSR pipeline only with one
+  // per nonzero of the row of A.
+  const double dense_flops = 2.0 * C_width * C_height * A_width;
+  const double useful_flops = 2.0 * C_width * nnz;
+
+  printf("\nDense:\n");
+  const run_times d = run_dense();
+  printf("Transmission Time: %0.3f ms\n", d.trans_time * 1e3);
+  printf("Kernel Time: %0.3f ms\n", d.kernel_time * 1e3);
+  printf("Throughput: %0.2f GFLOPS\n", dense_flops / d.kernel_time * 1e-9);
+  verify();
+
+  printf("\nCSR:\n");
+  const run_times s = run_csr();
+  printf("Transmission Time: %0.3f ms\n", s.trans_time * 1e3);
+  printf("Kernel Time: %0.3f ms\n", s.kernel_time * 1e3);
+  printf("Throughput: %0.2f GFLOPS useful, %0.2f GFLOPS dense-equivalent\n",
+      useful_flops / s.kernel_time * 1e-9, dense_flops / s.kernel_time * 1e-9);
+  verify();
+
+  printf("\nSpeedup over dense: %0.2fx (kernel), %0.2fx (with transfers)\n",
+      d.kernel_time / s.kernel_time,
+      (d.trans_time + d.kernel_time) / (s.trans_time + s.kernel_time));
+}
+
+// Dense vs CSR over a range of sparsity levels. The bytes of A are what
+// each pipeline transfers and streams through the channel.
+void sweep() {
+  static const float levels[] = { 0.0f, 0.5f, 0.75f, 0.9f, 0.95f, 0.99f, 0.999f };
+  const unsigned num_levels = sizeof(levels) / sizeof(levels[0]);
+
+  unsigned nnz[num_levels];
+  double build_time[num_levels];
+  run_times d[num_levels], s[num_levels];
+  bool dense_pass[num_levels], csr_pass[num_levels];
+
+  for(unsigned l = 0; l < num_levels; ++l) {
+    init_problem(levels[l]);
+    build_time[l] = build_all_csr();
+    nnz[l] = total_nnz();
+    compute_reference();
+
+    d[l] = run_dense();
+    dense_pass[l] = verify();
+    s[l] = run_csr();
+    csr_pass[l] = verify();
+  }
+
+  printf("\n%9s %10s %11s %11s %10s %10s %9s %8s %6s %6s\n",
+      "sparsity", "nnz", "A dense MB", "A CSR MB", "dense ms", "CSR ms",
+      "build ms", "speedup", "dense", "CSR");
+  for(unsigned l = 0; l < num_levels; ++l) {
+    const double dense_bytes = double(A_height) * A_width * sizeof(float);
+    const double csr_bytes = (A_height + num_devices) * sizeof(int) +
+        double(nnz[l]) * (sizeof(int) + sizeof(float));
+
+    printf("%9.3f %10u %11.2f %11.2f %10.3f %10.3f %9.3f %7.2fx %6s %6s\n",
+        levels[l], nnz[l], dense_bytes / (1 << 20), csr_bytes / (1 << 20),
+        (d[l].trans_time + d[l].kernel_time) * 1e3, (s[l].trans_time + s[l].kernel_time) * 1e3,
+        build_time[l] * 1e3, d[l].kernel_time / s[l].kernel_time,
+        dense_pass[l] ? "PASS" : "FAIL", csr_pass[l] ? "PASS" : "FAIL");
+  }
+  printf("\nTimes include the transfers; the speedup compares kernel times.\n");
+}
+
+void compute_reference() {
+  // Compute the reference output.
+  printf("Computing reference output\n");
+  ref_output.reset(C_height * C_width);
+
+  for(unsigned y = 0, dev_index = 0; y < C_height; ++dev_index) {
+    for(unsigned yy = 0; yy < rows_per_device[dev_index]; ++yy, ++y) {
+      for(unsigned x = 0; x < C_width; ++x) {
+        // Compute result for C(y, x)
+        float sum = 0.0f;
+        for(unsigned k = 0; k < A_width; ++k) {
+          sum += input_a[dev_index][yy * A_width + k] * input_b[k * B_width + x];
+        }
+        ref_output[y * C_width + x] = sum;
+      }
+    }
+  }
+}
+
+
+
+bool verify() {
+  printf("Verifying\n");
+
+  float diff = 0.0f;
+  float ref = 0.0f;
+  for(unsigned y = 0, dev_index = 0; y < C_height; ++dev_index) {
+    for(unsigned yy = 0; yy < rows_per_device[dev_index]; ++yy, ++y) {
+      for(unsigned x = 0; x < C_width; ++x) {
+        const float o = output[dev_index][yy * C_width + x];
+        const float r = ref_output[y * C_width + x];
+        const float d = o - r;
+        diff += d * d;
+        ref += r * r;
+      }
+    }
+  }
+
+  // A fully sparse A gives C == 0, so compare absolutely in that case.
+  const float diff_l2norm = sqrtf(diff);
+  const float ref_l2norm = sqrtf(ref);
+  const float error = ref_l2norm > 0.0f ? diff_l2norm / ref_l2norm : diff_l2norm;
+  const bool pass = error < 1e-6;
+  printf("Verification: %s\n", pass ? "PASS" : "FAIL");
+  if(!pass) {
+    printf("Error (L^2-Norm): %0.3g\n", error);
+  }
+  return pass;
+}
+
+void cleanup() {
+  for(unsigned i = 0; i < num_devices; ++i) {
+    if(kernel_in && kernel_in[i]) {
+      clReleaseKernel(kernel_in[i]);
+    }
+	if(kernel && kernel[i]) {
+      clReleaseKernel(kernel[i]);
+    }
+    if(kernel_in_csr && kernel_in_csr[i]) {
+      clReleaseKernel(kernel_in_csr[i]);
+    }
+	if(kernel_csr && kernel_csr[i]) {
+      clReleaseKernel(kernel_csr[i]);
+    }
+	if(queue_in && queue_in[i]) {
+      clReleaseCommandQueue(queue_in[i]);
+    }
+    if(queue && queue[i]) {
+      clReleaseCommandQueue(queue[i]);
+    }
+    if(input_a_buf && input_a_buf[i]) {
+      clReleaseMemObject(input_a_buf[i]);
+    }
+    if(row_ptr_buf && row_ptr_buf[i]) {
+      clReleaseMemObject(row_ptr_buf[i]);
+    }
+    if(col_idx_buf && col_idx_buf[i]) {
+      clReleaseMemObject(col_idx_buf[i]);
+    }
+    if(values_buf && values_buf[i]) {
+      clReleaseMemObject(values_buf[i]);
+    }
+    if(input_b_buf && input_b_buf[i]) {
+      clReleaseMemObject(input_b_buf[i]);
+    }
+    if(output_buf && output_buf[i]) {
+      clReleaseMemObject(output_buf[i]);
+    }
+  }
+
+  if(program) {
+    clReleaseProgram(program);
+  }
+  if(context) {
+    clReleaseContext(context);
+  }
+}
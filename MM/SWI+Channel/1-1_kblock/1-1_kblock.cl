@@ -0,0 +1,50 @@
+#ifndef K_BLOCK
+#define K_BLOCK 1024 // default value, size of the on-chip row buffer
+#endif
+
+	channel float chan;
+
+__kernel 
+void in( __global float *A, int A_width, int C_height)
+{
+	for (int i = 0; i < C_height; i ++){
+		for (int k = 0; k < A_width; k ++){
+			write_channel_altera(chan, A[i * A_width + k]);
+		}
+	}
+}
+
+
+// Same row-streaming scheme as 1-1, but A_width is no longer bounded by the
+// size of tA: every row of A is consumed in blocks of K_BLOCK values (the
+// last one partial), and each block adds its partial dot products to the
+// row of C written by the previous block.
+__kernel 
+void matrixMult( // Input and output matrices
+                 __global float *restrict C,
+                 __global float *B, 
+                 // Widths of matrices.
+                 int A_width, int C_width, int C_height)
+{
+	float tA[K_BLOCK];
+
+	for (int i = 0; i < C_height; i ++){
+
+		for (int kb = 0; kb < A_width; kb += K_BLOCK){
+
+			int k_len = (A_width - kb < K_BLOCK) ? A_width - kb : K_BLOCK;
+
+			for (int k = 0; k < k_len; k++)
+				tA[k] = read_channel_altera(chan);
+
+			for (int j = 0; j < C_width; j ++){
+				float running_sum = (kb == 0) ? 0.0f : C[i * C_width + j];
+				for (int k = 0; k < k_len; k++){
+					running_sum += tA[k] *	B[(kb + k) * C_width + j];		
+				}
+				C[i * C_width + j] = running_sum;
+			}
+		}
+
+	}
+}
@@ -0,0 +1,12 @@
+#ifndef ACCELERATION_H
+#define ACCELERATION_H
+
+// Flags of the accelerated frame mode (mandelbrotSetAcceleration). The
+// frames stay those of the brute-force iteration; the kernel uses the same
+// values for the flags it supports.
+#define ACCEL_BULB      1  // closed-form main cardioid and period-2 bulb rejection
+#define ACCEL_PERIOD    2  // periodicity (cycle) detection
+#define ACCEL_SUBDIVIDE 4  // rectangle subdivision, software only
+#define ACCEL_ALL       (ACCEL_BULB | ACCEL_PERIOD | ACCEL_SUBDIVIDE)
+
+#endif
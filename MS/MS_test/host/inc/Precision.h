@@ -0,0 +1,20 @@
+#ifndef PRECISION_H
+#define PRECISION_H
+
+// Iteration precision of the frames (mandelbrotSetPrecision). The kernel
+// uses the same lane count, rounding bound and redo marker.
+#define PRECISION_DOUBLE 0  // FP64 iteration
+#define PRECISION_FLOAT  1  // FP32 iteration, FLOAT_LANES pixels per work-item
+#define PRECISION_AUTO   2  // FP32 for the frames within FLOAT_MAX_ERROR, else FP64
+
+#define FLOAT_LANES      8    // pixels per work-item of hw_mandelbrot_frame_float
+#define FLOAT_MAX_ERROR  0.5  // largest FP32 error estimate, in pixels, of an auto frame
+
+// FP32 pixels carry a bound on the distance of their orbit from the exact
+// one. Every iteration adds FLOAT_ROUNDING * (|z|^2 + |c|) for its
+// rounding, and pixels whose escape test the bound cannot decide are
+// redone in FP64.
+#define FLOAT_ROUNDING   (1.0 / 1048576)  // 2^-20, 16 FP32 ulps
+#define FLOAT_REDO_PIXEL 0xFFFFFFFF       // pixel of an FP32 frame left for FP64
+
+#endif
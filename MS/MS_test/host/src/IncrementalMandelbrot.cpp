@@ -0,0 +1,276 @@
+#include "IncrementalMandelbrot.h"
+#include "Mandelbrot.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+
+using namespace aocl_utils;
+
+extern unsigned int theWidth;
+extern unsigned int theHeight;
+
+// A pan is reused when it moves the frame by whole pixels to within this
+// fraction of a pixel (at deep zooms the positions are only that exact)
+#define PIXEL_TOLERANCE 0.01
+
+// Preview rows are refined in bands of REFINE_BAND rows, in bit-reversed
+// band order so that the first bands are spread over the frame
+#define REFINE_BAND 8
+
+// The last frame: position, pixels and which rows are exact
+static bool theIncValid = false;
+static double theIncX = 0.0;
+static double theIncY = 0.0;
+static double theIncScale = 0.0;
+static unsigned int theIncWidth = 0;
+static unsigned int theIncHeight = 0;
+static unsigned int* theIncFrame = 0;
+static std::vector<unsigned char> theRowExact;
+
+// The next frame while it is assembled from the last one
+static unsigned int* theIncNext = 0;
+static std::vector<unsigned char> theNextRowExact;
+
+static std::vector<unsigned int> theBandOrder;
+static unsigned int theRefineParts = 1;
+static incrementalStats theIncStats;
+
+// Make the buffers match the frame size
+static void incrementalSetFrameBufferSize()
+{
+  if(theIncWidth == theWidth && theIncHeight == theHeight)
+    return;
+
+  incrementalRelease();
+  theIncWidth = theWidth;
+  theIncHeight = theHeight;
+  theIncFrame = (unsigned int*)alignedMalloc(theWidth * theHeight * sizeof(unsigned int));
+  theIncNext = (unsigned int*)alignedMalloc(theWidth * theHeight * sizeof(unsigned int));
+  theRowExact.assign(theHeight, 0);
+  theNextRowExact.assign(theHeight, 0);
+
+  // Bit-reversed order of the bands
+  const unsigned int bands = (theHeight + REFINE_BAND - 1) / REFINE_BAND;
+  unsigned int bits = 0;
+  while((1u << bits) < bands)
+    bits++;
+
+  theBandOrder.clear();
+  for(unsigned int i = 0; i < (1u << bits); i++)
+  {
+    unsigned int band = 0;
+    for(unsigned int b = 0; b < bits; b++)
+      band |= ((i >> b) & 1) << (bits - 1 - b);
+    if(band < bands)
+      theBandOrder.push_back(band);
+  }
+}
+
+// Calculate the whole frame at the current position
+static void incrementalCalculateAll()
+{
+  mandelbrotCalculateFullFrame(theIncX, theIncY, theIncScale, theIncFrame);
+  std::fill(theRowExact.begin(), theRowExact.end(), 1);
+  theIncStats.computedPixels += theWidth * theHeight;
+}
+
+// Calculate a rectangle of the frame at the current position
+static void incrementalCalculateRect(
+  unsigned int aX,
+  unsigned int aY,
+  unsigned int aWidth,
+  unsigned int aHeight)
+{
+  if(aWidth == 0 || aHeight == 0)
+    return;
+
+  mandelbrotCalculateRect(theIncX, theIncY, theIncScale, aX, aY, aWidth, aHeight, theIncFrame);
+  theIncStats.computedPixels += aWidth * aHeight;
+}
+
+// Move the last frame aColumns to the left and aRows up (the view moved
+// right and down), and calculate the strips that come into view
+static void incrementalPan(int aColumns, int aRows)
+{
+  const unsigned int width = theWidth - abs(aColumns);
+  const unsigned int height = theHeight - abs(aRows);
+  const unsigned int fromX = aColumns > 0 ? aColumns : 0;
+  const unsigned int toX = aColumns < 0 ? -aColumns : 0;
+  const unsigned int toY = aRows < 0 ? -aRows : 0;
+
+  for(unsigned int j = toY; j < toY + height; j++)
+  {
+    memcpy(&theIncNext[j * theWidth + toX], &theIncFrame[(j + aRows) * theWidth + fromX],
+      width * sizeof(unsigned int));
+    theNextRowExact[j] = theRowExact[j + aRows];
+  }
+  std::swap(theIncFrame, theIncNext);
+  theRowExact.swap(theNextRowExact);
+  theIncStats.reusedPixels += width * height;
+
+  // Exposed rows, then the exposed columns of the other rows
+  const unsigned int exposedY = aRows > 0 ? height : 0;
+  incrementalCalculateRect(0, exposedY, theWidth, theHeight - height);
+  for(unsigned int j = exposedY; j < exposedY + theHeight - height; j++)
+    theRowExact[j] = 1;
+
+  incrementalCalculateRect(aColumns > 0 ? width : 0, toY, theWidth - width, height);
+}
+
+// Resample the last frame, at (aOldX, aOldY) with aOldScale, to the current
+// position as a preview; false if the two frames do not overlap
+static bool incrementalZoom(double aOldX, double aOldY, double aOldScale)
+{
+  std::vector<unsigned int> columns(theWidth);
+  std::vector<unsigned int> rows(theHeight);
+  bool overlap = false;
+
+  for(unsigned int k = 0; k < theWidth; k++)
+  {
+    const double column = floor((theIncX + k * theIncScale - aOldX) / aOldScale + 0.5);
+    overlap |= column >= 0 && column < theWidth;
+    columns[k] = (unsigned int)std::min(std::max(column, 0.0), theWidth - 1.0);
+  }
+  if(!overlap)
+    return false;
+
+  overlap = false;
+  for(unsigned int j = 0; j < theHeight; j++)
+  {
+    const double row = floor((aOldY - (theIncY - j * theIncScale)) / aOldScale + 0.5);
+    overlap |= row >= 0 && row < theHeight;
+    rows[j] = (unsigned int)std::min(std::max(row, 0.0), theHeight - 1.0);
+  }
+  if(!overlap)
+    return false;
+
+  for(unsigned int j = 0; j < theHeight; j++)
+  {
+    const unsigned int* from = &theIncFrame[rows[j] * theWidth];
+    unsigned int* to = &theIncNext[j * theWidth];
+    for(unsigned int k = 0; k < theWidth; k++)
+      to[k] = from[columns[k]];
+  }
+  std::swap(theIncFrame, theIncNext);
+  std::fill(theRowExact.begin(), theRowExact.end(), 0);
+  return true;
+}
+
+// Calculate up to 1/theRefineParts of the frame rows that still show the
+// preview
+static void incrementalRefine()
+{
+  unsigned int budget = (theHeight + theRefineParts - 1) / theRefineParts;
+
+  for(size_t b = 0; b < theBandOrder.size() && budget > 0; b++)
+  {
+    const unsigned int bandEnd = std::min((theBandOrder[b] + 1) * REFINE_BAND, theHeight);
+    unsigned int j = theBandOrder[b] * REFINE_BAND;
+
+    while(j < bandEnd && budget > 0)
+    {
+      if(theRowExact[j])
+      {
+        j++;
+        continue;
+      }
+
+      // Run of preview rows
+      unsigned int end = j;
+      while(end < bandEnd && end - j < budget && !theRowExact[end])
+        theRowExact[end++] = 1;
+
+      incrementalCalculateRect(0, j, theWidth, end - j);
+      budget -= end - j;
+      j = end;
+    }
+  }
+
+  theIncStats.previewRows = 0;
+  for(unsigned int j = 0; j < theHeight; j++)
+    theIncStats.previewRows += !theRowExact[j];
+}
+
+// Calculate a frame, reusing the last one where it can
+int incrementalCalculateFrame(
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int* aFrameBuffer)
+{
+  incrementalSetFrameBufferSize();
+
+  const double oldX = theIncX;
+  const double oldY = theIncY;
+  const double oldScale = theIncScale;
+  const bool valid = theIncValid;
+
+  theIncX = aStartX;
+  theIncY = aStartY;
+  theIncScale = aScale;
+  theIncValid = true;
+  memset(&theIncStats, 0, sizeof(theIncStats));
+
+  if(!valid)
+    incrementalCalculateAll();
+
+  else if(aScale == oldScale)
+  {
+    // Pixels the view moved right and down
+    const double dx = (aStartX - oldX) / aScale;
+    const double dy = (oldY - aStartY) / aScale;
+    const double columns = floor(dx + 0.5);
+    const double rows = floor(dy + 0.5);
+
+    if(fabs(dx - columns) > PIXEL_TOLERANCE || fabs(dy - rows) > PIXEL_TOLERANCE ||
+      fabs(columns) >= theWidth || fabs(rows) >= theHeight)
+      incrementalCalculateAll();
+    else
+      incrementalPan((int)columns, (int)rows);
+  }
+
+  // A zoom shows a preview unless every row would be refined at once
+  else if(theRefineParts == 1 || !incrementalZoom(oldX, oldY, oldScale))
+    incrementalCalculateAll();
+
+  incrementalRefine();
+
+  memcpy(aFrameBuffer, theIncFrame, theWidth * theHeight * sizeof(unsigned int));
+
+  // Return success
+  return 0;
+}
+
+int incrementalSetRefineParts(unsigned int aParts)
+{
+  theRefineParts = aParts > 0 ? aParts : 1;
+  return 0;
+}
+
+void incrementalGetStats(incrementalStats* aStats)
+{
+  *aStats = theIncStats;
+}
+
+int incrementalReset()
+{
+  theIncValid = false;
+  return 0;
+}
+
+int incrementalRelease()
+{
+  if(theIncFrame)
+    alignedFree(theIncFrame);
+  if(theIncNext)
+    alignedFree(theIncNext);
+  theIncFrame = 0;
+  theIncNext = 0;
+  theIncWidth = 0;
+  theIncHeight = 0;
+  theIncValid = false;
+  return 0;
+}
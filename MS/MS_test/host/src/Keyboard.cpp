@@ -25,6 +25,21 @@ int keyboardPressEvent(SDL_Event* anEvent)
       mandelbrotSwitchCalculationMethod();
       break;
 
+    // Switch the accelerated frame mode on and off
+    case SDLK_a:
+      mandelbrotSwitchAcceleration();
+      break;
+
+    // Switch incremental frames on and off
+    case SDLK_i:
+      mandelbrotSwitchIncremental();
+      break;
+
+    // Switch between the automatic precision and double precision only
+    case SDLK_p:
+      mandelbrotSwitchPrecision();
+      break;
+
     // Switch demo mode on and off
     case SDLK_d:
         theDemoRunning = !theDemoRunning;
@@ -0,0 +1,97 @@
+// Amount of loop unrolling. Higher unrolling amounts lead to higher
+// performance but also greater resource usage.
+#ifndef UNROLL
+#define UNROLL 20
+#endif
+
+// Define the color black as 0
+#define BLACK 0x00000000
+
+// Accelerated frame mode flags, as in Acceleration.h
+#define ACCEL_BULB   1
+#define ACCEL_PERIOD 2
+
+////////////////////////////////////////////////////////////////////
+// Hardware implementation of the mandelbrot algorithm
+////////////////////////////////////////////////////////////////////
+
+
+// Mandelbrot set: zn+1 = zn^2 + c;
+
+__kernel 
+void hw_mandelbrot_frame (
+							const double x0,
+							const double y0,
+							const double stepSize,
+							const unsigned int maxIterations,
+							__global unsigned int *restrict framebuffer,
+							__constant const unsigned int *restrict colorLUT,
+							const unsigned int windowWidth,
+							const unsigned int acceleration)
+{
+	// Work-item position
+	const size_t windowPosX = get_global_id(0);
+	const size_t windowPosY = get_global_id(1);
+	
+	const double stepPosX = x0 + (windowPosX * stepSize);
+	const double stepPosY = y0 - (windowPosY * stepSize);
+
+	// Variables for the calculation
+	double x = 0.0;
+	double y = 0.0;
+	double xSqr = 0.0;
+	double ySqr = 0.0;
+	unsigned int iterations = 0;
+
+	// Points of the main cardioid and the period-2 bulb never escape
+	if (acceleration & ACCEL_BULB)
+	{
+		const double xq = stepPosX - 0.25;
+		const double q = xq*xq + stepPosY*stepPosY;
+		const double xp = stepPosX + 1.0;
+		if (q * (q + xq) <= 0.25 * stepPosY*stepPosY ||
+			xp*xp + stepPosY*stepPosY <= 0.0625)
+			iterations = maxIterations;
+	}
+
+	// Orbit point saved at the last power-of-two iteration, to detect
+	// periodic orbits
+	double xOld = 0.0;
+	double yOld = 0.0;
+
+	// Perform up to the maximum number of iterations to solve
+	// the current work-item's position in the image
+  //
+  // The loop unrolling factor can be adjusted based on the amount of FPGA
+  // resources available.
+
+	while (	xSqr + ySqr < 4.0 &&
+			iterations < maxIterations)
+	{
+		// Perform the current iteration
+		xSqr = x*x;
+		ySqr = y*y;
+
+		y = 2*x*y + stepPosY;
+		x = xSqr - ySqr + stepPosX;
+
+		// Increment iteration count
+		iterations++;
+
+		// An orbit that returns exactly to a previous point is periodic
+		// and never escapes
+		if (acceleration & ACCEL_PERIOD)
+		{
+			if (x == xOld && y == yOld)
+				iterations = maxIterations;
+			if ((iterations & (iterations - 1)) == 0)
+			{
+				xOld = x;
+				yOld = y;
+			}
+		}
+	}
+
+	// Output black if we never finished, and a color from the look up table otherwise
+	framebuffer[windowWidth * windowPosY + windowPosX] = (iterations == maxIterations)? BLACK : colorLUT[iterations];
+}
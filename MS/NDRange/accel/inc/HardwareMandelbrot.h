@@ -0,0 +1,81 @@
+#ifndef HARDWARE_MANDELBROT_H
+#define HARDWARE_MANDELBROT_H
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+#include <assert.h>
+
+#include "CL/opencl.h"
+#include "AOCLUtils/aocl_utils.h"
+#include "Acceleration.h"
+#include "Precision.h"
+
+// Hardware Mandelbrot
+int hardwareInitialize();
+
+int hardwareSetColorTable(
+  unsigned int* aColorTable,
+  unsigned int aColorTableSize);
+
+int hardwareSetAcceleration(unsigned int aFlags);
+
+// Set the precision of the next frames: PRECISION_DOUBLE or PRECISION_FLOAT;
+// -1 if the AOCX has no kernel in that precision
+int hardwareSetPrecision(unsigned int aPrecision);
+
+// Whether the AOCX has a frame kernel in aPrecision (PRECISION_FLOAT needs
+// the fp32 design)
+bool hardwareHasPrecision(unsigned int aPrecision);
+
+// Frame scheduling across the devices
+#define SCHEDULE_STATIC  0  // one contiguous slice of rows per device
+#define SCHEDULE_DYNAMIC 1  // devices (and CPU workers) pull row groups
+
+int hardwareSetSchedule(
+  unsigned int aSchedule,
+  unsigned int aRowGroup,
+  unsigned int aCpuWorkers);
+
+// Work of one device or CPU worker in the last frame
+struct workerStats {
+  double busyTime;        // seconds computing
+  unsigned int rowGroups; // row groups taken
+};
+
+unsigned int hardwareGetWorkerStats(const workerStats** aStats);
+
+int hardwareCalculateFrame(
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int* aFrameBuffer);
+
+// Calculate the aWidth x aHeight rectangle at pixel (aX, aY) of a frame
+int hardwareCalculateRect(
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int aX,
+  unsigned int aY,
+  unsigned int aWidth,
+  unsigned int aHeight,
+  unsigned int* aFrameBuffer);
+
+// Calculate a frame by perturbation against a reference orbit; -1 if the
+// AOCX has no perturbation kernel
+int hardwareCalculatePerturbed(
+  const double* aOrbitX,
+  const double* aOrbitY,
+  unsigned int aOrbitLength,
+  double aDeltaX0,
+  double aDeltaY0,
+  double aScale,
+  bool aOnlyGlitched,
+  unsigned int* aFrameBuffer);
+
+int hardwareRelease();
+
+#endif
+
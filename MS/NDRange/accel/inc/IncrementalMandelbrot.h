@@ -0,0 +1,34 @@
+#ifndef INCREMENTAL_MANDELBROT_H
+#define INCREMENTAL_MANDELBROT_H
+
+#include "AOCLUtils/aocl_utils.h"
+
+// Incremental frames: the last frame is kept, a pan by whole pixels reuses
+// its pixels and computes only the exposed strips, and a zoom shows it
+// resampled as a preview that is refined over the next frames.
+
+// Pixels of the last incremental frame
+struct incrementalStats {
+  unsigned int reusedPixels;    // moved over from the frame before
+  unsigned int computedPixels;  // calculated for this frame
+  unsigned int previewRows;     // rows still showing the preview
+};
+
+int incrementalCalculateFrame(
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int* aFrameBuffer);
+
+// Refine 1/aParts of the preview rows per frame (1 refines them all, so
+// every frame is exact)
+int incrementalSetRefineParts(unsigned int aParts);
+
+void incrementalGetStats(incrementalStats* aStats);
+
+// Forget the last frame, e.g. when the colors or the calculation change
+int incrementalReset();
+
+int incrementalRelease();
+
+#endif
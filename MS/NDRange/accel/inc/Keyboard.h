@@ -0,0 +1,16 @@
+#ifndef __KEYBOARD_H__
+#define __KEYBOARD_H__
+
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <SDL2/SDL.h>
+
+#include "MandelbrotWindow.h"
+#include "Mandelbrot.h"
+
+// Keyboard input
+int keyboardPressEvent(SDL_Event* anEvent);
+
+#endif
+
@@ -0,0 +1,869 @@
+// Headless benchmark driver.
+//
+// Renders theTestLocations, theDemoLocations and scripted pan and zoom
+// paths through mandelbrotCalculateFrame without SDL, so it runs on a
+// machine with no display. Build it from the sources of this directory
+// without main.cpp, MandelbrotWindow.cpp, Keyboard.cpp and Mouse.cpp, e.g.
+//
+//   g++ -O2 -fopenmp -march=native -ffp-contract=off -Iinc -I../../common/inc
+//     src/benchmark.cpp src/Mandelbrot.cpp src/IncrementalMandelbrot.cpp
+//     src/PerturbationMandelbrot.cpp src/HardwareMandelbrot.cpp
+//     src/SoftwareMandelbrot.cpp
+//     ../../common/src/AOCLUtils/*.cpp $(aocl link-config) -o bin/benchmark
+//
+// Options:
+//   -res=<WxH,...>       resolutions, default 800x640
+//   -iters=<n,...>       iteration limits (color table sizes), default 2000
+//   -set=<s,...>         location sets: test, demo, pan and zoom (paths
+//                        of consecutive window frames), all is test,demo
+//                        and paths is pan,zoom; default all
+//   -method=<m,...>      calculation methods: hw, sw (the frame engine),
+//                        scalar (single-threaded reference), hw_fast and
+//                        sw_fast (accelerated frame mode), hw_dyn (dynamic
+//                        schedule), hw_inc and sw_inc (incremental
+//                        frames), hw_f32 and sw_f32 (single precision),
+//                        hw_auto and sw_auto (precision per frame); all
+//                        is hw,sw. The other methods iterate in double.
+//   -accel=<a,...>       parts of the accelerated frame mode: bulb,
+//                        period, subdivide; default all three
+//   -group=<n>           rows per group of the dynamic schedule, default 16
+//   -cpu_workers=<n>     CPU threads pulling row groups with the devices
+//                        in the dynamic schedule, default 0
+//   -refine=<n>          incremental frames refine 1/n of the zoom
+//                        preview per frame, default 1 (exact frames)
+//   -passes=<n>          timed passes over the location set, default 3
+//   -deep                deep zoom benchmark instead of the location sets:
+//                        perturbation frames of the hw and sw methods
+//   -scales=<s,...>      scales of the deep zoom benchmark, default 1e-12
+//                        to 1e-30 in steps of 1000
+//
+// Every frame is timed end to end (kernel and read back for the
+// hardware). For the hardware methods the busy time of every device (and
+// CPU worker) is printed as a share of the frame time, with the row
+// groups it took per frame; for the incremental methods the share of
+// reused and computed pixels and the frames showing a preview; for the
+// single precision frames their number and their largest error estimate
+// (mandelbrotFloatErrorEstimate). The locations are scaled so that every
+// resolution covers the same region as the 800 pixel wide window. The
+// last frame of each location is compared against the one of the first
+// method, and the largest fraction of differing pixels is reported:
+// against a brute-force method first, it is the pixel-exactness of the
+// accelerated modes and of the single precision frames
+// (-ffp-contract=off keeps g++ from fusing the pixel positions into FMAs,
+// which would move the host and device sample points apart).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "AOCLUtils/aocl_utils.h"
+#include "Mandelbrot.h"
+
+using namespace aocl_utils;
+
+// Frame size, read by the hardware and software calculators
+unsigned int theWidth;
+unsigned int theHeight;
+
+extern int theCalculationMethod;
+extern unsigned int theMaxIterations;
+extern bool printFrameTimes;
+
+// Width the location scales are given for
+#define REFERENCE_WIDTH 800
+
+// A location set
+struct locationSet {
+  const char* name;
+  const struct coordinates* locations;
+  unsigned count;
+};
+
+// A calculation method
+struct calculationMethod {
+  const char* name;
+  int (*calculate)(double aStartX, double aStartY, double aScale, unsigned int* aFrameBuffer);
+  bool hardware;
+  bool incremental;
+};
+
+// Flags of the accelerated methods
+static unsigned int theBenchAcceleration = ACCEL_ALL;
+
+// Dynamic schedule of hw_dyn
+static unsigned int theBenchRowGroup = 16;
+static unsigned int theBenchCpuWorkers = 0;
+
+static int calculateHardware(double aStartX, double aStartY, double aScale, unsigned int* aFrameBuffer)
+{
+  theCalculationMethod = HARDWARE;
+  hardwareSetSchedule(SCHEDULE_STATIC, theBenchRowGroup, 0);
+  mandelbrotSetAcceleration(0);
+  mandelbrotSetIncremental(false);
+  mandelbrotSetPrecision(PRECISION_DOUBLE);
+  return mandelbrotCalculateFrame(aStartX, aStartY, aScale, aFrameBuffer);
+}
+
+static int calculateHardwareIncremental(double aStartX, double aStartY, double aScale, unsigned int* aFrameBuffer)
+{
+  theCalculationMethod = HARDWARE;
+  hardwareSetSchedule(SCHEDULE_STATIC, theBenchRowGroup, 0);
+  mandelbrotSetAcceleration(0);
+  mandelbrotSetIncremental(true);
+  mandelbrotSetPrecision(PRECISION_DOUBLE);
+  return mandelbrotCalculateFrame(aStartX, aStartY, aScale, aFrameBuffer);
+}
+
+static int calculateSoftwareIncremental(double aStartX, double aStartY, double aScale, unsigned int* aFrameBuffer)
+{
+  theCalculationMethod = SOFTWARE;
+  mandelbrotSetAcceleration(0);
+  mandelbrotSetIncremental(true);
+  mandelbrotSetPrecision(PRECISION_DOUBLE);
+  return mandelbrotCalculateFrame(aStartX, aStartY, aScale, aFrameBuffer);
+}
+
+static int calculateHardwareDynamic(double aStartX, double aStartY, double aScale, unsigned int* aFrameBuffer)
+{
+  theCalculationMethod = HARDWARE;
+  hardwareSetSchedule(SCHEDULE_DYNAMIC, theBenchRowGroup, theBenchCpuWorkers);
+  mandelbrotSetAcceleration(0);
+  mandelbrotSetIncremental(false);
+  mandelbrotSetPrecision(PRECISION_DOUBLE);
+  return mandelbrotCalculateFrame(aStartX, aStartY, aScale, aFrameBuffer);
+}
+
+static int calculateSoftware(double aStartX, double aStartY, double aScale, unsigned int* aFrameBuffer)
+{
+  theCalculationMethod = SOFTWARE;
+  mandelbrotSetAcceleration(0);
+  mandelbrotSetIncremental(false);
+  mandelbrotSetPrecision(PRECISION_DOUBLE);
+  return mandelbrotCalculateFrame(aStartX, aStartY, aScale, aFrameBuffer);
+}
+
+static int calculateHardwareFast(double aStartX, double aStartY, double aScale, unsigned int* aFrameBuffer)
+{
+  theCalculationMethod = HARDWARE;
+  hardwareSetSchedule(SCHEDULE_STATIC, theBenchRowGroup, 0);
+  mandelbrotSetAcceleration(theBenchAcceleration);
+  mandelbrotSetIncremental(false);
+  mandelbrotSetPrecision(PRECISION_DOUBLE);
+  return mandelbrotCalculateFrame(aStartX, aStartY, aScale, aFrameBuffer);
+}
+
+static int calculateSoftwareFast(double aStartX, double aStartY, double aScale, unsigned int* aFrameBuffer)
+{
+  theCalculationMethod = SOFTWARE;
+  mandelbrotSetAcceleration(theBenchAcceleration);
+  mandelbrotSetIncremental(false);
+  mandelbrotSetPrecision(PRECISION_DOUBLE);
+  return mandelbrotCalculateFrame(aStartX, aStartY, aScale, aFrameBuffer);
+}
+
+static int calculateHardwarePrecision(double aStartX, double aStartY, double aScale,
+  unsigned int* aFrameBuffer, unsigned int aPrecision)
+{
+  theCalculationMethod = HARDWARE;
+  hardwareSetSchedule(SCHEDULE_STATIC, theBenchRowGroup, 0);
+  mandelbrotSetAcceleration(0);
+  mandelbrotSetIncremental(false);
+  mandelbrotSetPrecision(aPrecision);
+  return mandelbrotCalculateFrame(aStartX, aStartY, aScale, aFrameBuffer);
+}
+
+static int calculateSoftwarePrecision(double aStartX, double aStartY, double aScale,
+  unsigned int* aFrameBuffer, unsigned int aPrecision)
+{
+  theCalculationMethod = SOFTWARE;
+  mandelbrotSetAcceleration(0);
+  mandelbrotSetIncremental(false);
+  mandelbrotSetPrecision(aPrecision);
+  return mandelbrotCalculateFrame(aStartX, aStartY, aScale, aFrameBuffer);
+}
+
+static int calculateHardwareFloat(double aStartX, double aStartY, double aScale, unsigned int* aFrameBuffer)
+{
+  return calculateHardwarePrecision(aStartX, aStartY, aScale, aFrameBuffer, PRECISION_FLOAT);
+}
+
+static int calculateSoftwareFloat(double aStartX, double aStartY, double aScale, unsigned int* aFrameBuffer)
+{
+  return calculateSoftwarePrecision(aStartX, aStartY, aScale, aFrameBuffer, PRECISION_FLOAT);
+}
+
+static int calculateHardwareAuto(double aStartX, double aStartY, double aScale, unsigned int* aFrameBuffer)
+{
+  return calculateHardwarePrecision(aStartX, aStartY, aScale, aFrameBuffer, PRECISION_AUTO);
+}
+
+static int calculateSoftwareAuto(double aStartX, double aStartY, double aScale, unsigned int* aFrameBuffer)
+{
+  return calculateSoftwarePrecision(aStartX, aStartY, aScale, aFrameBuffer, PRECISION_AUTO);
+}
+
+// Results of one configuration
+struct benchmarkResult {
+  unsigned frames;
+  double totalTime;
+  double p50, p90, p99, max;
+  std::vector<workerStats> workers;  // summed over the frames (hardware)
+  double reusedPixels;               // summed over the frames (incremental)
+  double computedPixels;
+  unsigned previewFrames;
+  unsigned floatFrames;              // frames calculated in FP32
+  double floatErrorEstimate;         // largest FP32 error estimate of a frame, in pixels
+};
+
+// Split a comma separated option value
+static std::vector<std::string> splitList(const std::string& aList)
+{
+  std::vector<std::string> items;
+  size_t start = 0;
+  while(start <= aList.size())
+  {
+    size_t end = aList.find(',', start);
+    if(end == std::string::npos)
+      end = aList.size();
+    if(end > start)
+      items.push_back(aList.substr(start, end - start));
+    start = end + 1;
+  }
+  return items;
+}
+
+// Same palette as colorTableInit in main.cpp, packed as 0x00RRGGBB (the
+// format SDL_MapRGB gives for the 32 bit frame surfaces)
+static unsigned int packRGB(unsigned r, unsigned g, unsigned b)
+{
+  return (std::min(r, 255u) << 16) | (std::min(g, 255u) << 8) | std::min(b, 255u);
+}
+
+static void setColorTable(unsigned aSize, bool aHardware)
+{
+  unsigned int* aColorTable = (unsigned int*)alignedMalloc(aSize * sizeof(unsigned int));
+
+  for(unsigned int i = 0; i < aSize; i++)
+  {
+    if (i < 64)
+      aColorTable[i] = packRGB(5*i+20, 0, 0);
+    else if (i < 128)
+      aColorTable[i] = packRGB(255, (2*i) & 0xff, 0);
+    else if (i < 768)
+      aColorTable[i] = packRGB((unsigned)(0.25*i), (unsigned)(0.25*i), 0);
+    else
+      aColorTable[i] = packRGB((unsigned)(0.10*i), (unsigned)(0.10*i), 0);
+  }
+
+  if(aHardware)
+    hardwareSetColorTable(aColorTable, aSize);
+  softwareSetColorTable(aColorTable, aSize);
+  perturbationSetColorTable(aColorTable, aSize);
+  incrementalReset();
+  theMaxIterations = aSize;
+
+  alignedFree(aColorTable);
+}
+
+// Fraction of the pixels in which two frames differ
+static double frameDifference(const unsigned int* aFrame, const unsigned int* aReference, unsigned aPixels)
+{
+  unsigned differ = 0;
+  for(unsigned i = 0; i < aPixels; i++)
+    differ += aFrame[i] != aReference[i];
+  return (double)differ / aPixels;
+}
+
+// Nearest-rank percentile of sorted latencies
+static double percentile(const std::vector<double>& aSorted, double aP)
+{
+  size_t rank = (size_t)(aP / 100.0 * aSorted.size() + 0.5);
+  if(rank < 1) rank = 1;
+  if(rank > aSorted.size()) rank = aSorted.size();
+  return aSorted[rank - 1];
+}
+
+// Pan path: the window panning to a few targets, by a fifth of the
+// remaining distance in whole pixels per frame as mandelbrotWindowUpdate
+// moves, starting from aStart. The scales are stored for REFERENCE_WIDTH
+// like those of the location sets.
+static std::vector<coordinates> makePanPath(const coordinates& aStart)
+{
+  static const int targets[][2] = { {240, 0}, {0, 160}, {-240, -80}, {120, -80} };
+  const double scale = aStart.scale * REFERENCE_WIDTH / theWidth;
+
+  std::vector<coordinates> path(1, aStart);
+  double x = aStart.x;
+  double y = aStart.y;
+  for(unsigned t = 0; t < sizeof(targets) / sizeof(targets[0]); t++)
+  {
+    const double targetX = x + targets[t][0] * scale;
+    const double targetY = y - targets[t][1] * scale;
+    for(;;)
+    {
+      const double xDistance = (targetX - x) / scale;
+      const double yDistance = (targetY - y) / scale;
+      if(fabs(xDistance) <= 5.0 && fabs(yDistance) <= 5.0)
+        break;
+      x += floor(xDistance * 0.2 + 0.5) * scale;
+      y += floor(yDistance * 0.2 + 0.5) * scale;
+      coordinates frame = { x, y, aStart.scale };
+      path.push_back(frame);
+    }
+    x = targetX;
+    y = targetY;
+    coordinates frame = { x, y, aStart.scale };
+    path.push_back(frame);
+  }
+  return path;
+}
+
+// Zoom path: zooming in on the centre of aStart by 5% per frame
+static std::vector<coordinates> makeZoomPath(const coordinates& aStart)
+{
+  const double scale = aStart.scale * REFERENCE_WIDTH / theWidth;
+  const double centreX = aStart.x + 0.5 * theWidth * scale;
+  const double centreY = aStart.y - 0.5 * theHeight * scale;
+
+  std::vector<coordinates> path;
+  double zoom = 1.0;
+  for(unsigned i = 0; i < 40; i++, zoom *= 0.95)
+  {
+    coordinates frame = { centreX - 0.5 * theWidth * scale * zoom,
+      centreY + 0.5 * theHeight * scale * zoom, aStart.scale * zoom };
+    path.push_back(frame);
+  }
+  return path;
+}
+
+// Centres of the deep zoom benchmark: the Misiurewicz point i, which has
+// detail at every scale, and the centres of two demo locations
+struct deepLocation {
+  const char* name;
+  double x;
+  double y;
+};
+
+static std::vector<deepLocation> deepLocations()
+{
+  std::vector<deepLocation> locations;
+  deepLocation misiurewicz = { "i", 0.0, 1.0 };
+  locations.push_back(misiurewicz);
+
+  static const unsigned demo[] = { 9, 11 };
+  static const char* names[] = { "demo9", "demo11" };
+  for(unsigned i = 0; i < 2; i++)
+  {
+    const coordinates& c = theDemoLocations[demo[i]];
+    deepLocation location = { names[i], c.x + 0.5 * REFERENCE_WIDTH * c.scale,
+      c.y - 0.5 * REFERENCE_WIDTH * 0.8 * c.scale };
+    locations.push_back(location);
+  }
+  return locations;
+}
+
+// Pixels of the frame compared against the high-precision reference
+#define DEEP_SAMPLES 12
+
+// Deep zoom benchmark at the current resolution and iteration limit: for
+// every location and scale the perturbation frame of each method is timed,
+// and DEEP_SAMPLES^2 pixels of it, and of a plain double frame, are
+// compared against a direct high-precision iteration
+static void runDeep(
+  const std::vector<double>& aScales,
+  const std::vector<calculationMethod>& aMethods,
+  unsigned aPasses,
+  unsigned aMaxIterations)
+{
+  const std::vector<deepLocation> locations = deepLocations();
+  unsigned int* frame = (unsigned int*)alignedMalloc(theWidth * theHeight * sizeof(unsigned int));
+
+  for(size_t l = 0; l < locations.size(); l++)
+  {
+    for(size_t s = 0; s < aScales.size(); s++)
+    {
+      const double scale = aScales[s];
+
+      // High-precision reference of the sampled pixels
+      std::vector<unsigned> sampleX, sampleY, reference;
+      for(unsigned j = 0; j < DEEP_SAMPLES; j++)
+        for(unsigned k = 0; k < DEEP_SAMPLES; k++)
+        {
+          sampleX.push_back((2 * k + 1) * theWidth / (2 * DEEP_SAMPLES));
+          sampleY.push_back((2 * j + 1) * theHeight / (2 * DEEP_SAMPLES));
+          reference.push_back(perturbationReferencePixel(locations[l].x, locations[l].y,
+            scale, sampleX.back(), sampleY.back()));
+        }
+
+      for(size_t m = 0; m < aMethods.size(); m++)
+      {
+        theCalculationMethod = aMethods[m].hardware ? HARDWARE : SOFTWARE;
+        mandelbrotSetAcceleration(0);
+        mandelbrotSetIncremental(false);
+
+        // Plain double precision frame, for comparison
+        mandelbrotCalculateFullFrame(locations[l].x - (theWidth / 2) * scale,
+          locations[l].y + (theHeight / 2) * scale, scale, frame);
+        unsigned doubleMismatches = 0;
+        for(size_t i = 0; i < reference.size(); i++)
+          doubleMismatches += frame[sampleY[i] * theWidth + sampleX[i]] != reference[i];
+
+        double totalTime = 0.0;
+        for(unsigned pass = 0; pass < aPasses; pass++)
+        {
+          const double start_time = getCurrentTimestamp();
+          mandelbrotCalculateDeepFrame(locations[l].x, locations[l].y, scale, frame);
+          totalTime += getCurrentTimestamp() - start_time;
+        }
+        perturbationStats stats;
+        perturbationGetStats(&stats);
+
+        unsigned mismatches = 0;
+        for(size_t i = 0; i < reference.size(); i++)
+          mismatches += frame[sampleY[i] * theWidth + sampleX[i]] != reference[i];
+
+        printf("%-7s %7.0e %-7s %6u %9.3f %9.3f %6u %6u %6u %9.1f %9.1f\n",
+          locations[l].name, scale, aMethods[m].name, aMaxIterations,
+          totalTime / aPasses * 1e3, stats.orbitTime * 1e3, stats.orbitLength,
+          stats.references, stats.hostPixels,
+          100.0 * mismatches / reference.size(), 100.0 * doubleMismatches / reference.size());
+        fflush(stdout);
+      }
+    }
+  }
+
+  alignedFree(frame);
+}
+
+// Render the set aPasses times with aMethod into aFrames, one frame per
+// location
+static benchmarkResult runSet(
+  const locationSet& aSet,
+  const calculationMethod& aMethod,
+  unsigned aPasses,
+  std::vector<unsigned int*>& aFrames)
+{
+  const double scale = (double)REFERENCE_WIDTH / theWidth;
+
+  // Warm-up frame: the hardware allocates its buffers on the first one
+  aMethod.calculate(aSet.locations[0].x, aSet.locations[0].y,
+    aSet.locations[0].scale * scale, aFrames[0]);
+
+  benchmarkResult result;
+  result.reusedPixels = 0.0;
+  result.computedPixels = 0.0;
+  result.previewFrames = 0;
+  result.floatFrames = 0;
+  result.floatErrorEstimate = 0.0;
+  std::vector<double> latencies;
+  for(unsigned pass = 0; pass < aPasses; pass++)
+  {
+    for(unsigned i = 0; i < aSet.count; i++)
+    {
+      const double start_time = getCurrentTimestamp();
+      aMethod.calculate(aSet.locations[i].x, aSet.locations[i].y,
+        aSet.locations[i].scale * scale, aFrames[i]);
+      latencies.push_back(getCurrentTimestamp() - start_time);
+
+      if(mandelbrotFramePrecision() == PRECISION_FLOAT)
+      {
+        result.floatFrames++;
+        result.floatErrorEstimate = std::max(result.floatErrorEstimate, mandelbrotFloatErrorEstimate(
+          aSet.locations[i].x, aSet.locations[i].y, aSet.locations[i].scale * scale));
+      }
+
+      // Incremental frames do not all run through the frame scheduler
+      if(aMethod.hardware && !aMethod.incremental)
+      {
+        const workerStats* stats;
+        const unsigned workers = hardwareGetWorkerStats(&stats);
+        result.workers.resize(workers);
+        for(unsigned w = 0; w < workers; w++)
+        {
+          result.workers[w].busyTime += stats[w].busyTime;
+          result.workers[w].rowGroups += stats[w].rowGroups;
+        }
+      }
+
+      if(aMethod.incremental)
+      {
+        incrementalStats stats;
+        incrementalGetStats(&stats);
+        result.reusedPixels += stats.reusedPixels;
+        result.computedPixels += stats.computedPixels;
+        result.previewFrames += stats.previewRows > 0;
+      }
+    }
+  }
+
+  result.frames = latencies.size();
+  result.totalTime = 0.0;
+  for(size_t i = 0; i < latencies.size(); i++)
+    result.totalTime += latencies[i];
+  std::sort(latencies.begin(), latencies.end());
+  result.p50 = percentile(latencies, 50);
+  result.p90 = percentile(latencies, 90);
+  result.p99 = percentile(latencies, 99);
+  result.max = latencies.back();
+  return result;
+}
+
+int main(int argc, char **argv)
+{
+  Options options(argc, argv);
+
+  std::string resolutions = "800x640";
+  std::string iterations = "2000";
+  std::string setName = "all";
+  std::string methodName = "all";
+  unsigned passes = 3;
+
+  if(options.has("res"))
+    resolutions = options.get<std::string>("res");
+  if(options.has("iters"))
+    iterations = options.get<std::string>("iters");
+  if(options.has("set"))
+    setName = options.get<std::string>("set");
+  if(options.has("method"))
+    methodName = options.get<std::string>("method");
+  if(options.has("passes"))
+    passes = options.get<unsigned>("passes");
+  if(options.has("group"))
+    theBenchRowGroup = options.get<unsigned>("group");
+  if(options.has("cpu_workers"))
+    theBenchCpuWorkers = options.get<unsigned>("cpu_workers");
+
+  bool badAcceleration = false;
+  if(options.has("accel"))
+  {
+    std::vector<std::string> parts = splitList(options.get<std::string>("accel"));
+    theBenchAcceleration = 0;
+    for(size_t i = 0; i < parts.size(); i++)
+    {
+      if(parts[i] == "bulb")
+        theBenchAcceleration |= ACCEL_BULB;
+      else if(parts[i] == "period")
+        theBenchAcceleration |= ACCEL_PERIOD;
+      else if(parts[i] == "subdivide")
+        theBenchAcceleration |= ACCEL_SUBDIVIDE;
+      else
+        badAcceleration = true;
+    }
+  }
+
+  if(options.has("refine"))
+    incrementalSetRefineParts(options.get<unsigned>("refine"));
+
+  std::vector<double> deepScales;
+  bool badScale = false;
+  if(options.has("deep"))
+  {
+    std::string scales = "1e-12,1e-15,1e-18,1e-21,1e-24,1e-27,1e-30";
+    if(options.has("scales"))
+      scales = options.get<std::string>("scales");
+    std::vector<std::string> scaleList = splitList(scales);
+    for(size_t i = 0; i < scaleList.size(); i++)
+    {
+      deepScales.push_back(atof(scaleList[i].c_str()));
+      badScale = badScale || deepScales.back() <= 0.0;
+    }
+  }
+
+  std::vector<std::string> setList = splitList(setName);
+  bool useTest = false, useDemo = false, usePan = false, useZoom = false;
+  bool badSet = setList.empty();
+  for(size_t i = 0; i < setList.size(); i++)
+  {
+    if(setList[i] == "test" || setList[i] == "all")
+      useTest = true;
+    if(setList[i] == "demo" || setList[i] == "all")
+      useDemo = true;
+    if(setList[i] == "pan" || setList[i] == "paths")
+      usePan = true;
+    if(setList[i] == "zoom" || setList[i] == "paths")
+      useZoom = true;
+    if(setList[i] != "test" && setList[i] != "demo" && setList[i] != "all" &&
+      setList[i] != "pan" && setList[i] != "zoom" && setList[i] != "paths")
+      badSet = true;
+  }
+
+  if(methodName == "all")
+    methodName = "hw,sw";
+  std::vector<std::string> methodList = splitList(methodName);
+  std::vector<calculationMethod> methods;
+  bool useHardware = false;
+  bool badMethod = false;
+  for(size_t m = 0; m < methodList.size(); m++)
+  {
+    calculationMethod method = { "", NULL, false, false };
+    if(methodList[m] == "hw")
+    {
+      method.name = "hw";
+      method.calculate = calculateHardware;
+      method.hardware = true;
+    }
+    else if(methodList[m] == "hw_dyn")
+    {
+      method.name = "hw_dyn";
+      method.calculate = calculateHardwareDynamic;
+      method.hardware = true;
+    }
+    else if(methodList[m] == "sw")
+    {
+      method.name = "sw";
+      method.calculate = calculateSoftware;
+    }
+    else if(methodList[m] == "hw_fast")
+    {
+      method.name = "hw_fast";
+      method.calculate = calculateHardwareFast;
+      method.hardware = true;
+    }
+    else if(methodList[m] == "sw_fast")
+    {
+      method.name = "sw_fast";
+      method.calculate = calculateSoftwareFast;
+    }
+    else if(methodList[m] == "hw_inc")
+    {
+      method.name = "hw_inc";
+      method.calculate = calculateHardwareIncremental;
+      method.hardware = true;
+      method.incremental = true;
+    }
+    else if(methodList[m] == "sw_inc")
+    {
+      method.name = "sw_inc";
+      method.calculate = calculateSoftwareIncremental;
+      method.incremental = true;
+    }
+    else if(methodList[m] == "hw_f32")
+    {
+      method.name = "hw_f32";
+      method.calculate = calculateHardwareFloat;
+      method.hardware = true;
+    }
+    else if(methodList[m] == "sw_f32")
+    {
+      method.name = "sw_f32";
+      method.calculate = calculateSoftwareFloat;
+    }
+    else if(methodList[m] == "hw_auto")
+    {
+      method.name = "hw_auto";
+      method.calculate = calculateHardwareAuto;
+      method.hardware = true;
+    }
+    else if(methodList[m] == "sw_auto")
+    {
+      method.name = "sw_auto";
+      method.calculate = calculateSoftwareAuto;
+    }
+    else if(methodList[m] == "scalar")
+    {
+      method.name = "scalar";
+      method.calculate = softwareCalculateFrameScalar;
+    }
+    else
+      badMethod = true;
+    useHardware = useHardware || method.hardware;
+    methods.push_back(method);
+  }
+
+  if(badSet || badScale || methods.empty() || badMethod || badAcceleration || passes == 0 || theBenchRowGroup == 0)
+  {
+    printf("Usage: %s [-res=WxH,...] [-iters=n,...] [-set=test,demo,pan,zoom|all|paths] "
+      "[-method=hw,sw,hw_fast,sw_fast,hw_dyn,hw_inc,sw_inc,hw_f32,sw_f32,hw_auto,sw_auto,scalar|all] [-accel=bulb,period,subdivide] "
+      "[-group=n] [-cpu_workers=n] [-refine=n] [-passes=n] [-deep [-scales=s,...]]\n", argv[0]);
+    return 1;
+  }
+
+  // Only the hardware prints per frame
+  printFrameTimes = false;
+
+  if(useHardware && hardwareInitialize() != 0)
+  {
+    printf("No hardware available, benchmarking the software only.\n");
+    useHardware = false;
+    for(size_t m = 0; m < methods.size(); )
+    {
+      if(methods[m].hardware)
+        methods.erase(methods.begin() + m);
+      else
+        m++;
+    }
+    if(methods.empty())
+      return 1;
+  }
+  softwareInitialize();
+
+  std::vector<std::string> resList = splitList(resolutions);
+  std::vector<std::string> iterList = splitList(iterations);
+
+  if(!deepScales.empty())
+  {
+    // Only the plain hardware and software methods: the frames are the
+    // perturbation frames of either
+    for(size_t m = 0; m < methods.size(); )
+    {
+      if(methods[m].calculate == calculateHardware || methods[m].calculate == calculateSoftware)
+        m++;
+      else
+        methods.erase(methods.begin() + m);
+    }
+
+    printf("\n%-7s %7s %-7s %6s %9s %9s %6s %6s %6s %9s %9s\n",
+      "centre", "scale", "method", "iters", "frame ms", "orbit ms", "orbit",
+      "refs", "host", "mism. %", "double %");
+
+    for(size_t r = 0; r < resList.size(); r++)
+    {
+      if(sscanf(resList[r].c_str(), "%ux%u", &theWidth, &theHeight) != 2 || theWidth == 0 || theHeight == 0)
+        continue;
+      for(size_t it = 0; it < iterList.size(); it++)
+      {
+        const unsigned maxIterations = atoi(iterList[it].c_str());
+        if(maxIterations == 0)
+          continue;
+        printf("%ux%u\n", theWidth, theHeight);
+        setColorTable(maxIterations, useHardware);
+        runDeep(deepScales, methods, passes, maxIterations);
+      }
+    }
+
+    if(useHardware)
+      hardwareRelease();
+    softwareRelease();
+    perturbationRelease();
+    return 0;
+  }
+
+  printf("\n%-5s %-7s %11s %6s %7s %9s %9s %9s %9s %9s %9s %7s\n",
+    "set", "method", "resolution", "iters", "frames", "FPS", "Mpixel/s",
+    "p50 ms", "p90 ms", "p99 ms", "max ms", "diff %");
+
+  for(size_t r = 0; r < resList.size(); r++)
+  {
+    unsigned width = 0, height = 0;
+    if(sscanf(resList[r].c_str(), "%ux%u", &width, &height) != 2 || width == 0 || height == 0)
+    {
+      printf("Bad resolution '%s'\n", resList[r].c_str());
+      continue;
+    }
+    theWidth = width;
+    theHeight = height;
+
+    // The paths move by whole pixels of this resolution
+    const std::vector<coordinates> panPath = makePanPath(theTestLocations[0]);
+    const std::vector<coordinates> zoomPath = makeZoomPath(theTestLocations[0]);
+
+    std::vector<locationSet> sets;
+    if(useTest)
+    {
+      locationSet set = { "test", theTestLocations, NUM_TEST_LOCATIONS };
+      sets.push_back(set);
+    }
+    if(useDemo)
+    {
+      locationSet set = { "demo", theDemoLocations, NUMBER_OF_COORDINATES };
+      sets.push_back(set);
+    }
+    if(usePan)
+    {
+      locationSet set = { "pan", &panPath[0], (unsigned)panPath.size() };
+      sets.push_back(set);
+    }
+    if(useZoom)
+    {
+      locationSet set = { "zoom", &zoomPath[0], (unsigned)zoomPath.size() };
+      sets.push_back(set);
+    }
+
+    for(size_t it = 0; it < iterList.size(); it++)
+    {
+      const unsigned maxIterations = atoi(iterList[it].c_str());
+      if(maxIterations == 0)
+      {
+        printf("Bad iteration limit '%s'\n", iterList[it].c_str());
+        continue;
+      }
+      setColorTable(maxIterations, useHardware);
+
+      for(size_t s = 0; s < sets.size(); s++)
+      {
+        // Frames of every location for every method
+        std::vector<std::vector<unsigned int*> > frames(methods.size());
+
+        for(size_t m = 0; m < methods.size(); m++)
+        {
+          for(unsigned i = 0; i < sets[s].count; i++)
+            frames[m].push_back((unsigned int*)alignedMalloc(theWidth * theHeight * sizeof(unsigned int)));
+          benchmarkResult result = runSet(sets[s], methods[m], passes, frames[m]);
+
+          // Worst location against the first method
+          char diff[32] = "-";
+          if(m > 0)
+          {
+            double worst = 0.0;
+            for(unsigned i = 0; i < sets[s].count; i++)
+              worst = std::max(worst, frameDifference(frames[m][i], frames[0][i], theWidth * theHeight));
+            sprintf(diff, "%.3f", worst * 100.0);
+          }
+
+          char resolution[32];
+          sprintf(resolution, "%ux%u", theWidth, theHeight);
+
+          printf("%-5s %-7s %11s %6u %7u %9.2f %9.2f %9.3f %9.3f %9.3f %9.3f %7s\n",
+            sets[s].name, methods[m].name, resolution, maxIterations,
+            result.frames, result.frames / result.totalTime,
+            (double)theWidth * theHeight * result.frames / result.totalTime * 1e-6,
+            result.p50 * 1e3, result.p90 * 1e3, result.p99 * 1e3, result.max * 1e3, diff);
+
+          // Utilisation of every device and CPU worker
+          const size_t devices = result.workers.size() -
+            (methods[m].calculate == calculateHardwareDynamic ? theBenchCpuWorkers : 0);
+          for(size_t w = 0; w < result.workers.size(); w++)
+          {
+            printf("%13s %s %u: busy %5.1f%%, %.1f row groups per frame\n", "",
+              w < devices ? "device" : "cpu worker", (unsigned)(w < devices ? w : w - devices),
+              100.0 * result.workers[w].busyTime / result.totalTime,
+              (double)result.workers[w].rowGroups / result.frames);
+          }
+
+          // Reuse of the incremental frames
+          if(methods[m].incremental)
+          {
+            const double pixels = (double)theWidth * theHeight * result.frames;
+            printf("%13s reused %5.1f%%, computed %5.1f%% of the pixels, %u preview frames\n", "",
+              100.0 * result.reusedPixels / pixels, 100.0 * result.computedPixels / pixels,
+              result.previewFrames);
+          }
+
+          // Single precision frames
+          if(result.floatFrames > 0)
+          {
+            printf("%13s FP32 in %u of %u frames, error estimate up to %.3f pixels\n", "",
+              result.floatFrames, result.frames, result.floatErrorEstimate);
+          }
+          fflush(stdout);
+        }
+
+        for(size_t m = 0; m < frames.size(); m++)
+          for(size_t i = 0; i < frames[m].size(); i++)
+            alignedFree(frames[m][i]);
+      }
+    }
+  }
+
+  if(useHardware)
+    hardwareRelease();
+  softwareRelease();
+  incrementalRelease();
+  perturbationRelease();
+
+  return 0;
+}
@@ -7,6 +7,8 @@
 
 #include "HardwareMandelbrot.h"
 #include "SoftwareMandelbrot.h"
+#include "IncrementalMandelbrot.h"
+#include "PerturbationMandelbrot.h"
 
 // Define labels for using software or hardware to calculate the frame
 #define HARDWARE 0
@@ -23,6 +25,35 @@ int mandelbrotSetColorTable(
 // Swap between using hardware and software to calculate
 int mandelbrotSwitchCalculationMethod();
 
+// Set the accelerated frame mode (ACCEL_* flags, 0 for brute force)
+int mandelbrotSetAcceleration(unsigned int aFlags);
+
+// Swap between brute force and all accelerations
+int mandelbrotSwitchAcceleration();
+
+// Switch incremental frames (reuse of the last frame) on or off
+int mandelbrotSetIncremental(bool aIncremental);
+
+// Swap between full and incremental frames
+int mandelbrotSwitchIncremental();
+
+// Set the precision mode (PRECISION_AUTO, PRECISION_FLOAT or
+// PRECISION_DOUBLE)
+int mandelbrotSetPrecision(unsigned int aPrecision);
+
+// Swap between the automatic precision and double precision only
+int mandelbrotSwitchPrecision();
+
+// Estimate of the FP32 rounding error of a frame, in pixels; the automatic
+// precision takes FP32 up to FLOAT_MAX_ERROR
+double mandelbrotFloatErrorEstimate(
+  double aStartX,
+  double aStartY,
+  double aScale);
+
+// Precision the last frame was calculated in
+unsigned int mandelbrotFramePrecision();
+
 // Calculate a frame
 int mandelbrotCalculateFrame(
   double aStartX,
@@ -30,6 +61,32 @@ int mandelbrotCalculateFrame(
   double aScale,
   unsigned int* aFrameBuffer);
 
+// Calculate a frame around (aCentreX, aCentreY) by perturbation, for deep
+// zooms; mandelbrotCalculateFrame switches to it by itself
+int mandelbrotCalculateDeepFrame(
+  double aCentreX,
+  double aCentreY,
+  double aScale,
+  unsigned int* aFrameBuffer);
+
+// Calculate a whole frame, never reusing the last one
+int mandelbrotCalculateFullFrame(
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int* aFrameBuffer);
+
+// Calculate the aWidth x aHeight rectangle at pixel (aX, aY) of a frame
+int mandelbrotCalculateRect(
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int aX,
+  unsigned int aY,
+  unsigned int aWidth,
+  unsigned int aHeight,
+  unsigned int* aFrameBuffer);
+
 // Release the Mandelbrot resources
 int mandelbrotRelease();
 
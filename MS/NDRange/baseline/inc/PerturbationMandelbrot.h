@@ -0,0 +1,43 @@
+#ifndef PERTURBATION_MANDELBROT_H
+#define PERTURBATION_MANDELBROT_H
+
+#include "AOCLUtils/aocl_utils.h"
+#include "Perturbation.h"
+
+// Deep zoom frames by perturbation: a reference orbit is iterated in high
+// precision on the host, and every pixel iterates only its difference to it
+// in double precision, on the hardware or the software. Frames are given
+// by their centre, since at deep zooms the top left corner of a frame is
+// not representable apart from it.
+
+// Work of the last perturbation frame
+struct perturbationStats {
+  unsigned int references;    // reference orbits used
+  unsigned int orbitLength;   // points of the first reference orbit
+  unsigned int hostPixels;    // glitched pixels left to the host
+  double orbitTime;           // seconds computing the reference orbits
+};
+
+int perturbationSetColorTable(
+  unsigned int* aColorTable,
+  unsigned int aColorTableSize);
+
+int perturbationCalculateFrame(
+  double aCentreX,
+  double aCentreY,
+  double aScale,
+  unsigned int* aFrameBuffer);
+
+// Color of pixel (aX, aY) of a frame, iterated directly in high precision
+unsigned int perturbationReferencePixel(
+  double aCentreX,
+  double aCentreY,
+  double aScale,
+  unsigned int aX,
+  unsigned int aY);
+
+void perturbationGetStats(perturbationStats* aStats);
+
+int perturbationRelease();
+
+#endif
@@ -28,6 +28,9 @@
 #include <cstdlib>
 #include <stdint.h>
 #include "AOCLUtils/aocl_utils.h"
+#include "Acceleration.h"
+#include "Perturbation.h"
+#include "Precision.h"
 
 // Software Mandelbrot
 int softwareInitialize();
@@ -40,6 +43,55 @@ int softwareCalculateFrame(double aStartX,
   double aScale,
   unsigned int* aFrameBuffer);
 
+// Rows aFirstRow to aFirstRow + aRows - 1 on the calling thread
+int softwareCalculateRows(double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int aFirstRow,
+  unsigned int aRows,
+  unsigned int* aFrameBuffer);
+
+// The aWidth x aHeight rectangle at pixel (aX, aY) of a frame
+int softwareCalculateRect(double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int aX,
+  unsigned int aY,
+  unsigned int aWidth,
+  unsigned int aHeight,
+  unsigned int* aFrameBuffer);
+
+// The FLOAT_REDO_PIXELs of a rectangle, in double precision; pixel (aX, aY)
+// is at (aStartX, aStartY)
+int softwareCalculateRedo(double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int aX,
+  unsigned int aY,
+  unsigned int aWidth,
+  unsigned int aHeight,
+  unsigned int* aFrameBuffer);
+
+// A frame by perturbation against a reference orbit
+int softwareCalculatePerturbed(const double* aOrbitX,
+  const double* aOrbitY,
+  unsigned int aOrbitLength,
+  double aDeltaX0,
+  double aDeltaY0,
+  double aScale,
+  bool aOnlyGlitched,
+  unsigned int* aFrameBuffer);
+
+int softwareSetAcceleration(unsigned int aFlags);
+
+int softwareSetPrecision(unsigned int aPrecision);
+
+// Single-threaded scalar reference
+int softwareCalculateFrameScalar(double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int* aFrameBuffer);
+
 int softwareRelease();
 
 #endif
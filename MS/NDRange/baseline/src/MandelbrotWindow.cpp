@@ -2,6 +2,7 @@
 #include "MandelbrotWindow.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
 
 using namespace aocl_utils;
 
@@ -172,10 +173,19 @@ int mandelbrotWindowUpdate()
     scaledYDistance < -5.0 ||
     scaleScale < 0.1))
   {
-    // Move half the distance
-    theCurrentX += xDistance*0.2;
-    theCurrentY += yDistance*0.2;
-    theCurrentScale += scaleDistance*0.2;
+    // Move a fifth of the distance. A pan moves by whole pixels, so that
+    // incremental frames can reuse the last one
+    if(scaleDistance == 0.0)
+    {
+      theCurrentX += floor(scaledXDistance*0.2 + 0.5)*theCurrentScale;
+      theCurrentY += floor(scaledYDistance*0.2 + 0.5)*theCurrentScale;
+    }
+    else
+    {
+      theCurrentX += xDistance*0.2;
+      theCurrentY += yDistance*0.2;
+      theCurrentScale += scaleDistance*0.2;
+    }
   }
   else
   {
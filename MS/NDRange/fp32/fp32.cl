@@ -0,0 +1,190 @@
+// Amount of loop unrolling. Higher unrolling amounts lead to higher
+// performance but also greater resource usage.
+#ifndef UNROLL
+#define UNROLL 20
+#endif
+
+// Define the color black as 0
+#define BLACK 0x00000000
+
+// Accelerated frame mode flags, as in Acceleration.h
+#define ACCEL_BULB   1
+#define ACCEL_PERIOD 2
+
+// Pixels per work-item of the single precision kernel, its rounding bound
+// per iteration and its marker of the pixels left for double precision, as
+// in Precision.h
+#define FLOAT_LANES      8
+#define FLOAT_ROUNDING   (1.0f / 1048576)
+#define FLOAT_REDO_PIXEL 0xFFFFFFFF
+
+////////////////////////////////////////////////////////////////////
+// Hardware implementation of the mandelbrot algorithm
+////////////////////////////////////////////////////////////////////
+
+
+// Mandelbrot set: zn+1 = zn^2 + c;
+
+__kernel 
+void hw_mandelbrot_frame (
+							const double x0,
+							const double y0,
+							const double stepSize,
+							const unsigned int maxIterations,
+							__global unsigned int *restrict framebuffer,
+							__constant const unsigned int *restrict colorLUT,
+							const unsigned int windowWidth)
+{
+	// Work-item position
+	const size_t windowPosX = get_global_id(0);
+	const size_t windowPosY = get_global_id(1);
+	
+	const double stepPosX = x0 + (windowPosX * stepSize);
+	const double stepPosY = y0 - (windowPosY * stepSize);
+
+	// Variables for the calculation
+	double x = 0.0;
+	double y = 0.0;
+	double xSqr = 0.0;
+	double ySqr = 0.0;
+	unsigned int iterations = 0;
+
+	// Perform up to the maximum number of iterations to solve
+	// the current work-item's position in the image
+  //
+  // The loop unrolling factor can be adjusted based on the amount of FPGA
+  // resources available.
+
+	while (	xSqr + ySqr < 4.0 &&
+			iterations < maxIterations)
+	{
+		// Perform the current iteration
+		xSqr = x*x;
+		ySqr = y*y;
+
+		y = 2*x*y + stepPosY;
+		x = xSqr - ySqr + stepPosX;
+
+		// Increment iteration count
+		iterations++;
+	}
+
+	// Output black if we never finished, and a color from the look up table otherwise
+	framebuffer[windowWidth * windowPosY + windowPosX] = (iterations == maxIterations)? BLACK : colorLUT[iterations];
+}
+
+
+// Single precision version of hw_mandelbrot_frame, for the frames whose
+// pixel step is far above the FP32 rounding error. Every work-item computes
+// FLOAT_LANES adjacent pixels of a row in unrolled lanes that iterate in
+// lockstep until all have escaped, so a row takes windowWidth / FLOAT_LANES
+// work-items, rounded up; the lanes past the end of the row are not stored.
+//
+// Every lane bounds the distance of its orbit from the exact one: the
+// bound starts at the rounding of the pixel position, and grows by
+// (2|z| + bound) times itself and the FLOAT_ROUNDING of every iteration.
+// Once the bound reaches |z|^2 - 4 the escape test may differ from the
+// exact one, and the pixel is stored as FLOAT_REDO_PIXEL for the host to
+// calculate in double precision.
+
+__kernel 
+void hw_mandelbrot_frame_float (
+							const float x0,
+							const float y0,
+							const float stepSize,
+							const unsigned int maxIterations,
+							__global unsigned int *restrict framebuffer,
+							__constant const unsigned int *restrict colorLUT,
+							const unsigned int windowWidth,
+							const unsigned int acceleration)
+{
+	// Work-item position: the first of its pixels
+	const size_t windowPosX = get_global_id(0) * FLOAT_LANES;
+	const size_t windowPosY = get_global_id(1);
+
+	const float stepPosY = y0 - (windowPosY * stepSize);
+
+	// Variables for the calculation, one per lane
+	float stepPosX[FLOAT_LANES];
+	float x[FLOAT_LANES];
+	float y[FLOAT_LANES];
+	float xSqr[FLOAT_LANES];
+	float ySqr[FLOAT_LANES];
+	float xOld[FLOAT_LANES];
+	float yOld[FLOAT_LANES];
+	float error[FLOAT_LANES];
+	float cRounding[FLOAT_LANES];
+	bool redo[FLOAT_LANES];
+	unsigned int iterations[FLOAT_LANES];
+
+	#pragma unroll
+	for (int l = 0; l < FLOAT_LANES; l++)
+	{
+		stepPosX[l] = x0 + ((windowPosX + l) * stepSize);
+		x[l] = y[l] = xSqr[l] = ySqr[l] = xOld[l] = yOld[l] = 0.0f;
+		error[l] = FLOAT_ROUNDING * (fabs(x0) + fabs(y0) + (windowPosX + l + windowPosY) * stepSize);
+		cRounding[l] = FLOAT_ROUNDING * (fabs(stepPosX[l]) + fabs(stepPosY));
+		redo[l] = false;
+		iterations[l] = 0;
+
+		// Points of the main cardioid and the period-2 bulb never escape
+		if (acceleration & ACCEL_BULB)
+		{
+			const float xq = stepPosX[l] - 0.25f;
+			const float q = xq*xq + stepPosY*stepPosY;
+			const float xp = stepPosX[l] + 1.0f;
+			if (q * (q + xq) <= 0.25f * stepPosY*stepPosY ||
+				xp*xp + stepPosY*stepPosY <= 0.0625f)
+				iterations[l] = maxIterations;
+		}
+	}
+
+	// Every lane runs the iteration of hw_mandelbrot_frame and stops once
+	// it escapes, reaches the limit or is left for double precision
+	bool running = true;
+	while (running)
+	{
+		running = false;
+
+		#pragma unroll
+		for (int l = 0; l < FLOAT_LANES; l++)
+		{
+			if (!redo[l] && xSqr[l] + ySqr[l] < 4.0f && iterations[l] < maxIterations)
+			{
+				xSqr[l] = x[l]*x[l];
+				ySqr[l] = y[l]*y[l];
+
+				const float r2 = xSqr[l] + ySqr[l];
+				error[l] = error[l] * (2 * sqrt(r2) + error[l]) + FLOAT_ROUNDING * r2 + cRounding[l];
+				if (fabs(r2 - 4.0f) <= error[l])
+					redo[l] = true;
+
+				y[l] = 2*x[l]*y[l] + stepPosY;
+				x[l] = xSqr[l] - ySqr[l] + stepPosX[l];
+
+				iterations[l]++;
+
+				if (acceleration & ACCEL_PERIOD)
+				{
+					if (x[l] == xOld[l] && y[l] == yOld[l])
+						iterations[l] = maxIterations;
+					if ((iterations[l] & (iterations[l] - 1)) == 0)
+					{
+						xOld[l] = x[l];
+						yOld[l] = y[l];
+					}
+				}
+
+				running = true;
+			}
+		}
+	}
+
+	#pragma unroll
+	for (int l = 0; l < FLOAT_LANES; l++)
+	{
+		if (windowPosX + l < windowWidth)
+			framebuffer[windowWidth * windowPosY + windowPosX + l] = redo[l] ? FLOAT_REDO_PIXEL :
+				(iterations[l] == maxIterations)? BLACK : colorLUT[iterations[l]];
+	}
+}
@@ -0,0 +1,259 @@
+#include "Mandelbrot.h"
+
+#include <math.h>
+
+extern unsigned int theWidth;
+extern unsigned int theHeight;
+
+// Hardware or software
+int theCalculationMethod = HARDWARE;
+
+// Accelerated frame mode flags
+unsigned int theAcceleration = 0;
+
+// Incremental frames, and the calculation method of the last one
+bool theIncrementalFrames = false;
+static int theIncrementalMethod = HARDWARE;
+
+// Precision mode, the precision of the last frame and the iteration limit
+// (the color table size)
+unsigned int thePrecision = PRECISION_AUTO;
+static unsigned int theFramePrecision = PRECISION_DOUBLE;
+unsigned int theMaxIterations = 0;
+
+// Initialize the Mandelbrot functions
+int mandelbrotInitialize()
+{
+  // Initialize the hardware and software frame calculators
+  hardwareInitialize();
+  softwareInitialize();
+
+  // Return success
+  return 0;
+}
+
+// Set the color table
+int mandelbrotSetColorTable(
+  unsigned int* aColorTable,
+  unsigned int aColorTableSize)
+
+{
+  // Set hardware and software color tables
+  hardwareSetColorTable(aColorTable, aColorTableSize);
+  softwareSetColorTable(aColorTable, aColorTableSize);
+  perturbationSetColorTable(aColorTable, aColorTableSize);
+  incrementalReset();
+  theMaxIterations = aColorTableSize;
+
+  // Return success
+  return 0;
+}
+
+// Swap States
+int mandelbrotSwitchCalculationMethod()
+{
+  // XOR
+  theCalculationMethod ^= 1;
+
+  // Return success
+  return 0;
+}
+
+// Set the accelerated frame mode
+int mandelbrotSetAcceleration(unsigned int aFlags)
+{
+  if(aFlags != theAcceleration)
+    incrementalReset();
+
+  theAcceleration = aFlags;
+  hardwareSetAcceleration(aFlags);
+  softwareSetAcceleration(aFlags);
+
+  // Return success
+  return 0;
+}
+
+// Swap between brute force and all accelerations
+int mandelbrotSwitchAcceleration()
+{
+  return mandelbrotSetAcceleration(theAcceleration ? 0 : ACCEL_ALL);
+}
+
+// Switch incremental frames on or off
+int mandelbrotSetIncremental(bool aIncremental)
+{
+  if(aIncremental && !theIncrementalFrames)
+    incrementalReset();
+
+  theIncrementalFrames = aIncremental;
+
+  // Return success
+  return 0;
+}
+
+// Swap between full and incremental frames
+int mandelbrotSwitchIncremental()
+{
+  return mandelbrotSetIncremental(!theIncrementalFrames);
+}
+
+// Set the precision mode
+int mandelbrotSetPrecision(unsigned int aPrecision)
+{
+  if(aPrecision != thePrecision)
+    incrementalReset();
+
+  thePrecision = aPrecision;
+
+  // Return success
+  return 0;
+}
+
+// Swap between the automatic precision and double precision only
+int mandelbrotSwitchPrecision()
+{
+  return mandelbrotSetPrecision(thePrecision == PRECISION_AUTO ? PRECISION_DOUBLE : PRECISION_AUTO);
+}
+
+// Estimate, in pixels, of the FP32 rounding error of a frame. The pixel
+// positions are rounded to 2^-24 of the largest coordinate, and until the
+// escape every iteration adds about 2^-24 of |z|^2 + |c| < 8 to the orbit.
+// FP32 frames match the double precision frames whatever the estimate, as
+// the pixels whose own error bound grows too large are redone in double;
+// the estimate keeps the automatic precision to the frames with few of them.
+double mandelbrotFloatErrorEstimate(
+  double aStartX,
+  double aStartY,
+  double aScale)
+{
+  const double endX = aStartX + theWidth * aScale;
+  const double endY = aStartY - theHeight * aScale;
+  const double extent = fmax(fmax(fabs(aStartX), fabs(endX)), fmax(fabs(aStartY), fabs(endY)));
+  return (extent + 8.0 * theMaxIterations) * ldexp(1.0, -24) / aScale;
+}
+
+// Precision of the last frame
+unsigned int mandelbrotFramePrecision()
+{
+  return theFramePrecision;
+}
+
+// Precision of a frame in the current mode
+static unsigned int framePrecision(
+  double aStartX,
+  double aStartY,
+  double aScale)
+{
+  unsigned int precision = thePrecision;
+  if(precision == PRECISION_AUTO)
+    precision = mandelbrotFloatErrorEstimate(aStartX, aStartY, aScale) <= FLOAT_MAX_ERROR ?
+      PRECISION_FLOAT : PRECISION_DOUBLE;
+
+  // The hardware frames stay in double precision without the FP32 kernel
+  if(theCalculationMethod == HARDWARE && !hardwareHasPrecision(precision))
+    precision = PRECISION_DOUBLE;
+
+  return precision;
+}
+
+// Calculate the next frames in aPrecision; the hardware is only set up
+// for its own frames, as it may not have been initialized
+static void setFramePrecision(unsigned int aPrecision)
+{
+  theFramePrecision = aPrecision;
+  if(theCalculationMethod == HARDWARE)
+    hardwareSetPrecision(aPrecision);
+  softwareSetPrecision(aPrecision);
+}
+
+// Calculate a frame
+int mandelbrotCalculateFrame(
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int* aFramebuffer)
+{
+  // Below 2^16 ulps of the coordinates per pixel, double precision
+  // iteration breaks down and the frame is rendered by perturbation
+  const double extent = fabs(aStartX) > fabs(aStartY) ? fabs(aStartX) : fabs(aStartY);
+  if(aScale < ldexp(extent, -36))
+  {
+    setFramePrecision(PRECISION_DOUBLE);
+    return mandelbrotCalculateDeepFrame(aStartX + (theWidth / 2) * aScale,
+      aStartY - (theHeight / 2) * aScale, aScale, aFramebuffer);
+  }
+
+  if(theIncrementalFrames)
+  {
+    // The last frame is only reused with the method and the precision
+    // that calculated it
+    if(theCalculationMethod != theIncrementalMethod ||
+      framePrecision(aStartX, aStartY, aScale) != theFramePrecision)
+      incrementalReset();
+    theIncrementalMethod = theCalculationMethod;
+
+    return incrementalCalculateFrame(aStartX, aStartY, aScale, aFramebuffer);
+  }
+
+  return mandelbrotCalculateFullFrame(aStartX, aStartY, aScale, aFramebuffer);
+}
+
+// Calculate a whole frame without reuse
+int mandelbrotCalculateFullFrame(
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int* aFramebuffer)
+{
+  setFramePrecision(framePrecision(aStartX, aStartY, aScale));
+
+  // Use either hardware or software to do the frame calculation
+  if(theCalculationMethod == HARDWARE)
+    return hardwareCalculateFrame(aStartX, aStartY, aScale, aFramebuffer);
+
+  else
+    return softwareCalculateFrame(aStartX, aStartY, aScale, aFramebuffer);
+}
+
+// Calculate a frame around (aCentreX, aCentreY) by perturbation
+int mandelbrotCalculateDeepFrame(
+  double aCentreX,
+  double aCentreY,
+  double aScale,
+  unsigned int* aFramebuffer)
+{
+  return perturbationCalculateFrame(aCentreX, aCentreY, aScale, aFramebuffer);
+}
+
+// Calculate a rectangle of a frame
+int mandelbrotCalculateRect(
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int aX,
+  unsigned int aY,
+  unsigned int aWidth,
+  unsigned int aHeight,
+  unsigned int* aFramebuffer)
+{
+  setFramePrecision(framePrecision(aStartX, aStartY, aScale));
+
+  if(theCalculationMethod == HARDWARE)
+    return hardwareCalculateRect(aStartX, aStartY, aScale, aX, aY, aWidth, aHeight, aFramebuffer);
+
+  else
+    return softwareCalculateRect(aStartX, aStartY, aScale, aX, aY, aWidth, aHeight, aFramebuffer);
+}
+
+// Release the Mandelbrot resources
+int mandelbrotRelease()
+{
+  hardwareRelease();
+  softwareRelease();
+  incrementalRelease();
+  perturbationRelease();
+
+  // Return success
+  return 0;
+}
+
@@ -0,0 +1,330 @@
+#include "PerturbationMandelbrot.h"
+#include "Mandelbrot.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+using namespace aocl_utils;
+
+extern unsigned int theWidth;
+extern unsigned int theHeight;
+extern int theCalculationMethod;
+
+// Reference orbits per frame; the pixels still glitched after the last one
+// are iterated directly on the host
+#define MAX_REFERENCES 32
+
+// High-precision fixed-point numbers: up to HP_MAX_LIMBS 32-bit limbs,
+// least significant first, of which theLimbs are used. The top limb is the
+// integer part, enough for the orbit values up to the escape.
+#define HP_MAX_LIMBS 8
+
+struct hpNumber {
+  bool negative;
+  uint32_t limb[HP_MAX_LIMBS];
+};
+
+static unsigned int theLimbs = HP_MAX_LIMBS;
+
+// Color table, for the pixels iterated on the host
+static unsigned int* thePertColorTable = 0;
+static unsigned int thePertColorTableSize = 0;
+
+// Reference orbit, rounded to double
+static std::vector<double> theOrbitX;
+static std::vector<double> theOrbitY;
+static unsigned int theOrbitLength = 0;
+
+static perturbationStats thePertStats;
+
+// Limbs for the frame: 64 bits below the pixel step
+static void hpSetPrecision(double aScale)
+{
+  const int fractionBits = (int)ceil(-log2(aScale)) + 64;
+  theLimbs = 1 + (fractionBits + 31) / 32;
+  if(theLimbs < 3)
+    theLimbs = 3;
+  if(theLimbs > HP_MAX_LIMBS)
+    theLimbs = HP_MAX_LIMBS;
+}
+
+// Exact up to the precision: each step takes the integer part off
+static hpNumber hpFromDouble(double aValue)
+{
+  hpNumber r;
+  r.negative = aValue < 0.0;
+  double a = fabs(aValue);
+  for(int i = theLimbs - 1; i >= 0; i--)
+  {
+    const double whole = floor(a);
+    r.limb[i] = (uint32_t)whole;
+    a = (a - whole) * 4294967296.0;
+  }
+  return r;
+}
+
+static double hpToDouble(const hpNumber& a)
+{
+  double r = 0.0;
+  for(unsigned int i = 0; i + 1 < theLimbs; i++)
+    r = (r + a.limb[i]) * (1.0 / 4294967296.0);
+  r += a.limb[theLimbs - 1];
+  return a.negative ? -r : r;
+}
+
+static int hpCompareMagnitude(const hpNumber& a, const hpNumber& b)
+{
+  for(int i = theLimbs - 1; i >= 0; i--)
+    if(a.limb[i] != b.limb[i])
+      return a.limb[i] > b.limb[i] ? 1 : -1;
+  return 0;
+}
+
+static hpNumber hpAdd(const hpNumber& a, const hpNumber& b)
+{
+  hpNumber r;
+  if(a.negative == b.negative)
+  {
+    uint64_t carry = 0;
+    for(unsigned int i = 0; i < theLimbs; i++)
+    {
+      const uint64_t t = (uint64_t)a.limb[i] + b.limb[i] + carry;
+      r.limb[i] = (uint32_t)t;
+      carry = t >> 32;
+    }
+    r.negative = a.negative;
+    return r;
+  }
+
+  // Different signs: the smaller magnitude off the larger one
+  const bool aLarger = hpCompareMagnitude(a, b) >= 0;
+  const hpNumber& large = aLarger ? a : b;
+  const hpNumber& small = aLarger ? b : a;
+  int64_t borrow = 0;
+  for(unsigned int i = 0; i < theLimbs; i++)
+  {
+    int64_t t = (int64_t)large.limb[i] - small.limb[i] - borrow;
+    borrow = t < 0;
+    if(borrow)
+      t += (int64_t)1 << 32;
+    r.limb[i] = (uint32_t)t;
+  }
+  r.negative = large.negative;
+  return r;
+}
+
+static hpNumber hpSub(const hpNumber& a, hpNumber b)
+{
+  b.negative = !b.negative;
+  return hpAdd(a, b);
+}
+
+// Product truncated to the precision
+static hpNumber hpMul(const hpNumber& a, const hpNumber& b)
+{
+  uint32_t full[2 * HP_MAX_LIMBS];
+  memset(full, 0, sizeof(full));
+
+  for(unsigned int i = 0; i < theLimbs; i++)
+  {
+    uint64_t carry = 0;
+    for(unsigned int j = 0; j < theLimbs; j++)
+    {
+      const uint64_t t = (uint64_t)a.limb[i] * b.limb[j] + full[i + j] + carry;
+      full[i + j] = (uint32_t)t;
+      carry = t >> 32;
+    }
+    full[i + theLimbs] = (uint32_t)carry;
+  }
+
+  hpNumber r;
+  for(unsigned int k = 0; k < theLimbs; k++)
+    r.limb[k] = full[k + theLimbs - 1];
+  r.negative = a.negative != b.negative;
+  return r;
+}
+
+// Offset of pixel (aX, aY) from the frame centre
+static double pixelOffsetX(unsigned int aX, double aScale)
+{
+  return ((double)aX - (double)(theWidth / 2)) * aScale;
+}
+
+static double pixelOffsetY(unsigned int aY, double aScale)
+{
+  return ((double)(theHeight / 2) - (double)aY) * aScale;
+}
+
+// Iterate the reference orbit of (aCx, aCy) up to its escape or the
+// iteration limit
+static void perturbationOrbit(const hpNumber& aCx, const hpNumber& aCy)
+{
+  const unsigned int maxIterations = thePertColorTableSize;
+  theOrbitX.resize(maxIterations);
+  theOrbitY.resize(maxIterations);
+
+  hpNumber x = hpFromDouble(0.0);
+  hpNumber y = hpFromDouble(0.0);
+  unsigned int n = 0;
+  while(n < maxIterations)
+  {
+    const double orbitX = hpToDouble(x);
+    const double orbitY = hpToDouble(y);
+    theOrbitX[n] = orbitX;
+    theOrbitY[n] = orbitY;
+    n++;
+    if(orbitX*orbitX + orbitY*orbitY >= 4.0)
+      break;
+
+    const hpNumber xSqr = hpMul(x, x);
+    const hpNumber ySqr = hpMul(y, y);
+    const hpNumber xy = hpMul(x, y);
+    y = hpAdd(hpAdd(xy, xy), aCy);
+    x = hpAdd(hpSub(xSqr, ySqr), aCx);
+  }
+  theOrbitLength = n;
+}
+
+int perturbationSetColorTable(
+  unsigned int* aColorTable,
+  unsigned int aColorTableSize)
+{
+  if(thePertColorTableSize != aColorTableSize)
+  {
+    thePertColorTableSize = aColorTableSize;
+    if(thePertColorTable) alignedFree(thePertColorTable);
+    thePertColorTable = (unsigned int*)alignedMalloc(aColorTableSize * sizeof(unsigned int));
+  }
+  memcpy(thePertColorTable, aColorTable, aColorTableSize * sizeof(unsigned int));
+
+  // Return success
+  return 0;
+}
+
+// Iterate a pixel directly in high precision, counting as the kernels do
+unsigned int perturbationReferencePixel(
+  double aCentreX,
+  double aCentreY,
+  double aScale,
+  unsigned int aX,
+  unsigned int aY)
+{
+  hpSetPrecision(aScale);
+  const hpNumber cx = hpAdd(hpFromDouble(aCentreX), hpFromDouble(pixelOffsetX(aX, aScale)));
+  const hpNumber cy = hpAdd(hpFromDouble(aCentreY), hpFromDouble(pixelOffsetY(aY, aScale)));
+
+  hpNumber x = hpFromDouble(0.0);
+  hpNumber y = hpFromDouble(0.0);
+  for(unsigned int n = 0; n + 1 < thePertColorTableSize; n++)
+  {
+    const double zx = hpToDouble(x);
+    const double zy = hpToDouble(y);
+    if(zx*zx + zy*zy >= 4.0)
+      return thePertColorTable[n + 1];
+
+    const hpNumber xSqr = hpMul(x, x);
+    const hpNumber ySqr = hpMul(y, y);
+    const hpNumber xy = hpMul(x, y);
+    y = hpAdd(hpAdd(xy, xy), cy);
+    x = hpAdd(hpSub(xSqr, ySqr), cx);
+  }
+  return 0x0;
+}
+
+// Calculate a frame around (aCentreX, aCentreY): a pass against the orbit
+// of the centre, then passes over the glitched pixels against the orbit of
+// the glitched pixel nearest their centroid
+int perturbationCalculateFrame(
+  double aCentreX,
+  double aCentreY,
+  double aScale,
+  unsigned int* aFrameBuffer)
+{
+  hpSetPrecision(aScale);
+  const hpNumber centreX = hpFromDouble(aCentreX);
+  const hpNumber centreY = hpFromDouble(aCentreY);
+  memset(&thePertStats, 0, sizeof(thePertStats));
+
+  unsigned int referenceX = theWidth / 2;
+  unsigned int referenceY = theHeight / 2;
+
+  for(unsigned int r = 0; r < MAX_REFERENCES; r++)
+  {
+    const double start_time = getCurrentTimestamp();
+    perturbationOrbit(hpAdd(centreX, hpFromDouble(pixelOffsetX(referenceX, aScale))),
+      hpAdd(centreY, hpFromDouble(pixelOffsetY(referenceY, aScale))));
+    thePertStats.orbitTime += getCurrentTimestamp() - start_time;
+    if(r == 0)
+      thePertStats.orbitLength = theOrbitLength;
+    thePertStats.references++;
+
+    const double deltaX0 = -(double)referenceX * aScale;
+    const double deltaY0 = (double)referenceY * aScale;
+    // The software takes over if the AOCX has no perturbation kernel
+    if(theCalculationMethod != HARDWARE ||
+      hardwareCalculatePerturbed(&theOrbitX[0], &theOrbitY[0], theOrbitLength,
+        deltaX0, deltaY0, aScale, r > 0, aFrameBuffer) != 0)
+      softwareCalculatePerturbed(&theOrbitX[0], &theOrbitY[0], theOrbitLength,
+        deltaX0, deltaY0, aScale, r > 0, aFrameBuffer);
+
+    // Centroid of the glitched pixels
+    double sumX = 0.0, sumY = 0.0;
+    unsigned int glitched = 0;
+    for(unsigned int j = 0; j < theHeight; j++)
+      for(unsigned int k = 0; k < theWidth; k++)
+        if(aFrameBuffer[j * theWidth + k] == GLITCH_PIXEL)
+        {
+          sumX += k;
+          sumY += j;
+          glitched++;
+        }
+    if(glitched == 0)
+      break;
+
+    // The next reference is the glitched pixel nearest it, which the new
+    // orbit resolves exactly
+    const double centroidX = sumX / glitched;
+    const double centroidY = sumY / glitched;
+    double nearest = -1.0;
+    for(unsigned int j = 0; j < theHeight; j++)
+      for(unsigned int k = 0; k < theWidth; k++)
+        if(aFrameBuffer[j * theWidth + k] == GLITCH_PIXEL)
+        {
+          const double distance = (k - centroidX) * (k - centroidX) + (j - centroidY) * (j - centroidY);
+          if(nearest < 0.0 || distance < nearest)
+          {
+            nearest = distance;
+            referenceX = k;
+            referenceY = j;
+          }
+        }
+  }
+
+  // Pixels no reference resolved
+  for(unsigned int j = 0; j < theHeight; j++)
+    for(unsigned int k = 0; k < theWidth; k++)
+      if(aFrameBuffer[j * theWidth + k] == GLITCH_PIXEL)
+      {
+        aFrameBuffer[j * theWidth + k] = perturbationReferencePixel(aCentreX, aCentreY, aScale, k, j);
+        thePertStats.hostPixels++;
+      }
+
+  // Return success
+  return 0;
+}
+
+void perturbationGetStats(perturbationStats* aStats)
+{
+  *aStats = thePertStats;
+}
+
+int perturbationRelease()
+{
+  if(thePertColorTable)
+    alignedFree(thePertColorTable);
+  thePertColorTable = 0;
+  thePertColorTableSize = 0;
+  return 0;
+}
@@ -0,0 +1,9 @@
+#ifndef PERTURBATION_H
+#define PERTURBATION_H
+
+// Constants of the perturbation (deep zoom) renderer; the kernel uses the
+// same values.
+#define GLITCH_PIXEL     0xFFFFFFFF  // pixel left for the next reference orbit
+#define GLITCH_TOLERANCE 1e-6        // glitched when |z|^2 < GLITCH_TOLERANCE * |Z|^2
+
+#endif
@@ -0,0 +1,98 @@
+// Copyright (C) 2013-2016 Altera Corporation, San Jose, California, USA. All rights reserved.
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this
+// software and associated documentation files (the "Software"), to deal in the Software
+// without restriction, including without limitation the rights to use, copy, modify, merge,
+// publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to
+// whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// This agreement shall be governed in all respects by the laws of the State of California and
+// by the laws of the United States of America.
+
+#ifndef SOFTWARE_MANDELBROT_H
+#define SOFTWARE_MANDELBROT_H
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+#include <stdint.h>
+#include "AOCLUtils/aocl_utils.h"
+#include "Acceleration.h"
+#include "Perturbation.h"
+#include "Precision.h"
+
+// Software Mandelbrot
+int softwareInitialize();
+
+int softwareSetColorTable(unsigned int* aColorTable,
+  unsigned int aColorTableSize);
+
+int softwareCalculateFrame(double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int* aFrameBuffer);
+
+// Rows aFirstRow to aFirstRow + aRows - 1 on the calling thread
+int softwareCalculateRows(double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int aFirstRow,
+  unsigned int aRows,
+  unsigned int* aFrameBuffer);
+
+// The aWidth x aHeight rectangle at pixel (aX, aY) of a frame
+int softwareCalculateRect(double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int aX,
+  unsigned int aY,
+  unsigned int aWidth,
+  unsigned int aHeight,
+  unsigned int* aFrameBuffer);
+
+// The FLOAT_REDO_PIXELs of a rectangle, in double precision; pixel (aX, aY)
+// is at (aStartX, aStartY)
+int softwareCalculateRedo(double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int aX,
+  unsigned int aY,
+  unsigned int aWidth,
+  unsigned int aHeight,
+  unsigned int* aFrameBuffer);
+
+// A frame by perturbation against a reference orbit
+int softwareCalculatePerturbed(const double* aOrbitX,
+  const double* aOrbitY,
+  unsigned int aOrbitLength,
+  double aDeltaX0,
+  double aDeltaY0,
+  double aScale,
+  bool aOnlyGlitched,
+  unsigned int* aFrameBuffer);
+
+int softwareSetAcceleration(unsigned int aFlags);
+
+int softwareSetPrecision(unsigned int aPrecision);
+
+// Single-threaded scalar reference
+int softwareCalculateFrameScalar(double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int* aFrameBuffer);
+
+int softwareRelease();
+
+#endif
+
@@ -0,0 +1,145 @@
+// Amount of loop unrolling. Higher unrolling amounts lead to higher
+// performance but also greater resource usage.
+#ifndef UNROLL
+#define UNROLL 20
+#endif
+
+// Define the color black as 0
+#define BLACK 0x00000000
+
+// Marker of a pixel the perturbation kernel could not resolve against its
+// reference orbit, as in PerturbationMandelbrot.h
+#define GLITCH_PIXEL 0xFFFFFFFF
+
+// A pixel is glitched when |z|^2 drops below this fraction of |Z|^2
+#define GLITCH_TOLERANCE 1e-6
+
+////////////////////////////////////////////////////////////////////
+// Hardware implementation of the mandelbrot algorithm
+////////////////////////////////////////////////////////////////////
+
+
+// Mandelbrot set: zn+1 = zn^2 + c;
+
+__kernel 
+void hw_mandelbrot_frame (
+							const double x0,
+							const double y0,
+							const double stepSize,
+							const unsigned int maxIterations,
+							__global unsigned int *restrict framebuffer,
+							__constant const unsigned int *restrict colorLUT,
+							const unsigned int windowWidth)
+{
+	// Work-item position
+	const size_t windowPosX = get_global_id(0);
+	const size_t windowPosY = get_global_id(1);
+	
+	const double stepPosX = x0 + (windowPosX * stepSize);
+	const double stepPosY = y0 - (windowPosY * stepSize);
+
+	// Variables for the calculation
+	double x = 0.0;
+	double y = 0.0;
+	double xSqr = 0.0;
+	double ySqr = 0.0;
+	unsigned int iterations = 0;
+
+	// Perform up to the maximum number of iterations to solve
+	// the current work-item's position in the image
+  //
+  // The loop unrolling factor can be adjusted based on the amount of FPGA
+  // resources available.
+
+	while (	xSqr + ySqr < 4.0 &&
+			iterations < maxIterations)
+	{
+		// Perform the current iteration
+		xSqr = x*x;
+		ySqr = y*y;
+
+		y = 2*x*y + stepPosY;
+		x = xSqr - ySqr + stepPosX;
+
+		// Increment iteration count
+		iterations++;
+	}
+
+	// Output black if we never finished, and a color from the look up table otherwise
+	framebuffer[windowWidth * windowPosY + windowPosX] = (iterations == maxIterations)? BLACK : colorLUT[iterations];
+}
+
+
+////////////////////////////////////////////////////////////////////
+// Perturbation (deep zoom) implementation
+////////////////////////////////////////////////////////////////////
+
+
+// Every pixel iterates its difference d to the reference orbit Z computed
+// on the host: dn+1 = 2*Zn*dn + dn^2 + dc, with zn = Zn + dn;
+// dc = (deltaX0 + x*stepSize, deltaY0 - y*stepSize) is the pixel's offset
+// from the reference point. Only the first pass computes every pixel; the
+// passes against a new reference (onlyGlitched) compute the GLITCH_PIXELs.
+
+__kernel 
+void hw_mandelbrot_perturb (
+							__global const double *restrict orbitX,
+							__global const double *restrict orbitY,
+							const unsigned int orbitLength,
+							const double deltaX0,
+							const double deltaY0,
+							const double stepSize,
+							const unsigned int maxIterations,
+							__global unsigned int *restrict framebuffer,
+							__constant const unsigned int *restrict colorLUT,
+							const unsigned int windowWidth,
+							const unsigned int onlyGlitched)
+{
+	// Work-item position
+	const size_t windowPosX = get_global_id(0);
+	const size_t windowPosY = get_global_id(1);
+	const size_t pixel = windowWidth * windowPosY + windowPosX;
+
+	if (onlyGlitched && framebuffer[pixel] != GLITCH_PIXEL)
+		return;
+
+	const double deltaC_X = deltaX0 + (windowPosX * stepSize);
+	const double deltaC_Y = deltaY0 - (windowPosY * stepSize);
+
+	double dx = 0.0;
+	double dy = 0.0;
+	unsigned int iterations = maxIterations;
+	bool glitched = false;
+
+	// Same count as hw_mandelbrot_frame: one more than the index of the
+	// first orbit point outside the radius 2 circle
+	for (unsigned int n = 0; n + 1 < maxIterations; n++)
+	{
+		const double X = orbitX[n];
+		const double Y = orbitY[n];
+		const double x = X + dx;
+		const double y = Y + dy;
+		const double magnitude = x*x + y*y;
+
+		if (magnitude >= 4.0)
+		{
+			iterations = n + 1;
+			break;
+		}
+
+		// The difference has swamped the orbit, or the reference escaped
+		// before this pixel
+		if (magnitude < GLITCH_TOLERANCE * (X*X + Y*Y) || n + 1 >= orbitLength)
+		{
+			glitched = true;
+			break;
+		}
+
+		const double dxNew = 2*(X*dx - Y*dy) + (dx*dx - dy*dy) + deltaC_X;
+		dy = 2*(X*dy + Y*dx) + 2*dx*dy + deltaC_Y;
+		dx = dxNew;
+	}
+
+	framebuffer[pixel] = glitched ? GLITCH_PIXEL :
+		(iterations == maxIterations) ? BLACK : colorLUT[iterations];
+}
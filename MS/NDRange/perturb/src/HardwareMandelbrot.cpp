@@ -0,0 +1,797 @@
+#include "HardwareMandelbrot.h"
+#include "SoftwareMandelbrot.h"
+
+using namespace aocl_utils;
+
+extern unsigned int theWidth;
+extern unsigned int theHeight;
+
+// ACL runtime configuration
+static unsigned numDevices = 0;
+static cl_platform_id thePlatform;
+static scoped_array<cl_device_id> theDevices;
+static cl_context theContext;
+static scoped_array<cl_command_queue> theQueues;
+static scoped_array<cl_kernel> theKernels;
+static cl_program theProgram;
+static cl_int theStatus;
+static scoped_array<unsigned> rowsPerDevice;
+
+static scoped_array<cl_mem> thePixelData;
+static unsigned int thePixelDataWidth = 0;
+static unsigned int thePixelDataHeight = 0;
+
+static cl_mem theHardColorTable = 0;
+static unsigned int theHardColorTableSize = 0;
+static unsigned int theHardAcceleration = 0;
+
+// Whether the frame kernel takes the accelerated frame mode flags; only
+// the kernel of the accel design does
+static bool theAccelKernel = false;
+
+// Frame kernels in single precision, NULL without the fp32 design, and the
+// precision of the frames
+static scoped_array<cl_kernel> theFloatKernels;
+static unsigned int theHardPrecision = PRECISION_DOUBLE;
+
+// Print the kernel times of every frame (the headless benchmark turns
+// this off and times the frames itself)
+bool printFrameTimes = true;
+
+// Frame scheduling. The dynamic schedule cuts the frame into groups of
+// theRowGroup rows that the devices, and theCpuWorkers software workers,
+// pull from a shared counter until the frame is done.
+static unsigned int theSchedule = SCHEDULE_STATIC;
+static unsigned int theRowGroup = 16;
+static unsigned int theCpuWorkers = 0;
+static unsigned int theNextGroup = 0;
+
+// Two row-group buffers per device, so that the next group is queued
+// while the last one is being read
+static scoped_array<cl_mem> theGroupData;
+static unsigned int theGroupDataSize = 0;
+
+// Work of every worker (devices first, then CPU workers) in the last frame
+static scoped_array<workerStats> theWorkerStats;
+
+// Per-device buffers of hardwareCalculateRect
+static scoped_array<cl_mem> theRectData;
+static unsigned int theRectDataSize = 0;
+
+// Perturbation kernels, NULL without the perturb design, and the reference
+// orbit they iterate against
+static scoped_array<cl_kernel> thePerturbKernels;
+static cl_mem theOrbitX = 0;
+static cl_mem theOrbitY = 0;
+static unsigned int theOrbitSize = 0;
+
+// Reset the frame buffer size
+int hardwareSetFrameBufferSize()
+{
+  if(thePixelDataWidth != theWidth ||
+    thePixelDataHeight != theHeight)
+  {
+    // Set new sizes
+    thePixelDataWidth = theWidth;
+    thePixelDataHeight = theHeight;
+
+    // If the buffer already exists release it
+    if(thePixelData) {
+      for(unsigned i = 0; i < numDevices; ++i) {
+        clReleaseMemObject(thePixelData[i]);
+      }
+    }
+
+    // Distribute rows evenly across all devices.
+    rowsPerDevice.reset(numDevices);
+    for(unsigned i = 0; i < numDevices; ++i) {
+      rowsPerDevice[i] = thePixelDataHeight / numDevices;
+      if(i < (thePixelDataHeight % numDevices)) { // for extra rows
+        rowsPerDevice[i]++;
+      }
+    }
+
+    thePixelData.reset(numDevices);
+    for(unsigned i = 0; i < numDevices; ++i) {
+      // create the input pixel data buffer
+      thePixelData[i] = clCreateBuffer(theContext, CL_MEM_WRITE_ONLY, 
+          thePixelDataWidth*rowsPerDevice[i]*sizeof(unsigned int), NULL, &theStatus);
+      checkError(theStatus, "Failed to create input pixel buffer");
+    }
+  }
+
+  // Return success
+  return 0;
+}
+
+// get the platform and device, and create the context, program, and kernels
+int hardwareInitialize()
+{
+  if(!setCwdToExeDir()) 
+  {
+    return -1;
+  }
+
+  // Set up the platform
+  thePlatform = findPlatform("Intel(R) FPGA");
+  if(thePlatform == NULL)
+  {
+    printf("Found no platforms!\n");
+    hardwareRelease();
+    return -1;
+  }
+
+  // Set up the device(s)
+  theDevices.reset(getDevices(thePlatform, CL_DEVICE_TYPE_ALL, &numDevices));
+
+  // Print the name of the platform being used
+  printf("Using platform: %s\n", getPlatformName(thePlatform).c_str());
+  printf("Using %d devices:\n", numDevices);
+  for(unsigned i = 0; i < numDevices; ++i) {
+    printf("  %s\n", getDeviceName(theDevices[i]).c_str());
+  }
+
+  // Create a context
+  theContext = clCreateContext(0, numDevices, theDevices, &oclContextCallback, NULL, &theStatus);
+  checkError(theStatus, "Failed to create context");
+
+  // Create command queues
+  theQueues.reset(numDevices);
+  for(unsigned i = 0; i < numDevices; ++i) {
+    theQueues[i] = clCreateCommandQueue(theContext, theDevices[i], CL_QUEUE_PROFILING_ENABLE, &theStatus);
+    checkError(theStatus, "Failed to create command queue");
+  }
+
+  // the name of the kernel we are going to load
+  const char *kernel_name = "hw_mandelbrot_frame";
+  
+
+
+  // Create the program using the binary aocx file
+  std::string binary_file = getBoardBinaryFile("perturb", theDevices[0]);
+  printf("Using AOCX: %s\n", binary_file.c_str());
+  theProgram = createProgramFromBinary(theContext, binary_file.c_str(), theDevices, numDevices);
+
+
+
+  // Create the kernels
+  theKernels.reset(numDevices);
+  thePerturbKernels.reset(numDevices);
+  theFloatKernels.reset(numDevices);
+  for(unsigned i = 0; i < numDevices; ++i) {
+    theKernels[i] = clCreateKernel(theProgram, kernel_name, &theStatus);
+    checkError(theStatus, "Failed to create kernel");
+    theFloatKernels[i] = clCreateKernel(theProgram, "hw_mandelbrot_frame_float", &theStatus);
+    if(theStatus != CL_SUCCESS)
+      theFloatKernels[i] = NULL;
+    thePerturbKernels[i] = clCreateKernel(theProgram, "hw_mandelbrot_perturb", &theStatus);
+    if(theStatus != CL_SUCCESS)
+      thePerturbKernels[i] = NULL;
+  }
+  if(!thePerturbKernels[0])
+    printf("No perturbation kernel in this AOCX\n");
+  if(!theFloatKernels[0])
+    printf("No single precision kernel in this AOCX\n");
+
+  // The accelerated frame kernel has the flags as an eighth argument
+  cl_uint numArgs = 0;
+  theStatus = clGetKernelInfo(theKernels[0], CL_KERNEL_NUM_ARGS, sizeof(numArgs), &numArgs, NULL);
+  checkError(theStatus, "Failed to query kernel arguments");
+  theAccelKernel = numArgs > 7;
+  if(!theAccelKernel)
+    printf("No accelerated frame mode in this AOCX\n");
+
+  // Return success
+  return 0;
+}
+
+// Set the color table
+int hardwareSetColorTable(
+  unsigned int* aColorTable,
+  unsigned int aColorTableSize)
+{
+  // If the color table is a different size than before
+  if(theHardColorTableSize != aColorTableSize)
+  {
+    // Set new table size
+    theHardColorTableSize = aColorTableSize;
+
+    // Free old table
+    if(theHardColorTable) clReleaseMemObject(theHardColorTable);
+
+    // Create new table
+    theHardColorTable = clCreateBuffer(theContext, CL_MEM_READ_ONLY, aColorTableSize*sizeof(unsigned int), NULL, &theStatus);
+    checkError(theStatus, "Failed to create color table buffer");
+  }
+
+  // Write the color table data to the device on the current queue
+  theStatus = clEnqueueWriteBuffer(theQueues[0], theHardColorTable, CL_TRUE, 0, aColorTableSize*sizeof(unsigned int), aColorTable, 0, NULL, NULL);
+  checkError(theStatus, "Failed to write to color table buffer");
+
+  // Return success
+  return 0;
+}
+
+// Set the accelerated frame mode; the kernel has no rectangle subdivision.
+// Returns -1 if the frame kernel has no accelerated frame mode.
+int hardwareSetAcceleration(unsigned int aFlags)
+{
+  theHardAcceleration = aFlags & (ACCEL_BULB | ACCEL_PERIOD);
+  if(!theAccelKernel && theHardAcceleration)
+    return -1;
+  return 0;
+}
+
+// Whether the AOCX has a frame kernel in aPrecision (none before
+// hardwareInitialize has created the kernels)
+bool hardwareHasPrecision(unsigned int aPrecision)
+{
+  return aPrecision != PRECISION_FLOAT || (theFloatKernels && theFloatKernels[0] != NULL);
+}
+
+// Set the precision of the frames; without the kernel in aPrecision the
+// frames stay in double precision and -1 is returned
+int hardwareSetPrecision(unsigned int aPrecision)
+{
+  if(!hardwareHasPrecision(aPrecision))
+  {
+    theHardPrecision = PRECISION_DOUBLE;
+    return -1;
+  }
+
+  theHardPrecision = aPrecision;
+  return 0;
+}
+
+// Frame kernel of aDevice in the precision of the frames
+static cl_kernel frameKernel(unsigned int aDevice)
+{
+  return theHardPrecision == PRECISION_FLOAT ? theFloatKernels[aDevice] : theKernels[aDevice];
+}
+
+// ND range of the frame kernel for aRows rows of aWidth pixels; the single
+// precision kernel computes FLOAT_LANES pixels per work-item
+static void frameGlobalSize(
+  unsigned int aWidth,
+  unsigned int aRows,
+  size_t* aGlobalSize)
+{
+  aGlobalSize[0] = theHardPrecision == PRECISION_FLOAT ?
+    (aWidth + FLOAT_LANES - 1) / FLOAT_LANES : aWidth;
+  aGlobalSize[1] = aRows;
+}
+
+// Set the frame kernel arguments for aWidth pixel wide rows starting at
+// (aStartX, aStartY) into aPixelData
+static cl_int setFrameArguments(
+  cl_kernel aKernel,
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int aWidth,
+  cl_mem aPixelData)
+{
+  cl_int status;
+  unsigned argi = 0;
+  if(theHardPrecision == PRECISION_FLOAT)
+  {
+    const cl_float startX = (cl_float)aStartX;
+    const cl_float startY = (cl_float)aStartY;
+    const cl_float scale = (cl_float)aScale;
+    status  = clSetKernelArg(aKernel, argi++, sizeof(cl_float), (void*)&startX);
+    status |= clSetKernelArg(aKernel, argi++, sizeof(cl_float), (void*)&startY);
+    status |= clSetKernelArg(aKernel, argi++, sizeof(cl_float), (void*)&scale);
+  }
+  else
+  {
+    status  = clSetKernelArg(aKernel, argi++, sizeof(cl_double), (void*)&aStartX);
+    status |= clSetKernelArg(aKernel, argi++, sizeof(cl_double), (void*)&aStartY);
+    status |= clSetKernelArg(aKernel, argi++, sizeof(cl_double), (void*)&aScale);
+  }
+  status |= clSetKernelArg(aKernel, argi++, sizeof(cl_uint), (void*)&theHardColorTableSize);
+  status |= clSetKernelArg(aKernel, argi++, sizeof(cl_mem), (void*)&aPixelData);
+  status |= clSetKernelArg(aKernel, argi++, sizeof(cl_mem), (void*)&theHardColorTable);
+  status |= clSetKernelArg(aKernel, argi++, sizeof(cl_uint), (void*)&aWidth);
+  if(theHardPrecision == PRECISION_FLOAT || theAccelKernel)
+    status |= clSetKernelArg(aKernel, argi++, sizeof(cl_uint), (void*)&theHardAcceleration);
+  return status;
+}
+
+// The FP32 kernel leaves the pixels its error bound cannot decide as
+// FLOAT_REDO_PIXELs. The software calculates them in double precision at
+// the positions of the double kernel, so every launch of aWidth x aHeight
+// pixels at (aX, aY) of the frame is redone from its own start position.
+static void redoFloatPixels(
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int aX,
+  unsigned int aY,
+  unsigned int aWidth,
+  unsigned int aHeight,
+  unsigned int* aFrameBuffer)
+{
+  if(theHardPrecision == PRECISION_FLOAT)
+    softwareCalculateRedo(aStartX, aStartY, aScale, aX, aY, aWidth, aHeight, aFrameBuffer);
+}
+
+// Set the frame scheduling: SCHEDULE_STATIC or SCHEDULE_DYNAMIC with
+// groups of aRowGroup rows and aCpuWorkers software workers
+int hardwareSetSchedule(
+  unsigned int aSchedule,
+  unsigned int aRowGroup,
+  unsigned int aCpuWorkers)
+{
+  theSchedule = aSchedule;
+  theRowGroup = aRowGroup > 0 ? aRowGroup : 1;
+  theCpuWorkers = aCpuWorkers;
+  return 0;
+}
+
+// Workers of the last frame, devices first, and their work
+unsigned int hardwareGetWorkerStats(const workerStats** aStats)
+{
+  *aStats = theWorkerStats;
+  return numDevices + (theSchedule == SCHEDULE_DYNAMIC ? theCpuWorkers : 0);
+}
+
+// Take the next row group of the frame, or -1 when all are taken
+static int nextRowGroup(unsigned int aGroups)
+{
+  int group;
+  #pragma omp critical(mandelbrot_schedule)
+  {
+    group = theNextGroup < aGroups ? (int)theNextGroup++ : -1;
+  }
+  return group;
+}
+
+// Device worker of the dynamic schedule: keeps two row groups in flight,
+// each computed into its own buffer and read straight into the frame
+static void deviceWorker(
+  unsigned int aDevice,
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int aGroups,
+  unsigned int* aFrameBuffer)
+{
+  cl_int status;
+  cl_event kernelDone[2] = {NULL, NULL};
+  cl_event readDone[2] = {NULL, NULL};
+  workerStats& stats = theWorkerStats[aDevice];
+
+  for(unsigned slot = 0; ; slot ^= 1)
+  {
+    // Retire the group last queued in this slot
+    if(readDone[slot])
+    {
+      clWaitForEvents(1, &readDone[slot]);
+      stats.busyTime += getStartEndTime(kernelDone[slot]) * 1e-9;
+      clReleaseEvent(kernelDone[slot]);
+      clReleaseEvent(readDone[slot]);
+      readDone[slot] = NULL;
+    }
+
+    const int group = nextRowGroup(aGroups);
+    if(group < 0)
+    {
+      // Retire the other slot and stop
+      if(readDone[slot ^ 1])
+      {
+        clWaitForEvents(1, &readDone[slot ^ 1]);
+        stats.busyTime += getStartEndTime(kernelDone[slot ^ 1]) * 1e-9;
+        clReleaseEvent(kernelDone[slot ^ 1]);
+        clReleaseEvent(readDone[slot ^ 1]);
+      }
+      break;
+    }
+
+    const unsigned int firstRow = group * theRowGroup;
+    const unsigned int rows = firstRow + theRowGroup < theHeight ? theRowGroup : theHeight - firstRow;
+    cl_mem buffer = theGroupData[2 * aDevice + slot];
+
+    cl_kernel kernel = frameKernel(aDevice);
+    status = setFrameArguments(kernel, aStartX, aStartY - firstRow * aScale, aScale, theWidth, buffer);
+    checkError(status, "Failed to set kernel arguments");
+
+    size_t globalSize[2];
+    frameGlobalSize(theWidth, rows, globalSize);
+    status = clEnqueueNDRangeKernel(theQueues[aDevice], kernel, 2, NULL, globalSize, NULL, 0, NULL, &kernelDone[slot]);
+    checkError(status, "Failed to enqueue kernel");
+
+    status = clEnqueueReadBuffer(theQueues[aDevice], buffer, CL_FALSE, 0, theWidth*rows*sizeof(unsigned int), &aFrameBuffer[firstRow * theWidth], 0, NULL, &readDone[slot]);
+    checkError(status, "Failed to read output");
+    clFlush(theQueues[aDevice]);
+
+    stats.rowGroups++;
+  }
+}
+
+// CPU worker of the dynamic schedule
+static void cpuWorker(
+  unsigned int aWorker,
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int aGroups,
+  unsigned int* aFrameBuffer)
+{
+  workerStats& stats = theWorkerStats[numDevices + aWorker];
+
+  for(int group = nextRowGroup(aGroups); group >= 0; group = nextRowGroup(aGroups))
+  {
+    const double start_time = getCurrentTimestamp();
+    const unsigned int firstRow = group * theRowGroup;
+    const unsigned int rows = firstRow + theRowGroup < theHeight ? theRowGroup : theHeight - firstRow;
+    softwareCalculateRows(aStartX, aStartY, aScale, firstRow, rows, aFrameBuffer);
+    stats.busyTime += getCurrentTimestamp() - start_time;
+    stats.rowGroups++;
+  }
+}
+
+// calculate the current frame with the devices (and CPU workers) pulling
+// row groups until none is left
+static int hardwareCalculateFrameDynamic(
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int* aFrameBuffer)
+{
+  // Make sure the group buffers fit
+  if(theGroupDataSize != theWidth * theRowGroup)
+  {
+    if(theGroupData) {
+      for(unsigned i = 0; i < 2 * numDevices; ++i) {
+        clReleaseMemObject(theGroupData[i]);
+      }
+    }
+
+    theGroupDataSize = theWidth * theRowGroup;
+    theGroupData.reset(2 * numDevices);
+    for(unsigned i = 0; i < 2 * numDevices; ++i) {
+      theGroupData[i] = clCreateBuffer(theContext, CL_MEM_WRITE_ONLY,
+          theGroupDataSize*sizeof(unsigned int), NULL, &theStatus);
+      checkError(theStatus, "Failed to create row group buffer");
+    }
+  }
+
+  const unsigned int groups = (theHeight + theRowGroup - 1) / theRowGroup;
+  const unsigned int workers = numDevices + theCpuWorkers;
+
+  theWorkerStats.reset(workers);
+  for(unsigned i = 0; i < workers; ++i) {
+    theWorkerStats[i].busyTime = 0.0;
+    theWorkerStats[i].rowGroups = 0;
+  }
+  theNextGroup = 0;
+
+  const double start_time = getCurrentTimestamp();
+
+  // One host thread per worker; without OpenMP the workers run in turn,
+  // so the first device takes every group
+  #pragma omp parallel for num_threads(workers) schedule(static, 1)
+  for(int w = 0; w < (int)workers; ++w)
+  {
+    if(w < (int)numDevices)
+      deviceWorker(w, aStartX, aStartY, aScale, groups, aFrameBuffer);
+    else
+      cpuWorker(w - numDevices, aStartX, aStartY, aScale, groups, aFrameBuffer);
+  }
+
+  // The CPU workers' groups have no FLOAT_REDO_PIXELs
+  for(unsigned int firstRow = 0; firstRow < theHeight; firstRow += theRowGroup)
+  {
+    const unsigned int rows = firstRow + theRowGroup < theHeight ? theRowGroup : theHeight - firstRow;
+    redoFloatPixels(aStartX, aStartY - firstRow * aScale, aScale, 0, firstRow, theWidth, rows, aFrameBuffer);
+  }
+
+  const double end_time = getCurrentTimestamp();
+
+  if(printFrameTimes) {
+    printf("\nFrame time: %0.3f ms\n", (end_time - start_time) * 1e3);
+    for(unsigned i = 0; i < workers; ++i) {
+      printf("%s %u: %u row groups, busy %0.1f%%\n", i < numDevices ? "Device" : "CPU worker",
+          i < numDevices ? i : i - numDevices, theWorkerStats[i].rowGroups,
+          100.0 * theWorkerStats[i].busyTime / (end_time - start_time));
+    }
+  }
+
+  // Return success
+  return 0;
+}
+
+// calculate the current frame using Altera hardware
+int hardwareCalculateFrame(
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int* aFrameBuffer)
+{
+  if(theSchedule == SCHEDULE_DYNAMIC)
+    return hardwareCalculateFrameDynamic(aStartX, aStartY, aScale, aFrameBuffer);
+
+  // Make sure width and height match up
+  hardwareSetFrameBufferSize();
+
+  unsigned rowOffset = 0;
+  
+  
+  
+  scoped_array<cl_event> kernel_event(numDevices);
+
+  const double start_time = getCurrentTimestamp();
+  
+  
+
+  
+  
+  for(unsigned i = 0; i < numDevices; rowOffset += rowsPerDevice[i++])
+  {
+    // Create ND range size
+    size_t globalSize[2];
+    frameGlobalSize(thePixelDataWidth, rowsPerDevice[i], globalSize);
+
+    // Set the arguments
+    cl_kernel kernel = frameKernel(i);
+    const double offsetedStartY = aStartY - rowOffset * aScale;
+    theStatus = setFrameArguments(kernel, aStartX, offsetedStartY, aScale, theWidth, thePixelData[i]);
+    checkError(theStatus, "Failed to set kernel arguments");
+
+    // Launch kernel
+    theStatus = clEnqueueNDRangeKernel(theQueues[i], kernel, 2, NULL, globalSize, NULL, 0, NULL, &kernel_event[i]);
+    checkError(theStatus, "Failed to enqueue kernel");
+  }
+
+
+
+
+  clWaitForEvents(numDevices, kernel_event);
+
+  // One contiguous slice per device
+  theWorkerStats.reset(numDevices);
+  for(unsigned i = 0; i < numDevices; ++i) {
+    theWorkerStats[i].busyTime = getStartEndTime(kernel_event[i]) * 1e-9;
+    theWorkerStats[i].rowGroups = 1;
+  }
+
+  const double end_time = getCurrentTimestamp();
+
+  const double kernel_time = end_time - start_time;
+
+  if(printFrameTimes) {
+    printf("\nKernel time: %0.3f ms\n",kernel_time * 1e3);
+
+    for(unsigned i = 0; i < numDevices; rowOffset += rowsPerDevice[i++]) {
+      cl_ulong time_ns = getStartEndTime(kernel_event[i]);
+      printf("Kernel Time (using event): %0.3f ms\n", double(time_ns) * 1e-6);
+    }
+  }
+
+
+  for(unsigned i = 0; i < numDevices; rowOffset += rowsPerDevice[i++]) {
+    clReleaseEvent(kernel_event[i]);
+  }
+
+
+
+
+  rowOffset = 0;
+  for(unsigned i = 0; i < numDevices; rowOffset += rowsPerDevice[i++])
+  {
+    // Read the output
+    theStatus = clEnqueueReadBuffer(theQueues[i], thePixelData[i], CL_TRUE, 0, thePixelDataWidth*rowsPerDevice[i]*sizeof(unsigned int), &aFrameBuffer[rowOffset * theWidth], 0, NULL, NULL);
+    checkError(theStatus, "Failed to read output");
+
+    redoFloatPixels(aStartX, aStartY - rowOffset * aScale, aScale, 0, rowOffset, theWidth, rowsPerDevice[i], aFrameBuffer);
+  }
+
+  // Return success
+  return 0;
+}
+
+// calculate the aWidth x aHeight rectangle of the frame at (aX, aY); the
+// rows are split evenly across the devices, and each part is read straight
+// into the frame
+int hardwareCalculateRect(
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int aX,
+  unsigned int aY,
+  unsigned int aWidth,
+  unsigned int aHeight,
+  unsigned int* aFrameBuffer)
+{
+  if(aWidth == 0 || aHeight == 0)
+    return 0;
+
+  const unsigned int rowsPerPart = (aHeight + numDevices - 1) / numDevices;
+
+  // Make sure the rectangle buffers fit
+  if(theRectDataSize < aWidth * rowsPerPart)
+  {
+    if(theRectData) {
+      for(unsigned i = 0; i < numDevices; ++i) {
+        clReleaseMemObject(theRectData[i]);
+      }
+    }
+
+    theRectDataSize = aWidth * rowsPerPart;
+    theRectData.reset(numDevices);
+    for(unsigned i = 0; i < numDevices; ++i) {
+      theRectData[i] = clCreateBuffer(theContext, CL_MEM_WRITE_ONLY,
+          theRectDataSize*sizeof(unsigned int), NULL, &theStatus);
+      checkError(theStatus, "Failed to create rectangle buffer");
+    }
+  }
+
+  scoped_array<cl_event> read_event(numDevices);
+  unsigned parts = 0;
+
+  for(unsigned int row = 0; row < aHeight; row += rowsPerPart, ++parts)
+  {
+    const unsigned int rows = row + rowsPerPart < aHeight ? rowsPerPart : aHeight - row;
+
+    cl_kernel kernel = frameKernel(parts);
+    theStatus = setFrameArguments(kernel, aStartX + aX * aScale,
+        aStartY - (aY + row) * aScale, aScale, aWidth, theRectData[parts]);
+    checkError(theStatus, "Failed to set kernel arguments");
+
+    size_t globalSize[2];
+    frameGlobalSize(aWidth, rows, globalSize);
+    theStatus = clEnqueueNDRangeKernel(theQueues[parts], kernel, 2, NULL, globalSize, NULL, 0, NULL, NULL);
+    checkError(theStatus, "Failed to enqueue kernel");
+
+    // Rows of aWidth pixels into rows of theWidth pixels
+    size_t bufferOrigin[3] = {0, 0, 0};
+    size_t hostOrigin[3] = {aX * sizeof(unsigned int), aY + row, 0};
+    size_t region[3] = {aWidth * sizeof(unsigned int), rows, 1};
+    theStatus = clEnqueueReadBufferRect(theQueues[parts], theRectData[parts], CL_FALSE,
+        bufferOrigin, hostOrigin, region, aWidth * sizeof(unsigned int), 0,
+        theWidth * sizeof(unsigned int), 0, aFrameBuffer, 0, NULL, &read_event[parts]);
+    checkError(theStatus, "Failed to read output");
+  }
+
+  clWaitForEvents(parts, read_event);
+  for(unsigned i = 0; i < parts; ++i) {
+    clReleaseEvent(read_event[i]);
+  }
+
+  for(unsigned int row = 0; row < aHeight; row += rowsPerPart)
+  {
+    const unsigned int rows = row + rowsPerPart < aHeight ? rowsPerPart : aHeight - row;
+    redoFloatPixels(aStartX + aX * aScale, aStartY - (aY + row) * aScale, aScale, aX, aY + row, aWidth, rows, aFrameBuffer);
+  }
+
+  // Return success
+  return 0;
+}
+
+// calculate a frame by perturbation against the reference orbit aOrbitX/Y
+// of aOrbitLength points; pixel (x, y) is at (aDeltaX0 + x*aScale,
+// aDeltaY0 - y*aScale) from the reference point. With aOnlyGlitched only
+// the GLITCH_PIXELs left by the last call are calculated. Returns -1 if
+// the AOCX has no perturbation kernel.
+int hardwareCalculatePerturbed(
+  const double* aOrbitX,
+  const double* aOrbitY,
+  unsigned int aOrbitLength,
+  double aDeltaX0,
+  double aDeltaY0,
+  double aScale,
+  bool aOnlyGlitched,
+  unsigned int* aFrameBuffer)
+{
+  if(!thePerturbKernels[0])
+    return -1;
+
+  // Make sure width and height match up
+  hardwareSetFrameBufferSize();
+
+  // Upload the orbit once for all devices
+  if(theOrbitSize < aOrbitLength)
+  {
+    if(theOrbitX) clReleaseMemObject(theOrbitX);
+    if(theOrbitY) clReleaseMemObject(theOrbitY);
+
+    theOrbitSize = aOrbitLength;
+    theOrbitX = clCreateBuffer(theContext, CL_MEM_READ_ONLY, theOrbitSize*sizeof(cl_double), NULL, &theStatus);
+    checkError(theStatus, "Failed to create orbit buffer");
+    theOrbitY = clCreateBuffer(theContext, CL_MEM_READ_ONLY, theOrbitSize*sizeof(cl_double), NULL, &theStatus);
+    checkError(theStatus, "Failed to create orbit buffer");
+  }
+
+  theStatus = clEnqueueWriteBuffer(theQueues[0], theOrbitX, CL_TRUE, 0, aOrbitLength*sizeof(cl_double), aOrbitX, 0, NULL, NULL);
+  checkError(theStatus, "Failed to write the orbit");
+  theStatus = clEnqueueWriteBuffer(theQueues[0], theOrbitY, CL_TRUE, 0, aOrbitLength*sizeof(cl_double), aOrbitY, 0, NULL, NULL);
+  checkError(theStatus, "Failed to write the orbit");
+
+  const cl_uint onlyGlitched = aOnlyGlitched ? 1 : 0;
+  scoped_array<cl_event> kernel_event(numDevices);
+  unsigned rowOffset = 0;
+
+  for(unsigned i = 0; i < numDevices; rowOffset += rowsPerDevice[i++])
+  {
+    const double offsetedDeltaY0 = aDeltaY0 - rowOffset * aScale;
+
+    cl_kernel kernel = thePerturbKernels[i];
+    unsigned argi = 0;
+    theStatus  = clSetKernelArg(kernel, argi++, sizeof(cl_mem), (void*)&theOrbitX);
+    theStatus |= clSetKernelArg(kernel, argi++, sizeof(cl_mem), (void*)&theOrbitY);
+    theStatus |= clSetKernelArg(kernel, argi++, sizeof(cl_uint), (void*)&aOrbitLength);
+    theStatus |= clSetKernelArg(kernel, argi++, sizeof(cl_double), (void*)&aDeltaX0);
+    theStatus |= clSetKernelArg(kernel, argi++, sizeof(cl_double), (void*)&offsetedDeltaY0);
+    theStatus |= clSetKernelArg(kernel, argi++, sizeof(cl_double), (void*)&aScale);
+    theStatus |= clSetKernelArg(kernel, argi++, sizeof(cl_uint), (void*)&theHardColorTableSize);
+    theStatus |= clSetKernelArg(kernel, argi++, sizeof(cl_mem), (void*)&thePixelData[i]);
+    theStatus |= clSetKernelArg(kernel, argi++, sizeof(cl_mem), (void*)&theHardColorTable);
+    theStatus |= clSetKernelArg(kernel, argi++, sizeof(cl_uint), (void*)&theWidth);
+    theStatus |= clSetKernelArg(kernel, argi++, sizeof(cl_uint), (void*)&onlyGlitched);
+    checkError(theStatus, "Failed to set kernel arguments");
+
+    size_t globalSize[2] = {thePixelDataWidth, rowsPerDevice[i]};
+    theStatus = clEnqueueNDRangeKernel(theQueues[i], kernel, 2, NULL, globalSize, NULL, 0, NULL, &kernel_event[i]);
+    checkError(theStatus, "Failed to enqueue kernel");
+  }
+
+  clWaitForEvents(numDevices, kernel_event);
+  for(unsigned i = 0; i < numDevices; ++i) {
+    clReleaseEvent(kernel_event[i]);
+  }
+
+  // The device buffers keep the frame for the next pass
+  rowOffset = 0;
+  for(unsigned i = 0; i < numDevices; rowOffset += rowsPerDevice[i++])
+  {
+    theStatus = clEnqueueReadBuffer(theQueues[i], thePixelData[i], CL_TRUE, 0, thePixelDataWidth*rowsPerDevice[i]*sizeof(unsigned int), &aFrameBuffer[rowOffset * theWidth], 0, NULL, NULL);
+    checkError(theStatus, "Failed to read output");
+  }
+
+  // Return success
+  return 0;
+}
+
+// free memory allocated by the program
+int hardwareRelease()
+{
+  // Release all created objects
+  for(unsigned i = 0; i < numDevices; ++i)
+  {
+    if(theKernels && theKernels[i]) 
+      clReleaseKernel(theKernels[i]);
+    if(thePerturbKernels && thePerturbKernels[i])
+      clReleaseKernel(thePerturbKernels[i]);
+    if(theFloatKernels && theFloatKernels[i])
+      clReleaseKernel(theFloatKernels[i]);
+    if(theQueues && theQueues[i]) 
+      clReleaseCommandQueue(theQueues[i]);
+    if(thePixelData && thePixelData[i]) 
+      clReleaseMemObject(thePixelData[i]);
+    if(theGroupData && theGroupData[2 * i])
+      clReleaseMemObject(theGroupData[2 * i]);
+    if(theGroupData && theGroupData[2 * i + 1])
+      clReleaseMemObject(theGroupData[2 * i + 1]);
+    if(theRectData && theRectData[i])
+      clReleaseMemObject(theRectData[i]);
+  }
+  if(theProgram) 
+    clReleaseProgram(theProgram);
+  if(theContext) 
+    clReleaseContext(theContext);
+  if(theHardColorTable) 
+    clReleaseMemObject(theHardColorTable);
+  if(theOrbitX)
+    clReleaseMemObject(theOrbitX);
+  if(theOrbitY)
+    clReleaseMemObject(theOrbitY);
+
+  // Return success
+  return 0;
+}
+
+// Called by aocl_utils::checkError
+void cleanup() {
+  hardwareRelease();
+}
+
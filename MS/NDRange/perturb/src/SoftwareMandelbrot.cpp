@@ -0,0 +1,1081 @@
+#include "SoftwareMandelbrot.h"
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Vector width of the frame engine: 8 doubles with AVX-512, 4 with AVX,
+// otherwise 4 lanes in plain arrays that the compiler may vectorize. In
+// single precision the same registers hold twice as many lanes.
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#define SOFTWARE_LANES 8
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define SOFTWARE_LANES 4
+#else
+#define SOFTWARE_LANES 4
+#endif
+#define SOFTWARE_FLOAT_LANES (2 * SOFTWARE_LANES)
+
+// Frames are cut into tiles that the threads take one at a time, since
+// the cost of a tile depends on how much of it lies in the set
+#define TILE_WIDTH  64
+#define TILE_HEIGHT 8
+
+// With rectangle subdivision the tiles are squares, and rectangles up to
+// MIN_RECTANGLE pixels across are computed in full
+#define SUBDIVIDE_TILE 64
+#define MIN_RECTANGLE  4
+
+// Steps between two periodicity checks (a power of two)
+#define PERIOD_CHECK 8
+
+// The FP32 error bound takes 2|z| from an approximate root; this factor
+// covers the error of rsqrt (2^-11) and of the Newton step
+#define MODULUS_BOUND 2.002f
+
+using namespace aocl_utils;
+
+// Global frame sizes
+extern unsigned int theWidth;
+extern unsigned int theHeight;
+
+// Local Data
+static int* theSoftColorTable = 0;
+static unsigned int theSoftColorTableSize = 0;
+static unsigned int theSoftAcceleration = 0;
+static unsigned int theSoftPrecision = PRECISION_DOUBLE;
+
+// compute the mandel value of a pixel
+inline unsigned int mandel_pixel(
+  double x0,
+  double y0,
+  unsigned int maxIterations)
+{
+  // variables for the calculation
+  double x = 0.0;
+  double y = 0.0;
+  double xSqr = 0.0;
+  double ySqr = 0.0;
+  unsigned int iterations = 0;
+
+  // perform up to the maximum number of iterations to solve
+  // the current work-item's position in the image
+  while (xSqr + ySqr < 4.0 &&
+      iterations < maxIterations)
+  {
+    // perform the current iteration
+    xSqr = x*x;
+    ySqr = y*y;
+
+    y = 2*x*y + y0;
+    x = xSqr - ySqr + x0;
+
+    // increment iteration count
+    iterations++;
+  }
+
+  // return the iteration count
+  return iterations;
+}
+
+// true if (x0, y0) lies in the main cardioid or the period-2 bulb, whose
+// orbits never escape
+static inline bool in_main_bulbs(
+  double x0,
+  double y0)
+{
+  const double xq = x0 - 0.25;
+  const double ySqr = y0*y0;
+  const double q = xq*xq + ySqr;
+  if (q * (q + xq) <= 0.25 * ySqr)
+    return true;
+
+  const double xp = x0 + 1.0;
+  return xp*xp + ySqr <= 0.0625;
+}
+
+// compute the mandel values of SOFTWARE_LANES pixels at (x0[l], y0[l]).
+// Every lane runs the iteration of mandel_pixel and stops counting once it
+// escapes; the group stops when all lanes have escaped or the limit is
+// reached. With ACCEL_BULB, lanes in the main bulbs are not iterated; with
+// ACCEL_PERIOD, a lane whose orbit returns exactly to the point saved at
+// the last power-of-two step is periodic and stops. Both get
+// maxIterations, which is what the full iteration would give. The orbits
+// are compared every PERIOD_CHECK steps only: a cycle of period p is then
+// seen at most PERIOD_CHECK * p steps late.
+static void mandel_lanes(
+  const double* x0,
+  const double* y0,
+  unsigned int maxIterations,
+  unsigned int acceleration,
+  unsigned int* iterations)
+{
+  // lanes known to reach maxIterations
+  unsigned int done = 0;
+  if (acceleration & ACCEL_BULB)
+  {
+    for (int l = 0; l < SOFTWARE_LANES; l++)
+      if (in_main_bulbs(x0[l], y0[l]))
+        done |= 1u << l;
+  }
+
+  const unsigned int allLanes = (1u << SOFTWARE_LANES) - 1;
+  const bool checkPeriod = (acceleration & ACCEL_PERIOD) != 0;
+
+  if (done != allLanes)
+  {
+#if defined(__AVX512F__)
+    const __m512d cx = _mm512_loadu_pd(x0);
+    const __m512d cy = _mm512_loadu_pd(y0);
+    const __m512d four = _mm512_set1_pd(4.0);
+    const __m512d one = _mm512_set1_pd(1.0);
+    __m512d x = _mm512_setzero_pd(), y = _mm512_setzero_pd();
+    __m512d xSqr = _mm512_setzero_pd(), ySqr = _mm512_setzero_pd();
+    __m512d xOld = _mm512_setzero_pd(), yOld = _mm512_setzero_pd();
+    __m512d count = _mm512_setzero_pd();
+    __mmask8 active = (__mmask8)(allLanes & ~done);
+
+    for (unsigned int i = 0; i < maxIterations; i++)
+    {
+      active = _mm512_mask_cmp_pd_mask(active, _mm512_add_pd(xSqr, ySqr), four, _CMP_LT_OQ);
+      if (!active)
+        break;
+
+      xSqr = _mm512_mul_pd(x, x);
+      ySqr = _mm512_mul_pd(y, y);
+      y = _mm512_add_pd(_mm512_mul_pd(_mm512_add_pd(x, x), y), cy);
+      x = _mm512_add_pd(_mm512_sub_pd(xSqr, ySqr), cx);
+      count = _mm512_mask_add_pd(count, active, count, one);
+
+      if (checkPeriod && (i & (PERIOD_CHECK - 1)) == PERIOD_CHECK - 1)
+      {
+        const __mmask8 periodic = _mm512_mask_cmp_pd_mask(
+          _mm512_mask_cmp_pd_mask(active, x, xOld, _CMP_EQ_OQ), y, yOld, _CMP_EQ_OQ);
+        done |= periodic;
+        active &= ~periodic;
+        if (((i + 1) & i) == 0)
+        {
+          xOld = x;
+          yOld = y;
+        }
+      }
+    }
+
+    double lanes[SOFTWARE_LANES];
+    _mm512_storeu_pd(lanes, count);
+    for (int l = 0; l < SOFTWARE_LANES; l++)
+      iterations[l] = (unsigned int)lanes[l];
+
+#elif defined(__AVX__)
+    long long initial[SOFTWARE_LANES];
+    for (int l = 0; l < SOFTWARE_LANES; l++)
+      initial[l] = (done >> l) & 1 ? 0 : -1;
+
+    const __m256d cx = _mm256_loadu_pd(x0);
+    const __m256d cy = _mm256_loadu_pd(y0);
+    const __m256d four = _mm256_set1_pd(4.0);
+    const __m256d one = _mm256_set1_pd(1.0);
+    __m256d x = _mm256_setzero_pd(), y = _mm256_setzero_pd();
+    __m256d xSqr = _mm256_setzero_pd(), ySqr = _mm256_setzero_pd();
+    __m256d xOld = _mm256_setzero_pd(), yOld = _mm256_setzero_pd();
+    __m256d count = _mm256_setzero_pd();
+    __m256d active = _mm256_castsi256_pd(_mm256_loadu_si256((const __m256i*)initial));
+
+    for (unsigned int i = 0; i < maxIterations; i++)
+    {
+      active = _mm256_and_pd(active, _mm256_cmp_pd(_mm256_add_pd(xSqr, ySqr), four, _CMP_LT_OQ));
+      if (_mm256_movemask_pd(active) == 0)
+        break;
+
+      xSqr = _mm256_mul_pd(x, x);
+      ySqr = _mm256_mul_pd(y, y);
+      y = _mm256_add_pd(_mm256_mul_pd(_mm256_add_pd(x, x), y), cy);
+      x = _mm256_add_pd(_mm256_sub_pd(xSqr, ySqr), cx);
+      count = _mm256_add_pd(count, _mm256_and_pd(active, one));
+
+      if (checkPeriod && (i & (PERIOD_CHECK - 1)) == PERIOD_CHECK - 1)
+      {
+        const __m256d periodic = _mm256_and_pd(active, _mm256_and_pd(
+          _mm256_cmp_pd(x, xOld, _CMP_EQ_OQ), _mm256_cmp_pd(y, yOld, _CMP_EQ_OQ)));
+        done |= _mm256_movemask_pd(periodic);
+        active = _mm256_andnot_pd(periodic, active);
+        if (((i + 1) & i) == 0)
+        {
+          xOld = x;
+          yOld = y;
+        }
+      }
+    }
+
+    double lanes[SOFTWARE_LANES];
+    _mm256_storeu_pd(lanes, count);
+    for (int l = 0; l < SOFTWARE_LANES; l++)
+      iterations[l] = (unsigned int)lanes[l];
+
+#else
+    double x[SOFTWARE_LANES], y[SOFTWARE_LANES];
+    double xSqr[SOFTWARE_LANES], ySqr[SOFTWARE_LANES];
+    double xOld[SOFTWARE_LANES], yOld[SOFTWARE_LANES];
+    unsigned int count[SOFTWARE_LANES];
+    int active[SOFTWARE_LANES];
+    for (int l = 0; l < SOFTWARE_LANES; l++)
+    {
+      x[l] = y[l] = xSqr[l] = ySqr[l] = xOld[l] = yOld[l] = 0.0;
+      count[l] = 0;
+      active[l] = !((done >> l) & 1);
+    }
+
+    for (unsigned int i = 0; i < maxIterations; i++)
+    {
+      int anyActive = 0;
+      for (int l = 0; l < SOFTWARE_LANES; l++)
+      {
+        active[l] = active[l] && xSqr[l] + ySqr[l] < 4.0;
+        anyActive |= active[l];
+      }
+      if (!anyActive)
+        break;
+
+      for (int l = 0; l < SOFTWARE_LANES; l++)
+      {
+        xSqr[l] = x[l]*x[l];
+        ySqr[l] = y[l]*y[l];
+        y[l] = 2*x[l]*y[l] + y0[l];
+        x[l] = xSqr[l] - ySqr[l] + x0[l];
+        count[l] += active[l];
+      }
+
+      if (checkPeriod && (i & (PERIOD_CHECK - 1)) == PERIOD_CHECK - 1)
+      {
+        for (int l = 0; l < SOFTWARE_LANES; l++)
+        {
+          if (active[l] && x[l] == xOld[l] && y[l] == yOld[l])
+          {
+            done |= 1u << l;
+            active[l] = 0;
+          }
+        }
+        if (((i + 1) & i) == 0)
+        {
+          for (int l = 0; l < SOFTWARE_LANES; l++)
+          {
+            xOld[l] = x[l];
+            yOld[l] = y[l];
+          }
+        }
+      }
+    }
+
+    for (int l = 0; l < SOFTWARE_LANES; l++)
+      iterations[l] = count[l];
+#endif
+  }
+
+  for (int l = 0; l < SOFTWARE_LANES; l++)
+    if ((done >> l) & 1)
+      iterations[l] = maxIterations;
+}
+
+#if !defined(__AVX__)
+// An upper bound of 2 sqrt(aSquare) without sqrtf, so that the lanes
+// vectorise: one Newton step from the halved exponent is never below the
+// root, and MODULUS_BOUND covers its rounding
+static inline float modulus_bound(float aSquare)
+{
+  unsigned int bits;
+  memcpy(&bits, &aSquare, sizeof(bits));
+  bits = (bits >> 1) + 0x1fbd1df5;
+  float root;
+  memcpy(&root, &bits, sizeof(root));
+  return (root + aSquare / root) * (MODULUS_BOUND / 2);
+}
+#endif
+
+// mandel_lanes in single precision for SOFTWARE_FLOAT_LANES pixels, as
+// hw_mandelbrot_frame_float computes them. Every lane bounds the distance
+// of its orbit from the exact one: the bound starts at the rounding of c,
+// grows by (2|z| + bound) times itself and the FLOAT_ROUNDING of every
+// iteration. A lane stops once the bound reaches |z|^2 - 4, as its escape
+// test may then differ from the exact one; the mask of those lanes is
+// returned, for double precision.
+static unsigned int mandel_lanes_float(
+  const float* x0,
+  const float* y0,
+  unsigned int maxIterations,
+  unsigned int acceleration,
+  unsigned int* iterations)
+{
+  // lanes known to reach maxIterations
+  unsigned int done = 0;
+  if (acceleration & ACCEL_BULB)
+  {
+    for (int l = 0; l < SOFTWARE_FLOAT_LANES; l++)
+      if (in_main_bulbs(x0[l], y0[l]))
+        done |= 1u << l;
+  }
+
+  const unsigned int allLanes = (1u << SOFTWARE_FLOAT_LANES) - 1;
+  const bool checkPeriod = (acceleration & ACCEL_PERIOD) != 0;
+
+  // lanes left for double precision
+  unsigned int redo = 0;
+
+  if (done != allLanes)
+  {
+#if defined(__AVX512F__)
+    const __m512 cx = _mm512_loadu_ps(x0);
+    const __m512 cy = _mm512_loadu_ps(y0);
+    const __m512 four = _mm512_set1_ps(4.0f);
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512 rounding = _mm512_set1_ps((float)FLOAT_ROUNDING);
+    const __m512 cRounding = _mm512_mul_ps(rounding, _mm512_add_ps(_mm512_abs_ps(cx), _mm512_abs_ps(cy)));
+    const __m512 twice = _mm512_set1_ps(MODULUS_BOUND);
+    const __m512 tiny = _mm512_set1_ps(FLT_MIN);
+    __m512 error = cRounding;
+    __m512 x = _mm512_setzero_ps(), y = _mm512_setzero_ps();
+    __m512 xSqr = _mm512_setzero_ps(), ySqr = _mm512_setzero_ps();
+    __m512 xOld = _mm512_setzero_ps(), yOld = _mm512_setzero_ps();
+    __m512 count = _mm512_setzero_ps();
+    __mmask16 active = (__mmask16)(allLanes & ~done);
+
+    for (unsigned int i = 0; i < maxIterations; i++)
+    {
+      active = _mm512_mask_cmp_ps_mask(active, _mm512_add_ps(xSqr, ySqr), four, _CMP_LT_OQ);
+      if (!active)
+        break;
+
+      xSqr = _mm512_mul_ps(x, x);
+      ySqr = _mm512_mul_ps(y, y);
+
+      const __m512 r2 = _mm512_add_ps(xSqr, ySqr);
+      const __m512 positive = _mm512_add_ps(r2, tiny);
+      const __m512 modulus = _mm512_mul_ps(_mm512_mul_ps(positive, _mm512_maskz_rsqrt14_ps(active, positive)), twice);
+      error = _mm512_add_ps(_mm512_mul_ps(error, _mm512_add_ps(modulus, error)),
+        _mm512_add_ps(_mm512_mul_ps(rounding, r2), cRounding));
+      const __mmask16 undecided = _mm512_mask_cmp_ps_mask(active,
+        _mm512_abs_ps(_mm512_sub_ps(r2, four)), error, _CMP_LE_OQ);
+      redo |= undecided;
+      active &= ~undecided;
+
+      y = _mm512_add_ps(_mm512_mul_ps(_mm512_add_ps(x, x), y), cy);
+      x = _mm512_add_ps(_mm512_sub_ps(xSqr, ySqr), cx);
+      count = _mm512_mask_add_ps(count, active, count, one);
+
+      if (checkPeriod && (i & (PERIOD_CHECK - 1)) == PERIOD_CHECK - 1)
+      {
+        const __mmask16 periodic = _mm512_mask_cmp_ps_mask(
+          _mm512_mask_cmp_ps_mask(active, x, xOld, _CMP_EQ_OQ), y, yOld, _CMP_EQ_OQ);
+        done |= periodic;
+        active &= ~periodic;
+        if (((i + 1) & i) == 0)
+        {
+          xOld = x;
+          yOld = y;
+        }
+      }
+    }
+
+    float lanes[SOFTWARE_FLOAT_LANES];
+    _mm512_storeu_ps(lanes, count);
+    for (int l = 0; l < SOFTWARE_FLOAT_LANES; l++)
+      iterations[l] = (unsigned int)lanes[l];
+
+#elif defined(__AVX__)
+    int initial[SOFTWARE_FLOAT_LANES];
+    for (int l = 0; l < SOFTWARE_FLOAT_LANES; l++)
+      initial[l] = (done >> l) & 1 ? 0 : -1;
+
+    const __m256 cx = _mm256_loadu_ps(x0);
+    const __m256 cy = _mm256_loadu_ps(y0);
+    const __m256 four = _mm256_set1_ps(4.0f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    const __m256 rounding = _mm256_set1_ps((float)FLOAT_ROUNDING);
+    const __m256 cRounding = _mm256_mul_ps(rounding,
+      _mm256_add_ps(_mm256_andnot_ps(sign, cx), _mm256_andnot_ps(sign, cy)));
+    const __m256 twice = _mm256_set1_ps(MODULUS_BOUND);
+    const __m256 tiny = _mm256_set1_ps(FLT_MIN);
+    __m256 error = cRounding;
+    __m256 x = _mm256_setzero_ps(), y = _mm256_setzero_ps();
+    __m256 xSqr = _mm256_setzero_ps(), ySqr = _mm256_setzero_ps();
+    __m256 xOld = _mm256_setzero_ps(), yOld = _mm256_setzero_ps();
+    __m256 count = _mm256_setzero_ps();
+    __m256 active = _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i*)initial));
+
+    for (unsigned int i = 0; i < maxIterations; i++)
+    {
+      active = _mm256_and_ps(active, _mm256_cmp_ps(_mm256_add_ps(xSqr, ySqr), four, _CMP_LT_OQ));
+      if (_mm256_movemask_ps(active) == 0)
+        break;
+
+      xSqr = _mm256_mul_ps(x, x);
+      ySqr = _mm256_mul_ps(y, y);
+
+      const __m256 r2 = _mm256_add_ps(xSqr, ySqr);
+      const __m256 positive = _mm256_add_ps(r2, tiny);
+      const __m256 modulus = _mm256_mul_ps(_mm256_mul_ps(positive, _mm256_rsqrt_ps(positive)), twice);
+      error = _mm256_add_ps(_mm256_mul_ps(error, _mm256_add_ps(modulus, error)),
+        _mm256_add_ps(_mm256_mul_ps(rounding, r2), cRounding));
+      const __m256 undecided = _mm256_and_ps(active,
+        _mm256_cmp_ps(_mm256_andnot_ps(sign, _mm256_sub_ps(r2, four)), error, _CMP_LE_OQ));
+      redo |= _mm256_movemask_ps(undecided);
+      active = _mm256_andnot_ps(undecided, active);
+
+      y = _mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(x, x), y), cy);
+      x = _mm256_add_ps(_mm256_sub_ps(xSqr, ySqr), cx);
+      count = _mm256_add_ps(count, _mm256_and_ps(active, one));
+
+      if (checkPeriod && (i & (PERIOD_CHECK - 1)) == PERIOD_CHECK - 1)
+      {
+        const __m256 periodic = _mm256_and_ps(active, _mm256_and_ps(
+          _mm256_cmp_ps(x, xOld, _CMP_EQ_OQ), _mm256_cmp_ps(y, yOld, _CMP_EQ_OQ)));
+        done |= _mm256_movemask_ps(periodic);
+        active = _mm256_andnot_ps(periodic, active);
+        if (((i + 1) & i) == 0)
+        {
+          xOld = x;
+          yOld = y;
+        }
+      }
+    }
+
+    float lanes[SOFTWARE_FLOAT_LANES];
+    _mm256_storeu_ps(lanes, count);
+    for (int l = 0; l < SOFTWARE_FLOAT_LANES; l++)
+      iterations[l] = (unsigned int)lanes[l];
+
+#else
+    float x[SOFTWARE_FLOAT_LANES], y[SOFTWARE_FLOAT_LANES];
+    float xSqr[SOFTWARE_FLOAT_LANES], ySqr[SOFTWARE_FLOAT_LANES];
+    float xOld[SOFTWARE_FLOAT_LANES], yOld[SOFTWARE_FLOAT_LANES];
+    float error[SOFTWARE_FLOAT_LANES], cRounding[SOFTWARE_FLOAT_LANES];
+    unsigned int count[SOFTWARE_FLOAT_LANES];
+    int active[SOFTWARE_FLOAT_LANES], undecided[SOFTWARE_FLOAT_LANES];
+    for (int l = 0; l < SOFTWARE_FLOAT_LANES; l++)
+    {
+      x[l] = y[l] = xSqr[l] = ySqr[l] = xOld[l] = yOld[l] = 0.0f;
+      cRounding[l] = error[l] = (float)FLOAT_ROUNDING * (fabsf(x0[l]) + fabsf(y0[l]));
+      count[l] = 0;
+      active[l] = !((done >> l) & 1);
+    }
+
+    for (unsigned int i = 0; i < maxIterations; i++)
+    {
+      int anyActive = 0;
+      for (int l = 0; l < SOFTWARE_FLOAT_LANES; l++)
+      {
+        active[l] = active[l] && xSqr[l] + ySqr[l] < 4.0f;
+        anyActive |= active[l];
+      }
+      if (!anyActive)
+        break;
+
+      for (int l = 0; l < SOFTWARE_FLOAT_LANES; l++)
+      {
+        xSqr[l] = x[l]*x[l];
+        ySqr[l] = y[l]*y[l];
+
+        const float r2 = xSqr[l] + ySqr[l];
+        error[l] = error[l] * (modulus_bound(r2) + error[l]) + (float)FLOAT_ROUNDING * r2 + cRounding[l];
+        undecided[l] = active[l] & (fabsf(r2 - 4.0f) <= error[l]);
+        active[l] &= !undecided[l];
+
+        y[l] = 2*x[l]*y[l] + y0[l];
+        x[l] = xSqr[l] - ySqr[l] + x0[l];
+        count[l] += active[l];
+      }
+
+      for (int l = 0; l < SOFTWARE_FLOAT_LANES; l++)
+        redo |= (unsigned int)undecided[l] << l;
+
+      if (checkPeriod && (i & (PERIOD_CHECK - 1)) == PERIOD_CHECK - 1)
+      {
+        for (int l = 0; l < SOFTWARE_FLOAT_LANES; l++)
+        {
+          if (active[l] && x[l] == xOld[l] && y[l] == yOld[l])
+          {
+            done |= 1u << l;
+            active[l] = 0;
+          }
+        }
+        if (((i + 1) & i) == 0)
+        {
+          for (int l = 0; l < SOFTWARE_FLOAT_LANES; l++)
+          {
+            xOld[l] = x[l];
+            yOld[l] = y[l];
+          }
+        }
+      }
+    }
+
+    for (int l = 0; l < SOFTWARE_FLOAT_LANES; l++)
+      iterations[l] = count[l];
+#endif
+  }
+
+  for (int l = 0; l < SOFTWARE_FLOAT_LANES; l++)
+    if ((done >> l) & 1)
+      iterations[l] = maxIterations;
+
+  return redo;
+}
+
+// compute the mandel values of SOFTWARE_FLOAT_LANES pixels in the
+// precision of the frame: one group of float lanes, or two groups of
+// double lanes. Both give the same values, as the float lanes that cannot
+// be decided are redone in double.
+static void mandel_pixels(
+  const double* x0,
+  const double* y0,
+  unsigned int maxIterations,
+  unsigned int acceleration,
+  unsigned int* iterations)
+{
+  if (theSoftPrecision == PRECISION_FLOAT)
+  {
+    float x0f[SOFTWARE_FLOAT_LANES];
+    float y0f[SOFTWARE_FLOAT_LANES];
+    for (int l = 0; l < SOFTWARE_FLOAT_LANES; l++)
+    {
+      x0f[l] = (float)x0[l];
+      y0f[l] = (float)y0[l];
+    }
+    const unsigned int redo = mandel_lanes_float(x0f, y0f, maxIterations, acceleration, iterations);
+
+    const unsigned int groupLanes = (1u << SOFTWARE_LANES) - 1;
+    for (int g = 0; g < SOFTWARE_FLOAT_LANES; g += SOFTWARE_LANES)
+    {
+      if (((redo >> g) & groupLanes) == 0)
+        continue;
+
+      unsigned int exact[SOFTWARE_LANES];
+      mandel_lanes(x0 + g, y0 + g, maxIterations, acceleration, exact);
+      for (int l = 0; l < SOFTWARE_LANES; l++)
+        if ((redo >> (g + l)) & 1)
+          iterations[g + l] = exact[l];
+    }
+  }
+  else
+  {
+    mandel_lanes(x0, y0, maxIterations, acceleration, iterations);
+    mandel_lanes(x0 + SOFTWARE_LANES, y0 + SOFTWARE_LANES, maxIterations, acceleration,
+      iterations + SOFTWARE_LANES);
+  }
+}
+
+// Pixels gathered SOFTWARE_FLOAT_LANES at a time for mandel_pixels, each
+// with the place its iteration count goes to
+struct pixelBatch {
+  double x0[SOFTWARE_FLOAT_LANES];
+  double y0[SOFTWARE_FLOAT_LANES];
+  unsigned int* out[SOFTWARE_FLOAT_LANES];
+  int count;
+};
+
+static void batchFlush(pixelBatch& aBatch, unsigned int aAcceleration)
+{
+  if (aBatch.count == 0)
+    return;
+
+  // Pad with copies of the first pixel
+  for (int l = aBatch.count; l < SOFTWARE_FLOAT_LANES; l++)
+  {
+    aBatch.x0[l] = aBatch.x0[0];
+    aBatch.y0[l] = aBatch.y0[0];
+  }
+
+  unsigned int iterations[SOFTWARE_FLOAT_LANES];
+  mandel_pixels(aBatch.x0, aBatch.y0, theSoftColorTableSize, aAcceleration, iterations);
+  for (int l = 0; l < aBatch.count; l++)
+    *aBatch.out[l] = iterations[l];
+  aBatch.count = 0;
+}
+
+static inline void batchAdd(pixelBatch& aBatch, double aX0, double aY0,
+  unsigned int* aOut, unsigned int aAcceleration)
+{
+  aBatch.x0[aBatch.count] = aX0;
+  aBatch.y0[aBatch.count] = aY0;
+  aBatch.out[aBatch.count] = aOut;
+  if (++aBatch.count == SOFTWARE_FLOAT_LANES)
+    batchFlush(aBatch, aAcceleration);
+}
+
+// Initialize by reporting the engine configuration
+int softwareInitialize()
+{
+#ifdef _OPENMP
+  printf("Software: %d threads, %d double or %d float lanes\n", omp_get_max_threads(),
+    SOFTWARE_LANES, SOFTWARE_FLOAT_LANES);
+#else
+  printf("Software: 1 thread, %d double or %d float lanes\n", SOFTWARE_LANES, SOFTWARE_FLOAT_LANES);
+#endif
+  return 0;
+}
+
+// Set the color table
+int softwareSetColorTable(
+  unsigned int* aColorTable,
+  unsigned int aColorTableSize)
+{
+  // If the color table is a different size than before
+  if(theSoftColorTableSize != aColorTableSize)
+  {
+    // Set new table size
+    theSoftColorTableSize = aColorTableSize;
+
+    // Free old table
+    if(theSoftColorTable) alignedFree(theSoftColorTable);
+
+    // Create new table
+    theSoftColorTable = (int*)alignedMalloc(theSoftColorTableSize * sizeof(int));
+  }
+
+  // Write the color table data to the device on the current queue
+  memcpy(theSoftColorTable, aColorTable, theSoftColorTableSize*sizeof(int));
+
+  // Return success
+  return 0;
+}
+
+// Calculate one tile of a frame, up to column aColumnEnd and row aRowEnd,
+// SOFTWARE_FLOAT_LANES pixels at a time; the lanes past the right edge of
+// the tile are computed but not stored
+static void softwareCalculateTile(
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int aTileX,
+  unsigned int aTileY,
+  unsigned int aColumnEnd,
+  unsigned int aRowEnd,
+  unsigned int* aFrameBuffer)
+{
+  const unsigned int xEnd = aTileX + TILE_WIDTH < aColumnEnd ? aTileX + TILE_WIDTH : aColumnEnd;
+  const unsigned int yEnd = aTileY + TILE_HEIGHT < aRowEnd ? aTileY + TILE_HEIGHT : aRowEnd;
+
+  double x0[SOFTWARE_FLOAT_LANES];
+  double y0[SOFTWARE_FLOAT_LANES];
+  unsigned int iterations[SOFTWARE_FLOAT_LANES];
+
+  for (unsigned int j = aTileY; j < yEnd; j++)
+  {
+    unsigned int* fb_ptr = aFrameBuffer + j * theWidth;
+    for (int l = 0; l < SOFTWARE_FLOAT_LANES; l++)
+      y0[l] = aStartY - j * aScale;
+
+    for (unsigned int k = aTileX; k < xEnd; k += SOFTWARE_FLOAT_LANES)
+    {
+      for (int l = 0; l < SOFTWARE_FLOAT_LANES; l++)
+        x0[l] = aStartX + (k + l) * aScale;
+
+      mandel_pixels(x0, y0, theSoftColorTableSize, theSoftAcceleration, iterations);
+
+      for (int l = 0; l < SOFTWARE_FLOAT_LANES && k + l < xEnd; l++)
+      {
+        const unsigned int pixel = iterations[l];
+        fb_ptr[k + l] = pixel == theSoftColorTableSize ? 0x0 : theSoftColorTable[pixel];
+      }
+    }
+  }
+}
+
+// A tile under rectangle subdivision: the iteration counts of its pixels
+// and the pixels waiting to be computed
+struct subdividedTile {
+  double startX;
+  double startY;
+  double scale;
+  unsigned int tileX;
+  unsigned int tileY;
+  unsigned int width;
+  unsigned int* iterations;
+  pixelBatch batch;
+};
+
+static inline void tileAdd(subdividedTile& aTile, unsigned int aX, unsigned int aY)
+{
+  batchAdd(aTile.batch,
+    aTile.startX + (aTile.tileX + aX) * aTile.scale,
+    aTile.startY - (aTile.tileY + aY) * aTile.scale,
+    &aTile.iterations[aY * aTile.width + aX], theSoftAcceleration);
+}
+
+// Mariani-Silver subdivision of the rectangle with corners (aX0, aY0) and
+// (aX1, aY1), whose border is already computed. If the whole border has
+// one iteration count the inside is filled with it, otherwise the
+// rectangle is cut in four by a computed cross, down to MIN_RECTANGLE.
+static void subdivide(
+  subdividedTile& aTile,
+  unsigned int aX0,
+  unsigned int aY0,
+  unsigned int aX1,
+  unsigned int aY1)
+{
+  // Nothing inside
+  if (aX1 - aX0 < 2 || aY1 - aY0 < 2)
+    return;
+
+  const unsigned int w = aTile.width;
+  unsigned int* it = aTile.iterations;
+  const unsigned int value = it[aY0 * w + aX0];
+
+  bool uniform = true;
+  for (unsigned int x = aX0; x <= aX1 && uniform; x++)
+    uniform = it[aY0 * w + x] == value && it[aY1 * w + x] == value;
+  for (unsigned int y = aY0 + 1; y < aY1 && uniform; y++)
+    uniform = it[y * w + aX0] == value && it[y * w + aX1] == value;
+
+  if (uniform)
+  {
+    for (unsigned int y = aY0 + 1; y < aY1; y++)
+      for (unsigned int x = aX0 + 1; x < aX1; x++)
+        it[y * w + x] = value;
+    return;
+  }
+
+  // Small rectangles are computed in full. Their inside is no other
+  // rectangle's border, so the batch is left to fill up across rectangles.
+  if (aX1 - aX0 <= MIN_RECTANGLE || aY1 - aY0 <= MIN_RECTANGLE)
+  {
+    for (unsigned int y = aY0 + 1; y < aY1; y++)
+      for (unsigned int x = aX0 + 1; x < aX1; x++)
+        tileAdd(aTile, x, y);
+    return;
+  }
+
+  const unsigned int xm = (aX0 + aX1) / 2;
+  const unsigned int ym = (aY0 + aY1) / 2;
+  for (unsigned int x = aX0 + 1; x < aX1; x++)
+    tileAdd(aTile, x, ym);
+  for (unsigned int y = aY0 + 1; y < aY1; y++)
+    if (y != ym)
+      tileAdd(aTile, xm, y);
+  batchFlush(aTile.batch, theSoftAcceleration);
+
+  subdivide(aTile, aX0, aY0, xm, ym);
+  subdivide(aTile, xm, aY0, aX1, ym);
+  subdivide(aTile, aX0, ym, xm, aY1);
+  subdivide(aTile, xm, ym, aX1, aY1);
+}
+
+// Calculate one SUBDIVIDE_TILE square tile by computing its border and
+// subdividing it
+static void softwareCalculateTileSubdivided(
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int aTileX,
+  unsigned int aTileY,
+  unsigned int* aFrameBuffer)
+{
+  unsigned int iterations[SUBDIVIDE_TILE * SUBDIVIDE_TILE];
+
+  subdividedTile tile;
+  tile.startX = aStartX;
+  tile.startY = aStartY;
+  tile.scale = aScale;
+  tile.tileX = aTileX;
+  tile.tileY = aTileY;
+  tile.width = aTileX + SUBDIVIDE_TILE < theWidth ? SUBDIVIDE_TILE : theWidth - aTileX;
+  tile.iterations = iterations;
+  tile.batch.count = 0;
+
+  const unsigned int height = aTileY + SUBDIVIDE_TILE < theHeight ? SUBDIVIDE_TILE : theHeight - aTileY;
+  const unsigned int xLast = tile.width - 1;
+  const unsigned int yLast = height - 1;
+
+  for (unsigned int x = 0; x <= xLast; x++)
+  {
+    tileAdd(tile, x, 0);
+    if (yLast > 0)
+      tileAdd(tile, x, yLast);
+  }
+  for (unsigned int y = 1; y < yLast; y++)
+  {
+    tileAdd(tile, 0, y);
+    if (xLast > 0)
+      tileAdd(tile, xLast, y);
+  }
+  batchFlush(tile.batch, theSoftAcceleration);
+
+  subdivide(tile, 0, 0, xLast, yLast);
+  batchFlush(tile.batch, theSoftAcceleration);
+
+  for (unsigned int y = 0; y < height; y++)
+  {
+    unsigned int* fb_ptr = aFrameBuffer + (aTileY + y) * theWidth + aTileX;
+    for (unsigned int x = 0; x < tile.width; x++)
+    {
+      const unsigned int pixel = iterations[y * tile.width + x];
+      fb_ptr[x] = pixel == theSoftColorTableSize ? 0x0 : theSoftColorTable[pixel];
+    }
+  }
+}
+
+// Use the cpu to calculate a frame: tiles are handed out to the threads
+// dynamically, and each tile is computed SOFTWARE_FLOAT_LANES pixels at a
+// time
+int softwareCalculateFrame(
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int* aFrameBuffer)
+{
+  const bool subdivided = (theSoftAcceleration & ACCEL_SUBDIVIDE) != 0;
+  const unsigned int tileWidth = subdivided ? SUBDIVIDE_TILE : TILE_WIDTH;
+  const unsigned int tileHeight = subdivided ? SUBDIVIDE_TILE : TILE_HEIGHT;
+
+  const int tilesX = (theWidth + tileWidth - 1) / tileWidth;
+  const int tilesY = (theHeight + tileHeight - 1) / tileHeight;
+  const int tiles = tilesX * tilesY;
+
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (int t = 0; t < tiles; t++)
+  {
+    const unsigned int tileX = (t % tilesX) * tileWidth;
+    const unsigned int tileY = (t / tilesX) * tileHeight;
+    if (subdivided)
+      softwareCalculateTileSubdivided(aStartX, aStartY, aScale, tileX, tileY, aFrameBuffer);
+    else
+      softwareCalculateTile(aStartX, aStartY, aScale, tileX, tileY, theWidth, theHeight, aFrameBuffer);
+  }
+
+  //return success
+  return 0;
+}
+
+// Calculate aRows rows of a frame from aFirstRow on the calling thread, for
+// a CPU worker that shares the frame with the hardware
+int softwareCalculateRows(
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int aFirstRow,
+  unsigned int aRows,
+  unsigned int* aFrameBuffer)
+{
+  const unsigned int rowEnd = aFirstRow + aRows < theHeight ? aFirstRow + aRows : theHeight;
+
+  for (unsigned int tileY = aFirstRow; tileY < rowEnd; tileY += TILE_HEIGHT)
+    for (unsigned int tileX = 0; tileX < theWidth; tileX += TILE_WIDTH)
+      softwareCalculateTile(aStartX, aStartY, aScale, tileX, tileY, theWidth, rowEnd, aFrameBuffer);
+
+  //return success
+  return 0;
+}
+
+// Calculate the aWidth x aHeight rectangle at (aX, aY) of a frame, with the
+// tiles of the rectangle handed out to the threads like a whole frame
+int softwareCalculateRect(
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int aX,
+  unsigned int aY,
+  unsigned int aWidth,
+  unsigned int aHeight,
+  unsigned int* aFrameBuffer)
+{
+  const int tilesX = (aWidth + TILE_WIDTH - 1) / TILE_WIDTH;
+  const int tilesY = (aHeight + TILE_HEIGHT - 1) / TILE_HEIGHT;
+  const int tiles = tilesX * tilesY;
+
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (int t = 0; t < tiles; t++)
+  {
+    const unsigned int tileX = aX + (t % tilesX) * TILE_WIDTH;
+    const unsigned int tileY = aY + (t / tilesX) * TILE_HEIGHT;
+    softwareCalculateTile(aStartX, aStartY, aScale, tileX, tileY, aX + aWidth, aY + aHeight, aFrameBuffer);
+  }
+
+  //return success
+  return 0;
+}
+
+// Calculate in double precision the FLOAT_REDO_PIXELs that the FP32 kernel
+// left in the aWidth x aHeight rectangle at (aX, aY), SOFTWARE_LANES pixels
+// of a row at a time. As in a kernel launch, (aStartX, aStartY) is pixel
+// (aX, aY) and the others are whole steps of aScale from it.
+int softwareCalculateRedo(
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int aX,
+  unsigned int aY,
+  unsigned int aWidth,
+  unsigned int aHeight,
+  unsigned int* aFrameBuffer)
+{
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (int j = (int)aY; j < (int)(aY + aHeight); j++)
+  {
+    unsigned int* fb_ptr = aFrameBuffer + j * theWidth;
+    unsigned int k = aX;
+
+    while (true)
+    {
+      unsigned int columns[SOFTWARE_LANES];
+      int count = 0;
+      for (; k < aX + aWidth && count < SOFTWARE_LANES; k++)
+        if (fb_ptr[k] == FLOAT_REDO_PIXEL)
+          columns[count++] = k;
+      if (count == 0)
+        break;
+
+      // Pad with copies of the first pixel
+      double x0[SOFTWARE_LANES];
+      double y0[SOFTWARE_LANES];
+      for (int l = 0; l < SOFTWARE_LANES; l++)
+      {
+        x0[l] = aStartX + (columns[l < count ? l : 0] - aX) * aScale;
+        y0[l] = aStartY - (j - aY) * aScale;
+      }
+
+      unsigned int iterations[SOFTWARE_LANES];
+      mandel_lanes(x0, y0, theSoftColorTableSize, theSoftAcceleration, iterations);
+      for (int l = 0; l < count; l++)
+        fb_ptr[columns[l]] = iterations[l] == theSoftColorTableSize ? 0x0 : theSoftColorTable[iterations[l]];
+    }
+  }
+
+  //return success
+  return 0;
+}
+
+// Calculate a frame by perturbation against a reference orbit, as
+// hw_mandelbrot_perturb does: every pixel iterates its difference to the
+// orbit, and pixels the orbit cannot resolve are left as GLITCH_PIXEL.
+// With aOnlyGlitched only the GLITCH_PIXELs of aFrameBuffer are calculated.
+int softwareCalculatePerturbed(
+  const double* aOrbitX,
+  const double* aOrbitY,
+  unsigned int aOrbitLength,
+  double aDeltaX0,
+  double aDeltaY0,
+  double aScale,
+  bool aOnlyGlitched,
+  unsigned int* aFrameBuffer)
+{
+  const unsigned int maxIterations = theSoftColorTableSize;
+
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (int j = 0; j < (int)theHeight; j++)
+  {
+    unsigned int* fb_ptr = aFrameBuffer + j * theWidth;
+    const double deltaC_Y = aDeltaY0 - j * aScale;
+
+    for (unsigned int k = 0; k < theWidth; k++)
+    {
+      if (aOnlyGlitched && fb_ptr[k] != GLITCH_PIXEL)
+        continue;
+
+      const double deltaC_X = aDeltaX0 + k * aScale;
+      double dx = 0.0;
+      double dy = 0.0;
+      unsigned int iterations = maxIterations;
+      bool glitched = false;
+
+      for (unsigned int n = 0; n + 1 < maxIterations; n++)
+      {
+        const double X = aOrbitX[n];
+        const double Y = aOrbitY[n];
+        const double x = X + dx;
+        const double y = Y + dy;
+        const double magnitude = x*x + y*y;
+
+        if (magnitude >= 4.0)
+        {
+          iterations = n + 1;
+          break;
+        }
+        if (magnitude < GLITCH_TOLERANCE * (X*X + Y*Y) || n + 1 >= aOrbitLength)
+        {
+          glitched = true;
+          break;
+        }
+
+        const double dxNew = 2*(X*dx - Y*dy) + (dx*dx - dy*dy) + deltaC_X;
+        dy = 2*(X*dy + Y*dx) + 2*dx*dy + deltaC_Y;
+        dx = dxNew;
+      }
+
+      fb_ptr[k] = glitched ? GLITCH_PIXEL :
+        iterations == maxIterations ? 0x0 : theSoftColorTable[iterations];
+    }
+  }
+
+  //return success
+  return 0;
+}
+
+// Set the accelerated frame mode (ACCEL_* flags)
+int softwareSetAcceleration(unsigned int aFlags)
+{
+  theSoftAcceleration = aFlags;
+  return 0;
+}
+
+// Set the precision of the frames (PRECISION_DOUBLE or PRECISION_FLOAT);
+// the scalar reference and the perturbation frames stay in double
+int softwareSetPrecision(unsigned int aPrecision)
+{
+  theSoftPrecision = aPrecision;
+  return 0;
+}
+
+// Use the cpu to calculate a frame one pixel at a time on one thread, as a
+// reference for the frame engine above
+int softwareCalculateFrameScalar(
+  double aStartX,
+  double aStartY,
+  double aScale,
+  unsigned int* aFrameBuffer)
+{
+  // temporary pointer and index variables
+  unsigned int * fb_ptr = aFrameBuffer;
+  unsigned int j, k, pixel;
+
+  // window position variables
+  double x = aStartX;
+  double y = aStartY;
+  double cur_x, cur_y;
+  double cur_step_size = aScale;
+
+  // for each pixel in the y dimension window; positions are computed from
+  // the origin as in the kernel rather than accumulated, so both methods
+  // sample the same points
+  for (j = 0; j < theHeight; j++)
+  {
+    cur_y = y - j * cur_step_size;
+
+    // for each pixel in the x dimension of the window
+    for (k = 0; k < theWidth; k++)
+    {
+      cur_x = x + k * cur_step_size;
+
+      // set the value of the pixel in the window
+      pixel = mandel_pixel(cur_x, cur_y, theSoftColorTableSize);
+      if (pixel == theSoftColorTableSize)
+        *fb_ptr++ = 0x0;
+      else
+        *fb_ptr++ = theSoftColorTable[pixel];
+    }
+  }
+
+  //return success
+  return 0;
+}
+
+// Release by doing nothing
+int softwareRelease()
+{
+  return 0;
+}